@@ -0,0 +1,175 @@
+// CommandProtocol.cpp
+// 10/18/2026
+
+// Encoding and decoding of CommandServer's messages, see CommandProtocol.h
+
+#include "CommandProtocol.h"
+
+const int snapshotFixedSize = 12; // bytes before the distances
+const int frameFixedSize = 24;
+
+static void put16(uint8_t* buffer, int16_t value)
+{
+	buffer[0] = (uint8_t)(value & 0xFF);
+	buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+static void put32(uint8_t* buffer, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		buffer[i] = (uint8_t)(value >> (8 * i));
+}
+
+static void put64(uint8_t* buffer, uint64_t value)
+{
+	for (int i = 0; i < 8; i++)
+		buffer[i] = (uint8_t)(value >> (8 * i));
+}
+
+static int16_t get16(const uint8_t* buffer)
+{
+	return (int16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* buffer)
+{
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++)
+		value |= (uint32_t)buffer[i] << (8 * i);
+	return value;
+}
+
+static uint64_t get64(const uint8_t* buffer)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++)
+		value |= (uint64_t)buffer[i] << (8 * i);
+	return value;
+}
+
+static int16_t toMilli(double value)
+{
+	return (int16_t)(value * 1000.0);
+}
+
+int commandMessageLength(const uint8_t* buffer, int available)
+{
+	if (available < 1)
+		return 0;
+	switch (buffer[0])
+	{
+	case requestSetSpeed:
+		return 5;
+	case requestSnapshot:
+		return 1;
+	case requestSubscribe:
+		return 2;
+	case replyAck:
+		return 3;
+	case replySnapshot:
+		if (available < snapshotFixedSize)
+			return 0;
+		if (buffer[snapshotFixedSize - 1] > maxSonar)
+			return -1;
+		return snapshotFixedSize + 2 * buffer[snapshotFixedSize - 1];
+	case replyFrame:
+		if (available < frameFixedSize)
+			return 0;
+		if (buffer[frameFixedSize - 1] > maxSonar)
+			return -1;
+		return frameFixedSize + 2 * buffer[frameFixedSize - 1];
+	default:
+		return -1;
+	}
+}
+
+int encodeSetSpeed(uint8_t* buffer, int translational, double angular)
+{
+	buffer[0] = requestSetSpeed;
+	put16(buffer + 1, (int16_t)translational);
+	put16(buffer + 3, toMilli(angular));
+	return 5;
+}
+
+int encodeSnapshotRequest(uint8_t* buffer)
+{
+	buffer[0] = requestSnapshot;
+	return 1;
+}
+
+int encodeSubscribe(uint8_t* buffer, bool subscribe)
+{
+	buffer[0] = requestSubscribe;
+	buffer[1] = subscribe ? 1 : 0;
+	return 2;
+}
+
+int encodeAck(uint8_t* buffer, uint8_t requestType, uint8_t status)
+{
+	buffer[0] = replyAck;
+	buffer[1] = requestType;
+	buffer[2] = status;
+	return 3;
+}
+
+int encodeSnapshot(uint8_t* buffer, const CommandSnapshot& snapshot)
+{
+	int numSonar = (snapshot.numSonar < maxSonar) ? snapshot.numSonar : maxSonar;
+	buffer[0] = replySnapshot;
+	put32(buffer + 1, snapshot.framesReceived);
+	put16(buffer + 5, (int16_t)snapshot.x);
+	put16(buffer + 7, (int16_t)snapshot.y);
+	put16(buffer + 9, toMilli(snapshot.theta));
+	buffer[11] = (uint8_t)numSonar;
+	for (int i = 0; i < numSonar; i++)
+		put16(buffer + snapshotFixedSize + 2 * i, (int16_t)snapshot.distances[i]);
+	return snapshotFixedSize + 2 * numSonar;
+}
+
+int encodeFrame(uint8_t* buffer, const SensorFrame& frame)
+{
+	int numSonar = (frame.numSonar < maxSonar) ? frame.numSonar : maxSonar;
+	buffer[0] = replyFrame;
+	put32(buffer + 1, frame.sequence);
+	put64(buffer + 5, (uint64_t)frame.timestamp);
+	put16(buffer + 13, frame.x);
+	put16(buffer + 15, frame.y);
+	put16(buffer + 17, toMilli(frame.theta));
+	put16(buffer + 19, frame.translational);
+	put16(buffer + 21, toMilli(frame.angular));
+	buffer[23] = (uint8_t)numSonar;
+	for (int i = 0; i < numSonar; i++)
+		put16(buffer + frameFixedSize + 2 * i, frame.distances[i]);
+	return frameFixedSize + 2 * numSonar;
+}
+
+void decodeSetSpeed(const uint8_t* buffer, int* translational, double* angular)
+{
+	*translational = get16(buffer + 1);
+	*angular = get16(buffer + 3) / 1000.0;
+}
+
+void decodeSnapshot(const uint8_t* buffer, CommandSnapshot* snapshot)
+{
+	snapshot->framesReceived = get32(buffer + 1);
+	snapshot->x = get16(buffer + 5);
+	snapshot->y = get16(buffer + 7);
+	snapshot->theta = get16(buffer + 9) / 1000.0;
+	snapshot->numSonar = buffer[11];
+	for (int i = 0; i < snapshot->numSonar; i++)
+		snapshot->distances[i] = get16(buffer + snapshotFixedSize + 2 * i);
+}
+
+void decodeFrame(const uint8_t* buffer, SensorFrame* frame)
+{
+	frame->sequence = get32(buffer + 1);
+	frame->timestamp = (int64_t)get64(buffer + 5);
+	frame->x = get16(buffer + 13);
+	frame->y = get16(buffer + 15);
+	frame->theta = get16(buffer + 17) / 1000.0;
+	frame->translational = get16(buffer + 19);
+	frame->angular = get16(buffer + 21) / 1000.0;
+	frame->numSonar = buffer[23];
+	for (int i = 0; i < frame->numSonar; i++)
+		frame->distances[i] = get16(buffer + frameFixedSize + 2 * i);
+}
@@ -0,0 +1,76 @@
+// CommandProtocol.h
+// 10/18/2026
+
+// Binary protocol spoken over CommandServer's Unix domain socket
+// Every message starts with a one byte type and has a length fixed by
+// its type (and, for snapshots and frames, by the sonar count that
+// follows the fixed fields). Multi-byte values are sent least significant
+// byte first, and angles and angular velocities are multiplied by 1000
+// and sent as 16 bit ints, as in SerialBot's packets
+
+// Requests, client to server:
+//    setSpeed:  type | translational (int16) | angular * 1000 (int16)
+//    snapshot:  type
+//    subscribe: type | 1 to start receiving frames, 0 to stop (uint8)
+// Replies, server to client, in the order the requests were sent:
+//    ack:       type | request type (uint8) | status (uint8)
+//               for setSpeed and subscribe
+//    snapshot:  type | frames received (uint32) | x (int16) | y (int16) |
+//               theta * 1000 (int16) | numSonar (uint8) | distances (int16 each)
+// Frames, pushed to subscribed clients between replies:
+//    frame:     type | sequence (uint32) | timestamp in ns (int64) |
+//               x (int16) | y (int16) | theta * 1000 (int16) |
+//               translational (int16) | angular * 1000 (int16) |
+//               numSonar (uint8) | distances (int16 each)
+
+#ifndef COMMANDPROTOCOL_H
+#define COMMANDPROTOCOL_H
+
+#include <stdint.h>
+#include "../SerialBot/SensorFrame.h"
+
+enum CommandMessageType
+{
+	requestSetSpeed = 1,
+	requestSnapshot = 2,
+	requestSubscribe = 3,
+	replyAck = 0x81,
+	replySnapshot = 0x82,
+	replyFrame = 0x83
+};
+
+enum CommandStatus
+{
+	statusOk = 0,
+	statusUnavailable = 1 // subscribe: the server has no telemetry to send frames from
+};
+
+const int maxCommandMessageSize = 24 + 2 * maxSonar; // a frame with every sonar
+
+struct CommandSnapshot
+{
+	uint32_t framesReceived;
+	int x, y; // cm
+	double theta; // rad
+	int numSonar;
+	int distances[maxSonar]; // cm
+};
+
+// length of the message starting at buffer, 0 if more than available
+// bytes are needed to tell, -1 if the type is unknown
+int commandMessageLength(const uint8_t* buffer, int available);
+
+// encoders return the number of bytes written, at most maxCommandMessageSize
+int encodeSetSpeed(uint8_t* buffer, int translational, double angular);
+int encodeSnapshotRequest(uint8_t* buffer);
+int encodeSubscribe(uint8_t* buffer, bool subscribe);
+int encodeAck(uint8_t* buffer, uint8_t requestType, uint8_t status);
+int encodeSnapshot(uint8_t* buffer, const CommandSnapshot& snapshot);
+int encodeFrame(uint8_t* buffer, const SensorFrame& frame);
+
+// decoders expect a whole message of the right type at buffer
+void decodeSetSpeed(const uint8_t* buffer, int* translational, double* angular);
+void decodeSnapshot(const uint8_t* buffer, CommandSnapshot* snapshot);
+void decodeFrame(const uint8_t* buffer, SensorFrame* frame);
+
+#endif
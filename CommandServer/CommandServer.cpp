@@ -0,0 +1,460 @@
+// CommandServer.cpp
+// 10/18/2026
+
+// Unix domain socket command server, see CommandServer.h
+
+#include "CommandServer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <iostream>
+
+using namespace std;
+
+const int maxEvents = 64;
+const int framePollMs = 2; // epoll timeout while anyone is subscribed
+const uint32_t listenId = 0xFFFFFFFF; // epoll data for the listening socket
+const uint32_t stopId = 0xFFFFFFFE; // and for the stop eventfd
+
+CommandServer::CommandServer(Robot* robot, int maxClients)
+{
+	robot_ = robot;
+	speedFunction_ = NULL;
+	speedArg_ = NULL;
+	realTime_ = defaultRealTimeConfig();
+	maxClients_ = maxClients;
+	clients_ = new Client[maxClients];
+	for (int i = 0; i < maxClients; i++)
+		clients_[i].fd = -1;
+	subscribers_ = 0;
+	path_[0] = '\0';
+	listenFd_ = -1;
+	epollFd_ = -1;
+	stopFd_ = -1;
+	running_ = false;
+	numClients_.store(0);
+	accepted_.store(0);
+	rejected_.store(0);
+	commands_.store(0);
+	snapshots_.store(0);
+	framesSent_.store(0);
+	framesDropped_.store(0);
+	disconnects_.store(0);
+}
+
+CommandServer::~CommandServer()
+{
+	stop();
+	if (listenFd_ != -1)
+	{
+		close(listenFd_);
+		unlink(path_);
+	}
+	if (epollFd_ != -1)
+		close(epollFd_);
+	if (stopFd_ != -1)
+		close(stopFd_);
+	delete [] clients_;
+}
+
+void CommandServer::setSpeedFunction(SpeedFunction function, void* arg)
+{
+	speedFunction_ = function;
+	speedArg_ = arg;
+}
+
+bool CommandServer::setTelemetry(const char* name)
+{
+	if (!telemetry_.open(name))
+		return false;
+	telemetry_.skipToLatest();
+	return true;
+}
+
+void CommandServer::setRealTime(const RealTimeConfig& config)
+{
+	realTime_ = config;
+}
+
+bool CommandServer::open(const char* path)
+{
+	struct sockaddr_un address;
+	if (strlen(path) >= sizeof(address.sun_path))
+		return false;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listenFd_ == -1)
+		return false;
+	unlink(path);
+	if (bind(listenFd_, (struct sockaddr*)&address, sizeof(address)) != 0
+	    || listen(listenFd_, maxClients_) != 0)
+	{
+		cerr << "command: unable to listen on " << path << ": " << strerror(errno) << endl;
+		close(listenFd_);
+		listenFd_ = -1;
+		return false;
+	}
+	strcpy(path_, path);
+	epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+	stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epollFd_ == -1 || stopFd_ == -1)
+		return false;
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = listenId;
+	epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+	event.data.u32 = stopId;
+	epoll_ctl(epollFd_, EPOLL_CTL_ADD, stopFd_, &event);
+	return true;
+}
+
+bool CommandServer::start()
+{
+	if (running_ || epollFd_ == -1)
+		return running_;
+	if (pthread_create(&thread_, NULL, threadFunction, this) != 0)
+	{
+		cerr << "command: unable to create server thread" << endl;
+		return false;
+	}
+	running_ = true;
+	return true;
+}
+
+void CommandServer::stop()
+{
+	if (!running_)
+		return;
+	uint64_t one = 1;
+	if (write(stopFd_, &one, sizeof(one)) != sizeof(one))
+		cerr << "command: unable to signal server thread" << endl;
+	pthread_join(thread_, NULL);
+	running_ = false;
+	for (int i = 0; i < maxClients_; i++)
+		if (clients_[i].fd != -1)
+			closeClient(&clients_[i]);
+}
+
+void CommandServer::getStats(CommandServerStats* stats)
+{
+	stats->clients = numClients_.load(memory_order_relaxed);
+	stats->accepted = accepted_.load(memory_order_relaxed);
+	stats->rejected = rejected_.load(memory_order_relaxed);
+	stats->commands = commands_.load(memory_order_relaxed);
+	stats->snapshots = snapshots_.load(memory_order_relaxed);
+	stats->framesSent = framesSent_.load(memory_order_relaxed);
+	stats->framesDropped = framesDropped_.load(memory_order_relaxed);
+	stats->disconnects = disconnects_.load(memory_order_relaxed);
+}
+
+void* CommandServer::threadFunction(void* server)
+{
+	((CommandServer*)server)->run();
+	return NULL;
+}
+
+// sleeps in epoll_wait until a client has something to say, waking every
+// framePollMs to forward new frames only while anyone is subscribed
+void CommandServer::run()
+{
+	if (realTime_.enabled)
+		enterRealTime("command", realTime_);
+	struct epoll_event events[maxEvents];
+	while (true)
+	{
+		int timeout = (subscribers_ > 0 && telemetry_.isOpen()) ? framePollMs : -1;
+		int numEvents = epoll_wait(epollFd_, events, maxEvents, timeout);
+		if (numEvents < 0 && errno != EINTR)
+		{
+			cerr << "command: epoll_wait failed: " << strerror(errno) << endl;
+			return;
+		}
+		for (int i = 0; i < numEvents; i++)
+		{
+			uint32_t id = events[i].data.u32;
+			if (id == stopId)
+				return;
+			if (id == listenId)
+			{
+				acceptClients();
+				continue;
+			}
+			Client* client = &clients_[id];
+			if (client->fd == -1)
+				continue; // closed earlier in this batch
+			if (events[i].events & (EPOLLERR | EPOLLHUP))
+			{
+				closeClient(client);
+				continue;
+			}
+			// a client held up by a full out picks up where it left off
+			// once the socket has taken enough of it
+			bool held = !client->reading;
+			if ((events[i].events & EPOLLOUT) && !flush(client))
+			{
+				closeClient(client);
+				continue;
+			}
+			if ((events[i].events & EPOLLIN) || (held && client->reading))
+				readClient(client);
+		}
+		if (subscribers_ > 0)
+			sendFrames();
+	}
+}
+
+void CommandServer::acceptClients()
+{
+	while (true)
+	{
+		int fd = accept4(listenFd_, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd == -1)
+			return; // EAGAIN once the backlog is empty
+		int slot = 0;
+		while (slot < maxClients_ && clients_[slot].fd != -1)
+			slot++;
+		if (slot == maxClients_)
+		{
+			close(fd);
+			rejected_.fetch_add(1, memory_order_relaxed);
+			continue;
+		}
+		Client* client = &clients_[slot];
+		client->fd = fd;
+		client->subscribed = false;
+		client->writing = false;
+		client->reading = true;
+		client->inLength = 0;
+		client->outLength = 0;
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = slot;
+		epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+		accepted_.fetch_add(1, memory_order_relaxed);
+		numClients_.fetch_add(1, memory_order_relaxed);
+	}
+}
+
+// reads everything available, handling each complete message as soon as
+// it's in, then writes the replies back
+// When out can't take another reply, what's queued is flushed; if the
+// socket won't take enough of it, the rest of the input waits in in and
+// the client isn't read again until it has caught up on its replies
+void CommandServer::readClient(Client* client)
+{
+	bool drained = false;
+	while (true)
+	{
+		if (!handleMessages(client))
+		{
+			disconnects_.fetch_add(1, memory_order_relaxed);
+			closeClient(client);
+			return;
+		}
+		if (!hasRoom(client))
+		{
+			if (!flush(client))
+			{
+				closeClient(client);
+				return;
+			}
+			if (!hasRoom(client))
+				return; // flush stopped watching for input
+			continue;
+		}
+		if (drained)
+			break;
+		int space = sizeof(client->in) - client->inLength;
+		ssize_t bytes = read(client->fd, client->in + client->inLength, space);
+		if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR))
+		{
+			closeClient(client);
+			return;
+		}
+		if (bytes < 0)
+			break;
+		client->inLength += bytes;
+		drained = bytes < space;
+	}
+	if (!flush(client))
+		closeClient(client);
+}
+
+// handles the complete messages in in while out has room for their
+// replies; false on a protocol error
+bool CommandServer::handleMessages(Client* client)
+{
+	int used = 0;
+	bool valid = true;
+	while (hasRoom(client))
+	{
+		int length = commandMessageLength(client->in + used, client->inLength - used);
+		if (length == 0 || length > client->inLength - used)
+			break;
+		if (length < 0 || !handleMessage(client, client->in + used))
+		{
+			valid = false;
+			break;
+		}
+		used += length;
+	}
+	client->inLength -= used;
+	memmove(client->in, client->in + used, client->inLength);
+	return valid;
+}
+
+bool CommandServer::handleMessage(Client* client, const uint8_t* message)
+{
+	uint8_t reply[maxCommandMessageSize];
+	int length = 0;
+	switch (message[0])
+	{
+	case requestSetSpeed:
+	{
+		int translational;
+		double angular;
+		decodeSetSpeed(message, &translational, &angular);
+		if (speedFunction_ != NULL)
+			speedFunction_(translational, angular, speedArg_);
+		else
+			robot_->setSpeed(translational, angular);
+		commands_.fetch_add(1, memory_order_relaxed);
+		length = encodeAck(reply, requestSetSpeed, statusOk);
+		break;
+	}
+	case requestSnapshot:
+	{
+		CommandSnapshot snapshot;
+		int distances[maxSonar];
+		snapshot.framesReceived = robot_->getFramesReceived();
+		robot_->getPose(&snapshot.x, &snapshot.y, &snapshot.theta);
+		robot_->getDistances(distances);
+		snapshot.numSonar = robot_->getNumSonar();
+		for (int i = 0; i < snapshot.numSonar; i++)
+			snapshot.distances[i] = distances[i];
+		snapshots_.fetch_add(1, memory_order_relaxed);
+		length = encodeSnapshot(reply, snapshot);
+		break;
+	}
+	case requestSubscribe:
+	{
+		bool subscribe = message[1] != 0 && telemetry_.isOpen();
+		// nobody was following the ring, so start from the present
+		if (subscribe && subscribers_ == 0)
+			telemetry_.skipToLatest();
+		if (subscribe != client->subscribed)
+			subscribers_ += subscribe ? 1 : -1;
+		client->subscribed = subscribe;
+		uint8_t status = (message[1] != 0 && !subscribe) ? statusUnavailable : statusOk;
+		length = encodeAck(reply, requestSubscribe, status);
+		break;
+	}
+	default:
+		return false; // a reply type sent to the server
+	}
+	return queue(client, reply, length);
+}
+
+bool CommandServer::queue(Client* client, const uint8_t* message, int length)
+{
+	if (client->outLength + length > (int)sizeof(client->out))
+		return false;
+	memcpy(client->out + client->outLength, message, length);
+	client->outLength += length;
+	return true;
+}
+
+bool CommandServer::hasRoom(Client* client)
+{
+	return client->outLength + maxCommandMessageSize <= (int)sizeof(client->out);
+}
+
+// writes as much of the client's output as the socket takes, and watches
+// for the socket becoming writable while anything is left, and for input
+// only while there's room in out for the replies
+bool CommandServer::flush(Client* client)
+{
+	int written = 0;
+	while (written < client->outLength)
+	{
+		ssize_t bytes = write(client->fd, client->out + written, client->outLength - written);
+		if (bytes < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN)
+				return false;
+			break;
+		}
+		written += bytes;
+	}
+	client->outLength -= written;
+	memmove(client->out, client->out + written, client->outLength);
+	bool writing = client->outLength > 0;
+	bool reading = hasRoom(client);
+	if (writing != client->writing || reading != client->reading)
+	{
+		struct epoll_event event;
+		event.events = (writing ? (uint32_t)EPOLLOUT : 0u) | (reading ? (uint32_t)EPOLLIN : 0u);
+		event.data.u32 = client - clients_;
+		epoll_ctl(epollFd_, EPOLL_CTL_MOD, client->fd, &event);
+		client->writing = writing;
+		client->reading = reading;
+	}
+	return true;
+}
+
+// forwards every frame published since the last call to each subscriber
+void CommandServer::sendFrames()
+{
+	TelemetryRecord record;
+	bool sent = false;
+	while (telemetry_.next(&record))
+	{
+		if (record.type != telemetryFrame)
+			continue;
+		uint8_t message[maxCommandMessageSize];
+		int length = encodeFrame(message, record.frame);
+		for (int i = 0; i < maxClients_; i++)
+		{
+			Client* client = &clients_[i];
+			if (client->fd == -1 || !client->subscribed)
+				continue;
+			if (queue(client, message, length))
+				framesSent_.fetch_add(1, memory_order_relaxed);
+			else
+				framesDropped_.fetch_add(1, memory_order_relaxed);
+		}
+		sent = true;
+	}
+	if (!sent)
+		return;
+	for (int i = 0; i < maxClients_; i++)
+	{
+		Client* client = &clients_[i];
+		if (client->fd == -1 || !client->subscribed)
+			continue;
+		bool held = !client->reading;
+		if (!flush(client))
+			closeClient(client);
+		else if (held && client->reading)
+			readClient(client);
+	}
+}
+
+void CommandServer::closeClient(Client* client)
+{
+	epoll_ctl(epollFd_, EPOLL_CTL_DEL, client->fd, NULL);
+	close(client->fd);
+	client->fd = -1;
+	if (client->subscribed)
+		subscribers_--;
+	client->subscribed = false;
+	numClients_.fetch_sub(1, memory_order_relaxed);
+}
@@ -0,0 +1,125 @@
+// CommandServer.h
+// 10/18/2026
+
+// Local command and query server in front of a Robot (SerialBot or
+// SimBot), so other programs can drive Colin and watch its sensors
+// Clients connect to a Unix domain socket and speak the binary protocol
+// in CommandProtocol.h: set the speed, read a snapshot of the latest
+// distances and pose, or subscribe to every sensor frame
+
+// One thread serves every client with epoll; sockets are non-blocking and
+// each client has its own input and output buffer, so a slow client only
+// delays itself. Requests are handled as soon as they're read: setSpeed
+// goes straight to Robot::setSpeed (or the speed function, if one is set),
+// which only takes the robot's lock, and the ack is written back in the
+// same pass
+// Frames for subscribers come from the shared memory telemetry ring (see
+// Telemetry/TelemetryRing.h), which the server polls every 2 ms
+// while anyone is subscribed; a subscriber whose output buffer is full
+// misses frames rather than holding up the others
+// A client may pipeline requests: when its output buffer fills, the
+// server stops reading from it until the socket has taken its replies, so
+// a client that stops reading them holds up only itself
+// A client that sends an unknown message type, or whose socket fails, is
+// disconnected
+// Clients are trusted alike: the last setSpeed received wins
+
+#ifndef COMMANDSERVER_H
+#define COMMANDSERVER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include "CommandProtocol.h"
+#include "../SerialBot/Robot.h"
+#include "../Telemetry/TelemetryReader.h"
+#include "../RealTime/RealTime.h"
+
+const char defaultCommandSocket[] = "/tmp/colin_command";
+
+// receives setSpeed requests instead of the robot, see setSpeedFunction
+typedef void (*SpeedFunction)(int translational, double angular, void* arg);
+
+struct CommandServerStats
+{
+	uint32_t clients; // connected now
+	uint64_t accepted; // connections accepted
+	uint64_t rejected; // connections refused because maxClients were connected
+	uint64_t commands; // setSpeed requests
+	uint64_t snapshots; // snapshot requests
+	uint64_t framesSent; // frames queued to subscribers
+	uint64_t framesDropped; // frames a subscriber missed because its buffer was full
+	uint64_t disconnects; // clients dropped for protocol errors
+};
+
+class CommandServer
+{
+public:
+	CommandServer(Robot* robot, int maxClients);
+	~CommandServer();
+	// set speed requests call function rather than robot->setSpeed, for
+	// programs that filter or limit commands; must be called before start
+	void setSpeedFunction(SpeedFunction function, void* arg);
+	// attaches to the telemetry ring subscribers' frames are read from;
+	// returns false if it doesn't exist. Must be called before start
+	bool setTelemetry(const char* name);
+	void setRealTime(const RealTimeConfig& config); // must be called before start
+	bool open(const char* path); // binds and listens on path, replacing any old socket
+	bool start(); // launches the server's thread
+	void stop(); // disconnects every client and joins the thread
+	void getStats(CommandServerStats* stats);
+
+private:
+	struct Client
+	{
+		int fd; // -1 if the slot is free
+		bool subscribed;
+		bool writing; // waiting for the socket to take the rest of out
+		bool reading; // watching for input, out has room for a reply
+		int inLength;
+		int outLength;
+		uint8_t in[4 * maxCommandMessageSize];
+		uint8_t out[4096];
+	};
+
+	Robot* robot_;
+	SpeedFunction speedFunction_;
+	void* speedArg_;
+	TelemetryReader telemetry_;
+	RealTimeConfig realTime_;
+	Client* clients_;
+	int maxClients_;
+	int subscribers_;
+	char path_[108];
+	int listenFd_;
+	int epollFd_;
+	int stopFd_; // eventfd that wakes the thread to stop
+	pthread_t thread_;
+	bool running_;
+
+	std::atomic<uint32_t> numClients_;
+	std::atomic<uint64_t> accepted_;
+	std::atomic<uint64_t> rejected_;
+	std::atomic<uint64_t> commands_;
+	std::atomic<uint64_t> snapshots_;
+	std::atomic<uint64_t> framesSent_;
+	std::atomic<uint64_t> framesDropped_;
+	std::atomic<uint64_t> disconnects_;
+
+	static void* threadFunction(void* server);
+	void run();
+	void acceptClients();
+	void readClient(Client* client);
+	bool handleMessages(Client* client); // handles what's in in, false on a protocol error
+	bool handleMessage(Client* client, const uint8_t* message); // false if the client must go
+	bool queue(Client* client, const uint8_t* message, int length); // false if out is full
+	bool hasRoom(Client* client); // out can take the largest reply
+	bool flush(Client* client); // writes what it can, false on error
+	void sendFrames();
+	void closeClient(Client* client);
+
+	CommandServer(const CommandServer&); // not copyable
+	CommandServer& operator=(const CommandServer&);
+};
+
+#endif
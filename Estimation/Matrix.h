@@ -0,0 +1,154 @@
+// Matrix.h
+// 10/18/2026
+
+// Fixed size matrix for small estimation problems
+// Dimensions are template parameters, so sizes are checked at compile
+// time and every matrix lives on the stack (or inline in its owner);
+// nothing here ever allocates
+// Storage is row major; m(row, col) accesses an element
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <math.h>
+
+template <int R, int C>
+class Matrix
+{
+public:
+	double data[R][C];
+
+	Matrix() { fill(0.0); }
+
+	static Matrix zero()
+	{
+		return Matrix();
+	}
+
+	static Matrix identity()
+	{
+		Matrix result;
+		for (int i = 0; i < R && i < C; i++)
+			result.data[i][i] = 1.0;
+		return result;
+	}
+
+	void fill(double value)
+	{
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				data[i][j] = value;
+	}
+
+	double& operator()(int row, int col) { return data[row][col]; }
+	double operator()(int row, int col) const { return data[row][col]; }
+
+	Matrix operator+(const Matrix& other) const
+	{
+		Matrix result;
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				result.data[i][j] = data[i][j] + other.data[i][j];
+		return result;
+	}
+
+	Matrix operator-(const Matrix& other) const
+	{
+		Matrix result;
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				result.data[i][j] = data[i][j] - other.data[i][j];
+		return result;
+	}
+
+	Matrix operator*(double scale) const
+	{
+		Matrix result;
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				result.data[i][j] = data[i][j] * scale;
+		return result;
+	}
+
+	template <int K>
+	Matrix<R, K> operator*(const Matrix<C, K>& other) const
+	{
+		Matrix<R, K> result;
+		for (int i = 0; i < R; i++)
+			for (int k = 0; k < C; k++)
+			{
+				double value = data[i][k];
+				for (int j = 0; j < K; j++)
+					result.data[i][j] += value * other.data[k][j];
+			}
+		return result;
+	}
+
+	Matrix<C, R> transpose() const
+	{
+		Matrix<C, R> result;
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				result.data[j][i] = data[i][j];
+		return result;
+	}
+
+	// averages the matrix with its transpose, removing rounding asymmetry
+	// from covariance updates
+	void symmetrize()
+	{
+		for (int i = 0; i < R; i++)
+			for (int j = i + 1; j < C; j++)
+			{
+				double value = 0.5 * (data[i][j] + data[j][i]);
+				data[i][j] = value;
+				data[j][i] = value;
+			}
+	}
+
+	// Gauss-Jordan inverse with partial pivoting, square matrices only
+	// returns false and leaves result undefined if the matrix is singular
+	bool inverse(Matrix* result) const
+	{
+		Matrix work = *this;
+		*result = identity();
+		for (int col = 0; col < R; col++)
+		{
+			int pivot = col;
+			for (int row = col + 1; row < R; row++)
+				if (fabs(work.data[row][col]) > fabs(work.data[pivot][col]))
+					pivot = row;
+			if (fabs(work.data[pivot][col]) < 1e-15)
+				return false;
+			for (int j = 0; j < C; j++)
+			{
+				double swap = work.data[col][j];
+				work.data[col][j] = work.data[pivot][j];
+				work.data[pivot][j] = swap;
+				swap = result->data[col][j];
+				result->data[col][j] = result->data[pivot][j];
+				result->data[pivot][j] = swap;
+			}
+			double scale = 1.0 / work.data[col][col];
+			for (int j = 0; j < C; j++)
+			{
+				work.data[col][j] *= scale;
+				result->data[col][j] *= scale;
+			}
+			for (int row = 0; row < R; row++)
+			{
+				if (row == col)
+					continue;
+				double factor = work.data[row][col];
+				for (int j = 0; j < C; j++)
+				{
+					work.data[row][j] -= factor * work.data[col][j];
+					result->data[row][j] -= factor * result->data[col][j];
+				}
+			}
+		}
+		return true;
+	}
+};
+
+#endif
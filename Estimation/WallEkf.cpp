@@ -0,0 +1,299 @@
+// WallEkf.cpp
+// 10/18/2026
+
+// Extended Kalman filter tracking Colin's pose and the followed wall
+// See WallEkf.h for the state and measurement models
+
+#include "WallEkf.h"
+
+enum { stateX, stateY, stateTheta, stateRho, stateAlpha };
+
+const double gateThreshold = 13.8; // chi-square, 2 dof, 99.9%
+const double maxHeading = M_PI / 2 - 0.01; // keeps getLine's slope finite
+
+WallEkf::WallEkf()
+{
+	odometryNoise_ = 0.05;
+	commandNoise_ = 0.2;
+	rhoDrift_ = 0.02;
+	alphaDrift_ = 0.002;
+	distanceSigma_ = 3.0;
+	angleSigma_ = 0.08;
+	maxRejections_ = 5;
+	reset();
+}
+
+void WallEkf::reset()
+{
+	state_.fill(0.0);
+	covariance_.fill(0.0);
+	initialized_ = false;
+	rejections_ = 0;
+}
+
+void WallEkf::setProcessNoise(double odometryNoise, double commandNoise)
+{
+	odometryNoise_ = odometryNoise;
+	commandNoise_ = commandNoise;
+}
+
+void WallEkf::setWallDrift(double rhoDrift, double alphaDrift)
+{
+	rhoDrift_ = rhoDrift;
+	alphaDrift_ = alphaDrift;
+}
+
+void WallEkf::setMeasurementNoise(double distanceSigma, double angleSigma)
+{
+	distanceSigma_ = distanceSigma;
+	angleSigma_ = angleSigma;
+}
+
+void WallEkf::setMaxRejections(int maxRejections)
+{
+	maxRejections_ = maxRejections;
+}
+
+void WallEkf::predictOdometry(const Pose2D& delta)
+{
+	predict(delta, odometryNoise_);
+}
+
+void WallEkf::predictCommand(double translational, double angular, double dt)
+{
+	// exact motion along the commanded arc
+	Pose2D delta;
+	double turn = angular * dt;
+	if (fabs(turn) < 1e-6)
+	{
+		delta.x = translational * dt;
+		delta.y = 0.0;
+	}
+	else
+	{
+		double radius = translational / angular;
+		delta.x = radius * sin(turn);
+		delta.y = radius * (1.0 - cos(turn));
+	}
+	delta.theta = turn;
+	predict(delta, commandNoise_);
+}
+
+void WallEkf::predict(const Pose2D& delta, double noise)
+{
+	double theta = state_(stateTheta, 0);
+	double c = cos(theta);
+	double s = sin(theta);
+	state_(stateX, 0) += c * delta.x - s * delta.y;
+	state_(stateY, 0) += s * delta.x + c * delta.y;
+	state_(stateTheta, 0) = normalizeAngle(theta + delta.theta);
+
+	// jacobian of the new state with respect to the old one
+	StateMatrix f = StateMatrix::identity();
+	f(stateX, stateTheta) = -s * delta.x - c * delta.y;
+	f(stateY, stateTheta) = c * delta.x - s * delta.y;
+
+	// jacobian with respect to the motion, whose noise grows with the
+	// distance and angle moved
+	Matrix<wallEkfStates, 3> g;
+	g(stateX, 0) = c;
+	g(stateX, 1) = -s;
+	g(stateY, 0) = s;
+	g(stateY, 1) = c;
+	g(stateTheta, 2) = 1.0;
+	double distance = hypot(delta.x, delta.y);
+	double sigmaXY = noise * distance;
+	double sigmaTheta = noise * (fabs(delta.theta) + 0.01 * distance);
+	Matrix<3, 3> motionNoise;
+	motionNoise(0, 0) = sigmaXY * sigmaXY;
+	motionNoise(1, 1) = sigmaXY * sigmaXY;
+	motionNoise(2, 2) = sigmaTheta * sigmaTheta;
+
+	// the wall drifts around where the robot is, not around the origin
+	double rhoSigma = rhoDrift_ * distance;
+	double alphaSigma = alphaDrift_ * distance;
+	Matrix<2, 2> wallNoise;
+	wallNoise(0, 0) = rhoSigma * rhoSigma;
+	wallNoise(1, 1) = alphaSigma * alphaSigma;
+	Matrix<wallEkfStates, 2> gw = localWallJacobian();
+
+	covariance_ = f * covariance_ * f.transpose() + g * motionNoise * g.transpose()
+	              + gw * wallNoise * gw.transpose();
+	covariance_.symmetrize();
+}
+
+bool WallEkf::updateLine(double slope, double intercept)
+{
+	// line fit in normal form: y = mx + b has unit normal (-m, 1) / sqrt(1 + m^2)
+	double norm = sqrt(1.0 + slope * slope);
+	double r = intercept / norm;
+	double phi = atan2(1.0, -slope);
+	if (!initialized_)
+	{
+		initializeWall(r, phi);
+		initialized_ = true;
+		return true;
+	}
+
+	double x = state_(stateX, 0);
+	double y = state_(stateY, 0);
+	double rho = state_(stateRho, 0);
+	double alpha = state_(stateAlpha, 0);
+	double c = cos(alpha);
+	double s = sin(alpha);
+	double predictedR = rho - x * c - y * s;
+	double predictedPhi = normalizeAngle(alpha - state_(stateTheta, 0));
+
+	// the same line has two normal forms, use the one facing the prediction
+	if (cos(phi - predictedPhi) < 0.0)
+	{
+		r = -r;
+		phi += M_PI;
+	}
+	Matrix<2, 1> innovation;
+	innovation(0, 0) = r - predictedR;
+	innovation(1, 0) = normalizeAngle(phi - predictedPhi);
+
+	Matrix<2, wallEkfStates> h;
+	h(0, stateX) = -c;
+	h(0, stateY) = -s;
+	h(0, stateRho) = 1.0;
+	h(0, stateAlpha) = x * s - y * c;
+	h(1, stateTheta) = -1.0;
+	h(1, stateAlpha) = 1.0;
+	Matrix<2, 2> measurementNoise;
+	measurementNoise(0, 0) = distanceSigma_ * distanceSigma_;
+	measurementNoise(1, 1) = angleSigma_ * angleSigma_;
+
+	Matrix<wallEkfStates, 2> pht = covariance_ * h.transpose();
+	Matrix<2, 2> innovationCovariance = h * pht + measurementNoise;
+	Matrix<2, 2> inverse;
+	if (!innovationCovariance.inverse(&inverse))
+		return false;
+	double mahalanobis = (innovation.transpose() * inverse * innovation)(0, 0);
+	if (mahalanobis > gateThreshold)
+	{
+		// a wall that keeps disagreeing is a new wall
+		if (++rejections_ >= maxRejections_)
+		{
+			initializeWall(r, phi);
+			rejections_ = 0;
+		}
+		return false;
+	}
+	rejections_ = 0;
+
+	Matrix<wallEkfStates, 2> gain = pht * inverse;
+	state_ = state_ + gain * innovation;
+	state_(stateTheta, 0) = normalizeAngle(state_(stateTheta, 0));
+	state_(stateAlpha, 0) = normalizeAngle(state_(stateAlpha, 0));
+
+	// Joseph form keeps the covariance positive definite
+	StateMatrix i_kh = StateMatrix::identity() - gain * h;
+	covariance_ = i_kh * covariance_ * i_kh.transpose()
+	              + gain * measurementNoise * gain.transpose();
+	covariance_.symmetrize();
+	return true;
+}
+
+// sets the wall from a local measurement, carrying the pose's uncertainty
+// into the wall's
+void WallEkf::initializeWall(double r, double phi)
+{
+	double x = state_(stateX, 0);
+	double y = state_(stateY, 0);
+	double alpha = normalizeAngle(state_(stateTheta, 0) + phi);
+	double c = cos(alpha);
+	double s = sin(alpha);
+	state_(stateRho, 0) = r + x * c + y * s;
+	state_(stateAlpha, 0) = alpha;
+
+	double rhoByAlpha = -x * s + y * c;
+	StateMatrix g;
+	for (int i = stateX; i <= stateTheta; i++)
+		g(i, i) = 1.0;
+	g(stateRho, stateX) = c;
+	g(stateRho, stateY) = s;
+	g(stateRho, stateTheta) = rhoByAlpha;
+	g(stateAlpha, stateTheta) = 1.0;
+	Matrix<wallEkfStates, 2> gz = localWallJacobian();
+	Matrix<2, 2> measurementNoise;
+	measurementNoise(0, 0) = distanceSigma_ * distanceSigma_;
+	measurementNoise(1, 1) = angleSigma_ * angleSigma_;
+	covariance_ = g * covariance_ * g.transpose() + gz * measurementNoise * gz.transpose();
+	covariance_.symmetrize();
+}
+
+// jacobian of the world frame wall (rho, alpha) with respect to the wall
+// seen from the robot (r, phi), holding the pose fixed
+Matrix<wallEkfStates, 2> WallEkf::localWallJacobian()
+{
+	double alpha = state_(stateAlpha, 0);
+	Matrix<wallEkfStates, 2> jacobian;
+	jacobian(stateRho, 0) = 1.0;
+	jacobian(stateRho, 1) = -state_(stateX, 0) * sin(alpha) + state_(stateY, 0) * cos(alpha);
+	jacobian(stateAlpha, 1) = 1.0;
+	return jacobian;
+}
+
+void WallEkf::getLocalWall(double* r, double* phi)
+{
+	double alpha = state_(stateAlpha, 0);
+	*r = state_(stateRho, 0) - state_(stateX, 0) * cos(alpha) - state_(stateY, 0) * sin(alpha);
+	*phi = normalizeAngle(alpha - state_(stateTheta, 0));
+	// normal pointing to the left, so r is positive for a wall on the left
+	if (*phi < 0.0)
+	{
+		*r = -*r;
+		*phi += M_PI;
+	}
+}
+
+bool WallEkf::isInitialized()
+{
+	return initialized_;
+}
+
+Pose2D WallEkf::getPose()
+{
+	return makePose(state_(stateX, 0), state_(stateY, 0), state_(stateTheta, 0));
+}
+
+double WallEkf::getWallOffset()
+{
+	double r, phi;
+	getLocalWall(&r, &phi);
+	return r;
+}
+
+double WallEkf::getWallHeading()
+{
+	double r, phi;
+	getLocalWall(&r, &phi);
+	return phi - M_PI / 2;
+}
+
+void WallEkf::getLine(double* slope, double* intercept)
+{
+	double r, phi;
+	getLocalWall(&r, &phi);
+	double heading = fmax(-maxHeading, fmin(maxHeading, phi - M_PI / 2));
+	*slope = tan(heading);
+	*intercept = r / cos(heading);
+}
+
+double WallEkf::getOffsetSigma()
+{
+	double alpha = state_(stateAlpha, 0);
+	Matrix<1, wallEkfStates> h;
+	h(0, stateX) = -cos(alpha);
+	h(0, stateY) = -sin(alpha);
+	h(0, stateRho) = 1.0;
+	h(0, stateAlpha) = state_(stateX, 0) * sin(alpha) - state_(stateY, 0) * cos(alpha);
+	return sqrt((h * covariance_ * h.transpose())(0, 0));
+}
+
+int WallEkf::getRejections()
+{
+	return rejections_;
+}
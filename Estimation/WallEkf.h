@@ -0,0 +1,95 @@
+// WallEkf.h
+// 10/18/2026
+
+// Extended Kalman filter tracking Colin's pose together with the wall
+// being followed, so noisy single-scan line fits are smoothed over time
+
+// state: x, y, theta of the robot in the world (odometry) frame, and the
+// wall as a world frame line in normal form:
+//    rho, alpha: the points p on the wall satisfy
+//    p.x * cos(alpha) + p.y * sin(alpha) = rho
+// Seen from the robot the same wall has normal angle phi = alpha - theta
+// and signed distance r = rho - x * cos(alpha) - y * sin(alpha), which is
+// what a LineFitter result (y = mx + b in the local frame) measures
+
+// prediction comes either from an odometry change (predictOdometry) or
+// from the commanded speeds over a time step (predictCommand), with
+// process noise growing with the distance and angle moved; the wall
+// itself is static apart from a little drift, which lets the filter
+// follow a gently curving wall
+// updateLine corrects the state with a fitted line; fits whose innovation
+// fails a chi-square gate are ignored, and after several rejections in a
+// row the wall is re-initialized from the fit, as happens at corners
+
+// WallEkf is a plain value: all matrices are fixed size members, nothing
+// is allocated, and copying one to predict ahead leaves the original alone
+
+// local coordinate system is defined as follows:
+//    x axis: forward-aft with forward positive
+//    y axis: left-right with left positive
+
+#ifndef WALLEKF_H
+#define WALLEKF_H
+
+#include "Matrix.h"
+#include "../Geometry/Pose2D.h"
+
+const int wallEkfStates = 5;
+
+class WallEkf
+{
+public:
+	WallEkf();
+	void reset(); // forgets the wall, pose goes back to the origin
+	// odometry noise as a fraction of the distance and angle moved
+	void setProcessNoise(double odometryNoise, double commandNoise);
+	// wall drift in cm and radians per cm driven
+	void setWallDrift(double rhoDrift, double alphaDrift);
+	// line fit noise: distance in cm, angle in radians
+	void setMeasurementNoise(double distanceSigma, double angleSigma);
+	// consecutive rejected fits before the wall is re-initialized
+	void setMaxRejections(int maxRejections);
+
+	// delta is the odometry change expressed in the previous pose's frame
+	void predictOdometry(const Pose2D& delta);
+	// translational in cm/s, angular in rad/s, dt in seconds
+	void predictCommand(double translational, double angular, double dt);
+	// slope and intercept of the wall in the local frame, as from LineFitter
+	// returns false if the fit was rejected
+	bool updateLine(double slope, double intercept);
+
+	bool isInitialized();
+	Pose2D getPose();
+	// perpendicular distance to the wall, positive if it is on the left
+	double getWallOffset();
+	// angle of the wall relative to Colin's heading in [-pi/2, pi/2),
+	// positive if the wall runs to the left ahead, same as atan(slope)
+	double getWallHeading();
+	// the wall in the local frame as y = slope * x + intercept
+	void getLine(double* slope, double* intercept);
+	double getOffsetSigma(); // standard deviation of getWallOffset
+	int getRejections();
+
+private:
+	typedef Matrix<wallEkfStates, wallEkfStates> StateMatrix;
+	typedef Matrix<wallEkfStates, 1> StateVector;
+
+	StateVector state_;
+	StateMatrix covariance_;
+	bool initialized_;
+	int rejections_;
+	int maxRejections_;
+	double odometryNoise_;
+	double commandNoise_;
+	double rhoDrift_;
+	double alphaDrift_;
+	double distanceSigma_;
+	double angleSigma_;
+
+	void predict(const Pose2D& delta, double noise);
+	void initializeWall(double r, double phi);
+	Matrix<wallEkfStates, 2> localWallJacobian();
+	void getLocalWall(double* r, double* phi); // normal form, canonical side
+};
+
+#endif
@@ -0,0 +1,153 @@
+// FixedMath.cpp
+// 10/18/2026
+
+// Integer math for the fixed point perception and control path, see
+// FixedMath.h
+// The tables are literals, generated once from the double expressions in
+// their comments and rounded, so no platform's libm is involved
+
+#include "FixedMath.h"
+
+// sin(i / 256 * pi / 2) * 32767 for i = 0 to 256, a quarter wave
+static const int16_t sineTable[257] =
+{
+	0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+	2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+	4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+	7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+	9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+	11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+	14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+	16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+	18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+	20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+	22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+	23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+	25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+	26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+	28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+	29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+	30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+	31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+	31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+	32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+	32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+	32757, 32761, 32765, 32766, 32767,
+};
+
+// exp(-r * r / 7500) * 32768 for r = 0 to 289 cm, LineFitter's weight
+static const uint16_t weightTable[290] =
+{
+	32768, 32764, 32751, 32729, 32698, 32659, 32611, 32555, 32490, 32416, 32334, 32244,
+	32145, 32038, 31923, 31800, 31668, 31529, 31383, 31228, 31066, 30897, 30720, 30536,
+	30346, 30148, 29944, 29733, 29516, 29292, 29063, 28827, 28586, 28339, 28087, 27830,
+	27568, 27301, 27029, 26753, 26473, 26188, 25900, 25608, 25313, 25014, 24713, 24408,
+	24101, 23791, 23479, 23165, 22849, 22532, 22212, 21892, 21570, 21248, 20924, 20601,
+	20276, 19952, 19627, 19303, 18979, 18655, 18332, 18010, 17689, 17368, 17049, 16732,
+	16416, 16102, 15789, 15479, 15170, 14864, 14560, 14258, 13959, 13662, 13369, 13078,
+	12790, 12505, 12223, 11944, 11669, 11397, 11128, 10863, 10601, 10342, 10088, 9837,
+	9589, 9346, 9106, 8870, 8638, 8409, 8185, 7964, 7747, 7534, 7325, 7120,
+	6919, 6722, 6528, 6339, 6153, 5971, 5793, 5619, 5448, 5282, 5119, 4960,
+	4804, 4652, 4504, 4359, 4218, 4080, 3946, 3815, 3687, 3563, 3442, 3324,
+	3210, 3099, 2990, 2885, 2782, 2683, 2586, 2493, 2402, 2313, 2228, 2145,
+	2064, 1986, 1910, 1837, 1766, 1698, 1631, 1567, 1505, 1445, 1387, 1331,
+	1277, 1225, 1175, 1126, 1079, 1034, 990, 948, 908, 869, 831, 795,
+	761, 727, 695, 664, 634, 606, 578, 552, 527, 503, 479, 457,
+	436, 415, 396, 377, 359, 342, 325, 309, 294, 280, 266, 253,
+	240, 228, 217, 206, 195, 185, 176, 167, 158, 150, 142, 135,
+	128, 121, 114, 108, 102, 97, 92, 87, 82, 77, 73, 69,
+	65, 61, 58, 55, 52, 49, 46, 43, 41, 38, 36, 34,
+	32, 30, 28, 27, 25, 24, 22, 21, 20, 18, 17, 16,
+	15, 14, 13, 12, 12, 11, 10, 10, 9, 8, 8, 7,
+	7, 6, 6, 6, 5, 5, 5, 4, 4, 4, 3, 3,
+	3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 0,
+};
+
+const int weightTableSize = sizeof(weightTable) / sizeof(weightTable[0]);
+const int64_t milliPerTurn = 6283; // 2 pi rad in milliradians
+const int32_t anglesPerTurn = 65536; // binary angle units
+
+// quarter wave lookup on a binary angle, 256 table steps per quadrant
+// and 64 interpolation steps per table step
+static int32_t sinBinary(int32_t angle)
+{
+	angle &= anglesPerTurn - 1;
+	int quadrant = angle >> 14;
+	int32_t offset = angle & 0x3FFF;
+	if (quadrant & 1)
+		offset = 0x4000 - offset; // falling half of the hump
+	int index = offset >> 6;
+	int32_t fraction = offset & 0x3F;
+	int32_t value = sineTable[index];
+	if (index < 256)
+		value += ((sineTable[index + 1] - value) * fraction + 32) >> 6;
+	return (quadrant & 2) ? -value : value;
+}
+
+static int32_t milliToBinary(int32_t milliradians)
+{
+	return (int32_t)divideRounded((int64_t)milliradians * anglesPerTurn, milliPerTurn);
+}
+
+int32_t sinMilli(int32_t milliradians)
+{
+	return sinBinary(milliToBinary(milliradians));
+}
+
+int32_t cosMilli(int32_t milliradians)
+{
+	return sinBinary(milliToBinary(milliradians) + anglesPerTurn / 4);
+}
+
+uint32_t isqrt64(uint64_t value)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while (bit > value)
+		bit >>= 2;
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+	return (uint32_t)root;
+}
+
+// interpolates between whole centimetres
+int32_t rangeWeight(int32_t range)
+{
+	if (range < 0)
+		range = -range;
+	int index = range >> 4;
+	if (index >= weightTableSize - 1)
+		return 0;
+	int32_t fraction = range & 0xF;
+	int32_t weight = weightTable[index];
+	return weight + (int32_t)divideRounded(((int32_t)weightTable[index + 1] - weight) * fraction, 16);
+}
+
+int32_t divideQ16(int64_t numerator, int64_t denominator)
+{
+	const int64_t limit = (int64_t)1 << 46;
+	while (numerator >= limit || numerator <= -limit)
+	{
+		numerator /= 2;
+		denominator /= 2;
+	}
+	if (denominator == 0)
+		return (numerator >= 0) ? INT32_MAX : -INT32_MAX;
+	int64_t quotient = divideRounded(numerator * q16One, denominator);
+	if (quotient > INT32_MAX)
+		return INT32_MAX;
+	if (quotient < -INT32_MAX)
+		return -INT32_MAX;
+	return (int32_t)quotient;
+}
@@ -0,0 +1,57 @@
+// FixedMath.h
+// 10/18/2026
+
+// Integer math for the fixed point perception and control path
+// (FixedLineFitter, FixedWallFollowLaw), which takes sonar readings and
+// headings as the packets carry them and produces angular velocity
+// commands in the packets' units, using only integer arithmetic
+// Integer operations are exact and the tables are literals, so the path
+// gives bit-identical results on any compiler or cpu, and nothing on it
+// needs an FPU, so it can move to the ATmega328 as is (with the tables in
+// PROGMEM)
+
+// Formats:
+//    Q4:  1/16 cm, positions and distances; int16 covers +/-2047 cm
+//    Q15: 1/32768, weights, confidences and sines, 1.0 is 32768
+//    Q16: 1/65536, slopes and gains, int32
+//    angles are milliradians and angular velocities milliradians/s, as
+//    in the sensor and command packets
+// Divisions round to nearest, half away from zero
+
+#ifndef FIXEDMATH_H
+#define FIXEDMATH_H
+
+#include <stdint.h>
+
+const int32_t q4One = 16;
+const int32_t q15One = 32768;
+const int32_t q16One = 65536;
+
+// Q15, sin peaks at 32767; linear between 1024 table points per turn
+int32_t sinMilli(int32_t milliradians);
+int32_t cosMilli(int32_t milliradians);
+
+uint32_t isqrt64(uint64_t value); // floor of the square root
+
+// LineFitter's weight exp(-range^2 / 7500) for a Q4 range, in Q15
+int32_t rangeWeight(int32_t range);
+
+// inline so divisions by constants compile to multiplies and shifts
+inline int64_t divideRounded(int64_t numerator, int64_t denominator)
+{
+	if (denominator < 0)
+	{
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+	int64_t half = denominator / 2;
+	return (numerator >= 0) ? (numerator + half) / denominator
+	                        : -((-numerator + half) / denominator);
+}
+
+// numerator / denominator in Q16, saturated to int32; denominator > 0
+// both are shifted down together first if the shift into Q16 would
+// overflow, which only costs bits the quotient can't hold anyway
+int32_t divideQ16(int64_t numerator, int64_t denominator);
+
+#endif
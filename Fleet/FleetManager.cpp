@@ -0,0 +1,339 @@
+// FleetManager.cpp
+// 10/18/2026
+
+// Many robots on a few epoll loops, see FleetManager.h
+
+#include "FleetManager.h"
+#include "../Pipeline/PipelineStage.h" // monotonicNanos
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+#include <iostream>
+
+using namespace std;
+
+const int maxEvents = 64;
+const uint32_t timerId = 0xFFFFFFFF; // epoll data for a loop's timerfd
+const uint32_t stopId = 0xFFFFFFFE; // and its stop eventfd
+const int64_t drainMargin = 5000000; // ns past a late packet's wire time to wait for its rest
+
+FleetManager::FleetManager(int maxRobots, int numLoops)
+{
+	maxRobots_ = maxRobots;
+	numRobots_ = 0;
+	links_ = new Link[maxRobots];
+	numLoops_ = (numLoops < 1) ? 1 : numLoops;
+	loops_ = new Loop[numLoops_];
+	for (int i = 0; i < numLoops_; i++)
+	{
+		Loop& loop = loops_[i];
+		loop.manager = this;
+		loop.epollFd = epoll_create1(EPOLL_CLOEXEC);
+		loop.timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		loop.stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		loop.links = new int[maxRobots];
+		loop.numLinks = 0;
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = timerId;
+		epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, loop.timerFd, &event);
+		event.data.u32 = stopId;
+		epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, loop.stopFd, &event);
+	}
+	running_ = false;
+}
+
+FleetManager::~FleetManager()
+{
+	stop();
+	for (int i = 0; i < numRobots_; i++)
+	{
+		close(links_[i].fd);
+		delete links_[i].assembler;
+		pthread_mutex_destroy(&links_[i].lock);
+	}
+	for (int i = 0; i < numLoops_; i++)
+	{
+		close(loops_[i].epollFd);
+		close(loops_[i].timerFd);
+		close(loops_[i].stopFd);
+		delete [] loops_[i].links;
+	}
+	delete [] loops_;
+	delete [] links_;
+}
+
+int FleetManager::addRobot(const SerialBotConfig& config)
+{
+	if (running_ || numRobots_ >= maxRobots_ || config.numSonar > maxSonar)
+		return -1;
+	int fd = openSerialPort(config.device, config.baudRate, 0);
+	if (fd == -1)
+		return -1;
+	tcflush(fd, TCIOFLUSH);
+	int id = numRobots_++;
+	Link& link = links_[id];
+	link.config = config;
+	link.fd = fd;
+	link.loop = id % numLoops_;
+	link.assembler = new PacketAssembler(sensorPacketSize(config.numSonar));
+	link.waiting = false;
+	link.sentAt = 0;
+	link.nextSend = 0;
+	link.drainUntil = 0;
+	link.drainLength = 0;
+	pthread_mutex_init(&link.lock, NULL);
+	link.translational = 0;
+	link.angular = 0.0;
+	memset(&link.state, 0, sizeof(link.state));
+	link.state.connected = true;
+	link.state.numSonar = config.numSonar;
+	Loop& loop = loops_[link.loop];
+	loop.links[loop.numLinks++] = id;
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = id;
+	epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, fd, &event);
+	return id;
+}
+
+int FleetManager::getNumRobots()
+{
+	return numRobots_;
+}
+
+bool FleetManager::start()
+{
+	if (running_)
+		return true;
+	int64_t now = monotonicNanos();
+	for (int i = 0; i < numRobots_; i++)
+		links_[i].nextSend = now;
+	for (int i = 0; i < numLoops_; i++)
+	{
+		if (pthread_create(&loops_[i].thread, NULL, threadFunction, &loops_[i]) != 0)
+		{
+			cerr << "fleet: unable to create loop thread" << endl;
+			numLoops_ = i; // so stop joins only the loops that started
+			running_ = true;
+			stop();
+			return false;
+		}
+	}
+	running_ = true;
+	return true;
+}
+
+void FleetManager::stop()
+{
+	if (!running_)
+		return;
+	uint64_t one = 1;
+	for (int i = 0; i < numLoops_; i++)
+		if (write(loops_[i].stopFd, &one, sizeof(one)) != sizeof(one))
+			cerr << "fleet: unable to signal loop thread" << endl;
+	for (int i = 0; i < numLoops_; i++)
+		pthread_join(loops_[i].thread, NULL);
+	running_ = false;
+}
+
+void FleetManager::setSpeed(int robot, int translational, double angular)
+{
+	Link& link = links_[robot];
+	pthread_mutex_lock(&link.lock);
+	link.translational = translational;
+	link.angular = angular;
+	pthread_mutex_unlock(&link.lock);
+}
+
+void FleetManager::getState(int robot, FleetRobotState* state)
+{
+	Link& link = links_[robot];
+	pthread_mutex_lock(&link.lock);
+	*state = link.state;
+	pthread_mutex_unlock(&link.lock);
+}
+
+void* FleetManager::threadFunction(void* loop)
+{
+	Loop* self = (Loop*)loop;
+	self->manager->run(self);
+	return NULL;
+}
+
+void FleetManager::run(Loop* loop)
+{
+	struct epoll_event events[maxEvents];
+	sendDue(loop, monotonicNanos());
+	while (true)
+	{
+		int numEvents = epoll_wait(loop->epollFd, events, maxEvents, -1);
+		if (numEvents < 0 && errno != EINTR)
+		{
+			cerr << "fleet: epoll_wait failed: " << strerror(errno) << endl;
+			return;
+		}
+		bool timer = false;
+		for (int i = 0; i < numEvents; i++)
+		{
+			uint32_t id = events[i].data.u32;
+			if (id == stopId)
+				return;
+			if (id == timerId)
+			{
+				timer = true;
+				continue;
+			}
+			Link* link = &links_[id];
+			readLink(link);
+			if (link->state.connected && (events[i].events & (EPOLLHUP | EPOLLERR)))
+				disconnect(link, "hung up");
+		}
+		if (timer)
+		{
+			uint64_t expirations;
+			if (read(loop->timerFd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+				cerr << "fleet: timerfd read failed" << endl;
+			sendDue(loop, monotonicNanos());
+		}
+	}
+}
+
+// deadlines advance by whole periods from the first, as PeriodicTimer's
+// do, so the rate doesn't drift with how late the loop wakes
+// Only this loop's thread changes a link's connected flag, so it's read
+// here without the lock
+void FleetManager::sendDue(Loop* loop, int64_t now)
+{
+	int64_t earliest = 0;
+	for (int i = 0; i < loop->numLinks; i++)
+	{
+		Link& link = links_[loop->links[i]];
+		if (!link.state.connected)
+			continue;
+		int64_t due = (link.drainUntil != 0) ? link.drainUntil : link.nextSend;
+		if (due <= now && link.waiting)
+		{
+			// take in what has arrived; a packet that has started, or has
+			// come on since it was last given time, is given the time its
+			// remaining bytes take on the wire
+			readLink(&link);
+			int length = link.assembler->getLength();
+			if (link.state.connected && link.waiting && length > 0
+			    && (link.drainUntil == 0 || length > link.drainLength))
+			{
+				int remaining = sensorPacketSize(link.config.numSonar) - length;
+				link.drainUntil = now + (int64_t)remaining * 10 * 1000000000LL / link.config.baudRate
+				                  + drainMargin;
+				link.drainLength = length;
+				due = link.drainUntil;
+			}
+		}
+		if (!link.state.connected)
+			continue;
+		if (due <= now)
+		{
+			int64_t period = (int64_t)link.config.readPeriod * 1000;
+			link.drainUntil = 0;
+			pthread_mutex_lock(&link.lock);
+			if (link.waiting)
+			{
+				link.state.timeouts++;
+				link.assembler->reset();
+			}
+			char packet[commandPacketSize];
+			encodeCommandPacket(packet, link.translational, link.angular);
+			pthread_mutex_unlock(&link.lock);
+			tcflush(link.fd, TCIFLUSH);
+			if (write(link.fd, packet, commandPacketSize) != commandPacketSize)
+			{
+				if (errno != EAGAIN && errno != EINTR)
+				{
+					disconnect(&link, strerror(errno));
+					continue;
+				}
+				cerr << "fleet: command to " << link.config.device << " failed" << endl;
+			}
+			link.waiting = true;
+			link.sentAt = now;
+			link.nextSend += period;
+			if (link.nextSend <= now)
+				link.nextSend = now + period; // fell a whole period behind
+			due = link.nextSend;
+		}
+		if (earliest == 0 || due < earliest)
+			earliest = due;
+	}
+	if (earliest == 0)
+		return;
+	struct itimerspec deadline;
+	deadline.it_interval.tv_sec = 0;
+	deadline.it_interval.tv_nsec = 0;
+	deadline.it_value.tv_sec = earliest / 1000000000LL;
+	deadline.it_value.tv_nsec = earliest % 1000000000LL;
+	timerfd_settime(loop->timerFd, TFD_TIMER_ABSTIME, &deadline, NULL);
+}
+
+// bytes that arrive when no command is waiting for them are discarded,
+// the link resynchronizes on the next exchange
+void FleetManager::readLink(Link* link)
+{
+	char buffer[256];
+	while (true)
+	{
+		ssize_t bytes = read(link->fd, buffer, sizeof(buffer));
+		if (bytes < 0 && errno == EINTR)
+			continue;
+		// a tty with VMIN 0 reads 0 bytes when it's drained rather than at
+		// end of file; a hang up shows as EPOLLHUP, or EIO here
+		if (bytes == 0 || (bytes < 0 && errno == EAGAIN))
+			return;
+		if (bytes < 0)
+		{
+			disconnect(link, strerror(errno));
+			return;
+		}
+		if (!link->waiting)
+			continue;
+		link->assembler->append(buffer, bytes);
+		if (!link->assembler->isComplete())
+			continue;
+		int64_t now = monotonicNanos();
+		SensorPacket sensors;
+		decodeSensorPacket(link->assembler->getPacket(), link->config.numSonar, &sensors);
+		link->assembler->reset();
+		link->waiting = false;
+		int64_t latency = now - link->sentAt;
+		pthread_mutex_lock(&link->lock);
+		FleetRobotState& state = link->state;
+		state.framesReceived++;
+		for (int i = 0; i < sensors.numSonar; i++)
+			state.distances[i] = sensors.distances[i];
+		state.x = sensors.x;
+		state.y = sensors.y;
+		state.theta = sensors.theta;
+		state.lastFrame = now;
+		state.latency = latency;
+		if (latency > state.maxLatency)
+			state.maxLatency = latency;
+		state.totalLatency += latency;
+		pthread_mutex_unlock(&link->lock);
+	}
+}
+
+// leaves the fd open until the destructor, so its number can't be reused
+// while the robot's id still refers to it
+void FleetManager::disconnect(Link* link, const char* reason)
+{
+	epoll_ctl(loops_[link->loop].epollFd, EPOLL_CTL_DEL, link->fd, NULL);
+	link->waiting = false;
+	link->drainUntil = 0;
+	pthread_mutex_lock(&link->lock);
+	link->state.connected = false;
+	pthread_mutex_unlock(&link->lock);
+	cerr << "fleet: lost " << link->config.device << ": " << reason << endl;
+}
@@ -0,0 +1,111 @@
+// FleetManager.h
+// 10/18/2026
+
+// Drives many Colins from one process, one serial device (or pty) each,
+// with a few epoll event loop threads in place of a SerialBot and a comm
+// thread per robot
+// Each robot has its own SerialBotConfig (device, baud rate, sonar count
+// and update period) and runs SerialBot's exchange: every readPeriod the
+// current command is sent and the sensor packet that comes back is
+// assembled from however many reads it arrives in (PacketCodec.h)
+// A robot that hasn't answered by the time its next command is due has
+// its partial packet dropped and a timeout counted, then carries on. If
+// part of the packet has come, the command waits the wire time of the
+// rest, for as long as more keeps coming, so a late packet isn't split
+// across two exchanges; and as
+// SerialBot does, the device's input is flushed before every command, so
+// a late packet's leftovers aren't taken for the start of the next
+// A robot whose device hangs up or fails (a pty's master closed, a USB
+// serial adapter unplugged) is taken out of its loop
+// and marked disconnected; it's sent nothing more
+// Robots are spread over the loops round robin; each loop sleeps in
+// epoll_wait until one of its devices is readable or a timerfd fires at
+// the earliest command deadline, so an idle fleet costs nothing and a
+// busy one costs a read and a write per exchange
+// setSpeed and getState lock only the one robot's state, so they can be
+// called from any thread
+// Controllers are not reset over gpio, whatever resetPin says
+
+#ifndef FLEETMANAGER_H
+#define FLEETMANAGER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "../SerialBot/SerialPort.h"
+#include "../SerialBot/PacketCodec.h"
+
+struct FleetRobotState
+{
+	bool connected; // false once its device has closed or failed
+	uint32_t framesReceived;
+	uint32_t timeouts; // exchanges with no complete answer before the next was due
+	int numSonar;
+	int16_t distances[maxSonar]; // cm
+	int16_t x, y; // cm
+	double theta; // rad
+	int64_t lastFrame; // monotonic ns the last packet completed, 0 before any
+	int64_t latency; // ns from sending the last command to its packet completing
+	int64_t maxLatency;
+	int64_t totalLatency; // over framesReceived
+};
+
+class FleetManager
+{
+public:
+	FleetManager(int maxRobots, int numLoops);
+	~FleetManager();
+	// opens the robot's device, returns its id or -1; must be called before start
+	int addRobot(const SerialBotConfig& config);
+	int getNumRobots();
+	bool start();
+	void stop();
+	void setSpeed(int robot, int translational, double angular);
+	void getState(int robot, FleetRobotState* state);
+
+private:
+	struct Link
+	{
+		SerialBotConfig config;
+		int fd;
+		int loop;
+		PacketAssembler* assembler;
+		bool waiting; // a command is out and its packet isn't complete
+		int64_t sentAt;
+		int64_t nextSend;
+		int64_t drainUntil; // the rest of a late packet should be in by then, 0 if none is arriving
+		int drainLength; // bytes of it in when drainUntil was set
+		pthread_mutex_t lock; // guards command and state
+		int16_t translational;
+		double angular;
+		FleetRobotState state;
+	};
+
+	struct Loop
+	{
+		FleetManager* manager;
+		pthread_t thread;
+		int epollFd;
+		int timerFd; // fires at the loop's earliest command deadline
+		int stopFd;
+		int* links;
+		int numLinks;
+	};
+
+	Link* links_;
+	int maxRobots_;
+	int numRobots_;
+	Loop* loops_;
+	int numLoops_;
+	bool running_;
+
+	static void* threadFunction(void* loop);
+	void run(Loop* loop);
+	void sendDue(Loop* loop, int64_t now); // sends every command that's due, rearms the timer
+	void readLink(Link* link);
+	void disconnect(Link* link, const char* reason);
+
+	FleetManager(const FleetManager&); // not copyable
+	FleetManager& operator=(const FleetManager&);
+};
+
+#endif
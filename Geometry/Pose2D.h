@@ -0,0 +1,82 @@
+// Pose2D.h
+// 10/18/2026
+
+// Planar pose of the robot and helpers for moving points and poses
+// between Colin's local coordinate system and a fixed world frame
+
+// local coordinate system is defined as follows:
+//    x axis: forward-aft with forward positive
+//    y axis: left-right with left positive
+// theta is measured counterclockwise from the world x axis
+
+#ifndef POSE2D_H
+#define POSE2D_H
+
+#include <math.h>
+
+struct Pose2D
+{
+	double x; // cm
+	double y; // cm
+	double theta; // radians
+};
+
+inline Pose2D makePose(double x, double y, double theta)
+{
+	Pose2D pose;
+	pose.x = x;
+	pose.y = y;
+	pose.theta = theta;
+	return pose;
+}
+
+// wraps an angle to [-pi, pi)
+inline double normalizeAngle(double angle)
+{
+	angle = fmod(angle + M_PI, 2.0 * M_PI);
+	if (angle < 0.0)
+		angle += 2.0 * M_PI;
+	return angle - M_PI;
+}
+
+// transforms a point in the pose's local frame into the world frame
+inline void localToWorld(const Pose2D& pose, double localX, double localY,
+                         double* worldX, double* worldY)
+{
+	double c = cos(pose.theta);
+	double s = sin(pose.theta);
+	*worldX = pose.x + c * localX - s * localY;
+	*worldY = pose.y + s * localX + c * localY;
+}
+
+// transforms a world frame point into the pose's local frame
+inline void worldToLocal(const Pose2D& pose, double worldX, double worldY,
+                         double* localX, double* localY)
+{
+	double c = cos(pose.theta);
+	double s = sin(pose.theta);
+	double dx = worldX - pose.x;
+	double dy = worldY - pose.y;
+	*localX = c * dx + s * dy;
+	*localY = -s * dx + c * dy;
+}
+
+// returns the pose reached by moving by delta (expressed in a's frame) from a
+inline Pose2D composePose(const Pose2D& a, const Pose2D& delta)
+{
+	Pose2D result;
+	localToWorld(a, delta.x, delta.y, &result.x, &result.y);
+	result.theta = normalizeAngle(a.theta + delta.theta);
+	return result;
+}
+
+// returns b expressed in a's frame, the inverse of composePose
+inline Pose2D relativePose(const Pose2D& a, const Pose2D& b)
+{
+	Pose2D result;
+	worldToLocal(a, b.x, b.y, &result.x, &result.y);
+	result.theta = normalizeAngle(b.theta - a.theta);
+	return result;
+}
+
+#endif
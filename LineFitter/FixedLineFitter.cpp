@@ -0,0 +1,103 @@
+// FixedLineFitter.cpp
+// 10/18/2026
+
+// Integer weighted line fit, see FixedLineFitter.h
+
+#include "FixedLineFitter.h"
+#include "../FixedPoint/FixedMath.h"
+
+FixedPoint makeFixedPoint(int16_t range, int16_t heading)
+{
+	FixedPoint point;
+	// Q0 cm times Q15 is Q15, down 11 bits to Q4
+	point.x = (int16_t)divideRounded((int64_t)range * cosMilli(heading), 1 << 11);
+	point.y = (int16_t)divideRounded((int64_t)range * sinMilli(heading), 1 << 11);
+	point.range = range * q4One;
+	return point;
+}
+
+FixedPoint makeFixedPointXY(int16_t x, int16_t y)
+{
+	FixedPoint point;
+	point.x = x;
+	point.y = y;
+	point.range = (int16_t)isqrt64((int64_t)x * x + (int64_t)y * y);
+	return point;
+}
+
+FixedLineFitter::FixedLineFitter(int capacity)
+{
+	capacity_ = capacity;
+	numPoints_ = 0;
+	points_ = new FixedPoint[capacity];
+	weights_ = new int32_t[capacity];
+	slope_ = 0;
+	intercept_ = 0;
+}
+
+FixedLineFitter::~FixedLineFitter()
+{
+	delete [] points_;
+	delete [] weights_;
+}
+
+void FixedLineFitter::setPoints(const FixedPoint* points, int numPoints)
+{
+	numPoints_ = (numPoints < capacity_) ? numPoints : capacity_;
+	for (int i = 0; i < numPoints_; i++)
+	{
+		points_[i] = points[i];
+		weights_[i] = rangeWeight(points[i].range);
+	}
+}
+
+void FixedLineFitter::setConfidence(const uint16_t* confidence)
+{
+	for (int i = 0; i < numPoints_; i++)
+		weights_[i] = (int32_t)divideRounded((int64_t)rangeWeight(points_[i].range) * confidence[i], q15One);
+}
+
+// sums of Q15 weights times products of Q4 offsets stay under 2^56 for
+// 256 points anywhere within int16 range
+void FixedLineFitter::updateLine()
+{
+	int64_t sumW = 0, sumX = 0, sumY = 0;
+	for (int i = 0; i < numPoints_; i++)
+	{
+		sumW += weights_[i];
+		sumX += (int64_t)weights_[i] * points_[i].x;
+		sumY += (int64_t)weights_[i] * points_[i].y;
+	}
+	if (sumW <= 0)
+		return;
+	int32_t meanX = (int32_t)divideRounded(sumX, sumW);
+	int32_t meanY = (int32_t)divideRounded(sumY, sumW);
+
+	int64_t sumXX = 0, sumXY = 0;
+	for (int i = 0; i < numPoints_; i++)
+	{
+		int64_t dx = points_[i].x - meanX;
+		int64_t dy = points_[i].y - meanY;
+		sumXX += weights_[i] * dx * dx;
+		sumXY += weights_[i] * dx * dy;
+	}
+	if (sumXX <= 0)
+		return; // every weighted point at the same x
+	slope_ = divideQ16(sumXY, sumXX);
+	intercept_ = meanY - (int32_t)divideRounded((int64_t)slope_ * meanX, q16One);
+}
+
+int32_t FixedLineFitter::getSlope()
+{
+	return slope_;
+}
+
+int32_t FixedLineFitter::getIntercept()
+{
+	return intercept_;
+}
+
+int FixedLineFitter::getNumPoints()
+{
+	return numPoints_;
+}
@@ -0,0 +1,55 @@
+// FixedLineFitter.h
+// 10/18/2026
+
+// Integer version of LineFitter: weighted least squares fit of
+// y = slope * x + intercept to points in Colin's local frame, with the
+// same range weighting, using the formats in FixedPoint/FixedMath.h
+// Points are Q4 cm, confidences Q15, the slope comes out in Q16 and the
+// intercept in Q4 cm
+
+// The fit is done in two passes so the sums fit in 64 bits: the weighted
+// means of x and y, then the weighted sums of products of each point's
+// offsets from the means, whose ratio is the slope; this is LineFitter's
+// normal equations rearranged, and agrees with it to rounding
+
+#ifndef FIXEDLINEFITTER_H
+#define FIXEDLINEFITTER_H
+
+#include <stdint.h>
+
+struct FixedPoint
+{
+	int16_t x, y; // Q4 cm
+	int16_t range; // Q4 cm from the origin
+};
+
+// a sonar reading in whole cm at a heading in milliradians
+FixedPoint makeFixedPoint(int16_t range, int16_t heading);
+// a point already in Cartesian Q4 cm, such as an accumulated one
+FixedPoint makeFixedPointXY(int16_t x, int16_t y);
+
+class FixedLineFitter
+{
+public:
+	FixedLineFitter(int capacity);
+	~FixedLineFitter();
+	void setPoints(const FixedPoint* points, int numPoints); // clamped to capacity
+	void setConfidence(const uint16_t* confidence); // Q15 per point, after setPoints
+	void updateLine(); // keeps the previous line if the points don't determine one
+	int32_t getSlope(); // Q16
+	int32_t getIntercept(); // Q4 cm
+	int getNumPoints();
+
+private:
+	FixedPoint* points_;
+	int32_t* weights_; // Q15, range weight times confidence
+	int capacity_;
+	int numPoints_;
+	int32_t slope_;
+	int32_t intercept_;
+
+	FixedLineFitter(const FixedLineFitter&); // not copyable
+	FixedLineFitter& operator=(const FixedLineFitter&);
+};
+
+#endif
@@ -10,30 +10,26 @@ using namespace std;
 class LineFitter
 {
 public:
-	LineFitter(Point* points, int numPoints);
+	LineFitter(Point* points, int numPoints); // numPoints is also the capacity
 	~LineFitter();
 	void setPoints(Point* points);
+	void setPoints(Point* points, int numPoints); // fits to the first numPoints points
+	void setConfidence(const float* confidence); // scales each point's weight, 0 to 1
 	void updateLine();
 	double getM();
 	double getB();
+	int getNumPoints();
 
 private:
-	double** W_;
-	double** A_;
-	double** B_;
+	double* weights_;
 	Point* points_;
+	double* confidence_; // per point weight multiplier, defaults to 1
 	double m_;
 	double b_;
-	int numPoints_;
-	void buildAMatrix();
-	void buildBMatrix();
-	void buildWMatrix();
+	int numPoints_; // number of points in the current fit
+	int capacity_; // size of points_, weights_ and confidence_
+	void buildWeights();
 	void findCoefficients();
-	double** multiplyMatrices(double** A, int aRows, int aColumns, 
-						 	  double** B, int bRows, int bColumns);
-	double** find_At_W();
-	double** find2by2inverse(double** matrix);
-	//void printMatrix(double** matrix, int rows, int columns);
 };
 
-#endif
\ No newline at end of file
+#endif
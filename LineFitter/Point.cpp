@@ -39,4 +39,12 @@ void Point::setCoordinates(double range, double heading)
 	heading_ = heading;
 	x_ = range_ * cos(heading_);
 	y_ = range_ * sin(heading_);
+}
+
+void Point::setCartesian(double x, double y)
+{
+	x_ = x;
+	y_ = y;
+	range_ = sqrt(x_ * x_ + y_ * y_);
+	heading_ = atan2(y_, x_);
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ public:
 	double getRange();
 	double getHeading();
 	void setCoordinates(double range, double heading);
+	void setCartesian(double x, double y); // sets x and y, computes range and heading
 };
 
 #endif
\ No newline at end of file
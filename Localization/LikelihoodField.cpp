@@ -0,0 +1,187 @@
+// LikelihoodField.cpp
+// 10/18/2026
+
+// Precomputed sonar measurement model for localization
+// See LikelihoodField.h for usage
+
+#include "LikelihoodField.h"
+
+const float infiniteDistance = 1e20f;
+
+// exact 1D squared Euclidean distance transform (Felzenszwalb & Huttenlocher)
+// f holds 0 at sources and infiniteDistance elsewhere, result goes in d
+// v and z are scratch arrays of length n and n + 1
+static void distanceTransform1D(const float* f, float* d, int n, int* v, float* z)
+{
+	int k = 0;
+	v[0] = 0;
+	z[0] = -infiniteDistance;
+	z[1] = infiniteDistance;
+	for (int q = 1; q < n; q++)
+	{
+		float s;
+		while (true)
+		{
+			int p = v[k];
+			s = ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * (q - p));
+			if (s > z[k] || k == 0)
+				break;
+			k--;
+		}
+		if (s <= z[k])
+		{
+			// only reachable with k == 0, replace the first parabola
+			v[0] = q;
+			z[0] = -infiniteDistance;
+			z[1] = infiniteDistance;
+			continue;
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = infiniteDistance;
+	}
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < q)
+			k++;
+		float dq = (float)(q - v[k]);
+		d[q] = dq * dq + f[v[k]];
+	}
+}
+
+LikelihoodField::LikelihoodField(OccupancyGrid* grid, double sigma, double randomWeight)
+{
+	resolution_ = (float)grid->getResolution();
+	inverseResolution_ = 1.0f / resolution_;
+	outside_ = (float)log(randomWeight);
+	int margin = (int)ceil(3.0 * sigma / resolution_) + 1;
+	int minCx = 0, minCy = 0, maxCx = 1, maxCy = 1;
+	grid->getBounds(&minCx, &minCy, &maxCx, &maxCy);
+	minCx -= margin;
+	minCy -= margin;
+	maxCx += margin;
+	maxCy += margin;
+	width_ = maxCx - minCx;
+	height_ = maxCy - minCy;
+	originX_ = minCx * resolution_;
+	originY_ = minCy * resolution_;
+	field_ = new float[width_ * height_];
+
+	// squared distance to the nearest occupied cell, columns then rows
+	int longest = (width_ > height_) ? width_ : height_;
+	float* f = new float[longest];
+	float* d = new float[longest];
+	float* z = new float[longest + 1];
+	int* v = new int[longest];
+	numFreeCells_ = 0;
+	for (int row = 0; row < height_; row++)
+	{
+		for (int col = 0; col < width_; col++)
+		{
+			int16_t logOdds = grid->getLogOdds(minCx + col, minCy + row);
+			field_[row * width_ + col] = (logOdds > 0) ? 0.0f : infiniteDistance;
+			if (logOdds < 0)
+				numFreeCells_++;
+		}
+	}
+	for (int col = 0; col < width_; col++)
+	{
+		for (int row = 0; row < height_; row++)
+			f[row] = field_[row * width_ + col];
+		distanceTransform1D(f, d, height_, v, z);
+		for (int row = 0; row < height_; row++)
+			field_[row * width_ + col] = d[row];
+	}
+	for (int row = 0; row < height_; row++)
+	{
+		float* line = &field_[row * width_];
+		for (int col = 0; col < width_; col++)
+			f[col] = line[col];
+		distanceTransform1D(f, line, width_, v, z);
+	}
+	delete[] f;
+	delete[] d;
+	delete[] z;
+	delete[] v;
+
+	// distance to log-likelihood
+	double scale = resolution_ * resolution_ / (2.0 * sigma * sigma);
+	double hitWeight = 1.0 - randomWeight;
+	for (int i = 0; i < width_ * height_; i++)
+		field_[i] = (float)log(hitWeight * exp(-field_[i] * scale) + randomWeight);
+
+	freeCells_ = new int[numFreeCells_ > 0 ? numFreeCells_ : 1];
+	int freeIndex = 0;
+	for (int row = 0; row < height_; row++)
+	{
+		for (int col = 0; col < width_; col++)
+		{
+			if (grid->getLogOdds(minCx + col, minCy + row) < 0)
+				freeCells_[freeIndex++] = row * width_ + col;
+		}
+	}
+}
+
+LikelihoodField::~LikelihoodField()
+{
+	delete[] field_;
+	delete[] freeCells_;
+}
+
+float LikelihoodField::getLogLikelihood(float x, float y)
+{
+	int col = (int)floorf((x - originX_) * inverseResolution_);
+	int row = (int)floorf((y - originY_) * inverseResolution_);
+	if (col < 0 || col >= width_ || row < 0 || row >= height_)
+		return outside_;
+	return field_[row * width_ + col];
+}
+
+const float* LikelihoodField::getData()
+{
+	return field_;
+}
+
+int LikelihoodField::getWidth()
+{
+	return width_;
+}
+
+int LikelihoodField::getHeight()
+{
+	return height_;
+}
+
+float LikelihoodField::getOriginX()
+{
+	return originX_;
+}
+
+float LikelihoodField::getOriginY()
+{
+	return originY_;
+}
+
+float LikelihoodField::getInverseResolution()
+{
+	return inverseResolution_;
+}
+
+float LikelihoodField::getOutsideLogLikelihood()
+{
+	return outside_;
+}
+
+int LikelihoodField::getNumFreeCells()
+{
+	return numFreeCells_;
+}
+
+void LikelihoodField::getFreeCell(int index, float* x, float* y)
+{
+	int cell = freeCells_[index];
+	*x = originX_ + ((cell % width_) + 0.5f) * resolution_;
+	*y = originY_ + ((cell / width_) + 0.5f) * resolution_;
+}
@@ -0,0 +1,53 @@
+// LikelihoodField.h
+// 10/18/2026
+
+// Precomputed sonar measurement model for localization
+// Built once from an occupancy grid: every cell stores the log-likelihood
+// of a sonar echo ending in that cell, based on the distance from the
+// cell to the nearest occupied cell
+//    likelihood = hitWeight * exp(-d^2 / (2 sigma^2)) + randomWeight
+// Scoring a reading is then a single table lookup at the reading's end
+// point instead of a ray-cast through the map
+
+// The field is a dense row-major float array covering the map's bounds
+// plus a margin; lookups outside it return the log of randomWeight
+
+#ifndef LIKELIHOODFIELD_H
+#define LIKELIHOODFIELD_H
+
+#include "../Mapping/OccupancyGrid.h"
+
+class LikelihoodField
+{
+public:
+	// sigma is the echo position noise in cm, randomWeight the
+	// likelihood of a reading that doesn't match the map at all
+	LikelihoodField(OccupancyGrid* grid, double sigma, double randomWeight);
+	~LikelihoodField();
+	float getLogLikelihood(float x, float y); // world coordinates in cm
+	const float* getData(); // row major, width x height cells
+	int getWidth();
+	int getHeight();
+	float getOriginX(); // world coordinates of the first cell's corner
+	float getOriginY();
+	float getInverseResolution(); // cells per cm
+	float getOutsideLogLikelihood();
+	// free cells, usable for spreading particles over the map
+	int getNumFreeCells();
+	void getFreeCell(int index, float* x, float* y); // cell center
+
+private:
+	float* field_;
+	int width_, height_;
+	float originX_, originY_;
+	float resolution_;
+	float inverseResolution_;
+	float outside_;
+	int* freeCells_;
+	int numFreeCells_;
+
+	LikelihoodField(const LikelihoodField&); // not copyable
+	LikelihoodField& operator=(const LikelihoodField&);
+};
+
+#endif
@@ -0,0 +1,336 @@
+// ParticleFilter.cpp
+// 10/18/2026
+
+// Monte Carlo localization of Colin against a prebuilt map
+// See ParticleFilter.h for usage
+
+#include "ParticleFilter.h"
+
+const int particleGrain = 256; // particles per chunk handed to the pool
+
+// small, fast generator (xorshift64*) so each chunk can carry its own
+static inline uint64_t nextRandom(uint64_t* state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 2685821657736338717ULL;
+}
+
+static inline float uniformRandom(uint64_t* state)
+{
+	return (float)(nextRandom(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+static inline float gaussianRandom(uint64_t* state)
+{
+	float u1 = uniformRandom(state) + 1e-7f;
+	float u2 = uniformRandom(state);
+	return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+static inline uint64_t chunkSeed(uint64_t seed, uint64_t step, int begin)
+{
+	uint64_t state = seed ^ (step * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)begin << 32);
+	return (state == 0) ? 1 : state;
+}
+
+MotionNoise defaultMotionNoise()
+{
+	MotionNoise noise;
+	noise.translationPerCm = 0.05;
+	noise.rotationPerCm = 0.002;
+	noise.rotationPerRad = 0.1;
+	noise.translationPerRad = 1.0;
+	return noise;
+}
+
+ParticleFilter::ParticleFilter(LikelihoodField* field, int numParticles, ThreadPool* pool)
+{
+	field_ = field;
+	pool_ = pool;
+	numParticles_ = numParticles;
+	noise_ = defaultMotionNoise();
+	maxRange_ = 300.0;
+	seed_ = 0x2545F4914F6CDD1DULL;
+	step_ = 0;
+	haveOdometry_ = false;
+	x_ = new float[numParticles_];
+	y_ = new float[numParticles_];
+	theta_ = new float[numParticles_];
+	logWeight_ = new float[numParticles_];
+	weight_ = new float[numParticles_];
+	nextX_ = new float[numParticles_];
+	nextY_ = new float[numParticles_];
+	nextTheta_ = new float[numParticles_];
+	cos_ = new float[numParticles_];
+	sin_ = new float[numParticles_];
+	numReadings_ = 0;
+	initialize(makePose(0.0, 0.0, 0.0), 0.0, 0.0);
+}
+
+ParticleFilter::~ParticleFilter()
+{
+	delete[] x_;
+	delete[] y_;
+	delete[] theta_;
+	delete[] logWeight_;
+	delete[] weight_;
+	delete[] nextX_;
+	delete[] nextY_;
+	delete[] nextTheta_;
+	delete[] cos_;
+	delete[] sin_;
+}
+
+void ParticleFilter::setMotionNoise(const MotionNoise& noise)
+{
+	noise_ = noise;
+}
+
+void ParticleFilter::setMaxRange(double maxRange)
+{
+	maxRange_ = maxRange;
+}
+
+void ParticleFilter::setSeed(uint64_t seed)
+{
+	seed_ = (seed == 0) ? 1 : seed;
+}
+
+void ParticleFilter::initialize(const Pose2D& pose, double spreadXY, double spreadTheta)
+{
+	uint64_t state = chunkSeed(seed_, step_++, -1);
+	for (int i = 0; i < numParticles_; i++)
+	{
+		x_[i] = (float)(pose.x + spreadXY * gaussianRandom(&state));
+		y_[i] = (float)(pose.y + spreadXY * gaussianRandom(&state));
+		theta_[i] = (float)normalizeAngle(pose.theta + spreadTheta * gaussianRandom(&state));
+		logWeight_[i] = 0.0f;
+		weight_[i] = 1.0f / numParticles_;
+	}
+	haveOdometry_ = false;
+}
+
+void ParticleFilter::initializeUniform()
+{
+	int numFree = field_->getNumFreeCells();
+	if (numFree == 0)
+		return;
+	uint64_t state = chunkSeed(seed_, step_++, -1);
+	for (int i = 0; i < numParticles_; i++)
+	{
+		int cell = (int)(nextRandom(&state) % (uint64_t)numFree);
+		field_->getFreeCell(cell, &x_[i], &y_[i]);
+		theta_[i] = (float)(2.0 * M_PI * uniformRandom(&state) - M_PI);
+		logWeight_[i] = 0.0f;
+		weight_[i] = 1.0f / numParticles_;
+	}
+	haveOdometry_ = false;
+}
+
+void ParticleFilter::predictChunk(int begin, int end, void* arg)
+{
+	ParticleFilter* filter = (ParticleFilter*)arg;
+	const Pose2D& delta = filter->delta_;
+	const MotionNoise& noise = filter->noise_;
+	double distance = sqrt(delta.x * delta.x + delta.y * delta.y);
+	double turn = fabs(delta.theta);
+	float translationSigma = (float)(noise.translationPerCm * distance
+	                                 + noise.translationPerRad * turn);
+	float rotationSigma = (float)(noise.rotationPerCm * distance
+	                              + noise.rotationPerRad * turn);
+	uint64_t state = chunkSeed(filter->seed_, filter->step_, begin);
+	float* x = filter->x_;
+	float* y = filter->y_;
+	float* theta = filter->theta_;
+	for (int i = begin; i < end; i++)
+	{
+		float dx = (float)delta.x + translationSigma * gaussianRandom(&state);
+		float dy = (float)delta.y + translationSigma * gaussianRandom(&state);
+		float dTheta = (float)delta.theta + rotationSigma * gaussianRandom(&state);
+		float c = cosf(theta[i]);
+		float s = sinf(theta[i]);
+		x[i] += c * dx - s * dy;
+		y[i] += s * dx + c * dy;
+		float heading = theta[i] + dTheta;
+		if (heading >= (float)M_PI)
+			heading -= 2.0f * (float)M_PI;
+		else if (heading < -(float)M_PI)
+			heading += 2.0f * (float)M_PI;
+		theta[i] = heading;
+	}
+}
+
+void ParticleFilter::predict(const Pose2D& delta)
+{
+	delta_ = delta;
+	pool_->parallelFor(0, numParticles_, predictChunk, this, particleGrain);
+	step_++;
+}
+
+// each reading's end point is computed for the whole chunk at once from
+// the particles' cached cos and sin, then looked up in the field
+void ParticleFilter::weightChunk(int begin, int end, void* arg)
+{
+	ParticleFilter* filter = (ParticleFilter*)arg;
+	LikelihoodField* field = filter->field_;
+	const float* data = field->getData();
+	const int width = field->getWidth();
+	const float widthF = (float)width;
+	const float heightF = (float)field->getHeight();
+	const float originX = field->getOriginX();
+	const float originY = field->getOriginY();
+	const float scale = field->getInverseResolution();
+	const float outside = field->getOutsideLogLikelihood();
+	const float* __restrict x = filter->x_;
+	const float* __restrict y = filter->y_;
+	float* __restrict c = filter->cos_;
+	float* __restrict s = filter->sin_;
+	float* __restrict logWeight = filter->logWeight_;
+	const float* theta = filter->theta_;
+
+	for (int i = begin; i < end; i++)
+	{
+		c[i] = cosf(theta[i]);
+		s[i] = sinf(theta[i]);
+	}
+	for (int r = 0; r < filter->numReadings_; r++)
+	{
+		// sensor direction in the robot frame scaled by range
+		const float forward = filter->readingRange_[r] * filter->readingCos_[r];
+		const float left = filter->readingRange_[r] * filter->readingSin_[r];
+		for (int i = begin; i < end; i++)
+		{
+			float col = (x[i] + c[i] * forward - s[i] * left - originX) * scale;
+			float row = (y[i] + s[i] * forward + c[i] * left - originY) * scale;
+			bool inside = col >= 0.0f && col < widthF && row >= 0.0f && row < heightF;
+			int index = inside ? (int)row * width + (int)col : 0;
+			logWeight[i] += inside ? data[index] : outside;
+		}
+	}
+}
+
+void ParticleFilter::update(const int16_t* ranges, const double* sensorAngles, int numSonar)
+{
+	numReadings_ = 0;
+	for (int i = 0; i < numSonar && i < maxSonar; i++)
+	{
+		if (ranges[i] <= 0 || ranges[i] > maxRange_)
+			continue;
+		readingRange_[numReadings_] = (float)ranges[i];
+		readingCos_[numReadings_] = (float)cos(sensorAngles[i]);
+		readingSin_[numReadings_] = (float)sin(sensorAngles[i]);
+		numReadings_++;
+	}
+	if (numReadings_ == 0)
+		return;
+	pool_->parallelFor(0, numParticles_, weightChunk, this, particleGrain);
+	normalize();
+}
+
+// converts log weights to normalized weights, keeping log weights as the
+// log of the normalized value so they stay in range across updates
+void ParticleFilter::normalize()
+{
+	float maxLog = logWeight_[0];
+	for (int i = 1; i < numParticles_; i++)
+		maxLog = (logWeight_[i] > maxLog) ? logWeight_[i] : maxLog;
+	double sum = 0.0;
+	for (int i = 0; i < numParticles_; i++)
+	{
+		weight_[i] = expf(logWeight_[i] - maxLog);
+		sum += weight_[i];
+	}
+	float inverseSum = (float)(1.0 / sum);
+	float logSum = (float)log(sum);
+	for (int i = 0; i < numParticles_; i++)
+	{
+		weight_[i] *= inverseSum;
+		logWeight_[i] -= maxLog + logSum;
+	}
+}
+
+double ParticleFilter::getEffectiveSampleSize()
+{
+	double sumSquares = 0.0;
+	for (int i = 0; i < numParticles_; i++)
+		sumSquares += (double)weight_[i] * weight_[i];
+	return 1.0 / sumSquares;
+}
+
+// low-variance resampling: one random offset, then evenly spaced
+// pointers walk the cumulative weights once
+bool ParticleFilter::resampleIfNeeded()
+{
+	if (getEffectiveSampleSize() >= 0.5 * numParticles_)
+		return false;
+	uint64_t state = chunkSeed(seed_, step_++, -2);
+	double spacing = 1.0 / numParticles_;
+	double pointer = uniformRandom(&state) * spacing;
+	double cumulative = weight_[0];
+	int source = 0;
+	for (int i = 0; i < numParticles_; i++)
+	{
+		while (pointer > cumulative && source < numParticles_ - 1)
+			cumulative += weight_[++source];
+		nextX_[i] = x_[source];
+		nextY_[i] = y_[source];
+		nextTheta_[i] = theta_[source];
+		pointer += spacing;
+	}
+	float* swap = x_; x_ = nextX_; nextX_ = swap;
+	swap = y_; y_ = nextY_; nextY_ = swap;
+	swap = theta_; theta_ = nextTheta_; nextTheta_ = swap;
+	float uniformLog = -logf((float)numParticles_);
+	for (int i = 0; i < numParticles_; i++)
+	{
+		logWeight_[i] = uniformLog;
+		weight_[i] = (float)spacing;
+	}
+	return true;
+}
+
+void ParticleFilter::processFrame(const SensorFrame& frame, const double* sensorAngles)
+{
+	Pose2D odometry = makePose(frame.x, frame.y, frame.theta);
+	if (haveOdometry_)
+		predict(relativePose(lastOdometry_, odometry));
+	lastOdometry_ = odometry;
+	haveOdometry_ = true;
+	update(frame.distances, sensorAngles, frame.numSonar);
+	resampleIfNeeded();
+}
+
+Pose2D ParticleFilter::getEstimate()
+{
+	double sumX = 0.0, sumY = 0.0, sumCos = 0.0, sumSin = 0.0;
+	for (int i = 0; i < numParticles_; i++)
+	{
+		sumX += weight_[i] * x_[i];
+		sumY += weight_[i] * y_[i];
+		sumCos += weight_[i] * cosf(theta_[i]);
+		sumSin += weight_[i] * sinf(theta_[i]);
+	}
+	return makePose(sumX, sumY, atan2(sumSin, sumCos));
+}
+
+int ParticleFilter::getNumParticles()
+{
+	return numParticles_;
+}
+
+const float* ParticleFilter::getX()
+{
+	return x_;
+}
+
+const float* ParticleFilter::getY()
+{
+	return y_;
+}
+
+const float* ParticleFilter::getTheta()
+{
+	return theta_;
+}
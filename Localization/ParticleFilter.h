@@ -0,0 +1,102 @@
+// ParticleFilter.h
+// 10/18/2026
+
+// Monte Carlo localization of Colin against a prebuilt map
+// Fuses odometry deltas from SerialBot's pose with the sonar ranges
+// scored against a LikelihoodField
+
+// Particles are stored structure-of-arrays (x, y, theta and log weight
+// each in their own array) so the weighting loop runs over contiguous
+// floats and vectorizes; motion and weighting are split across a
+// ThreadPool in fixed chunks, each chunk seeding its own random number
+// generator from the chunk index and step count, so results don't
+// depend on thread timing
+// Resampling is low-variance (systematic) into preallocated arrays
+// that are then swapped; nothing is allocated after construction
+
+#ifndef PARTICLEFILTER_H
+#define PARTICLEFILTER_H
+
+#include <stdint.h>
+#include "LikelihoodField.h"
+#include "../Geometry/Pose2D.h"
+#include "../SerialBot/SensorFrame.h"
+#include "../ThreadPool/ThreadPool.h"
+
+struct MotionNoise
+{
+	double translationPerCm; // std dev of translation per cm driven
+	double rotationPerCm; // std dev of heading (rad) per cm driven
+	double rotationPerRad; // std dev of heading per rad turned
+	double translationPerRad; // std dev of translation (cm) per rad turned
+};
+
+MotionNoise defaultMotionNoise();
+
+class ParticleFilter
+{
+public:
+	ParticleFilter(LikelihoodField* field, int numParticles, ThreadPool* pool);
+	~ParticleFilter();
+	void setMotionNoise(const MotionNoise& noise);
+	void setMaxRange(double maxRange); // readings of 0 or beyond this are ignored
+	void setSeed(uint64_t seed);
+	void initialize(const Pose2D& pose, double spreadXY, double spreadTheta);
+	void initializeUniform(); // spreads particles over the map's free cells
+
+	// moves every particle by delta, expressed in the robot's previous frame
+	void predict(const Pose2D& delta);
+	// weights particles by how well the readings match the map
+	void update(const int16_t* ranges, const double* sensorAngles, int numSonar);
+	// resamples if the effective sample size has dropped below half
+	// returns true if it resampled
+	bool resampleIfNeeded();
+	// predict from the change in odometry since the last frame, then
+	// update and resample
+	void processFrame(const SensorFrame& frame, const double* sensorAngles);
+
+	Pose2D getEstimate(); // weighted mean of the particles
+	double getEffectiveSampleSize();
+	int getNumParticles();
+	const float* getX();
+	const float* getY();
+	const float* getTheta();
+
+private:
+	LikelihoodField* field_;
+	ThreadPool* pool_;
+	int numParticles_;
+	MotionNoise noise_;
+	double maxRange_;
+	uint64_t seed_;
+	uint64_t step_;
+	bool haveOdometry_;
+	Pose2D lastOdometry_;
+
+	float* x_;
+	float* y_;
+	float* theta_;
+	float* logWeight_;
+	float* weight_; // normalized weights
+	float* nextX_; // resampling targets, swapped with x_, y_ and theta_
+	float* nextY_;
+	float* nextTheta_;
+	float* cos_; // cos and sin of theta_, refreshed before weighting
+	float* sin_;
+
+	// current step's inputs shared with the chunk functions
+	Pose2D delta_;
+	int numReadings_;
+	float readingRange_[maxSonar];
+	float readingCos_[maxSonar];
+	float readingSin_[maxSonar];
+
+	static void predictChunk(int begin, int end, void* filter);
+	static void weightChunk(int begin, int end, void* filter);
+	void normalize();
+
+	ParticleFilter(const ParticleFilter&); // not copyable
+	ParticleFilter& operator=(const ParticleFilter&);
+};
+
+#endif
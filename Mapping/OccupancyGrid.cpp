@@ -0,0 +1,346 @@
+// OccupancyGrid.cpp
+// 10/18/2026
+
+// Persistent occupancy grid map built from Colin's sonar readings and
+// odometry pose
+// See OccupancyGrid.h for a description of the map layout
+
+#include "OccupancyGrid.h"
+#include <stdio.h>
+#include <string.h>
+
+const char mapMagic[4] = {'C', 'O', 'G', '1'};
+
+SonarModel defaultSonarModel()
+{
+	SonarModel model;
+	model.beamWidth = sonarBeamWidth;
+	model.raysPerCone = 5;
+	model.maxRange = 300.0;
+	model.clearOnMiss = false;
+	model.hit = 85; // p = 0.7
+	model.miss = -40; // p = 0.4
+	model.minLogOdds = -400;
+	model.maxLogOdds = 400;
+	return model;
+}
+
+OccupancyGrid::OccupancyGrid(double resolution)
+{
+	resolution_ = resolution;
+	model_ = defaultSonarModel();
+	tiles_ = NULL;
+	originTx_ = 0;
+	originTy_ = 0;
+	widthTiles_ = 0;
+	heightTiles_ = 0;
+	numTiles_ = 0;
+	cellUpdates_ = 0;
+}
+
+OccupancyGrid::~OccupancyGrid()
+{
+	clear();
+}
+
+void OccupancyGrid::setSonarModel(const SonarModel& model)
+{
+	model_ = model;
+}
+
+void OccupancyGrid::clear()
+{
+	for (int i = 0; i < widthTiles_ * heightTiles_; i++)
+		delete[] tiles_[i];
+	delete[] tiles_;
+	tiles_ = NULL;
+	originTx_ = 0;
+	originTy_ = 0;
+	widthTiles_ = 0;
+	heightTiles_ = 0;
+	numTiles_ = 0;
+}
+
+double OccupancyGrid::getResolution()
+{
+	return resolution_;
+}
+
+void OccupancyGrid::worldToCell(double x, double y, int* cx, int* cy)
+{
+	*cx = (int)floor(x / resolution_);
+	*cy = (int)floor(y / resolution_);
+}
+
+void OccupancyGrid::cellToWorld(int cx, int cy, double* x, double* y)
+{
+	*x = (cx + 0.5) * resolution_;
+	*y = (cy + 0.5) * resolution_;
+}
+
+// grows the directory with some slack on the side that's growing so a
+// robot driving in one direction doesn't regrow it every few tiles
+void OccupancyGrid::growToInclude(int tx, int ty)
+{
+	int minTx = originTx_, minTy = originTy_;
+	int maxTx = originTx_ + widthTiles_, maxTy = originTy_ + heightTiles_;
+	if (widthTiles_ == 0)
+	{
+		minTx = tx - 2;
+		minTy = ty - 2;
+		maxTx = tx + 3;
+		maxTy = ty + 3;
+	}
+	int slackX = widthTiles_ / 2 + 1;
+	int slackY = heightTiles_ / 2 + 1;
+	if (tx < minTx)
+		minTx = tx - slackX;
+	if (tx >= maxTx)
+		maxTx = tx + 1 + slackX;
+	if (ty < minTy)
+		minTy = ty - slackY;
+	if (ty >= maxTy)
+		maxTy = ty + 1 + slackY;
+
+	int newWidth = maxTx - minTx;
+	int newHeight = maxTy - minTy;
+	int16_t** newTiles = new int16_t*[newWidth * newHeight];
+	for (int i = 0; i < newWidth * newHeight; i++)
+		newTiles[i] = NULL;
+	for (int row = 0; row < heightTiles_; row++)
+	{
+		for (int col = 0; col < widthTiles_; col++)
+		{
+			int newRow = row + originTy_ - minTy;
+			int newCol = col + originTx_ - minTx;
+			newTiles[newRow * newWidth + newCol] = tiles_[row * widthTiles_ + col];
+		}
+	}
+	delete[] tiles_;
+	tiles_ = newTiles;
+	originTx_ = minTx;
+	originTy_ = minTy;
+	widthTiles_ = newWidth;
+	heightTiles_ = newHeight;
+}
+
+int16_t* OccupancyGrid::getTile(int tx, int ty, bool create)
+{
+	int col = tx - originTx_;
+	int row = ty - originTy_;
+	if (col < 0 || col >= widthTiles_ || row < 0 || row >= heightTiles_)
+	{
+		if (!create)
+			return NULL;
+		growToInclude(tx, ty);
+		col = tx - originTx_;
+		row = ty - originTy_;
+	}
+	int16_t*& tile = tiles_[row * widthTiles_ + col];
+	if (tile == NULL && create)
+	{
+		tile = new int16_t[tileSize * tileSize];
+		memset(tile, 0, sizeof(int16_t) * tileSize * tileSize);
+		numTiles_++;
+	}
+	return tile;
+}
+
+void OccupancyGrid::updateCell(int16_t* cell, int delta)
+{
+	int value = *cell + delta;
+	if (value < model_.minLogOdds)
+		value = model_.minLogOdds;
+	if (value > model_.maxLogOdds)
+		value = model_.maxLogOdds;
+	*cell = (int16_t)value;
+	cellUpdates_++;
+}
+
+// integer Bresenham traversal from (x0, y0) to (x1, y1) in cell coordinates
+// the tile pointer is only looked up again when the ray crosses into a
+// new tile
+void OccupancyGrid::traceRay(int x0, int y0, int x1, int y1, bool hit)
+{
+	int dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+	int dy = (y1 > y0) ? y0 - y1 : y1 - y0; // negative
+	int stepX = (x0 < x1) ? 1 : -1;
+	int stepY = (y0 < y1) ? 1 : -1;
+	int error = dx + dy;
+	int tx = x0 >> tileShift;
+	int ty = y0 >> tileShift;
+	int16_t* tile = getTile(tx, ty, true);
+	while (true)
+	{
+		if ((x0 >> tileShift) != tx || (y0 >> tileShift) != ty)
+		{
+			tx = x0 >> tileShift;
+			ty = y0 >> tileShift;
+			tile = getTile(tx, ty, true);
+		}
+		int16_t* cell = &tile[((y0 & tileMask) << tileShift) | (x0 & tileMask)];
+		if (x0 == x1 && y0 == y1)
+		{
+			updateCell(cell, hit ? model_.hit : model_.miss);
+			break;
+		}
+		updateCell(cell, model_.miss);
+		int error2 = 2 * error;
+		if (error2 >= dy)
+		{
+			error += dy;
+			x0 += stepX;
+		}
+		if (error2 <= dx)
+		{
+			error += dx;
+			y0 += stepY;
+		}
+	}
+}
+
+void OccupancyGrid::insertScan(const Pose2D& pose, const int16_t* ranges,
+                               const double* sensorAngles, int numSonar)
+{
+	int originX, originY;
+	worldToCell(pose.x, pose.y, &originX, &originY);
+	int rays = (model_.raysPerCone > 1) ? model_.raysPerCone : 1;
+	double spacing = (rays > 1) ? model_.beamWidth / (rays - 1) : 0.0;
+	for (int i = 0; i < numSonar; i++)
+	{
+		double range = ranges[i];
+		bool hit = range > 0.0 && range <= model_.maxRange;
+		if (!hit)
+		{
+			if (!model_.clearOnMiss)
+				continue;
+			range = model_.maxRange;
+		}
+		double angle = pose.theta + sensorAngles[i] - 0.5 * spacing * (rays - 1);
+		for (int ray = 0; ray < rays; ray++, angle += spacing)
+		{
+			int endX, endY;
+			worldToCell(pose.x + range * cos(angle), pose.y + range * sin(angle),
+			            &endX, &endY);
+			traceRay(originX, originY, endX, endY, hit);
+		}
+	}
+}
+
+void OccupancyGrid::insertFrame(const SensorFrame& frame, const double* sensorAngles)
+{
+	insertScan(makePose(frame.x, frame.y, frame.theta), frame.distances,
+	           sensorAngles, frame.numSonar);
+}
+
+int16_t OccupancyGrid::getLogOdds(int cx, int cy)
+{
+	int16_t* tile = getTile(cx >> tileShift, cy >> tileShift, false);
+	if (tile == NULL)
+		return 0;
+	return tile[((cy & tileMask) << tileShift) | (cx & tileMask)];
+}
+
+double OccupancyGrid::getProbability(int cx, int cy)
+{
+	return 1.0 - 1.0 / (1.0 + exp(getLogOdds(cx, cy) / 100.0));
+}
+
+bool OccupancyGrid::isOccupied(int cx, int cy)
+{
+	return getLogOdds(cx, cy) > 0;
+}
+
+bool OccupancyGrid::getBounds(int* minCx, int* minCy, int* maxCx, int* maxCy)
+{
+	bool found = false;
+	for (int row = 0; row < heightTiles_; row++)
+	{
+		for (int col = 0; col < widthTiles_; col++)
+		{
+			if (tiles_[row * widthTiles_ + col] == NULL)
+				continue;
+			int cx = (col + originTx_) << tileShift;
+			int cy = (row + originTy_) << tileShift;
+			if (!found || cx < *minCx)
+				*minCx = cx;
+			if (!found || cy < *minCy)
+				*minCy = cy;
+			if (!found || cx + tileSize > *maxCx)
+				*maxCx = cx + tileSize;
+			if (!found || cy + tileSize > *maxCy)
+				*maxCy = cy + tileSize;
+			found = true;
+		}
+	}
+	return found;
+}
+
+uint64_t OccupancyGrid::getCellUpdates()
+{
+	return cellUpdates_;
+}
+
+int OccupancyGrid::getNumTiles()
+{
+	return numTiles_;
+}
+
+// file format (host byte order):
+//    magic "COG1", double resolution, int32 tile count,
+//    then per tile int32 tx, int32 ty and tileSize * tileSize int16 cells
+bool OccupancyGrid::save(const char* fileName)
+{
+	FILE* file = fopen(fileName, "wb");
+	if (file == NULL)
+		return false;
+	int32_t count = numTiles_;
+	bool ok = fwrite(mapMagic, 1, 4, file) == 4
+	          && fwrite(&resolution_, sizeof(resolution_), 1, file) == 1
+	          && fwrite(&count, sizeof(count), 1, file) == 1;
+	for (int row = 0; ok && row < heightTiles_; row++)
+	{
+		for (int col = 0; ok && col < widthTiles_; col++)
+		{
+			int16_t* tile = tiles_[row * widthTiles_ + col];
+			if (tile == NULL)
+				continue;
+			int32_t coords[2] = {col + originTx_, row + originTy_};
+			ok = fwrite(coords, sizeof(int32_t), 2, file) == 2
+			     && fwrite(tile, sizeof(int16_t), tileSize * tileSize, file)
+			        == (size_t)(tileSize * tileSize);
+		}
+	}
+	return fclose(file) == 0 && ok;
+}
+
+bool OccupancyGrid::load(const char* fileName)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (file == NULL)
+		return false;
+	char magic[4];
+	double resolution;
+	int32_t count;
+	bool ok = fread(magic, 1, 4, file) == 4 && memcmp(magic, mapMagic, 4) == 0
+	          && fread(&resolution, sizeof(resolution), 1, file) == 1
+	          && fread(&count, sizeof(count), 1, file) == 1 && count >= 0;
+	if (ok)
+	{
+		clear();
+		resolution_ = resolution;
+	}
+	for (int i = 0; ok && i < count; i++)
+	{
+		int32_t coords[2];
+		ok = fread(coords, sizeof(int32_t), 2, file) == 2;
+		if (ok)
+		{
+			int16_t* tile = getTile(coords[0], coords[1], true);
+			ok = fread(tile, sizeof(int16_t), tileSize * tileSize, file)
+			     == (size_t)(tileSize * tileSize);
+		}
+	}
+	fclose(file);
+	return ok;
+}
@@ -0,0 +1,95 @@
+// OccupancyGrid.h
+// 10/18/2026
+
+// Persistent occupancy grid map built from Colin's sonar readings and
+// odometry pose
+
+// Cells hold log-odds of occupancy as 16 bit ints in units of 0.01, so
+// updates are integer adds and the map stays compact
+// Cells are grouped into square tiles of tileSize x tileSize, stored
+// contiguously, so a ray mostly walks within one or two tiles that stay
+// in cache; tiles are only allocated once something is written to them
+// The map grows in any direction by reallocating the tile directory (one
+// pointer per tile), never the cells themselves
+
+// Each sonar reading is modeled as a cone of raysPerCone rays spread
+// across the beam width; cells along each ray are traversed with integer
+// Bresenham steps and marked free, and the end cell is marked occupied if
+// the reading was an echo within maxRange
+
+// The grid isn't thread safe; one thread should own inserts
+
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include <stdint.h>
+#include "../Geometry/Pose2D.h"
+#include "../SerialBot/SensorFrame.h"
+
+const int tileShift = 5;
+const int tileSize = 1 << tileShift; // cells per tile side
+const int tileMask = tileSize - 1;
+
+struct SonarModel
+{
+	double beamWidth; // full cone angle in radians
+	int raysPerCone; // rays cast across the cone
+	double maxRange; // readings beyond this (or 0) are treated as no echo, cm
+	bool clearOnMiss; // if set, no echo clears cells out to maxRange
+	int16_t hit; // log-odds added to the end cell of an echo
+	int16_t miss; // log-odds added to cells a ray passes through (negative)
+	int16_t minLogOdds; // clamping limits, keep cells able to change
+	int16_t maxLogOdds;
+};
+
+// returns a model for Colin's HC-SR04 style sonars
+SonarModel defaultSonarModel();
+
+class OccupancyGrid
+{
+public:
+	OccupancyGrid(double resolution); // cell size in cm
+	~OccupancyGrid();
+	void setSonarModel(const SonarModel& model);
+	void clear(); // frees every tile
+
+	// ray-casts numSonar readings taken at pose with sensors at the
+	// given angles in the robot's local frame
+	void insertScan(const Pose2D& pose, const int16_t* ranges,
+	                const double* sensorAngles, int numSonar);
+	void insertFrame(const SensorFrame& frame, const double* sensorAngles);
+
+	double getResolution();
+	void worldToCell(double x, double y, int* cx, int* cy);
+	void cellToWorld(int cx, int cy, double* x, double* y); // cell center
+	int16_t getLogOdds(int cx, int cy); // 0 (unknown) for cells never written
+	double getProbability(int cx, int cy);
+	bool isOccupied(int cx, int cy); // log-odds above zero
+	// smallest cell rectangle covering every allocated tile, max exclusive
+	// returns false if the map is empty
+	bool getBounds(int* minCx, int* minCy, int* maxCx, int* maxCy);
+	uint64_t getCellUpdates(); // number of cell writes since construction
+	int getNumTiles();
+
+	bool save(const char* fileName);
+	bool load(const char* fileName);
+
+private:
+	double resolution_;
+	SonarModel model_;
+	int16_t** tiles_; // directory, row major, NULL for unallocated tiles
+	int originTx_, originTy_; // tile coordinates of tiles_[0]
+	int widthTiles_, heightTiles_;
+	int numTiles_;
+	uint64_t cellUpdates_;
+
+	int16_t* getTile(int tx, int ty, bool create);
+	void growToInclude(int tx, int ty);
+	void traceRay(int x0, int y0, int x1, int y1, bool hit);
+	void updateCell(int16_t* cell, int delta);
+
+	OccupancyGrid(const OccupancyGrid&); // not copyable
+	OccupancyGrid& operator=(const OccupancyGrid&);
+};
+
+#endif
@@ -5,22 +5,60 @@
 // Assists in manual PID tuning of Colin the Robot
 // Must be used with PID_tune.ino running on Colin's ATmega328
 
+// With -a, runs a schedule of trials back to back without prompting and
+// logs one CSV line per trial:
+//    grid:  every combination of the kP, kI and kD lists
+//    nm:    Nelder-Mead search over (kP, kI, kD) minimizing the trial cost
+//    relay: relay feedback experiment, then a trial with the
+//           Ziegler-Nichols gains it gives
+// -s runs trials against a simulated plant (Sim/WheelPlant.h) instead of
+// the serial port
+// PID_tune.ino only answers a command with an ACK, so against the robot
+// there is no response to measure: only grid schedules can run, and the
+// log records when each trial was acknowledged. nm and relay need the
+// response and run only with -s
+// On the serial port each trial's packet is sent once the trial before it
+// has been acknowledged and has run for its time. With -q the next
+// packet is sent as soon as the current trial is acknowledged, so it
+// waits in the ATmega's receive buffer and starts as soon as the current
+// trial ends; that's only safe if PID_tune.ino acknowledges a command when
+// it starts it and reads the next one only once the trial is over, as a
+// packet read mid-trial would cut the trial short. Put Colin on a stand
+// before running a schedule
+
+// usage: PID_tune
+//        PID_tune -a grid|nm|relay [-s] [-q] [-t speed angular timeMs]
+//                 [-p kPs] [-i kIs] [-d kDs] [-l logFile]
+//    -q: queue each trial's packet behind the running trial (see above)
+//    -t: the command each trial runs (default 50 cm/s, 0 rad/s, 1000 ms);
+//        nm and relay need one that moves the wheels
+//    -p, -i, -d: comma separated gain lists for grid
+
 #include <stdio.h>
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <unistd.h>
 #include <fcntl.h>
 #include <termios.h>
+#include <time.h>
+#include <sys/select.h>
+#include "Sim/WheelPlant.h"
 
 using namespace std;
 
 const int commandPacketLength = 12;
 const char ACK = 'a';
+const double maxGain = 3.2767; // gains are sent * 10000 in an int16
+const int ackTimeout = 50; // ms
+const int maxListLength = 32;
+const int maxNelderMeadTrials = 80;
+const double unmeasuredCost = 1e9; // cost of a trial with no response to measure
 int serialFD;
 
-// opens serial connection 
+// opens serial connection
 void openSerial()
 {
 	serialFD = -1;
@@ -52,7 +90,7 @@ int transmit(char* commandPacket)
 	return result;
 }
 
-void makeCommandPacket(char* commandPacket, int16_t speed, int16_t time, 
+void makeCommandPacket(char* commandPacket, int16_t speed, int16_t time,
 						double angular, double kP, double kI, double kD)
 {
 	commandPacket[0] = (char)(speed & 0xFF);
@@ -73,33 +111,33 @@ void makeCommandPacket(char* commandPacket, int16_t speed, int16_t time,
 	commandPacket[11] = (char)((intKD >> 8) & 0xFF);
 }
 
-int receive()
+// waits up to timeoutMs for an ACK
+// returns 1 on ACK, 0 on timeout, -1 if select fails, -2 on any other byte
+int receive(int timeoutMs = ackTimeout)
 {
-	if (serialFD != 1)
+	if (serialFD == -1)
+		return -1;
+	fd_set set;
+	FD_ZERO(&set);
+	FD_SET(serialFD, &set);
+	struct timeval timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+	int selectResult = select(serialFD + 1, &set, NULL, NULL, &timeout);
+	if (selectResult < 0)
 	{
-		fd_set set;
-		FD_ZERO(&set);
-		FD_SET(serialFD, &set);
-		struct timeval timeout;
-		timeout.tv_sec = 0;
-		timeout.tv_usec = 50000; // timeout after 50ms
-		
-		int selectResult = select(serialFD + 1, &set, NULL, NULL, &timeout);
-		if (selectResult < 0)
-		{
-			return -1;
-		}
-		else if (selectResult == 0)
-		{
-			return 0;
-		}
-		else
-		{
-			char inChar;
-			read(serialFD, &inChar, 1);
-			if (inChar == ACK) return 1;
-			else return -2;
-		}
+		return -1;
+	}
+	else if (selectResult == 0)
+	{
+		return 0;
+	}
+	else
+	{
+		char inChar;
+		if (read(serialFD, &inChar, 1) == 1 && inChar == ACK) return 1;
+		else return -2;
 	}
 }
 
@@ -121,7 +159,7 @@ void getUserParams(int16_t& speed, int16_t& time, double& angular,
 	cout << endl;
 }
 
-int main()
+void manualTuning()
 {
 	openSerial();
 	while(true)
@@ -138,4 +176,382 @@ int main()
 		else if (ack == -1) cerr << "select attempt failed" << endl;
 		else if (ack == -2) cerr << "incorrect ACK received" << endl;
 	}
-}
\ No newline at end of file
+}
+
+double monotonicMs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+struct TrialResult
+{
+	int ack; // as returned by receive, always 1 for the simulated plant
+	double ackGap; // ms since the previous trial's ACK, -1 for the first
+	bool measured; // metrics are valid
+	TrialMetrics metrics;
+};
+
+// what the tuner minimizes: error integrated over the trial plus overshoot
+double trialCost(const TrialMetrics& metrics)
+{
+	return metrics.iae + metrics.overshoot;
+}
+
+// runs trials on the robot or on the simulated plant
+// next is the trial that will follow, if it's known yet, so it can be
+// queued when queue is set
+class TrialRunner
+{
+public:
+	TrialRunner(WheelPlant* plant, bool queue)
+		: plant_(plant), queue_(queue), queued_(false), lastAck_(-1.0) {}
+
+	void run(const PidTrial& trial, const PidTrial* next, TrialResult* result)
+	{
+		result->ackGap = -1.0;
+		if (plant_ != NULL)
+		{
+			result->ack = 1;
+			result->measured = plant_->runTrial(trial, &result->metrics);
+			return;
+		}
+		// a queued packet is acknowledged once the trial ahead of it ends
+		int timeout = ackTimeout;
+		if (queued_)
+			timeout += previousTime_;
+		else
+			send(trial);
+		result->ack = receive(timeout);
+		result->measured = false;
+		double now = monotonicMs();
+		if (result->ack == 1)
+		{
+			if (lastAck_ >= 0.0)
+				result->ackGap = now - lastAck_;
+			lastAck_ = now;
+		}
+		queued_ = false;
+		if (queue_ && next != NULL && result->ack == 1)
+		{
+			send(*next);
+			queued_ = true;
+			previousTime_ = trial.time;
+		}
+		else
+			usleep(trial.time * 1000); // let the trial finish before the next is sent
+	}
+
+private:
+	WheelPlant* plant_; // NULL to use the serial port
+	bool queue_; // send the next trial's packet while the current one runs
+	bool queued_; // the next trial's packet has been sent
+	int previousTime_; // ms, length of the trial running when the packet was queued
+	double lastAck_;
+
+	void send(const PidTrial& trial)
+	{
+		char commandPacket[commandPacketLength];
+		makeCommandPacket(commandPacket, trial.speed, trial.time, trial.angular,
+		                  trial.kP, trial.kI, trial.kD);
+		transmit(commandPacket);
+	}
+};
+
+FILE* logFile;
+int trialNumber = 0;
+
+void logTrial(const PidTrial& trial, const TrialResult& result)
+{
+	trialNumber++;
+	fprintf(logFile, "%d,%.4f,%.4f,%.4f,%d,%.1f", trialNumber, trial.kP, trial.kI,
+	        trial.kD, result.ack, result.ackGap);
+	if (result.measured)
+	{
+		const TrialMetrics& m = result.metrics;
+		fprintf(logFile, ",%.3f,%.4f,%.3f,%.2f,%.4f,%.4f\n", m.riseTime, m.overshoot,
+		        m.settlingTime, m.steadyError, m.iae, trialCost(m));
+	}
+	else
+		fprintf(logFile, ",,,,,,\n");
+	fflush(logFile);
+}
+
+double clampGain(double gain)
+{
+	return fmax(0.0, fmin(maxGain, gain));
+}
+
+PidTrial makeTrial(const PidTrial& command, double kP, double kI, double kD)
+{
+	PidTrial trial = command;
+	trial.kP = clampGain(kP);
+	trial.kI = clampGain(kI);
+	trial.kD = clampGain(kD);
+	return trial;
+}
+
+// parses a comma separated list, returns the number of values
+int parseList(const char* text, double* values)
+{
+	int count = 0;
+	char* end;
+	while (count < maxListLength)
+	{
+		values[count++] = strtod(text, &end);
+		if (*end != ',')
+			break;
+		text = end + 1;
+	}
+	return count;
+}
+
+void gridSchedule(TrialRunner* runner, const PidTrial& command, const double* kPs, int numKP,
+                  const double* kIs, int numKI, const double* kDs, int numKD)
+{
+	int numTrials = numKP * numKI * numKD;
+	PidTrial* trials = new PidTrial[numTrials];
+	int n = 0;
+	for (int p = 0; p < numKP; p++)
+		for (int i = 0; i < numKI; i++)
+			for (int d = 0; d < numKD; d++)
+				trials[n++] = makeTrial(command, kPs[p], kIs[i], kDs[d]);
+	int best = -1;
+	double bestCost = 0.0;
+	for (int t = 0; t < numTrials; t++)
+	{
+		TrialResult result;
+		runner->run(trials[t], (t + 1 < numTrials) ? &trials[t + 1] : NULL, &result);
+		logTrial(trials[t], result);
+		if (result.measured && (best < 0 || trialCost(result.metrics) < bestCost))
+		{
+			best = t;
+			bestCost = trialCost(result.metrics);
+		}
+	}
+	if (best >= 0)
+		fprintf(stderr, "best: kP %.4f kI %.4f kD %.4f cost %.4f\n",
+		        trials[best].kP, trials[best].kI, trials[best].kD, bestCost);
+	delete [] trials;
+}
+
+double evaluate(TrialRunner* runner, const PidTrial& command, const double* gains)
+{
+	PidTrial trial = makeTrial(command, gains[0], gains[1], gains[2]);
+	TrialResult result;
+	runner->run(trial, NULL, &result);
+	logTrial(trial, result);
+	if (!result.measured)
+		return unmeasuredCost;
+	return trialCost(result.metrics);
+}
+
+// Nelder-Mead over (kP, kI, kD) with the usual coefficients (reflection
+// 1, expansion 2, contraction 0.5, shrink 0.5); each point costs a trial
+void nelderMead(TrialRunner* runner, const PidTrial& command)
+{
+	const double start[3] = {1.0, 0.05, 0.2};
+	const double steps[3] = {0.5, 0.05, 0.3};
+	double simplex[4][3];
+	double costs[4];
+	for (int v = 0; v < 4; v++)
+	{
+		for (int j = 0; j < 3; j++)
+			simplex[v][j] = start[j] + ((v == j + 1) ? steps[j] : 0.0);
+		costs[v] = evaluate(runner, command, simplex[v]);
+	}
+	int trials = 4;
+	while (trials < maxNelderMeadTrials)
+	{
+		// order vertices best to worst
+		for (int a = 0; a < 4; a++)
+			for (int b = a + 1; b < 4; b++)
+				if (costs[b] < costs[a])
+				{
+					swap(costs[a], costs[b]);
+					for (int j = 0; j < 3; j++)
+						swap(simplex[a][j], simplex[b][j]);
+				}
+		if (costs[3] - costs[0] < 1e-4)
+			break;
+		double centroid[3], reflected[3], trial[3];
+		for (int j = 0; j < 3; j++)
+		{
+			centroid[j] = (simplex[0][j] + simplex[1][j] + simplex[2][j]) / 3.0;
+			reflected[j] = clampGain(centroid[j] + (centroid[j] - simplex[3][j]));
+		}
+		double reflectedCost = evaluate(runner, command, reflected);
+		trials++;
+		if (reflectedCost < costs[0])
+		{
+			for (int j = 0; j < 3; j++)
+				trial[j] = clampGain(centroid[j] + 2.0 * (centroid[j] - simplex[3][j]));
+			double expandedCost = evaluate(runner, command, trial);
+			trials++;
+			bool expand = expandedCost < reflectedCost;
+			for (int j = 0; j < 3; j++)
+				simplex[3][j] = expand ? trial[j] : reflected[j];
+			costs[3] = expand ? expandedCost : reflectedCost;
+			continue;
+		}
+		if (reflectedCost < costs[2])
+		{
+			for (int j = 0; j < 3; j++)
+				simplex[3][j] = reflected[j];
+			costs[3] = reflectedCost;
+			continue;
+		}
+		for (int j = 0; j < 3; j++)
+			trial[j] = centroid[j] + 0.5 * (simplex[3][j] - centroid[j]);
+		double contractedCost = evaluate(runner, command, trial);
+		trials++;
+		if (contractedCost < costs[3])
+		{
+			for (int j = 0; j < 3; j++)
+				simplex[3][j] = trial[j];
+			costs[3] = contractedCost;
+			continue;
+		}
+		for (int v = 1; v < 4; v++)
+		{
+			for (int j = 0; j < 3; j++)
+				simplex[v][j] = simplex[0][j] + 0.5 * (simplex[v][j] - simplex[0][j]);
+			costs[v] = evaluate(runner, command, simplex[v]);
+			trials++;
+		}
+	}
+	int best = 0;
+	for (int v = 1; v < 4; v++)
+		if (costs[v] < costs[best])
+			best = v;
+	if (costs[best] >= unmeasuredCost)
+	{
+		fprintf(stderr, "no trial had a response to measure after %d trials\n", trials);
+		return;
+	}
+	fprintf(stderr, "best after %d trials: kP %.4f kI %.4f kD %.4f cost %.4f\n", trials,
+	        simplex[best][0], simplex[best][1], simplex[best][2], costs[best]);
+}
+
+// Ziegler-Nichols from the relay experiment's ultimate gain and period,
+// converted to the per loop integral and derivative the firmware uses
+void relayTune(TrialRunner* runner, WheelPlant* plant, const PidTrial& command)
+{
+	double ultimateGain, ultimatePeriod;
+	double setSpeed = (command.speed != 0) ? fabs((double)command.speed) : 50.0;
+	if (!plant->relayTest(setSpeed, 60.0, 20.0, &ultimateGain, &ultimatePeriod))
+	{
+		fprintf(stderr, "relay experiment didn't settle into an oscillation\n");
+		return;
+	}
+	double dt = plant->getConfig().loopPeriod;
+	double kP = 0.6 * ultimateGain;
+	double kI = 1.2 * ultimateGain * dt / ultimatePeriod;
+	double kD = 0.075 * ultimateGain * ultimatePeriod / dt;
+	fprintf(stderr, "ultimate gain %.3f, period %.3f s: kP %.4f kI %.4f kD %.4f\n",
+	        ultimateGain, ultimatePeriod, kP, kI, kD);
+	PidTrial trial = makeTrial(command, kP, kI, kD);
+	TrialResult result;
+	runner->run(trial, NULL, &result);
+	logTrial(trial, result);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		manualTuning();
+		return 0;
+	}
+	const char* mode = NULL;
+	bool simulate = false;
+	bool queue = false;
+	PidTrial command;
+	command.speed = 50;
+	command.angular = 0.0;
+	command.time = 1000;
+	command.kP = command.kI = command.kD = 0.0;
+	double kPs[maxListLength] = {0.5, 1.0, 1.5, 2.0, 2.5, 3.0};
+	double kIs[maxListLength] = {0.0, 0.1, 0.3, 0.6};
+	double kDs[maxListLength] = {0.0, 0.5, 1.0};
+	int numKP = 6, numKI = 4, numKD = 3;
+	logFile = stdout;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (strcmp(argv[arg], "-s") == 0)
+			simulate = true;
+		else if (strcmp(argv[arg], "-q") == 0)
+			queue = true;
+		else if (arg + 1 < argc && strcmp(argv[arg], "-a") == 0)
+			mode = argv[++arg];
+		else if (arg + 3 < argc && strcmp(argv[arg], "-t") == 0)
+		{
+			command.speed = atoi(argv[arg + 1]);
+			command.angular = atof(argv[arg + 2]);
+			command.time = atoi(argv[arg + 3]);
+			arg += 3;
+		}
+		else if (arg + 1 < argc && strcmp(argv[arg], "-p") == 0)
+			numKP = parseList(argv[++arg], kPs);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-i") == 0)
+			numKI = parseList(argv[++arg], kIs);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-d") == 0)
+			numKD = parseList(argv[++arg], kDs);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-l") == 0)
+		{
+			logFile = fopen(argv[++arg], "w");
+			if (logFile == NULL)
+			{
+				cerr << "unable to open " << argv[arg] << endl;
+				return 1;
+			}
+		}
+		else
+		{
+			mode = NULL;
+			break;
+		}
+	}
+	if (mode == NULL || (strcmp(mode, "grid") != 0 && strcmp(mode, "nm") != 0
+	                     && strcmp(mode, "relay") != 0))
+	{
+		cerr << "usage: PID_tune -a grid|nm|relay [-s] [-q] [-t speed angular timeMs]" << endl
+		     << "                [-p kPs] [-i kIs] [-d kDs] [-l logFile]" << endl;
+		return 1;
+	}
+	if (!simulate && strcmp(mode, "grid") != 0)
+	{
+		cerr << mode << " needs the wheel response, which PID_tune.ino doesn't report; "
+		     << "use -s" << endl;
+		return 1;
+	}
+	bool moves = (command.speed != 0 || command.angular != 0.0) && command.time > 0;
+	if (strcmp(mode, "grid") != 0 && !moves)
+	{
+		cerr << mode << " needs a command that moves the wheels; "
+		     << "-t speed and angular can't both be 0, and timeMs must be positive" << endl;
+		return 1;
+	}
+
+	WheelPlant* plant = NULL;
+	if (simulate)
+		plant = new WheelPlant(defaultWheelPlantConfig(), 1);
+	else
+		openSerial();
+	TrialRunner runner(plant, queue);
+	fprintf(logFile, "trial,kP,kI,kD,ack,ackGapMs,riseTime,overshoot,settlingTime,"
+	        "steadyError,iae,cost\n");
+	double start = monotonicMs();
+	if (strcmp(mode, "grid") == 0)
+		gridSchedule(&runner, command, kPs, numKP, kIs, numKI, kDs, numKD);
+	else if (strcmp(mode, "nm") == 0)
+		nelderMead(&runner, command);
+	else
+		relayTune(&runner, plant, command);
+	fprintf(stderr, "%d trials in %.1f s\n", trialNumber, (monotonicMs() - start) / 1e3);
+	if (logFile != stdout)
+		fclose(logFile);
+	delete plant;
+	return 0;
+}
@@ -0,0 +1,143 @@
+// PipelineStage.cpp
+// 10/18/2026
+
+// Base class for one stage of a multi-threaded processing pipeline
+// See PipelineStage.h for usage
+
+#include "PipelineStage.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+
+using namespace std;
+
+bool pinThreadToCpu(pthread_t thread, int cpu)
+{
+	if (cpu < 0 || cpu >= CPU_SETSIZE || cpu >= sysconf(_SC_NPROCESSORS_CONF))
+		return false;
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+}
+
+int64_t monotonicNanos()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+PipelineStage::PipelineStage(const char* name, int cpu)
+{
+	name_ = name;
+	cpu_ = cpu;
+	running_.store(false);
+	items_.store(0);
+	stalls_.store(0);
+	busyNanos_.store(0);
+	startNanos_ = 0;
+	idleSleep_ = 200;
+	realTime_ = defaultRealTimeConfig();
+}
+
+PipelineStage::~PipelineStage()
+{
+	stop();
+}
+
+void PipelineStage::setRealTime(const RealTimeConfig& config)
+{
+	realTime_ = config;
+	if (realTime_.cpu < 0)
+		realTime_.cpu = cpu_;
+}
+
+bool PipelineStage::start()
+{
+	if (running_.load())
+		return true;
+	running_.store(true);
+	startNanos_ = monotonicNanos();
+	if (pthread_create(&thread_, NULL, threadFunction, this) != 0)
+	{
+		cerr << name_ << ": unable to create stage thread" << endl;
+		running_.store(false);
+		return false;
+	}
+	if (cpu_ >= 0 && !pinThreadToCpu(thread_, cpu_))
+		cerr << name_ << ": unable to pin stage to cpu " << cpu_ << endl;
+	return true;
+}
+
+void PipelineStage::stop()
+{
+	if (!running_.exchange(false))
+		return;
+	pthread_join(thread_, NULL);
+}
+
+void PipelineStage::getStats(StageStats* stats)
+{
+	stats->items = items_.load(memory_order_relaxed);
+	stats->stalls = stalls_.load(memory_order_relaxed);
+	stats->busyNanos = busyNanos_.load(memory_order_relaxed);
+	stats->runNanos = (startNanos_ == 0) ? 0 : monotonicNanos() - startNanos_;
+}
+
+void PipelineStage::printStats()
+{
+	StageStats stats;
+	getStats(&stats);
+	double seconds = (double)stats.runNanos / 1e9;
+	double throughput = (seconds > 0.0) ? (double)stats.items / seconds : 0.0;
+	double serviceUs = (stats.items > 0) ?
+		(double)stats.busyNanos / (double)stats.items / 1000.0 : 0.0;
+	printf("%-12s cpu %2d  %8llu items  %8.2f items/s  %8.2f us/item  %6llu stalls\n",
+	       name_, cpu_, (unsigned long long)stats.items, throughput, serviceUs,
+	       (unsigned long long)stats.stalls);
+}
+
+const char* PipelineStage::getName()
+{
+	return name_;
+}
+
+bool PipelineStage::isRunning()
+{
+	return running_.load(memory_order_relaxed);
+}
+
+void* PipelineStage::threadFunction(void* stage)
+{
+	((PipelineStage*)stage)->run();
+	return NULL;
+}
+
+// polls process() until stopped
+// spins briefly when idle so a new item is picked up quickly, then sleeps
+// so an idle stage doesn't burn its core
+void PipelineStage::run()
+{
+	if (realTime_.enabled)
+		enterRealTime(name_, realTime_);
+	int idlePolls = 0;
+	while (isRunning())
+	{
+		int64_t begin = monotonicNanos();
+		if (process())
+		{
+			busyNanos_.fetch_add(monotonicNanos() - begin, memory_order_relaxed);
+			items_.fetch_add(1, memory_order_relaxed);
+			idlePolls = 0;
+		}
+		else if (++idlePolls < 64)
+		{
+			sched_yield();
+		}
+		else
+		{
+			usleep(idleSleep_);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+// PipelineStage.h
+// 10/18/2026
+
+// Base class for one stage of a multi-threaded processing pipeline
+// Each stage runs process() in its own pthread, optionally pinned to a
+// single CPU core, and is connected to its neighbours by SpscQueues
+
+// Subclasses implement process(), which should handle at most one input
+// item and return false if there was nothing to do
+// pushOutput() waits while the downstream queue is full, so a slow stage
+// applies back-pressure to the stages ahead of it; the number of times a
+// stage had to wait is reported in its stats
+// setRealTime opts the stage's thread into real-time scheduling, see
+// RealTime.h; the stage's cpu is used if the config doesn't name one
+
+#ifndef PIPELINESTAGE_H
+#define PIPELINESTAGE_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include "SpscQueue.h"
+#include "../RealTime/RealTime.h"
+
+// pins the given thread to a single cpu
+// returns false if the cpu doesn't exist or the call fails
+bool pinThreadToCpu(pthread_t thread, int cpu);
+
+// current value of the monotonic clock in nanoseconds
+int64_t monotonicNanos();
+
+struct StageStats
+{
+	uint64_t items; // number of items processed
+	uint64_t stalls; // number of times the output queue was full
+	int64_t busyNanos; // time spent in calls to process() that did work
+	int64_t runNanos; // time since the stage was started
+};
+
+class PipelineStage
+{
+public:
+	PipelineStage(const char* name, int cpu); // cpu < 0 leaves the thread unpinned
+	virtual ~PipelineStage();
+	void setRealTime(const RealTimeConfig& config); // must be called before start
+	bool start(); // launches the stage's thread
+	void stop(); // signals the thread to exit and joins it
+	void getStats(StageStats* stats);
+	void printStats(); // prints throughput, service time and stalls to stdout
+	const char* getName();
+
+protected:
+	virtual bool process() = 0; // handles one item, returns false if idle
+	bool isRunning();
+
+	// pushes item to queue, waiting while the queue is full
+	// returns false if the stage was stopped while waiting
+	template <typename T>
+	bool pushOutput(SpscQueue<T>* queue, const T& item)
+	{
+		if (queue->tryPush(item))
+			return true;
+		stalls_.fetch_add(1, std::memory_order_relaxed);
+		while (!queue->tryPush(item))
+		{
+			if (!isRunning())
+				return false;
+			sched_yield();
+		}
+		return true;
+	}
+
+private:
+	const char* name_;
+	int cpu_;
+	pthread_t thread_;
+	std::atomic<bool> running_;
+	std::atomic<uint64_t> items_;
+	std::atomic<uint64_t> stalls_;
+	std::atomic<int64_t> busyNanos_;
+	int64_t startNanos_;
+	int idleSleep_; // microseconds to sleep after a run of idle polls
+	RealTimeConfig realTime_;
+
+	static void* threadFunction(void* stage);
+	void run();
+};
+
+#endif
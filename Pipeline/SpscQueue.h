@@ -0,0 +1,108 @@
+// SpscQueue.h
+// 10/18/2026
+
+// Bounded lock-free queue connecting exactly one producer thread to exactly
+// one consumer thread
+// Used to pass messages between the stages of a processing pipeline
+
+// Capacity is rounded up to a power of two so ring indices can be masked
+// Head and tail live on separate cache lines so the producer and consumer
+// don't contend for the same line, and each side keeps a cached copy of
+// the other side's index so it only touches the shared line when it has to
+
+// tryPush fails when the queue is full and tryPop fails when it is empty
+// Callers decide whether to wait (back-pressure) or drop the item
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+template <typename T>
+class SpscQueue
+{
+public:
+	SpscQueue(size_t capacity);
+	~SpscQueue();
+	bool tryPush(const T& item); // called by producer only
+	bool tryPop(T& item); // called by consumer only
+	size_t size() const; // approximate number of queued items
+	size_t capacity() const;
+
+private:
+	T* buffer_;
+	size_t mask_;
+	alignas(64) std::atomic<size_t> head_; // next slot to read, owned by consumer
+	size_t cachedTail_; // consumer's last view of tail_
+	alignas(64) std::atomic<size_t> tail_; // next slot to write, owned by producer
+	size_t cachedHead_; // producer's last view of head_
+
+	SpscQueue(const SpscQueue&); // not copyable
+	SpscQueue& operator=(const SpscQueue&);
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	buffer_ = new T[size];
+	mask_ = size - 1;
+	head_.store(0, std::memory_order_relaxed);
+	tail_.store(0, std::memory_order_relaxed);
+	cachedHead_ = 0;
+	cachedTail_ = 0;
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue()
+{
+	delete[] buffer_;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(const T& item)
+{
+	size_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - cachedHead_ > mask_)
+	{
+		cachedHead_ = head_.load(std::memory_order_acquire);
+		if (tail - cachedHead_ > mask_)
+			return false;
+	}
+	buffer_[tail & mask_] = item;
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPop(T& item)
+{
+	size_t head = head_.load(std::memory_order_relaxed);
+	if (head == cachedTail_)
+	{
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+		if (head == cachedTail_)
+			return false;
+	}
+	item = buffer_[head & mask_];
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+size_t SpscQueue<T>::size() const
+{
+	return tail_.load(std::memory_order_acquire)
+	       - head_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+size_t SpscQueue<T>::capacity() const
+{
+	return mask_ + 1;
+}
+
+#endif
@@ -0,0 +1,423 @@
+// DStarLite.cpp
+// 10/18/2026
+
+// Incremental shortest path planner on a grid
+// See DStarLite.h for a description of the planner and its storage
+
+#include "DStarLite.h"
+#include <math.h>
+#include <stdlib.h>
+
+const int32_t unreachable = 1 << 30; // costs saturate here
+const int32_t straightCost = 1000;
+const int32_t diagonalCost = 1414;
+const int numNeighbours = 8;
+const int neighbourX[numNeighbours] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int neighbourY[numNeighbours] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+DStarLite::DStarLite(int width, int height, int inflation)
+{
+	width_ = width;
+	height_ = height;
+	inflation_ = inflation;
+	nodes_ = new Node[width * height];
+	heap_ = new HeapEntry[width * height];
+	for (int i = 0; i < width * height; i++)
+	{
+		nodes_[i].g = unreachable;
+		nodes_[i].rhs = unreachable;
+		nodes_[i].heapIndex = -1;
+		nodes_[i].blockers = 0;
+		nodes_[i].occupied = 0;
+		nodes_[i].padding = 0;
+	}
+	heapSize_ = 0;
+	start_ = 0;
+	lastStart_ = 0;
+	goal_ = 0;
+	km_ = 0;
+	searching_ = false;
+	expansions_ = 0;
+}
+
+DStarLite::~DStarLite()
+{
+	delete [] nodes_;
+	delete [] heap_;
+}
+
+int DStarLite::getWidth()
+{
+	return width_;
+}
+
+int DStarLite::getHeight()
+{
+	return height_;
+}
+
+void DStarLite::setOccupied(int x, int y, bool occupied)
+{
+	Node& node = nodes_[y * width_ + x];
+	if ((node.occupied != 0) == occupied)
+		return;
+	node.occupied = occupied ? 1 : 0;
+	int change = occupied ? 1 : -1;
+	for (int dy = -inflation_; dy <= inflation_; dy++)
+	{
+		int cy = y + dy;
+		if (cy < 0 || cy >= height_)
+			continue;
+		for (int dx = -inflation_; dx <= inflation_; dx++)
+		{
+			int cx = x + dx;
+			if (cx < 0 || cx >= width_ || dx * dx + dy * dy > inflation_ * inflation_)
+				continue;
+			int index = cy * width_ + cx;
+			nodes_[index].blockers += change;
+			// only a cell going from free to blocked or back changes edges
+			bool flipped = occupied ? (nodes_[index].blockers == 1) : (nodes_[index].blockers == 0);
+			if (flipped && searching_ && index != y * width_ + x)
+				cellChanged(index);
+		}
+	}
+	// the cell itself always changes, it may have been blocked already
+	if (searching_)
+		cellChanged(y * width_ + x);
+}
+
+bool DStarLite::isOccupied(int x, int y)
+{
+	return nodes_[y * width_ + x].occupied != 0;
+}
+
+bool DStarLite::isBlocked(int x, int y)
+{
+	return nodes_[y * width_ + x].blockers > 0;
+}
+
+void DStarLite::setGoal(int x, int y)
+{
+	for (int i = 0; i < width_ * height_; i++)
+	{
+		nodes_[i].g = unreachable;
+		nodes_[i].rhs = unreachable;
+		nodes_[i].heapIndex = -1;
+	}
+	heapSize_ = 0;
+	km_ = 0;
+	lastStart_ = start_;
+	goal_ = y * width_ + x;
+	nodes_[goal_].rhs = 0;
+	int32_t k1, k2;
+	calculateKey(goal_, &k1, &k2);
+	heapPush(goal_, k1, k2);
+	searching_ = true;
+}
+
+void DStarLite::setStart(int x, int y)
+{
+	start_ = y * width_ + x;
+	// keys already in the open list were computed from the old start;
+	// raising km keeps them lower bounds instead of re-keying them all
+	if (searching_)
+	{
+		km_ += heuristic(lastStart_, start_);
+		lastStart_ = start_;
+	}
+}
+
+bool DStarLite::computePath()
+{
+	expansions_ = 0;
+	if (!searching_)
+		return false;
+	while (heapSize_ > 0)
+	{
+		HeapEntry top = heap_[0];
+		HeapEntry startKey;
+		calculateKey(start_, &startKey.k1, &startKey.k2);
+		if (!keyLess(top, startKey) && nodes_[start_].rhs == nodes_[start_].g)
+			break;
+		int u = top.node;
+		HeapEntry newKey;
+		calculateKey(u, &newKey.k1, &newKey.k2);
+		expansions_++;
+		if (keyLess(top, newKey))
+		{
+			heapUpdate(u, newKey.k1, newKey.k2);
+			continue;
+		}
+		int x = u % width_;
+		int y = u / width_;
+		if (nodes_[u].g > nodes_[u].rhs)
+		{
+			nodes_[u].g = nodes_[u].rhs;
+			heapRemove(u);
+		}
+		else
+		{
+			nodes_[u].g = unreachable;
+			updateVertex(u);
+		}
+		for (int i = 0; i < numNeighbours; i++)
+		{
+			int nx = x + neighbourX[i];
+			int ny = y + neighbourY[i];
+			if (nx >= 0 && nx < width_ && ny >= 0 && ny < height_)
+				updateVertex(ny * width_ + nx);
+		}
+	}
+	return nodes_[start_].g < unreachable;
+}
+
+int DStarLite::getPath(int* xs, int* ys, int maxCells)
+{
+	if (!searching_ || nodes_[start_].g >= unreachable || maxCells < 1)
+		return 0;
+	int current = start_;
+	int count = 0;
+	xs[count] = current % width_;
+	ys[count] = current / width_;
+	count++;
+	while (current != goal_ && count < maxCells)
+	{
+		int32_t total;
+		current = bestSuccessor(current, &total);
+		if (current < 0 || total >= unreachable)
+			return 0;
+		xs[count] = current % width_;
+		ys[count] = current / width_;
+		count++;
+	}
+	return count;
+}
+
+int DStarLite::getWaypoints(int* xs, int* ys, int maxWaypoints)
+{
+	int count = 0;
+	if (!searching_ || nodes_[start_].g >= unreachable)
+		return 0;
+	int current = start_;
+	int lastDx = 0, lastDy = 0;
+	while (current != goal_ && count < maxWaypoints)
+	{
+		int32_t total;
+		int next = bestSuccessor(current, &total);
+		if (next < 0 || total >= unreachable)
+			return 0;
+		int dx = next % width_ - current % width_;
+		int dy = next / width_ - current / width_;
+		if ((dx != lastDx || dy != lastDy) && current != start_)
+		{
+			xs[count] = current % width_;
+			ys[count] = current / width_;
+			count++;
+		}
+		lastDx = dx;
+		lastDy = dy;
+		current = next;
+	}
+	if (current == goal_ && count < maxWaypoints)
+	{
+		xs[count] = goal_ % width_;
+		ys[count] = goal_ / width_;
+		count++;
+	}
+	return count;
+}
+
+float DStarLite::getPathCost()
+{
+	if (nodes_[start_].g >= unreachable)
+		return INFINITY;
+	return (float)nodes_[start_].g / straightCost;
+}
+
+int DStarLite::getExpansions()
+{
+	return expansions_;
+}
+
+// octile distance, exact on an empty 8 connected grid
+int32_t DStarLite::heuristic(int a, int b)
+{
+	int dx = abs(a % width_ - b % width_);
+	int dy = abs(a / width_ - b / width_);
+	int straight = (dx > dy) ? dx - dy : dy - dx;
+	int diagonal = (dx > dy) ? dy : dx;
+	return straightCost * straight + diagonalCost * diagonal;
+}
+
+// the cost of a move depends on the cell entered (and, diagonally, the
+// two cells whose corners it passes), never the cell left, so a robot
+// that has ended up on an occupied cell can still drive out
+int32_t DStarLite::cost(int a, int b)
+{
+	const Node& to = nodes_[b];
+	if (to.occupied)
+		return unreachable;
+	int32_t move = straightCost;
+	int ax = a % width_;
+	int ay = a / width_;
+	int bx = b % width_;
+	int by = b / width_;
+	if (ax != bx && ay != by)
+	{
+		if (nodes_[ay * width_ + bx].occupied || nodes_[by * width_ + ax].occupied)
+			return unreachable;
+		move = diagonalCost;
+	}
+	return (to.blockers > 0) ? move * inflationPenalty : move;
+}
+
+void DStarLite::calculateKey(int node, int32_t* k1, int32_t* k2)
+{
+	int32_t best = (nodes_[node].g < nodes_[node].rhs) ? nodes_[node].g : nodes_[node].rhs;
+	*k1 = (best >= unreachable) ? unreachable : best + heuristic(start_, node) + km_;
+	*k2 = best;
+}
+
+// returns the neighbour with the lowest cost plus g, and that total
+int DStarLite::bestSuccessor(int node, int32_t* total)
+{
+	int x = node % width_;
+	int y = node / width_;
+	int best = -1;
+	*total = unreachable;
+	for (int i = 0; i < numNeighbours; i++)
+	{
+		int nx = x + neighbourX[i];
+		int ny = y + neighbourY[i];
+		if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_)
+			continue;
+		int neighbour = ny * width_ + nx;
+		int32_t edge = cost(node, neighbour);
+		int32_t g = nodes_[neighbour].g;
+		if (edge >= unreachable || g >= unreachable)
+			continue;
+		int32_t value = edge + g;
+		if (value < *total)
+		{
+			*total = value;
+			best = neighbour;
+		}
+	}
+	return best;
+}
+
+void DStarLite::updateVertex(int node)
+{
+	if (node != goal_)
+	{
+		int32_t total;
+		bestSuccessor(node, &total);
+		nodes_[node].rhs = total;
+	}
+	bool inHeap = nodes_[node].heapIndex >= 0;
+	if (nodes_[node].g != nodes_[node].rhs)
+	{
+		int32_t k1, k2;
+		calculateKey(node, &k1, &k2);
+		if (inHeap)
+			heapUpdate(node, k1, k2);
+		else
+			heapPush(node, k1, k2);
+	}
+	else if (inHeap)
+	{
+		heapRemove(node);
+	}
+}
+
+// a cell became blocked or free: the edges into it and the diagonals
+// cutting its corners changed, and those all start at its neighbours
+void DStarLite::cellChanged(int node)
+{
+	int x = node % width_;
+	int y = node / width_;
+	updateVertex(node);
+	for (int i = 0; i < numNeighbours; i++)
+	{
+		int nx = x + neighbourX[i];
+		int ny = y + neighbourY[i];
+		if (nx >= 0 && nx < width_ && ny >= 0 && ny < height_)
+			updateVertex(ny * width_ + nx);
+	}
+}
+
+bool DStarLite::keyLess(const HeapEntry& a, const HeapEntry& b)
+{
+	return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+}
+
+void DStarLite::heapPush(int node, int32_t k1, int32_t k2)
+{
+	int index = heapSize_++;
+	heap_[index].k1 = k1;
+	heap_[index].k2 = k2;
+	heap_[index].node = node;
+	nodes_[node].heapIndex = index;
+	siftUp(index);
+}
+
+void DStarLite::heapRemove(int node)
+{
+	int index = nodes_[node].heapIndex;
+	nodes_[node].heapIndex = -1;
+	heapSize_--;
+	if (index == heapSize_)
+		return;
+	int moved = heap_[heapSize_].node;
+	heap_[index] = heap_[heapSize_];
+	nodes_[moved].heapIndex = index;
+	siftUp(index);
+	siftDown(nodes_[moved].heapIndex);
+}
+
+void DStarLite::heapUpdate(int node, int32_t k1, int32_t k2)
+{
+	int index = nodes_[node].heapIndex;
+	heap_[index].k1 = k1;
+	heap_[index].k2 = k2;
+	siftUp(index);
+	siftDown(nodes_[node].heapIndex);
+}
+
+void DStarLite::siftUp(int index)
+{
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (!keyLess(heap_[index], heap_[parent]))
+			break;
+		heapSwap(index, parent);
+		index = parent;
+	}
+}
+
+void DStarLite::siftDown(int index)
+{
+	while (true)
+	{
+		int left = 2 * index + 1;
+		if (left >= heapSize_)
+			break;
+		int smallest = left;
+		if (left + 1 < heapSize_ && keyLess(heap_[left + 1], heap_[left]))
+			smallest = left + 1;
+		if (!keyLess(heap_[smallest], heap_[index]))
+			break;
+		heapSwap(index, smallest);
+		index = smallest;
+	}
+}
+
+void DStarLite::heapSwap(int a, int b)
+{
+	HeapEntry swap = heap_[a];
+	heap_[a] = heap_[b];
+	heap_[b] = swap;
+	nodes_[heap_[a].node].heapIndex = a;
+	nodes_[heap_[b].node].heapIndex = b;
+}
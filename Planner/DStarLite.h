@@ -0,0 +1,117 @@
+// DStarLite.h
+// 10/18/2026
+
+// Incremental shortest path planner on a grid (D* Lite, Koenig and
+// Likhachev 2002)
+// Searches backwards from the goal, so as the robot moves and cells
+// change only the part of the search the changes touch is redone,
+// rather than replanning from scratch after every sonar update
+
+// Cells are marked occupied from an occupancy grid and can't be entered;
+// cells within inflation cells of an occupied one are blocked and cost
+// inflationPenalty times as much to enter, so paths keep the robot's
+// body clear of obstacles where there's room, and a robot that has
+// strayed inside the margin can still find its way out. Moves go to the
+// 8 neighbours, cost 1 straight and sqrt(2) diagonally, and may not cut
+// the corner of an occupied cell
+// Costs are integers in thousandths of a cell (1414 for a diagonal):
+// keys are sums of costs and the heuristic, and with floats rounding
+// could break a tie between keys the wrong way and end a repair early
+
+// All state lives in flat arrays allocated by the constructor:
+//    nodes: one packed 16 byte record per cell (g, rhs, heap position,
+//    and the occupancy counts), row major
+//    open list: a binary heap of (key, node) entries indexed by position,
+//    each node recording its own slot so keys can be changed or removed
+//    in place
+// Nothing is allocated while planning
+
+// Typical use, once per sensor update:
+//    setOccupied for cells that changed, setStart with the robot's cell,
+//    computePath, then getWaypoints
+
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+
+#include <stdint.h>
+
+const int inflationPenalty = 10;
+
+class DStarLite
+{
+public:
+	DStarLite(int width, int height, int inflation);
+	~DStarLite();
+	int getWidth();
+	int getHeight();
+
+	// marks a cell occupied or free and updates blocking around it
+	void setOccupied(int x, int y, bool occupied);
+	bool isOccupied(int x, int y);
+	bool isBlocked(int x, int y); // occupied or within inflation of one
+
+	// starts a new search toward the goal, forgetting the old one
+	void setGoal(int x, int y);
+	// moves the start, the search is kept
+	void setStart(int x, int y);
+	// brings the search up to date, returns false if no path exists
+	bool computePath();
+	// writes the cells from start to goal, returns the number written,
+	// 0 if there is no path
+	int getPath(int* xs, int* ys, int maxCells);
+	// like getPath, but only the cells where the path changes direction
+	// and the goal
+	int getWaypoints(int* xs, int* ys, int maxWaypoints);
+	float getPathCost(); // cost from start to goal, in cells
+	int getExpansions(); // nodes expanded by the last computePath
+
+private:
+	struct Node
+	{
+		int32_t g; // cost to goal found so far
+		int32_t rhs; // one step lookahead of g
+		int32_t heapIndex; // position in the open list, -1 if not in it
+		uint16_t blockers; // occupied cells within inflation
+		uint8_t occupied;
+		uint8_t padding;
+	};
+	struct HeapEntry
+	{
+		int32_t k1;
+		int32_t k2;
+		int32_t node;
+	};
+
+	int width_;
+	int height_;
+	int inflation_;
+	Node* nodes_;
+	HeapEntry* heap_;
+	int heapSize_;
+	int start_;
+	int lastStart_;
+	int goal_;
+	int32_t km_; // key offset accumulated as the start moves
+	bool searching_;
+	int expansions_;
+
+	int32_t heuristic(int a, int b);
+	int32_t cost(int a, int b); // edge cost between neighbouring nodes
+	void calculateKey(int node, int32_t* k1, int32_t* k2);
+	void updateVertex(int node);
+	void cellChanged(int node);
+	int bestSuccessor(int node, int32_t* total);
+
+	bool keyLess(const HeapEntry& a, const HeapEntry& b);
+	void heapPush(int node, int32_t k1, int32_t k2);
+	void heapRemove(int node);
+	void heapUpdate(int node, int32_t k1, int32_t k2);
+	void siftUp(int index);
+	void siftDown(int index);
+	void heapSwap(int a, int b);
+
+	DStarLite(const DStarLite&); // not copyable
+	DStarLite& operator=(const DStarLite&);
+};
+
+#endif
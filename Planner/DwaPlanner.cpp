@@ -0,0 +1,227 @@
+// DwaPlanner.cpp
+// 10/18/2026
+
+// Dynamic window approach local planner
+// See DwaPlanner.h for a description of the planning
+
+#include "DwaPlanner.h"
+#include <stdlib.h>
+#include <math.h>
+
+DwaConfig defaultDwaConfig()
+{
+	DwaConfig config;
+	config.maxTrans = 200.0;
+	config.maxAng = 2.0;
+	config.maxAccel = 100.0;
+	config.maxAngAccel = 4.0;
+	config.horizon = 1.5;
+	config.numSteps = 12;
+	config.numTrans = 16;
+	config.numAngular = 32;
+	config.robotRadius = 12.0;
+	config.clearanceCap = 30.0;
+	config.maxObstacles = 256;
+	config.clearanceWeight = 0.5;
+	config.speedWeight = 0.2;
+	config.trackingWeight = 2.0;
+	return config;
+}
+
+static inline v4f splat(float value)
+{
+	v4f result = {value, value, value, value};
+	return result;
+}
+
+// vector types need 16 byte alignment, which new doesn't promise for
+// over-aligned types before C++17
+static v4f* allocateLanes(int count)
+{
+	void* memory = NULL;
+	if (posix_memalign(&memory, sizeof(v4f), count * sizeof(v4f)) != 0)
+		abort();
+	return (v4f*)memory;
+}
+
+DwaPlanner::DwaPlanner(const DwaConfig& config)
+{
+	config_ = config;
+	numCandidates_ = config.numTrans * config.numAngular;
+	numGroups_ = (numCandidates_ + dwaLanes - 1) / dwaLanes;
+	trans_ = new float[numGroups_ * dwaLanes];
+	angular_ = new float[numGroups_ * dwaLanes];
+	pathX_ = allocateLanes(numGroups_ * config.numSteps);
+	pathY_ = allocateLanes(numGroups_ * config.numSteps);
+	minDistance_ = allocateLanes(numGroups_);
+	hitTime_ = allocateLanes(numGroups_);
+	obstacleX_ = new float[config.maxObstacles];
+	obstacleY_ = new float[config.maxObstacles];
+	numObstacles_ = 0;
+}
+
+DwaPlanner::~DwaPlanner()
+{
+	delete [] trans_;
+	delete [] angular_;
+	free(pathX_);
+	free(pathY_);
+	free(minDistance_);
+	free(hitTime_);
+	delete [] obstacleX_;
+	delete [] obstacleY_;
+}
+
+void DwaPlanner::setObstacles(Point* points, int numPoints)
+{
+	numObstacles_ = (numPoints < config_.maxObstacles) ? numPoints : config_.maxObstacles;
+	for (int i = 0; i < numObstacles_; i++)
+	{
+		obstacleX_[i] = (float)points[i].getX();
+		obstacleY_[i] = (float)points[i].getY();
+	}
+}
+
+// fills the candidate grid with speeds reachable within the period
+void DwaPlanner::sample(double currentTrans, double currentAng, double period)
+{
+	double transStep = config_.maxAccel * period;
+	double angStep = config_.maxAngAccel * period;
+	double minTrans = fmax(-config_.maxTrans, fmin(config_.maxTrans, currentTrans - transStep));
+	double maxTrans = fmin(config_.maxTrans, fmax(-config_.maxTrans, currentTrans + transStep));
+	double minAng = fmax(-config_.maxAng, fmin(config_.maxAng, currentAng - angStep));
+	double maxAng = fmin(config_.maxAng, fmax(-config_.maxAng, currentAng + angStep));
+	int c = 0;
+	for (int i = 0; i < config_.numTrans; i++)
+	{
+		double fraction = (config_.numTrans > 1) ? (double)i / (config_.numTrans - 1) : 0.5;
+		float trans = (float)(minTrans + fraction * (maxTrans - minTrans));
+		for (int j = 0; j < config_.numAngular; j++, c++)
+		{
+			fraction = (config_.numAngular > 1) ? (double)j / (config_.numAngular - 1) : 0.5;
+			trans_[c] = trans;
+			angular_[c] = (float)(minAng + fraction * (maxAng - minAng));
+		}
+	}
+	// pad the last group with copies, they're never chosen
+	for (; c < numGroups_ * dwaLanes; c++)
+	{
+		trans_[c] = trans_[0];
+		angular_[c] = angular_[0];
+	}
+}
+
+// positions along each candidate's arc at every step
+void DwaPlanner::simulate()
+{
+	int numSteps = config_.numSteps;
+	for (int c = 0; c < numGroups_ * dwaLanes; c++)
+	{
+		int group = c / dwaLanes;
+		int lane = c % dwaLanes;
+		double trans = trans_[c];
+		double angular = angular_[c];
+		for (int k = 0; k < numSteps; k++)
+		{
+			double t = (k + 1) * config_.horizon / numSteps;
+			double x, y;
+			if (fabs(angular) < 1e-4)
+			{
+				x = trans * t;
+				y = 0.0;
+			}
+			else
+			{
+				double radius = trans / angular;
+				x = radius * sin(angular * t);
+				y = radius * (1.0 - cos(angular * t));
+			}
+			pathX_[group * numSteps + k][lane] = (float)x;
+			pathY_[group * numSteps + k][lane] = (float)y;
+		}
+	}
+}
+
+// closest approach and first collision of every candidate, four at a time
+void DwaPlanner::checkClearance()
+{
+	int numSteps = config_.numSteps;
+	float radius = (float)config_.robotRadius;
+	v4f radius2 = splat(radius * radius);
+	v4f horizon = splat((float)config_.horizon);
+	v4f far = splat(1e12f);
+	for (int g = 0; g < numGroups_; g++)
+	{
+		v4f minDistance2 = far;
+		v4f hitTime = horizon;
+		for (int k = 0; k < numSteps; k++)
+		{
+			v4f x = pathX_[g * numSteps + k];
+			v4f y = pathY_[g * numSteps + k];
+			v4f stepMin = far;
+			for (int p = 0; p < numObstacles_; p++)
+			{
+				v4f dx = x - obstacleX_[p];
+				v4f dy = y - obstacleY_[p];
+				v4f distance2 = dx * dx + dy * dy;
+				stepMin = (distance2 < stepMin) ? distance2 : stepMin;
+			}
+			minDistance2 = (stepMin < minDistance2) ? stepMin : minDistance2;
+			v4f t = splat((float)((k + 1) * config_.horizon / numSteps));
+			hitTime = (stepMin < radius2 && hitTime >= horizon) ? t : hitTime;
+		}
+		minDistance_[g] = minDistance2;
+		hitTime_[g] = hitTime;
+	}
+}
+
+DwaCommand DwaPlanner::plan(double currentTrans, double currentAng,
+                            double preferredTrans, double preferredAng, double period)
+{
+	sample(currentTrans, currentAng, fmax(period, 0.0));
+	simulate();
+	checkClearance();
+
+	DwaCommand best;
+	best.translational = 0.0;
+	best.angular = 0.0;
+	best.clearance = 0.0;
+	best.score = -1e300;
+	best.valid = false;
+	double direction = (preferredTrans < 0.0) ? -1.0 : 1.0;
+	for (int c = 0; c < numCandidates_; c++)
+	{
+		int group = c / dwaLanes;
+		int lane = c % dwaLanes;
+		double trans = trans_[c];
+		double angular = angular_[c];
+
+		// a collision is only acceptable if it is farther than the
+		// distance needed to stop
+		double hitTime = hitTime_[group][lane];
+		if (hitTime < config_.horizon
+		    && fabs(trans) * hitTime < trans * trans / (2.0 * config_.maxAccel))
+			continue;
+
+		double clearance = sqrt(minDistance_[group][lane]) - config_.robotRadius;
+		clearance = fmax(0.0, fmin(config_.clearanceCap, clearance));
+		double score = config_.clearanceWeight * clearance / config_.clearanceCap
+		               + config_.speedWeight * direction * trans / config_.maxTrans
+		               - config_.trackingWeight * (fabs(trans - preferredTrans) / config_.maxTrans
+		                                           + fabs(angular - preferredAng) / config_.maxAng);
+		if (score > best.score)
+		{
+			best.translational = trans;
+			best.angular = angular;
+			best.clearance = clearance;
+			best.score = score;
+			best.valid = true;
+		}
+	}
+	return best;
+}
+
+int DwaPlanner::getNumCandidates()
+{
+	return numCandidates_;
+}
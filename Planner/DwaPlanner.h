@@ -0,0 +1,99 @@
+// DwaPlanner.h
+// 10/18/2026
+
+// Dynamic window approach local planner
+// Keeps Colin from driving into obstacles in front of it while staying as
+// close as it can to a preferred command, such as the one from the wall
+// following control law
+
+// Each plan samples a grid of (translational, angular) pairs inside the
+// dynamic window: the speeds reachable from the current command within
+// the period passed to plan, clipped to maxTrans and maxAng. The period is
+// the time from when the current command took effect to when the planned
+// one will, which varies when SerialBot adapts its rate. Every candidate is
+// driven along its arc for the planning horizon and checked against the
+// current sonar points (in Colin's local frame):
+//    a candidate that hits something before it could brake to a stop is
+//    rejected
+//    the rest are scored on clearance, speed, and how far they are from
+//    the preferred command
+// If no candidate is admissible the planner asks for a stop
+
+// Candidates are stored structure-of-arrays in 4 float lanes (one NEON
+// or SSE register) using GCC vector extensions, and the clearance loop
+// compares four candidates against each obstacle point at once; all
+// storage is allocated in the constructor
+
+#ifndef DWAPLANNER_H
+#define DWAPLANNER_H
+
+#include "../LineFitter/Point.h"
+
+typedef float v4f __attribute__((vector_size(16)));
+const int dwaLanes = 4;
+
+struct DwaConfig
+{
+	double maxTrans; // cm/s
+	double maxAng; // rad/s
+	double maxAccel; // cm/s^2, also the braking deceleration
+	double maxAngAccel; // rad/s^2
+	double horizon; // s, how far ahead each candidate is simulated
+	int numSteps; // points checked along each candidate's arc
+	int numTrans; // translational samples
+	int numAngular; // angular samples
+	double robotRadius; // cm
+	double clearanceCap; // cm, clearance beyond this scores no better
+	int maxObstacles;
+	double clearanceWeight;
+	double speedWeight;
+	double trackingWeight; // closeness to the preferred command
+};
+
+DwaConfig defaultDwaConfig();
+
+struct DwaCommand
+{
+	double translational;
+	double angular;
+	double clearance; // cm between Colin's edge and the nearest obstacle on the arc
+	double score;
+	bool valid; // false if nothing was admissible and the command is a stop
+};
+
+class DwaPlanner
+{
+public:
+	DwaPlanner(const DwaConfig& config);
+	~DwaPlanner();
+	// points in Colin's local frame, at most maxObstacles are used
+	void setObstacles(Point* points, int numPoints);
+	// current is the last command sent, preferred the command wanted;
+	// period is the seconds between when the two take effect
+	DwaCommand plan(double currentTrans, double currentAng,
+	                double preferredTrans, double preferredAng, double period);
+	int getNumCandidates();
+
+private:
+	DwaConfig config_;
+	int numCandidates_;
+	int numGroups_; // candidates / dwaLanes, rounded up
+	float* trans_; // per candidate
+	float* angular_;
+	v4f* pathX_; // per group and step: position along the arc
+	v4f* pathY_;
+	v4f* minDistance_; // per group: closest approach over the horizon
+	v4f* hitTime_; // per group: time of the first collision, or horizon
+	float* obstacleX_;
+	float* obstacleY_;
+	int numObstacles_;
+
+	void sample(double currentTrans, double currentAng, double period);
+	void simulate();
+	void checkClearance();
+
+	DwaPlanner(const DwaPlanner&); // not copyable
+	DwaPlanner& operator=(const DwaPlanner&);
+};
+
+#endif
@@ -0,0 +1,89 @@
+// WaypointTracker.cpp
+// 10/18/2026
+
+// Drives Colin through a list of world frame waypoints
+// See WaypointTracker.h for a description of the control law
+
+#include "WaypointTracker.h"
+
+WaypointTracker::WaypointTracker(int maxWaypoints, double maxTrans, double maxAng)
+{
+	maxWaypoints_ = maxWaypoints;
+	maxTrans_ = maxTrans;
+	maxAng_ = maxAng;
+	turnGain_ = 1.5;
+	tolerance_ = 10.0;
+	slowdownDistance_ = 50.0;
+	xs_ = new double[maxWaypoints];
+	ys_ = new double[maxWaypoints];
+	numWaypoints_ = 0;
+	current_ = 0;
+}
+
+WaypointTracker::~WaypointTracker()
+{
+	delete [] xs_;
+	delete [] ys_;
+}
+
+void WaypointTracker::setTurnGain(double turnGain)
+{
+	turnGain_ = turnGain;
+}
+
+void WaypointTracker::setTolerance(double tolerance)
+{
+	tolerance_ = tolerance;
+}
+
+void WaypointTracker::setSlowdownDistance(double distance)
+{
+	slowdownDistance_ = distance;
+}
+
+void WaypointTracker::setWaypoints(const double* xs, const double* ys, int numWaypoints)
+{
+	numWaypoints_ = (numWaypoints < maxWaypoints_) ? numWaypoints : maxWaypoints_;
+	for (int i = 0; i < numWaypoints_; i++)
+	{
+		xs_[i] = xs[i];
+		ys_[i] = ys[i];
+	}
+	current_ = 0;
+}
+
+TrackerCommand WaypointTracker::update(const Pose2D& pose)
+{
+	TrackerCommand command;
+	command.translational = 0.0;
+	command.angular = 0.0;
+	command.finished = true;
+	// skip past waypoints already within reach
+	while (current_ < numWaypoints_
+	       && hypot(xs_[current_] - pose.x, ys_[current_] - pose.y) < tolerance_)
+		current_++;
+	if (current_ >= numWaypoints_)
+		return command;
+	command.finished = false;
+
+	double dx = xs_[current_] - pose.x;
+	double dy = ys_[current_] - pose.y;
+	double error = normalizeAngle(atan2(dy, dx) - pose.theta);
+	command.angular = fmax(-maxAng_, fmin(maxAng_, turnGain_ * error));
+	// full speed when facing the waypoint, none when it's abeam or behind
+	double speed = maxTrans_ * fmax(0.0, cos(error));
+	if (current_ == numWaypoints_ - 1)
+		speed *= fmin(1.0, hypot(dx, dy) / slowdownDistance_);
+	command.translational = speed;
+	return command;
+}
+
+int WaypointTracker::getCurrentWaypoint()
+{
+	return current_;
+}
+
+int WaypointTracker::getNumWaypoints()
+{
+	return numWaypoints_;
+}
@@ -0,0 +1,53 @@
+// WaypointTracker.h
+// 10/18/2026
+
+// Drives Colin through a list of world frame waypoints, such as those
+// from DStarLite, producing speed commands for SerialBot::setSpeed
+// Steers toward the current waypoint in proportion to the heading error,
+// slowing as the error grows and turning in place when the waypoint is
+// behind; a waypoint counts as reached within the tolerance and the last
+// one is approached at decreasing speed
+
+#ifndef WAYPOINTTRACKER_H
+#define WAYPOINTTRACKER_H
+
+#include "../Geometry/Pose2D.h"
+
+struct TrackerCommand
+{
+	double translational; // cm/s
+	double angular; // rad/s
+	bool finished; // the last waypoint has been reached
+};
+
+class WaypointTracker
+{
+public:
+	WaypointTracker(int maxWaypoints, double maxTrans, double maxAng);
+	~WaypointTracker();
+	void setTurnGain(double turnGain); // rad/s per rad of heading error
+	void setTolerance(double tolerance); // cm
+	void setSlowdownDistance(double distance); // cm from the last waypoint
+	// replaces the waypoints, tracking restarts at the first one
+	void setWaypoints(const double* xs, const double* ys, int numWaypoints);
+	TrackerCommand update(const Pose2D& pose);
+	int getCurrentWaypoint();
+	int getNumWaypoints();
+
+private:
+	int maxWaypoints_;
+	double maxTrans_;
+	double maxAng_;
+	double turnGain_;
+	double tolerance_;
+	double slowdownDistance_;
+	double* xs_;
+	double* ys_;
+	int numWaypoints_;
+	int current_;
+
+	WaypointTracker(const WaypointTracker&); // not copyable
+	WaypointTracker& operator=(const WaypointTracker&);
+};
+
+#endif
@@ -0,0 +1,109 @@
+// PointAccumulator.cpp
+// 10/18/2026
+
+// Accumulates sonar points from many scans in a fixed world frame
+// See PointAccumulator.h for usage
+
+#include "PointAccumulator.h"
+
+PointAccumulator::PointAccumulator(int capacity, int64_t maxAge, double maxTravel)
+{
+	capacity_ = capacity;
+	maxAge_ = maxAge;
+	maxTravel_ = maxTravel;
+	x_ = new float[capacity_];
+	y_ = new float[capacity_];
+	confidence_ = new float[capacity_];
+	timestamp_ = new int64_t[capacity_];
+	travel_ = new double[capacity_];
+	clear();
+}
+
+PointAccumulator::~PointAccumulator()
+{
+	delete[] x_;
+	delete[] y_;
+	delete[] confidence_;
+	delete[] timestamp_;
+	delete[] travel_;
+}
+
+void PointAccumulator::clear()
+{
+	head_ = 0;
+	count_ = 0;
+	odometer_ = 0.0;
+	havePose_ = false;
+}
+
+void PointAccumulator::addScan(const Point* points, const float* confidence,
+                               int numPoints, const Pose2D& pose, int64_t timestamp)
+{
+	if (havePose_)
+	{
+		double dx = pose.x - lastPose_.x;
+		double dy = pose.y - lastPose_.y;
+		odometer_ += sqrt(dx * dx + dy * dy);
+	}
+	lastPose_ = pose;
+	havePose_ = true;
+
+	for (int i = 0; i < numPoints; i++)
+	{
+		Point point = points[i];
+		double worldX, worldY;
+		localToWorld(pose, point.getX(), point.getY(), &worldX, &worldY);
+		x_[head_] = (float)worldX;
+		y_[head_] = (float)worldY;
+		confidence_[head_] = (confidence != NULL) ? confidence[i] : 1.0f;
+		timestamp_[head_] = timestamp;
+		travel_[head_] = odometer_;
+		head_ = (head_ + 1 == capacity_) ? 0 : head_ + 1;
+		if (count_ < capacity_)
+			count_++;
+	}
+	expire(timestamp);
+}
+
+// points are stored in the order they were added, so the expired ones
+// are always the oldest and can be dropped from the tail of the ring
+void PointAccumulator::expire(int64_t now)
+{
+	while (count_ > 0)
+	{
+		int oldest = head_ - count_;
+		if (oldest < 0)
+			oldest += capacity_;
+		if (now - timestamp_[oldest] <= maxAge_
+		    && odometer_ - travel_[oldest] <= maxTravel_)
+			break;
+		count_--;
+	}
+}
+
+int PointAccumulator::getRobotFrame(const Pose2D& pose, Point* points,
+                                    float* confidence, int maxPoints)
+{
+	int n = (count_ < maxPoints) ? count_ : maxPoints;
+	int index = head_;
+	for (int i = 0; i < n; i++)
+	{
+		index = (index == 0) ? capacity_ - 1 : index - 1;
+		double localX, localY;
+		worldToLocal(pose, x_[index], y_[index], &localX, &localY);
+		points[i].setCartesian(localX, localY);
+		if (confidence != NULL)
+			confidence[i] = confidence_[index];
+	}
+	return n;
+}
+
+int PointAccumulator::getNumPoints()
+{
+	return count_;
+}
+
+int PointAccumulator::getCapacity()
+{
+	return capacity_;
+}
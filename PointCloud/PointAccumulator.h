@@ -0,0 +1,61 @@
+// PointAccumulator.h
+// 10/18/2026
+
+// Accumulates sonar points from many scans in a fixed world frame
+// Each scan is transformed into the world frame using the odometry pose
+// reported in the same sensor packet, so points from earlier scans stay
+// put as the robot moves
+
+// Points are kept in a fixed capacity ring buffer, stored as separate
+// arrays per field; once full, the oldest points are overwritten
+// Points also expire once they're older than maxAge or the robot has
+// driven more than maxTravel since they were seen, which bounds how much
+// odometry drift can build up between the oldest and newest points
+
+// getRobotFrame transforms every live point into the robot's current
+// local frame in one pass, ready to hand to LineFitter
+
+#ifndef POINTACCUMULATOR_H
+#define POINTACCUMULATOR_H
+
+#include <stdint.h>
+#include "../Geometry/Pose2D.h"
+#include "../LineFitter/Point.h"
+
+class PointAccumulator
+{
+public:
+	PointAccumulator(int capacity, int64_t maxAge, double maxTravel); // age in ns, travel in cm
+	~PointAccumulator();
+	void clear();
+	// adds points given in the robot's local frame at pose
+	// confidence may be NULL, in which case every point gets 1
+	void addScan(const Point* points, const float* confidence, int numPoints,
+	             const Pose2D& pose, int64_t timestamp);
+	void expire(int64_t now); // drops points past maxAge or maxTravel
+	// writes up to maxPoints live points, newest first, in pose's local frame
+	// returns the number of points written
+	int getRobotFrame(const Pose2D& pose, Point* points, float* confidence, int maxPoints);
+	int getNumPoints();
+	int getCapacity();
+
+private:
+	int capacity_;
+	int head_; // index the next point will be written to
+	int count_; // number of live points
+	int64_t maxAge_;
+	double maxTravel_;
+	double odometer_; // total distance driven so far in cm
+	bool havePose_;
+	Pose2D lastPose_;
+	float* x_; // world frame coordinates in cm
+	float* y_;
+	float* confidence_;
+	int64_t* timestamp_; // time the point was added in ns
+	double* travel_; // odometer_ when the point was added
+
+	PointAccumulator(const PointAccumulator&); // not copyable
+	PointAccumulator& operator=(const PointAccumulator&);
+};
+
+#endif
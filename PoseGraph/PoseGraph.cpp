@@ -0,0 +1,1022 @@
+// PoseGraph.cpp
+// 10/18/2026
+
+// Incremental pose graph solver, see PoseGraph.h
+// Blocks and fronts are row major arrays of doubles; block (a, b) of a
+// front of dimension dim starts at front[3a * dim + 3b]
+
+#include "PoseGraph.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+const double anchorSigma = 0.01; // cm and rad
+
+PoseGraphConfig defaultPoseGraphConfig()
+{
+	PoseGraphConfig config;
+	config.odometryNoise = 0.02;
+	config.odometryAngleNoise = 0.05;
+	config.odometryAnglePerCm = 0.001;
+	config.minTranslationSigma = 0.1;
+	config.minRotationSigma = 0.002;
+	config.wallDistanceSigma = 3.0;
+	config.wallAngleSigma = 0.05;
+	config.wallDistanceGate = 30.0;
+	config.wallAngleGate = 0.3;
+	config.wallRevisitPoses = 10;
+	config.relinearizeTranslation = 0.5;
+	config.relinearizeRotation = 0.005;
+	config.wildfireTranslation = 0.05;
+	config.wildfireRotation = 0.0002;
+	config.maxUpdateMB = 32.0;
+	return config;
+}
+
+// lower Cholesky factor of a symmetric positive definite 3x3 block
+static bool cholesky3(const double* a, double* l)
+{
+	memset(l, 0, 9 * sizeof(double));
+	for (int j = 0; j < 3; j++)
+	{
+		double sum = a[j * 3 + j];
+		for (int k = 0; k < j; k++)
+			sum -= l[j * 3 + k] * l[j * 3 + k];
+		if (sum <= 0.0)
+			return false;
+		l[j * 3 + j] = sqrt(sum);
+		for (int i = j + 1; i < 3; i++)
+		{
+			double value = a[i * 3 + j];
+			for (int k = 0; k < j; k++)
+				value -= l[i * 3 + k] * l[j * 3 + k];
+			l[i * 3 + j] = value / l[j * 3 + j];
+		}
+	}
+	return true;
+}
+
+// solves l x = b in place, l lower triangular
+static void forward3(const double* l, double* x)
+{
+	x[0] /= l[0];
+	x[1] = (x[1] - l[3] * x[0]) / l[4];
+	x[2] = (x[2] - l[6] * x[0] - l[7] * x[1]) / l[8];
+}
+
+// solves l^T x = b in place
+static void backward3(const double* l, double* x)
+{
+	x[2] /= l[8];
+	x[1] = (x[1] - l[7] * x[2]) / l[4];
+	x[0] = (x[0] - l[3] * x[1] - l[6] * x[2]) / l[0];
+}
+
+// adds block (transposed if asked) to the front at block (a, b)
+static void addBlock(double* front, int dim, int a, int b, const double* block, bool transpose)
+{
+	double* target = front + 3 * a * dim + 3 * b;
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			target[i * dim + j] += transpose ? block[j * 3 + i] : block[i * 3 + j];
+}
+
+static int compareInts(const void* a, const void* b)
+{
+	return *(const int*)a - *(const int*)b;
+}
+
+PoseGraph::PoseGraph(int maxPoses, int maxConstraints, const PoseGraphConfig& config)
+{
+	config_ = config;
+	maxPoses_ = maxPoses;
+	maxConstraints_ = maxConstraints;
+	numPoses_ = 0;
+	numConstraints_ = 0;
+	numWalls_ = 0;
+	firstNewPose_ = 0;
+	constrainedFrom_ = 0;
+	lastOdometry_ = makePose(0.0, 0.0, 0.0);
+	linPoint_ = new Pose2D[maxPoses];
+	delta_ = new double[3 * maxPoses];
+	firstConstraint_ = new int[maxPoses];
+	columns_ = new Column[maxPoses];
+	constraints_ = new Constraint[maxConstraints];
+	walls_ = new Wall[maxGraphWalls];
+	dirty_ = new int[maxConstraints];
+	numDirty_ = 0;
+	pending_ = new int[maxPoses];
+	numPending_ = 0;
+	isPending_ = new bool[maxPoses];
+	affected_ = new int[maxPoses];
+	boundary_ = new int[maxPoses];
+	numBoundary_ = 0;
+	roots_ = new int[maxPoses];
+	numRoots_ = 0;
+	stack_ = new int[maxPoses];
+	pattern_ = new int[maxPoses];
+	slot_ = new int[maxPoses];
+	stamp_ = 0;
+	mark_ = new int[maxPoses];
+	seenStamp_ = 0;
+	seen_ = new int[maxPoses];
+	changed_ = new int[maxPoses];
+	solveStamp_ = 0;
+	frontCapacity_ = 16;
+	front_ = new double[9 * frontCapacity_ * frontCapacity_];
+	frontRhs_ = new double[3 * frontCapacity_];
+	cached_ = new int[2 * maxPoses];
+	cachedHead_ = 0;
+	cachedTail_ = 0;
+	timesQueued_ = new int[maxPoses];
+	adjacency_ = new int*[maxPoses];
+	adjacencySize_ = new int[maxPoses];
+	bucketHead_ = new int[maxPoses + 1];
+	bucketNext_ = new int[maxPoses];
+	bucketPrev_ = new int[maxPoses];
+	eliminated_ = new bool[maxPoses];
+	for (int i = 0; i < maxPoses; i++)
+	{
+		mark_[i] = 0;
+		seen_[i] = 0;
+		changed_[i] = 0;
+		timesQueued_[i] = 0;
+		adjacency_[i] = NULL;
+	}
+	nextPosition_ = 0;
+	memset(&stats_, 0, sizeof(stats_));
+}
+
+PoseGraph::~PoseGraph()
+{
+	for (int i = 0; i < numPoses_; i++)
+	{
+		delete[] columns_[i].rows;
+		delete[] columns_[i].blocks;
+		delete[] columns_[i].update;
+		delete[] columns_[i].updateRhs;
+	}
+	delete[] linPoint_;
+	delete[] delta_;
+	delete[] firstConstraint_;
+	delete[] columns_;
+	delete[] constraints_;
+	delete[] walls_;
+	delete[] dirty_;
+	delete[] pending_;
+	delete[] isPending_;
+	delete[] affected_;
+	delete[] boundary_;
+	delete[] roots_;
+	delete[] stack_;
+	delete[] pattern_;
+	delete[] slot_;
+	delete[] mark_;
+	delete[] seen_;
+	delete[] changed_;
+	delete[] front_;
+	delete[] frontRhs_;
+	delete[] cached_;
+	delete[] timesQueued_;
+	delete[] adjacency_;
+	delete[] adjacencySize_;
+	delete[] bucketHead_;
+	delete[] bucketNext_;
+	delete[] bucketPrev_;
+	delete[] eliminated_;
+}
+
+int PoseGraph::addPose(const Pose2D& odometry)
+{
+	if (numPoses_ >= maxPoses_ || numConstraints_ >= maxConstraints_)
+		return -1;
+	int pose = numPoses_;
+	firstConstraint_[pose] = -1;
+	Column& column = columns_[pose];
+	column.position = -1;
+	column.parent = -1;
+	column.firstChild = -1;
+	column.nextSibling = -1;
+	column.numRows = 0;
+	column.rows = NULL;
+	column.blocks = NULL;
+	column.update = NULL;
+	column.updateRhs = NULL;
+	delta_[3 * pose] = delta_[3 * pose + 1] = delta_[3 * pose + 2] = 0.0;
+	isPending_[pose] = false;
+	numPoses_++;
+	if (pose == 0)
+	{
+		linPoint_[pose] = odometry;
+		Constraint& anchor = constraints_[newConstraint(constraintAnchor, pose, -1)];
+		anchor.measured[0] = odometry.x;
+		anchor.measured[1] = odometry.y;
+		anchor.measured[2] = odometry.theta;
+		for (int i = 0; i < 3; i++)
+			anchor.information[i] = 1.0 / (anchorSigma * anchorSigma);
+	}
+	else
+	{
+		Pose2D delta = relativePose(lastOdometry_, odometry);
+		linPoint_[pose] = composePose(estimate(pose - 1), delta);
+		double distance = hypot(delta.x, delta.y);
+		double translationSigma = fmax(config_.minTranslationSigma, config_.odometryNoise * distance);
+		double rotationSigma = fmax(config_.minRotationSigma,
+		                            config_.odometryAngleNoise * fabs(delta.theta)
+		                            + config_.odometryAnglePerCm * distance);
+		Constraint& odometryConstraint = constraints_[newConstraint(constraintPose, pose - 1, pose)];
+		odometryConstraint.measured[0] = delta.x;
+		odometryConstraint.measured[1] = delta.y;
+		odometryConstraint.measured[2] = delta.theta;
+		odometryConstraint.information[0] = 1.0 / (translationSigma * translationSigma);
+		odometryConstraint.information[1] = odometryConstraint.information[0];
+		odometryConstraint.information[2] = 1.0 / (rotationSigma * rotationSigma);
+	}
+	lastOdometry_ = odometry;
+	return pose;
+}
+
+// lines are kept in normal form, the points p on them satisfying
+// p.x cos(phi) + p.y sin(phi) = r with r >= 0; y = mx + b has the normal
+// (-m, 1) / sqrt(1 + m^2) at distance b / sqrt(1 + m^2)
+int PoseGraph::addWall(int pose, double slope, double intercept)
+{
+	if (pose < 0 || pose >= numPoses_)
+		return -1;
+	double norm = sqrt(1.0 + slope * slope);
+	double r = fabs(intercept) / norm;
+	if (r < 1e-6)
+		return -1;
+	double phi = (intercept > 0.0) ? atan2(1.0, -slope) : atan2(-1.0, slope);
+	// walls are compared in the pose's frame, where a small error in a
+	// wall's angle moves it little; in the world frame it would move its
+	// distance from the origin by as much as the wall is far away
+	Pose2D here = estimate(pose);
+	int best = -1;
+	double bestScore = 0.0;
+	for (int i = 0; i < numWalls_; i++)
+	{
+		if (walls_[i].lastPose == pose)
+			continue;
+		double rho, alpha;
+		worldLine(walls_[i].lastPose, walls_[i].r, walls_[i].phi, &rho, &alpha);
+		double wallR = rho - here.x * cos(alpha) - here.y * sin(alpha);
+		double wallPhi = alpha - here.theta;
+		if (wallR < 0.0)
+		{
+			wallR = -wallR;
+			wallPhi += M_PI;
+		}
+		double dR = r - wallR;
+		double dPhi = normalizeAngle(phi - wallPhi);
+		if (fabs(dR) > config_.wallDistanceGate || fabs(dPhi) > config_.wallAngleGate)
+			continue;
+		double score = dR * dR / (config_.wallDistanceGate * config_.wallDistanceGate)
+		             + dPhi * dPhi / (config_.wallAngleGate * config_.wallAngleGate);
+		if (best == -1 || score < bestScore)
+		{
+			best = i;
+			bestScore = score;
+		}
+	}
+	if (best == -1)
+	{
+		if (numWalls_ >= maxGraphWalls)
+			return -1;
+		best = numWalls_++;
+		walls_[best].firstPose = pose;
+		walls_[best].firstR = r;
+		walls_[best].firstPhi = phi;
+	}
+	else
+	{
+		// a sighting continues the chain along the wall while it stays in
+		// view; once it's been out of view it goes back to the first pose
+		// that saw it, so laps don't chain to each other
+		Wall& wall = walls_[best];
+		bool revisit = pose - wall.lastPose > config_.wallRevisitPoses;
+		int from = revisit ? wall.firstPose : wall.lastPose;
+		int index = newConstraint(constraintWall, from, pose);
+		if (index == -1)
+			return -1;
+		Constraint& constraint = constraints_[index];
+		constraint.measured[0] = revisit ? wall.firstR : wall.r;
+		constraint.measured[1] = revisit ? wall.firstPhi : wall.phi;
+		constraint.measured[2] = r;
+		constraint.measured[3] = phi;
+		// the residual carries the noise of both fits
+		constraint.information[0] = 0.5 / (config_.wallDistanceSigma * config_.wallDistanceSigma);
+		constraint.information[1] = 0.5 / (config_.wallAngleSigma * config_.wallAngleSigma);
+		constraint.information[2] = 0.0;
+	}
+	walls_[best].lastPose = pose;
+	walls_[best].r = r;
+	walls_[best].phi = phi;
+	return best;
+}
+
+bool PoseGraph::addConstraint(int from, int to, const Pose2D& measured,
+                              double translationSigma, double rotationSigma)
+{
+	if (from < 0 || from >= numPoses_ || to < 0 || to >= numPoses_ || from == to)
+		return false;
+	int index = newConstraint(constraintPose, from, to);
+	if (index == -1)
+		return false;
+	Constraint& constraint = constraints_[index];
+	constraint.measured[0] = measured.x;
+	constraint.measured[1] = measured.y;
+	constraint.measured[2] = measured.theta;
+	constraint.information[0] = 1.0 / (translationSigma * translationSigma);
+	constraint.information[1] = constraint.information[0];
+	constraint.information[2] = 1.0 / (rotationSigma * rotationSigma);
+	return true;
+}
+
+void PoseGraph::update()
+{
+	solve(false);
+}
+
+void PoseGraph::optimize(int iterations)
+{
+	for (int i = 0; i < iterations; i++)
+		solve(true);
+}
+
+int PoseGraph::getNumPoses()
+{
+	return numPoses_;
+}
+
+Pose2D PoseGraph::getPose(int pose)
+{
+	return estimate(pose);
+}
+
+bool PoseGraph::getWall(int wall, double* rho, double* alpha)
+{
+	if (wall < 0 || wall >= numWalls_)
+		return false;
+	worldLine(walls_[wall].lastPose, walls_[wall].r, walls_[wall].phi, rho, alpha);
+	return true;
+}
+
+void PoseGraph::getStats(PoseGraphStats* stats)
+{
+	*stats = stats_;
+	stats->poses = numPoses_;
+	stats->constraints = numConstraints_;
+	stats->walls = numWalls_;
+}
+
+int PoseGraph::otherPose(const Constraint& constraint, int pose)
+{
+	return (constraint.from == pose) ? constraint.to : constraint.from;
+}
+
+int PoseGraph::nextConstraint(int constraint, int pose)
+{
+	const Constraint& current = constraints_[constraint];
+	return (current.from == pose) ? current.nextFrom : current.nextTo;
+}
+
+int PoseGraph::newConstraint(int type, int from, int to)
+{
+	if (numConstraints_ >= maxConstraints_)
+		return -1;
+	int index = numConstraints_++;
+	Constraint& constraint = constraints_[index];
+	constraint.type = type;
+	constraint.from = from;
+	constraint.to = to;
+	constraint.nextFrom = firstConstraint_[from];
+	firstConstraint_[from] = index;
+	constraint.nextTo = -1;
+	if (to >= 0)
+	{
+		constraint.nextTo = firstConstraint_[to];
+		firstConstraint_[to] = index;
+	}
+	constraint.dirty = true;
+	dirty_[numDirty_++] = index;
+	return index;
+}
+
+// residuals and their Jacobians with respect to the two poses, at the
+// poses' linearization points:
+//    anchor: from - measured
+//    pose:   to expressed in from's frame, less the measurement
+//    wall:   the line from saw, moved into to's frame, less the line to saw
+// then the information blocks J^T W J and gradient -J^T W e
+void PoseGraph::linearize(Constraint* constraint)
+{
+	double jFrom[9], jTo[9], error[3];
+	memset(jFrom, 0, sizeof(jFrom));
+	memset(jTo, 0, sizeof(jTo));
+	int residuals = 3;
+	const Pose2D& a = linPoint_[constraint->from];
+	const double* z = constraint->measured;
+	if (constraint->type == constraintAnchor)
+	{
+		error[0] = a.x - z[0];
+		error[1] = a.y - z[1];
+		error[2] = normalizeAngle(a.theta - z[2]);
+		jFrom[0] = jFrom[4] = jFrom[8] = 1.0;
+	}
+	else if (constraint->type == constraintPose)
+	{
+		const Pose2D& b = linPoint_[constraint->to];
+		double c = cos(a.theta);
+		double s = sin(a.theta);
+		double dx = b.x - a.x;
+		double dy = b.y - a.y;
+		error[0] = c * dx + s * dy - z[0];
+		error[1] = -s * dx + c * dy - z[1];
+		error[2] = normalizeAngle(b.theta - a.theta - z[2]);
+		jFrom[0] = -c; jFrom[1] = -s; jFrom[2] = -s * dx + c * dy;
+		jFrom[3] = s; jFrom[4] = -c; jFrom[5] = -c * dx - s * dy;
+		jFrom[8] = -1.0;
+		jTo[0] = c; jTo[1] = s;
+		jTo[3] = -s; jTo[4] = c;
+		jTo[8] = 1.0;
+	}
+	else
+	{
+		const Pose2D& b = linPoint_[constraint->to];
+		double alpha = a.theta + z[1];
+		double c = cos(alpha);
+		double s = sin(alpha);
+		double dx = a.x - b.x;
+		double dy = a.y - b.y;
+		residuals = 2;
+		error[0] = z[0] + dx * c + dy * s - z[2];
+		error[1] = normalizeAngle(alpha - b.theta - z[3]);
+		error[2] = 0.0;
+		jFrom[0] = c; jFrom[1] = s; jFrom[2] = -dx * s + dy * c;
+		jFrom[5] = 1.0;
+		jTo[0] = -c; jTo[1] = -s;
+		jTo[5] = -1.0;
+	}
+	const double* w = constraint->information;
+	for (int i = 0; i < 3; i++)
+	{
+		double gFrom = 0.0, gTo = 0.0;
+		for (int k = 0; k < residuals; k++)
+		{
+			gFrom -= jFrom[k * 3 + i] * w[k] * error[k];
+			gTo -= jTo[k * 3 + i] * w[k] * error[k];
+		}
+		constraint->gFrom[i] = gFrom;
+		constraint->gTo[i] = gTo;
+		for (int j = 0; j < 3; j++)
+		{
+			double hFrom = 0.0, hCross = 0.0, hTo = 0.0;
+			for (int k = 0; k < residuals; k++)
+			{
+				hFrom += jFrom[k * 3 + i] * w[k] * jFrom[k * 3 + j];
+				hCross += jFrom[k * 3 + i] * w[k] * jTo[k * 3 + j];
+				hTo += jTo[k * 3 + i] * w[k] * jTo[k * 3 + j];
+			}
+			constraint->hFrom[i * 3 + j] = hFrom;
+			constraint->hCross[i * 3 + j] = hCross;
+			constraint->hTo[i * 3 + j] = hTo;
+		}
+	}
+	constraint->dirty = false;
+}
+
+Pose2D PoseGraph::estimate(int pose)
+{
+	const double* delta = delta_ + 3 * pose;
+	const Pose2D& point = linPoint_[pose];
+	return makePose(point.x + delta[0], point.y + delta[1], normalizeAngle(point.theta + delta[2]));
+}
+
+// ancestors of an affected pose are already affected, so each walk stops
+// where an earlier one went
+void PoseGraph::touch(int pose)
+{
+	for (int v = pose; v != -1 && mark_[v] != stamp_; v = columns_[v].parent)
+	{
+		mark_[v] = stamp_;
+		affected_[stats_.eliminated++] = v;
+	}
+}
+
+// all relinearizes every pose and refactors the whole graph
+void PoseGraph::solve(bool all)
+{
+	stamp_++;
+	stats_.eliminated = 0;
+	stats_.maxFront = 0;
+	stats_.relinearized = 0;
+	stats_.solved = 0;
+	stats_.uncached = 0;
+	if (all)
+	{
+		for (int v = 0; v < numPoses_; v++)
+			if (!isPending_[v])
+			{
+				isPending_[v] = true;
+				pending_[numPending_++] = v;
+			}
+	}
+	// relinearizing a pose moves its linearization point to the estimate,
+	// so its step starts again from 0 and its constraints change
+	for (int i = 0; i < numPending_; i++)
+	{
+		int v = pending_[i];
+		linPoint_[v] = estimate(v);
+		delta_[3 * v] = delta_[3 * v + 1] = delta_[3 * v + 2] = 0.0;
+		isPending_[v] = false;
+		for (int c = firstConstraint_[v]; c != -1; c = nextConstraint(c, v))
+			if (!constraints_[c].dirty)
+			{
+				constraints_[c].dirty = true;
+				dirty_[numDirty_++] = c;
+			}
+	}
+	stats_.relinearized = numPending_;
+	numPending_ = 0;
+	for (int i = 0; i < numDirty_; i++)
+	{
+		Constraint* constraint = &constraints_[dirty_[i]];
+		linearize(constraint);
+		touch(constraint->from);
+		if (constraint->to >= 0)
+			touch(constraint->to);
+	}
+	numDirty_ = 0;
+	if (all)
+		for (int v = 0; v < numPoses_; v++)
+			touch(v);
+	if (stats_.eliminated == 0)
+		return;
+
+	// the untouched subtrees hanging off the affected columns keep their
+	// factor; only their update matrices are absorbed again, and a column
+	// whose update matrix was freed is eliminated again from its children's
+	numBoundary_ = 0;
+	for (int i = 0; i < stats_.eliminated; i++)
+	{
+		int v = affected_[i];
+		for (int child = columns_[v].firstChild; child != -1; child = columns_[child].nextSibling)
+		{
+			if (mark_[child] == stamp_)
+				continue;
+			if (columns_[child].update == NULL)
+			{
+				mark_[child] = stamp_;
+				affected_[stats_.eliminated++] = child;
+				stats_.uncached++;
+			}
+			else
+			{
+				boundary_[numBoundary_++] = child;
+				queueUpdate(child);
+			}
+		}
+	}
+	int numAffected = stats_.eliminated;
+	for (int i = 0; i < numAffected; i++)
+		columns_[affected_[i]].firstChild = -1;
+	constrainedFrom_ = all ? numPoses_ - 1 : firstNewPose_;
+	order(affected_, numAffected);
+	// a subtree's rows are all affected, its new parent is the first of them
+	for (int i = 0; i < numBoundary_; i++)
+	{
+		Column& column = columns_[boundary_[i]];
+		int parent = column.rows[0];
+		for (int j = 1; j < column.numRows; j++)
+			if (columns_[column.rows[j]].position < columns_[parent].position)
+				parent = column.rows[j];
+		column.parent = parent;
+		column.nextSibling = columns_[parent].firstChild;
+		columns_[parent].firstChild = boundary_[i];
+	}
+	for (int i = 0; i < numAffected; i++)
+		eliminate(affected_[i]);
+
+	int numRoots = 0;
+	for (int i = 0; i < numRoots_; i++)
+		if (mark_[roots_[i]] != stamp_)
+			roots_[numRoots++] = roots_[i];
+	for (int i = 0; i < numAffected; i++)
+		if (columns_[affected_[i]].parent == -1)
+			roots_[numRoots++] = affected_[i];
+	numRoots_ = numRoots;
+	firstNewPose_ = numPoses_;
+	backSubstitute();
+	freeUpdates();
+}
+
+// minimum degree ordering of the affected poses, on the graph of their
+// constraints among themselves plus a clique over each untouched
+// subtree's rows, which its update matrix couples; poses from
+// constrainedFrom_ on are ordered after all the others, so the next
+// update's new poses join near the root
+// the poses are rewritten in elimination order and given positions after
+// every pose already in the tree
+void PoseGraph::order(int* poses, int count)
+{
+	for (int i = 0; i < count; i++)
+		adjacencySize_[poses[i]] = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			int v = poses[i];
+			for (int c = firstConstraint_[v]; c != -1; c = nextConstraint(c, v))
+			{
+				int w = otherPose(constraints_[c], v);
+				if (w < 0 || w == v || mark_[w] != stamp_)
+					continue;
+				if (pass == 1)
+					adjacency_[v][adjacencySize_[v]] = w;
+				adjacencySize_[v]++;
+			}
+		}
+		for (int i = 0; i < numBoundary_; i++)
+		{
+			const Column& column = columns_[boundary_[i]];
+			for (int a = 0; a < column.numRows; a++)
+			{
+				int v = column.rows[a];
+				for (int b = 0; b < column.numRows; b++)
+				{
+					if (b == a)
+						continue;
+					if (pass == 1)
+						adjacency_[v][adjacencySize_[v]] = column.rows[b];
+					adjacencySize_[v]++;
+				}
+			}
+		}
+		for (int i = 0; i < count; i++)
+		{
+			int v = poses[i];
+			if (pass == 0)
+				adjacency_[v] = new int[adjacencySize_[v] + 1];
+			else
+			{
+				// sort and drop duplicates
+				int* list = adjacency_[v];
+				qsort(list, adjacencySize_[v], sizeof(int), compareInts);
+				int size = 0;
+				for (int j = 0; j < adjacencySize_[v]; j++)
+					if (size == 0 || list[size - 1] != list[j])
+						list[size++] = list[j];
+				adjacencySize_[v] = size;
+			}
+			eliminated_[v] = false;
+			if (pass == 0)
+				adjacencySize_[v] = 0;
+		}
+	}
+
+	int* ordered = stack_;
+	int numOrdered = 0;
+	for (int phase = 0; phase < 2; phase++)
+	{
+		for (int d = 0; d <= count; d++)
+			bucketHead_[d] = -1;
+		int remaining = 0;
+		int minDegree = count;
+		for (int i = 0; i < count; i++)
+		{
+			int v = poses[i];
+			if ((v >= constrainedFrom_) != (phase == 1))
+				continue;
+			int degree = adjacencySize_[v];
+			bucketPrev_[v] = -1;
+			bucketNext_[v] = bucketHead_[degree];
+			if (bucketHead_[degree] != -1)
+				bucketPrev_[bucketHead_[degree]] = v;
+			bucketHead_[degree] = v;
+			if (degree < minDegree)
+				minDegree = degree;
+			remaining++;
+		}
+		while (remaining > 0)
+		{
+			while (bucketHead_[minDegree] == -1)
+				minDegree++;
+			int p = bucketHead_[minDegree];
+			bucketHead_[minDegree] = bucketNext_[p];
+			if (bucketNext_[p] != -1)
+				bucketPrev_[bucketNext_[p]] = -1;
+			remaining--;
+			eliminated_[p] = true;
+			ordered[numOrdered++] = p;
+			// eliminating p joins its neighbours into a clique
+			const int* neighbours = adjacency_[p];
+			int numNeighbours = adjacencySize_[p];
+			for (int i = 0; i < numNeighbours; i++)
+			{
+				int n = neighbours[i];
+				const int* list = adjacency_[n];
+				int size = adjacencySize_[n];
+				int* merged = new int[size + numNeighbours];
+				int length = 0;
+				int a = 0, b = 0;
+				while (a < size || b < numNeighbours)
+				{
+					int next;
+					if (b == numNeighbours || (a < size && list[a] < neighbours[b]))
+						next = list[a++];
+					else if (a == size || neighbours[b] < list[a])
+						next = neighbours[b++];
+					else
+					{
+						next = list[a++];
+						b++;
+					}
+					if (next != n && next != p)
+						merged[length++] = next;
+				}
+				delete[] adjacency_[n];
+				adjacency_[n] = merged;
+				adjacencySize_[n] = length;
+				if ((n >= constrainedFrom_) != (phase == 1))
+					continue;
+				// move n to the bucket for its new degree
+				if (bucketPrev_[n] != -1)
+					bucketNext_[bucketPrev_[n]] = bucketNext_[n];
+				else
+					bucketHead_[size] = bucketNext_[n];
+				if (bucketNext_[n] != -1)
+					bucketPrev_[bucketNext_[n]] = bucketPrev_[n];
+				bucketPrev_[n] = -1;
+				bucketNext_[n] = bucketHead_[length];
+				if (bucketHead_[length] != -1)
+					bucketPrev_[bucketHead_[length]] = n;
+				bucketHead_[length] = n;
+				if (length < minDegree)
+					minDegree = length;
+			}
+			delete[] adjacency_[p];
+			adjacency_[p] = NULL;
+		}
+	}
+	for (int i = 0; i < count; i++)
+	{
+		poses[i] = ordered[i];
+		columns_[poses[i]].position = nextPosition_++;
+	}
+}
+
+// eliminates one affected pose: assembles its front from its constraints
+// and its children's update matrices, factors the diagonal block, and
+// leaves an update matrix for its parent
+void PoseGraph::eliminate(int pose)
+{
+	Column& column = columns_[pose];
+	seenStamp_++;
+	int numRows = 0;
+	for (int c = firstConstraint_[pose]; c != -1; c = nextConstraint(c, pose))
+	{
+		int w = otherPose(constraints_[c], pose);
+		if (w >= 0 && mark_[w] == stamp_ && columns_[w].position > column.position
+		    && seen_[w] != seenStamp_)
+		{
+			seen_[w] = seenStamp_;
+			pattern_[numRows++] = w;
+		}
+	}
+	for (int child = column.firstChild; child != -1; child = columns_[child].nextSibling)
+	{
+		const Column& childColumn = columns_[child];
+		for (int i = 0; i < childColumn.numRows; i++)
+		{
+			int w = childColumn.rows[i];
+			if (w != pose && seen_[w] != seenStamp_)
+			{
+				seen_[w] = seenStamp_;
+				pattern_[numRows++] = w;
+			}
+		}
+	}
+	// rows in elimination order, so the first is the parent
+	for (int i = 1; i < numRows; i++)
+	{
+		int w = pattern_[i];
+		int64_t position = columns_[w].position;
+		int j = i - 1;
+		for (; j >= 0 && columns_[pattern_[j]].position > position; j--)
+			pattern_[j + 1] = pattern_[j];
+		pattern_[j + 1] = w;
+	}
+
+	int size = numRows + 1;
+	if (size > frontCapacity_)
+	{
+		delete[] front_;
+		delete[] frontRhs_;
+		frontCapacity_ = (2 * frontCapacity_ > size) ? 2 * frontCapacity_ : size;
+		front_ = new double[9 * frontCapacity_ * frontCapacity_];
+		frontRhs_ = new double[3 * frontCapacity_];
+	}
+	if (size > stats_.maxFront)
+		stats_.maxFront = size;
+	int dim = 3 * size;
+	double* front = front_;
+	double* rhs = frontRhs_;
+	memset(front, 0, dim * dim * sizeof(double));
+	memset(rhs, 0, dim * sizeof(double));
+	slot_[pose] = 0;
+	for (int i = 0; i < numRows; i++)
+		slot_[pattern_[i]] = i + 1;
+
+	for (int c = firstConstraint_[pose]; c != -1; c = nextConstraint(c, pose))
+	{
+		const Constraint& constraint = constraints_[c];
+		bool isFrom = constraint.from == pose;
+		addBlock(front, dim, 0, 0, isFrom ? constraint.hFrom : constraint.hTo, false);
+		const double* gradient = isFrom ? constraint.gFrom : constraint.gTo;
+		for (int i = 0; i < 3; i++)
+			rhs[i] += gradient[i];
+		// the block below the diagonal, if the other pose comes later
+		int w = otherPose(constraint, pose);
+		if (w >= 0 && mark_[w] == stamp_ && columns_[w].position > column.position)
+			addBlock(front, dim, slot_[w], 0, constraint.hCross, isFrom);
+	}
+	for (int child = column.firstChild; child != -1; child = columns_[child].nextSibling)
+	{
+		const Column& childColumn = columns_[child];
+		int childDim = 3 * childColumn.numRows;
+		for (int a = 0; a < childColumn.numRows; a++)
+		{
+			int slotA = slot_[childColumn.rows[a]];
+			for (int i = 0; i < 3; i++)
+				rhs[3 * slotA + i] += childColumn.updateRhs[3 * a + i];
+			for (int b = 0; b < childColumn.numRows; b++)
+			{
+				int slotB = slot_[childColumn.rows[b]];
+				for (int i = 0; i < 3; i++)
+					for (int j = 0; j < 3; j++)
+						front[(3 * slotA + i) * dim + 3 * slotB + j]
+							+= childColumn.update[(3 * a + i) * childDim + 3 * b + j];
+			}
+		}
+	}
+
+	// F = [Fpp Fpr; Frp Frr] becomes L's diagonal block D = chol(Fpp), its
+	// blocks below X = Frp D^-T and the update Frr - X X^T
+	double diagonal[9];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			diagonal[i * 3 + j] = front[i * dim + j];
+	for (double damping = 1e-9; !cholesky3(diagonal, column.diagonal); damping *= 10.0)
+		for (int i = 0; i < 3; i++)
+			diagonal[i * 3 + i] += damping;
+	stats_.factorBlocks += numRows - column.numRows;
+	if (column.update != NULL)
+		stats_.updateDoubles -= 9 * column.numRows * column.numRows + 3 * column.numRows;
+	delete[] column.rows;
+	delete[] column.blocks;
+	delete[] column.update;
+	delete[] column.updateRhs;
+	int rowDim = 3 * numRows;
+	column.numRows = numRows;
+	column.rows = new int[numRows];
+	column.blocks = new double[9 * numRows];
+	column.update = new double[rowDim * rowDim];
+	column.updateRhs = new double[rowDim];
+	stats_.updateDoubles += rowDim * rowDim + rowDim;
+	memcpy(column.rows, pattern_, numRows * sizeof(int));
+	double* x = column.blocks; // rows of X, 3 values each
+	for (int r = 0; r < rowDim; r++)
+	{
+		for (int j = 0; j < 3; j++)
+			x[3 * r + j] = front[(3 + r) * dim + j];
+		forward3(column.diagonal, x + 3 * r);
+	}
+	for (int i = 0; i < 3; i++)
+		column.y[i] = rhs[i];
+	forward3(column.diagonal, column.y);
+	for (int r = 0; r < rowDim; r++)
+	{
+		const double* xr = x + 3 * r;
+		column.updateRhs[r] = rhs[3 + r] - (xr[0] * column.y[0] + xr[1] * column.y[1] + xr[2] * column.y[2]);
+		for (int q = 0; q <= r; q++)
+		{
+			const double* xq = x + 3 * q;
+			double value = front[(3 + r) * dim + 3 + q] - (xr[0] * xq[0] + xr[1] * xq[1] + xr[2] * xq[2]);
+			column.update[r * rowDim + q] = value;
+			column.update[q * rowDim + r] = value;
+		}
+	}
+
+	column.parent = (numRows > 0) ? pattern_[0] : -1;
+	if (column.parent != -1)
+	{
+		column.nextSibling = columns_[column.parent].firstChild;
+		columns_[column.parent].firstChild = pose;
+		queueUpdate(pose);
+	}
+}
+
+void PoseGraph::queueUpdate(int pose)
+{
+	if (cachedTail_ == 2 * maxPoses_)
+	{
+		// keep just each pose's last entry, so at most one per pose
+		int kept = 0;
+		for (int i = cachedHead_; i < cachedTail_; i++)
+			if (--timesQueued_[cached_[i]] == 0)
+				cached_[kept++] = cached_[i];
+		for (int i = 0; i < kept; i++)
+			timesQueued_[cached_[i]] = 1;
+		cachedHead_ = 0;
+		cachedTail_ = kept;
+	}
+	cached_[cachedTail_++] = pose;
+	timesQueued_[pose]++;
+}
+
+// the update matrices longest unused are the likeliest to belong to parts
+// of the map Colin has left; if one is needed again, its column is
+// eliminated again
+void PoseGraph::freeUpdates()
+{
+	int64_t maxDoubles = (int64_t)(config_.maxUpdateMB * 1e6 / sizeof(double));
+	if (maxDoubles <= 0)
+		return;
+	while (stats_.updateDoubles > maxDoubles && cachedHead_ < cachedTail_)
+	{
+		int pose = cached_[cachedHead_++];
+		if (--timesQueued_[pose] > 0)
+			continue;
+		Column& column = columns_[pose];
+		if (column.update == NULL)
+			continue;
+		stats_.updateDoubles -= 9 * column.numRows * column.numRows + 3 * column.numRows;
+		delete[] column.update;
+		delete[] column.updateRhs;
+		column.update = NULL;
+		column.updateRhs = NULL;
+	}
+}
+
+// solves L^T delta = y from the roots down; a column is solved if it was
+// eliminated again or any pose in its rows moved past the wildfire
+// threshold, and its children are visited only if it was solved
+void PoseGraph::backSubstitute()
+{
+	solveStamp_++;
+	int top = 0;
+	for (int i = 0; i < numRoots_; i++)
+		stack_[top++] = roots_[i];
+	while (top > 0)
+	{
+		int v = stack_[--top];
+		const Column& column = columns_[v];
+		bool solve = mark_[v] == stamp_;
+		for (int i = 0; i < column.numRows && !solve; i++)
+			solve = changed_[column.rows[i]] == solveStamp_;
+		if (!solve)
+			continue;
+		double x[3] = {column.y[0], column.y[1], column.y[2]};
+		for (int a = 0; a < column.numRows; a++)
+		{
+			const double* block = column.blocks + 9 * a;
+			const double* other = delta_ + 3 * column.rows[a];
+			for (int j = 0; j < 3; j++)
+				x[j] -= block[j] * other[0] + block[3 + j] * other[1] + block[6 + j] * other[2];
+		}
+		backward3(column.diagonal, x);
+		double* delta = delta_ + 3 * v;
+		if (fabs(x[0] - delta[0]) > config_.wildfireTranslation
+		    || fabs(x[1] - delta[1]) > config_.wildfireTranslation
+		    || fabs(x[2] - delta[2]) > config_.wildfireRotation)
+			changed_[v] = solveStamp_;
+		delta[0] = x[0];
+		delta[1] = x[1];
+		delta[2] = x[2];
+		stats_.solved++;
+		if (!isPending_[v] && (fabs(x[0]) > config_.relinearizeTranslation
+		                       || fabs(x[1]) > config_.relinearizeTranslation
+		                       || fabs(x[2]) > config_.relinearizeRotation))
+		{
+			isPending_[v] = true;
+			pending_[numPending_++] = v;
+		}
+		for (int child = column.firstChild; child != -1; child = columns_[child].nextSibling)
+			stack_[top++] = child;
+	}
+}
+
+// the line (r, phi) seen from a pose, in the world frame with rho >= 0
+void PoseGraph::worldLine(int pose, double r, double phi, double* rho, double* alpha)
+{
+	Pose2D estimated = estimate(pose);
+	*alpha = estimated.theta + phi;
+	*rho = r + estimated.x * cos(*alpha) + estimated.y * sin(*alpha);
+	if (*rho < 0.0)
+	{
+		*rho = -*rho;
+		*alpha += M_PI;
+	}
+	*alpha = normalizeAngle(*alpha);
+}
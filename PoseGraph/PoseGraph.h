@@ -0,0 +1,254 @@
+// PoseGraph.h
+// 10/18/2026
+
+// Pose graph SLAM backend: keeps the poses Colin passes through as nodes
+// joined by constraints, and finds the poses that best agree with all of
+// them, so odometry drift is corrected whenever a wall is seen again or
+// a place is recognized
+
+// Constraints:
+//    odometry:     addPose joins each new pose to the previous one with the
+//                  change in odometry (SerialBot's pose), its noise growing
+//                  with the distance and angle moved
+//    wall lines:   addWall takes a line fitted in a pose's local frame, as
+//                  y = mx + b from LineFitter, and matches it to the walls
+//                  seen so far as they'd look from the pose; a matched
+//                  line ties the pose to the last pose that saw the wall
+//                  while it stays in view, and to the first pose that saw
+//                  it when it comes back into view, both having to agree
+//                  on its distance and angle (2 dof)
+//    loop closure: addConstraint joins any two poses with a measured
+//                  relative pose, as from recognizing a place or matching
+//                  scans
+// The first pose is anchored where its odometry says it is
+// The caller decides when to add a pose: every frame, or only once Colin
+// has moved some distance
+
+// update() solves incrementally in the manner of iSAM2 (Kaess et al.
+// 2012), over a block sparse Cholesky factor L of the information matrix
+// with a 3x3 block column per pose, built multifrontally: eliminating a
+// pose leaves an update matrix on the poses its column reaches, which its
+// parent in the elimination tree absorbs
+// New and relinearized constraints change only the columns of the poses
+// they touch and those poses' ancestors in the tree. update() takes out
+// just those columns, orders them again by minimum degree with the poses
+// added since the last update last, and eliminates them, absorbing the
+// cached update matrices of the untouched subtrees beneath; the rest of
+// the factor, structure and values, is reused as it is
+// The solution is then back substituted from the root down, descending
+// only while some pose a column reaches has moved by more than the
+// wildfire threshold
+// Constraints stay linearized at their poses' linearization points until
+// a pose's step from its point passes the relinearization threshold, so
+// while changes stay local an update costs about the same however large
+// the graph has grown; a loop closure costs in proportion to the part of
+// the tree it reaches
+// How large the fronts get depends on how the graph is joined. Tying each
+// lap's sightings of a wall to the previous lap's would chain every lap
+// to the one before along every wall, and fronts would keep growing with
+// the laps driven (14 to 98 poses over 58 laps in poseGraphBench). Tied
+// to the first pose that saw them, laps meet only at those poses, about
+// one per wall, and fronts grow only as new walls are found (12 to 29
+// poses over the same laps, then level)
+// optimize() relinearizes every pose and refactors from scratch, as a
+// batch Gauss-Newton solver would
+
+// Poses and constraints live in arrays allocated by the constructor; a
+// column's pattern, blocks and update matrix are allocated when it's
+// eliminated and freed when it's eliminated again. The update matrices
+// take the most room, and past maxUpdateMB the ones longest unused are
+// freed; a column whose update matrix is needed after that is eliminated
+// again, and so in turn are its children whose matrices were freed
+
+#ifndef POSEGRAPH_H
+#define POSEGRAPH_H
+
+#include <stdint.h>
+#include "../Geometry/Pose2D.h"
+
+const int maxGraphWalls = 1024;
+
+struct PoseGraphConfig
+{
+	double odometryNoise; // sigma of distance and sideways drift per cm driven
+	double odometryAngleNoise; // sigma of heading per radian turned
+	double odometryAnglePerCm; // sigma of heading (rad) per cm driven
+	double minTranslationSigma; // cm, floor on the odometry sigmas
+	double minRotationSigma; // rad
+	double wallDistanceSigma; // cm, noise of a fitted line's distance
+	double wallAngleSigma; // rad, and of its angle
+	double wallDistanceGate; // cm, a line this close to a known wall
+	double wallAngleGate; // rad, and this close in angle is matched to it
+	int wallRevisitPoses; // poses a wall may go unseen before it's tied back to its first pose
+	double relinearizeTranslation; // cm a pose's step may reach before it's relinearized
+	double relinearizeRotation; // rad
+	double wildfireTranslation; // cm change below which back substitution stops
+	double wildfireRotation; // rad
+	double maxUpdateMB; // cached update matrices past this are freed, oldest first; 0 for no limit
+};
+
+PoseGraphConfig defaultPoseGraphConfig();
+
+struct PoseGraphStats
+{
+	int poses;
+	int constraints;
+	int walls;
+	int eliminated; // columns eliminated by the last update
+	int maxFront; // most poses in one of its fronts
+	int relinearized; // poses relinearized by it
+	int solved; // poses it back substituted
+	int uncached; // columns it eliminated again because their update matrix was freed
+	int64_t factorBlocks; // off-diagonal 3x3 blocks in L
+	int64_t updateDoubles; // doubles held in cached update matrices
+};
+
+class PoseGraph
+{
+public:
+	PoseGraph(int maxPoses, int maxConstraints, const PoseGraphConfig& config);
+	~PoseGraph();
+
+	// odometry is the robot's pose as it reports it; returns the new
+	// pose's id, or -1 if the graph is full
+	int addPose(const Pose2D& odometry);
+	// a line seen from pose in its local frame, y = slope * x + intercept;
+	// returns the id of the wall it was matched to or started, -1 if the
+	// line passes through the robot or there's no room
+	int addWall(int pose, double slope, double intercept);
+	// to as seen from from, with independent sigmas on x and y (cm) and
+	// theta (rad); returns false if there's no room
+	bool addConstraint(int from, int to, const Pose2D& measured,
+	                   double translationSigma, double rotationSigma);
+
+	void update(); // takes in everything added since the last update
+	void optimize(int iterations); // relinearizes everything and refactors
+
+	int getNumPoses();
+	Pose2D getPose(int pose); // current estimate
+	// the wall in the world frame, p.x cos(alpha) + p.y sin(alpha) = rho
+	bool getWall(int wall, double* rho, double* alpha);
+	void getStats(PoseGraphStats* stats);
+
+private:
+	enum ConstraintType
+	{
+		constraintAnchor, // holds from at its measured pose
+		constraintPose, // odometry and loop closures
+		constraintWall
+	};
+
+	struct Constraint
+	{
+		int type;
+		int from, to; // to is -1 for an anchor
+		int nextFrom, nextTo; // next constraint on from and on to
+		double measured[4]; // pose: x, y, theta; wall: r, phi from from, then from to
+		double information[3]; // diagonal, per residual
+		bool dirty; // waiting to be linearized
+		// linearization: information blocks (row major) and gradient
+		double hFrom[9], hCross[9], hTo[9]; // hCross is from rows, to columns
+		double gFrom[3], gTo[3];
+	};
+
+	// one block column of L
+	struct Column
+	{
+		int64_t position; // in the elimination order
+		int parent; // -1 for a root or a pose not yet eliminated
+		int firstChild, nextSibling;
+		int numRows;
+		int* rows; // poses with blocks below the diagonal
+		double diagonal[9]; // lower triangular
+		double* blocks; // numRows 3x3 blocks
+		double y[3]; // forward substitution
+		double* update; // (3 numRows)^2, left on rows by eliminating this column; NULL if freed
+		double* updateRhs; // 3 numRows
+	};
+
+	struct Wall
+	{
+		int firstPose; // first pose that saw it
+		double firstR, firstPhi; // as that pose saw it
+		int lastPose; // last pose that saw it
+		double r, phi; // as that pose saw it
+	};
+
+	PoseGraphConfig config_;
+	int maxPoses_;
+	int maxConstraints_;
+	int numPoses_;
+	int numConstraints_;
+	int numWalls_;
+	int firstNewPose_; // poses from here on haven't been through update
+	int constrainedFrom_; // poses ordered last by the current update
+	Pose2D lastOdometry_;
+
+	Pose2D* linPoint_; // per pose
+	double* delta_; // 3 per pose, solution of the linear system
+	int* firstConstraint_;
+	Column* columns_;
+	Constraint* constraints_;
+	Wall* walls_;
+
+	// lists and stamps for update, sized by maxPoses or maxConstraints
+	int* dirty_;
+	int numDirty_;
+	int* pending_; // poses to relinearize
+	int numPending_;
+	bool* isPending_;
+	int* affected_;
+	int* boundary_; // untouched children of affected columns
+	int numBoundary_;
+	int* roots_;
+	int numRoots_;
+	int* stack_;
+	int* pattern_;
+	int* slot_; // a pose's block in the current front
+	int stamp_; // update count; mark_ == stamp_ means affected
+	int* mark_;
+	int seenStamp_;
+	int* seen_;
+	int* changed_; // solve count a pose last moved past the wildfire threshold
+	int solveStamp_;
+	double* front_;
+	double* frontRhs_;
+	int frontCapacity_; // poses
+
+	// columns in the order their update matrices were last made or
+	// absorbed, to free the longest unused; a column is queued again each
+	// time, and only its last entry counts
+	int* cached_;
+	int cachedHead_, cachedTail_;
+	int* timesQueued_;
+
+	// minimum degree
+	int** adjacency_; // sorted, among the affected poses
+	int* adjacencySize_;
+	int* bucketHead_;
+	int* bucketNext_;
+	int* bucketPrev_;
+	bool* eliminated_;
+
+	int64_t nextPosition_;
+	PoseGraphStats stats_;
+
+	int otherPose(const Constraint& constraint, int pose);
+	int nextConstraint(int constraint, int pose);
+	int newConstraint(int type, int from, int to); // returns its index, -1 if full
+	void linearize(Constraint* constraint);
+	Pose2D estimate(int pose);
+	void touch(int pose); // marks the pose and its ancestors affected
+	void solve(bool all);
+	void order(int* poses, int count);
+	void eliminate(int pose);
+	void backSubstitute();
+	void queueUpdate(int pose); // as just made or absorbed
+	void freeUpdates(); // down to maxUpdateMB
+	void worldLine(int pose, double r, double phi, double* rho, double* alpha);
+
+	PoseGraph(const PoseGraph&); // not copyable
+	PoseGraph& operator=(const PoseGraph&);
+};
+
+#endif
@@ -0,0 +1,151 @@
+// RealTime.cpp
+// 10/18/2026
+
+// Opt-in real-time execution for time critical threads
+// See RealTime.h for usage
+
+#include "RealTime.h"
+#include "../Pipeline/PipelineStage.h"
+#include <alloca.h>
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <iostream>
+
+using namespace std;
+
+const size_t maxStackPrefault = 512 * 1024;
+
+RealTimeConfig defaultRealTimeConfig()
+{
+	RealTimeConfig config;
+	config.enabled = false;
+	config.priority = 80;
+	config.cpu = -1;
+	config.lockMemory = true;
+	config.stackPrefault = 64 * 1024;
+	return config;
+}
+
+// memory locking is process wide, so it's only done once
+static bool lockMemory(const char* name)
+{
+	static pthread_mutex_t lockMutex = PTHREAD_MUTEX_INITIALIZER;
+	static bool locked = false;
+	pthread_mutex_lock(&lockMutex);
+	if (!locked)
+	{
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+		{
+			// keep freed heap memory mapped and locked rather than
+			// returning it to the kernel and faulting it back in later
+			mallopt(M_TRIM_THRESHOLD, -1);
+			mallopt(M_MMAP_MAX, 0);
+			locked = true;
+		}
+		else
+		{
+			cerr << name << ": unable to lock memory (" << strerror(errno)
+			     << "), page faults may add latency" << endl;
+		}
+	}
+	bool result = locked;
+	pthread_mutex_unlock(&lockMutex);
+	return result;
+}
+
+// touches size bytes of stack so those pages are resident before the
+// time critical loop starts
+static void prefaultStack(size_t size)
+{
+	if (size > maxStackPrefault)
+		size = maxStackPrefault;
+	volatile unsigned char* stack = (volatile unsigned char*)alloca(size);
+	for (size_t i = 0; i < size; i += 4096)
+		stack[i] = 0;
+}
+
+bool enterRealTime(const char* name, const RealTimeConfig& config)
+{
+	if (!config.enabled)
+		return false;
+	bool success = true;
+
+	if (config.lockMemory && !lockMemory(name))
+		success = false;
+
+	if (config.stackPrefault > 0)
+		prefaultStack(config.stackPrefault);
+
+	if (config.cpu >= 0 && !pinThreadToCpu(pthread_self(), config.cpu))
+	{
+		cerr << name << ": unable to pin thread to cpu " << config.cpu << endl;
+		success = false;
+	}
+
+	int minPriority = sched_get_priority_min(SCHED_FIFO);
+	int maxPriority = sched_get_priority_max(SCHED_FIFO);
+	struct sched_param param;
+	param.sched_priority = config.priority;
+	if (param.sched_priority < minPriority)
+		param.sched_priority = minPriority;
+	if (param.sched_priority > maxPriority)
+		param.sched_priority = maxPriority;
+	int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+	if (result != 0)
+	{
+		cerr << name << ": unable to set SCHED_FIFO priority "
+		     << param.sched_priority << " (" << strerror(result)
+		     << "), running with normal scheduling" << endl;
+		success = false;
+	}
+
+	if (success)
+	{
+		cerr << name << ": real-time mode enabled, SCHED_FIFO priority "
+		     << param.sched_priority << endl;
+	}
+	return success;
+}
+
+PeriodicTimer::PeriodicTimer(int64_t periodNanos)
+{
+	periodNanos_ = periodNanos;
+	start();
+}
+
+void PeriodicTimer::setPeriod(int64_t periodNanos)
+{
+	periodNanos_ = periodNanos;
+}
+
+void PeriodicTimer::start()
+{
+	clock_gettime(CLOCK_MONOTONIC, &deadline_);
+	deadline_.tv_sec += periodNanos_ / 1000000000LL;
+	deadline_.tv_nsec += periodNanos_ % 1000000000LL;
+	if (deadline_.tv_nsec >= 1000000000L)
+	{
+		deadline_.tv_sec++;
+		deadline_.tv_nsec -= 1000000000L;
+	}
+}
+
+// if the loop overran by more than a period, the missed deadlines are
+// skipped rather than run back to back
+int64_t PeriodicTimer::wait()
+{
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline_, NULL) == EINTR)
+		;
+	int64_t deadline = (int64_t)deadline_.tv_sec * 1000000000LL + deadline_.tv_nsec;
+	int64_t lateness = monotonicNanos() - deadline;
+	int64_t next = deadline + periodNanos_;
+	if (lateness > periodNanos_)
+		next += (lateness / periodNanos_) * periodNanos_;
+	deadline_.tv_sec = next / 1000000000LL;
+	deadline_.tv_nsec = next % 1000000000LL;
+	return lateness;
+}
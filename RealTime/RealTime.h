@@ -0,0 +1,54 @@
+// RealTime.h
+// 10/18/2026
+
+// Opt-in real-time execution for time critical threads such as
+// SerialBot's comm thread and the wall follower's control stage
+
+// enterRealTime applies a RealTimeConfig to the calling thread:
+//    locks current and future memory so the thread never page faults
+//    pre-faults part of the thread's stack
+//    pins the thread to a single cpu
+//    switches the thread to SCHED_FIFO at the given priority
+// Each step is attempted independently; a step that fails (usually for
+// lack of CAP_SYS_NICE / CAP_IPC_LOCK or an RLIMIT) is logged to cerr and
+// the thread keeps running with normal scheduling
+
+// PeriodicTimer sleeps to absolute deadlines on the monotonic clock, so
+// the period doesn't stretch by however long the loop body took
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+struct RealTimeConfig
+{
+	bool enabled; // nothing is changed unless this is set
+	int priority; // SCHED_FIFO priority, 1 (lowest) to 99 (highest)
+	int cpu; // cpu to pin the thread to, -1 leaves it unpinned
+	bool lockMemory; // mlockall current and future pages
+	size_t stackPrefault; // bytes of stack to touch before entering the loop
+};
+
+// returns a disabled config with sensible values for the other fields
+RealTimeConfig defaultRealTimeConfig();
+
+// applies config to the calling thread, name is used in log messages
+// returns true only if every requested step succeeded
+bool enterRealTime(const char* name, const RealTimeConfig& config);
+
+class PeriodicTimer
+{
+public:
+	PeriodicTimer(int64_t periodNanos);
+	void setPeriod(int64_t periodNanos);
+	void start(); // sets the first deadline one period from now
+	int64_t wait(); // sleeps until the next deadline, returns lateness in ns
+private:
+	int64_t periodNanos_;
+	struct timespec deadline_;
+};
+
+#endif
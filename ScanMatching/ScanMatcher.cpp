@@ -0,0 +1,263 @@
+// ScanMatcher.cpp
+// 10/18/2026
+
+// Corrects wheel odometry by aligning each sonar scan against a map of
+// recently seen points
+// See ScanMatcher.h for a description of the matching
+
+#include "ScanMatcher.h"
+
+const double huberThreshold = 3.0; // residuals beyond this (cm) are down-weighted
+const double residualGate = 8.0; // residuals beyond this (cm) are ignored
+const int maxNeighbours = 32; // map points used to fit each local line
+const double maxFlatness = 0.05; // largest minor/major axis variance ratio of a line
+const double minLineSpread = 5.0; // smallest std dev (cm) along a line's major axis
+
+// solves the symmetric 3x3 system a x = b by Cramer's rule
+// returns false if a is singular
+static bool solve3x3(double a[3][3], const double* b, double* x)
+{
+	double c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+	double c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+	double c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+	double determinant = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+	if (fabs(determinant) < 1e-12)
+		return false;
+	double inverse[3][3];
+	inverse[0][0] = c00;
+	inverse[1][0] = c01;
+	inverse[2][0] = c02;
+	inverse[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+	inverse[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+	inverse[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+	inverse[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+	inverse[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+	inverse[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+	for (int i = 0; i < 3; i++)
+		x[i] = (inverse[i][0] * b[0] + inverse[i][1] * b[1] + inverse[i][2] * b[2]) / determinant;
+	return true;
+}
+
+// fits a line to the given map points
+// writes their centroid and the line's unit normal, returns false if
+// the points are too round to define a line
+bool ScanMatcher::fitLine(const int* ids, int numIds, double* cx, double* cy,
+                          double* nx, double* ny)
+{
+	double meanX = 0.0, meanY = 0.0;
+	for (int i = 0; i < numIds; i++)
+	{
+		meanX += hash_.getX(ids[i]);
+		meanY += hash_.getY(ids[i]);
+	}
+	meanX /= numIds;
+	meanY /= numIds;
+	double sxx = 0.0, sxy = 0.0, syy = 0.0;
+	for (int i = 0; i < numIds; i++)
+	{
+		double dx = hash_.getX(ids[i]) - meanX;
+		double dy = hash_.getY(ids[i]) - meanY;
+		sxx += dx * dx;
+		sxy += dx * dy;
+		syy += dy * dy;
+	}
+	double half = 0.5 * (sxx + syy);
+	double spread = sqrt(0.25 * (sxx - syy) * (sxx - syy) + sxy * sxy);
+	double major = half + spread;
+	double minor = half - spread;
+	if (major < minLineSpread * minLineSpread * numIds || minor > maxFlatness * major)
+		return false;
+	double angle = 0.5 * atan2(2.0 * sxy, sxx - syy);
+	*cx = meanX;
+	*cy = meanY;
+	*nx = -sin(angle);
+	*ny = cos(angle);
+	return true;
+}
+
+ScanMatcher::ScanMatcher(int mapCapacity, float maxDistance)
+	: hash_(mapCapacity, maxDistance)
+{
+	capacity_ = mapCapacity;
+	maxDistance_ = maxDistance;
+	maxIterations_ = 10;
+	minMatches_ = 3;
+	measurementSigma_ = 2.0;
+	odometryNoise_ = 0.05;
+	reset();
+}
+
+ScanMatcher::~ScanMatcher()
+{
+}
+
+void ScanMatcher::reset()
+{
+	hash_.clear();
+	head_ = 0;
+	havePose_ = false;
+	pose_ = makePose(0.0, 0.0, 0.0);
+}
+
+void ScanMatcher::setMaxIterations(int maxIterations)
+{
+	maxIterations_ = maxIterations;
+}
+
+void ScanMatcher::setMinMatches(int minMatches)
+{
+	minMatches_ = minMatches;
+}
+
+void ScanMatcher::setNoise(double measurementSigma, double odometryNoise)
+{
+	measurementSigma_ = measurementSigma;
+	odometryNoise_ = odometryNoise;
+}
+
+ScanMatchResult ScanMatcher::processScan(const Point* points, int numPoints,
+                                         const Pose2D& odometry)
+{
+	Pose2D prediction = odometry;
+	if (havePose_)
+		prediction = composePose(pose_, relativePose(lastOdometry_, odometry));
+	lastOdometry_ = odometry;
+	havePose_ = true;
+
+	// odometry uncertainty grows with the distance and angle moved
+	double distance = hypot(prediction.x - pose_.x, prediction.y - pose_.y);
+	double turn = fabs(normalizeAngle(prediction.theta - pose_.theta));
+	double sigmaXY = 0.5 + odometryNoise_ * distance;
+	double sigmaTheta = 0.002 + odometryNoise_ * (turn + 0.01 * distance);
+	priorXY_ = 1.0 / (sigmaXY * sigmaXY);
+	priorTheta_ = 1.0 / (sigmaTheta * sigmaTheta);
+
+	ScanMatchResult result = match(points, numPoints, prediction);
+	pose_ = result.pose;
+	addToMap(points, numPoints, pose_);
+	return result;
+}
+
+ScanMatchResult ScanMatcher::match(const Point* points, int numPoints, const Pose2D& guess)
+{
+	ScanMatchResult result;
+	result.pose = guess;
+	result.iterations = 0;
+	result.matches = 0;
+	result.meanResidual = 0.0;
+	result.matched = false;
+	if (hash_.getSize() < 2)
+		return result;
+
+	int neighbours[maxNeighbours];
+	double measurementWeight = 1.0 / (measurementSigma_ * measurementSigma_);
+	Pose2D pose = guess;
+	for (int iteration = 0; iteration < maxIterations_; iteration++)
+	{
+		double c = cos(pose.theta);
+		double s = sin(pose.theta);
+		double hessian[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+		double gradient[3] = {0.0, 0.0, 0.0};
+		int matches = 0;
+		double residualSum = 0.0;
+		for (int i = 0; i < numPoints; i++)
+		{
+			Point point = points[i];
+			double px = point.getX();
+			double py = point.getY();
+			double wx = pose.x + c * px - s * py;
+			double wy = pose.y + s * px + c * py;
+			int nearest = hash_.findNearest((float)wx, (float)wy, maxDistance_, NULL);
+			if (nearest < 0)
+				continue;
+
+			// local line through the map points around the nearest one,
+			// from the principal axis of their scatter
+			// points without a line are skipped rather than matched
+			// point-to-point: a sonar's hits slide along a wall as the
+			// robot drives, so matching a hit to the last hit from the
+			// same sensor would pull the pose back to where it was
+			double mx, my, nx, ny;
+			int numNeighbours = hash_.findWithin(hash_.getX(nearest), hash_.getY(nearest),
+			                                     maxDistance_, neighbours, maxNeighbours);
+			if (numNeighbours < 3 || !fitLine(neighbours, numNeighbours, &mx, &my, &nx, &ny))
+				continue;
+
+			double residual = nx * (wx - mx) + ny * (wy - my);
+			double magnitude = fabs(residual);
+			if (magnitude > residualGate)
+				continue;
+			double jacobian[3] = {nx, ny, nx * (-s * px - c * py) + ny * (c * px - s * py)};
+			double weight = (magnitude <= huberThreshold) ? 1.0 : huberThreshold / magnitude;
+			weight *= measurementWeight;
+			for (int row = 0; row < 3; row++)
+			{
+				gradient[row] += weight * jacobian[row] * residual;
+				for (int col = 0; col < 3; col++)
+					hessian[row][col] += weight * jacobian[row] * jacobian[col];
+			}
+			matches++;
+			residualSum += magnitude;
+		}
+
+		result.iterations = iteration + 1;
+		result.matches = matches;
+		result.meanResidual = (matches > 0) ? residualSum / matches : 0.0;
+		if (matches < minMatches_)
+			return result;
+
+		// odometry prior pulls the pose toward the prediction
+		gradient[0] += priorXY_ * (pose.x - guess.x);
+		gradient[1] += priorXY_ * (pose.y - guess.y);
+		gradient[2] += priorTheta_ * normalizeAngle(pose.theta - guess.theta);
+		hessian[0][0] += priorXY_;
+		hessian[1][1] += priorXY_;
+		hessian[2][2] += priorTheta_;
+		double negGradient[3] = {-gradient[0], -gradient[1], -gradient[2]};
+		double step[3];
+		if (!solve3x3(hessian, negGradient, step))
+			return result;
+		pose.x += step[0];
+		pose.y += step[1];
+		pose.theta = normalizeAngle(pose.theta + step[2]);
+		if (fabs(step[0]) < 0.01 && fabs(step[1]) < 0.01 && fabs(step[2]) < 1e-4)
+			break;
+	}
+
+	// a correction bigger than the match radius means the match slid
+	// somewhere it shouldn't have
+	if (result.matches < minMatches_)
+		return result;
+	if (hypot(pose.x - guess.x, pose.y - guess.y) <= maxDistance_)
+	{
+		result.pose = pose;
+		result.matched = true;
+	}
+	return result;
+}
+
+void ScanMatcher::addToMap(const Point* points, int numPoints, const Pose2D& pose)
+{
+	double c = cos(pose.theta);
+	double s = sin(pose.theta);
+	for (int i = 0; i < numPoints; i++)
+	{
+		Point point = points[i];
+		double px = point.getX();
+		double py = point.getY();
+		hash_.remove(head_);
+		hash_.insert(head_, (float)(pose.x + c * px - s * py),
+		             (float)(pose.y + s * px + c * py));
+		head_ = (head_ + 1 == capacity_) ? 0 : head_ + 1;
+	}
+}
+
+Pose2D ScanMatcher::getPose()
+{
+	return pose_;
+}
+
+int ScanMatcher::getMapSize()
+{
+	return hash_.getSize();
+}
@@ -0,0 +1,80 @@
+// ScanMatcher.h
+// 10/18/2026
+
+// Corrects wheel odometry by aligning each sonar scan against a map of
+// recently seen points (point-to-line ICP)
+
+// processScan predicts the pose by applying the odometry change since
+// the last scan to the last corrected pose, then refines it:
+//    each scan point is moved into the world frame with the current guess
+//    a line fitted to the map points around its nearest neighbour (found
+//    through a SpatialHash) gives the local surface; points with no
+//    line-like neighbourhood are left out
+//    Gauss-Newton steps minimize the points' distances to their lines
+//    plus an odometry prior that grows weaker the farther the robot moved
+// Iteration stops when the step is tiny or after maxIterations, which
+// bounds the cost per cycle; with too few matches the prediction is kept
+// The prior keeps directions the scan can't see (along a single straight
+// wall, for instance) at the odometry prediction
+
+// The scan is then added to the local map with the corrected pose; the
+// map is a fixed capacity ring, the oldest points dropping out of the
+// spatial hash as new ones arrive
+
+#ifndef SCANMATCHER_H
+#define SCANMATCHER_H
+
+#include "SpatialHash.h"
+#include "../Geometry/Pose2D.h"
+#include "../LineFitter/Point.h"
+
+struct ScanMatchResult
+{
+	Pose2D pose; // corrected pose
+	int iterations; // Gauss-Newton iterations run
+	int matches; // scan points matched to the map in the last iteration
+	double meanResidual; // mean absolute point-to-line distance in cm
+	bool matched; // false if the prediction was used unrefined
+};
+
+class ScanMatcher
+{
+public:
+	// mapCapacity points are kept, matches farther than maxDistance (cm) are ignored
+	ScanMatcher(int mapCapacity, float maxDistance);
+	~ScanMatcher();
+	void reset(); // clears the map and starts from the next odometry pose
+	void setMaxIterations(int maxIterations);
+	void setMinMatches(int minMatches);
+	// sonar point noise in cm, odometry noise as a fraction of motion
+	void setNoise(double measurementSigma, double odometryNoise);
+	// points are in the robot's local frame, odometry is the pose from the
+	// same sensor packet
+	ScanMatchResult processScan(const Point* points, int numPoints, const Pose2D& odometry);
+	Pose2D getPose(); // last corrected pose
+	int getMapSize();
+
+private:
+	SpatialHash hash_;
+	int capacity_;
+	int head_; // ring slot the next map point goes in
+	float maxDistance_;
+	int maxIterations_;
+	int minMatches_;
+	double measurementSigma_;
+	double odometryNoise_;
+	double priorXY_; // odometry prior weights for the current scan
+	double priorTheta_;
+	bool havePose_;
+	Pose2D lastOdometry_;
+	Pose2D pose_;
+
+	ScanMatchResult match(const Point* points, int numPoints, const Pose2D& guess);
+	void addToMap(const Point* points, int numPoints, const Pose2D& pose);
+	bool fitLine(const int* ids, int numIds, double* cx, double* cy, double* nx, double* ny);
+
+	ScanMatcher(const ScanMatcher&); // not copyable
+	ScanMatcher& operator=(const ScanMatcher&);
+};
+
+#endif
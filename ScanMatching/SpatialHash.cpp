@@ -0,0 +1,177 @@
+// SpatialHash.cpp
+// 10/18/2026
+
+// Uniform grid hash for nearest neighbour queries on a changing point set
+// See SpatialHash.h for usage
+
+#include "SpatialHash.h"
+#include <math.h>
+
+SpatialHash::SpatialHash(int capacity, float cellSize)
+{
+	capacity_ = capacity;
+	inverseCellSize_ = 1.0f / cellSize;
+	numBuckets_ = 16;
+	while (numBuckets_ < 2 * capacity_)
+		numBuckets_ <<= 1;
+	buckets_ = new int[numBuckets_];
+	next_ = new int[capacity_];
+	prev_ = new int[capacity_];
+	bucketOf_ = new int[capacity_];
+	x_ = new float[capacity_];
+	y_ = new float[capacity_];
+	clear();
+}
+
+SpatialHash::~SpatialHash()
+{
+	delete[] buckets_;
+	delete[] next_;
+	delete[] prev_;
+	delete[] bucketOf_;
+	delete[] x_;
+	delete[] y_;
+}
+
+void SpatialHash::clear()
+{
+	for (int i = 0; i < numBuckets_; i++)
+		buckets_[i] = -1;
+	for (int i = 0; i < capacity_; i++)
+		bucketOf_[i] = -1;
+	size_ = 0;
+}
+
+int SpatialHash::getBucket(int cx, int cy)
+{
+	unsigned hash = (unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u;
+	return (int)(hash & (unsigned)(numBuckets_ - 1));
+}
+
+void SpatialHash::insert(int id, float x, float y)
+{
+	int bucket = getBucket((int)floorf(x * inverseCellSize_), (int)floorf(y * inverseCellSize_));
+	x_[id] = x;
+	y_[id] = y;
+	bucketOf_[id] = bucket;
+	prev_[id] = -1;
+	next_[id] = buckets_[bucket];
+	if (buckets_[bucket] >= 0)
+		prev_[buckets_[bucket]] = id;
+	buckets_[bucket] = id;
+	size_++;
+}
+
+void SpatialHash::remove(int id)
+{
+	int bucket = bucketOf_[id];
+	if (bucket < 0)
+		return;
+	if (prev_[id] >= 0)
+		next_[prev_[id]] = next_[id];
+	else
+		buckets_[bucket] = next_[id];
+	if (next_[id] >= 0)
+		prev_[next_[id]] = prev_[id];
+	bucketOf_[id] = -1;
+	size_--;
+}
+
+bool SpatialHash::contains(int id)
+{
+	return bucketOf_[id] >= 0;
+}
+
+// different cells can share a bucket, so every candidate's distance is
+// checked, and a bucket reached twice from the 3x3 block is only scanned once
+int SpatialHash::findNearest(float x, float y, float maxDistance, int* second)
+{
+	int cx = (int)floorf(x * inverseCellSize_);
+	int cy = (int)floorf(y * inverseCellSize_);
+	float best = maxDistance * maxDistance;
+	float secondBest = best;
+	int bestId = -1;
+	int secondId = -1;
+	int visited[9];
+	int numVisited = 0;
+	for (int dy = -1; dy <= 1; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			int bucket = getBucket(cx + dx, cy + dy);
+			bool seen = false;
+			for (int i = 0; i < numVisited; i++)
+				seen = seen || visited[i] == bucket;
+			if (seen)
+				continue;
+			visited[numVisited++] = bucket;
+			for (int id = buckets_[bucket]; id >= 0; id = next_[id])
+			{
+				float ex = x_[id] - x;
+				float ey = y_[id] - y;
+				float distance = ex * ex + ey * ey;
+				if (distance < best)
+				{
+					secondBest = best;
+					secondId = bestId;
+					best = distance;
+					bestId = id;
+				}
+				else if (distance < secondBest)
+				{
+					secondBest = distance;
+					secondId = id;
+				}
+			}
+		}
+	}
+	if (second != NULL)
+		*second = secondId;
+	return bestId;
+}
+
+int SpatialHash::findWithin(float x, float y, float radius, int* ids, int maxIds)
+{
+	int cx = (int)floorf(x * inverseCellSize_);
+	int cy = (int)floorf(y * inverseCellSize_);
+	float limit = radius * radius;
+	int found = 0;
+	int visited[9];
+	int numVisited = 0;
+	for (int dy = -1; dy <= 1; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			int bucket = getBucket(cx + dx, cy + dy);
+			bool seen = false;
+			for (int i = 0; i < numVisited; i++)
+				seen = seen || visited[i] == bucket;
+			if (seen)
+				continue;
+			visited[numVisited++] = bucket;
+			for (int id = buckets_[bucket]; id >= 0 && found < maxIds; id = next_[id])
+			{
+				float ex = x_[id] - x;
+				float ey = y_[id] - y;
+				if (ex * ex + ey * ey <= limit)
+					ids[found++] = id;
+			}
+		}
+	}
+	return found;
+}
+
+float SpatialHash::getX(int id)
+{
+	return x_[id];
+}
+
+float SpatialHash::getY(int id)
+{
+	return y_[id];
+}
+
+int SpatialHash::getSize()
+{
+	return size_;
+}
@@ -0,0 +1,54 @@
+// SpatialHash.h
+// 10/18/2026
+
+// Uniform grid hash for nearest neighbour queries on a changing point set
+// Space is cut into square cells of cellSize; each cell hashes to a
+// bucket holding a doubly linked list of the points in it, so points can
+// be inserted and removed in constant time as a local map slides along
+// A nearest neighbour query only looks at the 3x3 block of cells around
+// the query, so the search radius must be at most cellSize
+
+// Points are identified by an id from 0 to capacity - 1, normally their
+// slot in the caller's ring buffer; all storage is allocated up front
+
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+class SpatialHash
+{
+public:
+	SpatialHash(int capacity, float cellSize);
+	~SpatialHash();
+	void clear();
+	void insert(int id, float x, float y); // id must not already be present
+	void remove(int id); // no effect if id isn't present
+	bool contains(int id);
+	// returns the id of the nearest point within maxDistance (<= cellSize)
+	// or -1, and the second nearest in second if it isn't NULL
+	int findNearest(float x, float y, float maxDistance, int* second);
+	// writes the ids of up to maxIds points within radius (<= cellSize)
+	// to ids, returns the number written
+	int findWithin(float x, float y, float radius, int* ids, int maxIds);
+	float getX(int id);
+	float getY(int id);
+	int getSize();
+
+private:
+	int capacity_;
+	int numBuckets_; // power of two
+	float inverseCellSize_;
+	int size_;
+	int* buckets_; // head id per bucket, -1 if empty
+	int* next_; // linked list links per id
+	int* prev_;
+	int* bucketOf_; // bucket per id, -1 if not present
+	float* x_;
+	float* y_;
+
+	int getBucket(int cx, int cy);
+
+	SpatialHash(const SpatialHash&); // not copyable
+	SpatialHash& operator=(const SpatialHash&);
+};
+
+#endif
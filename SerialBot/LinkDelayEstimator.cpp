@@ -0,0 +1,67 @@
+// LinkDelayEstimator.cpp
+// 10/18/2026
+
+// Serial link delay estimate, see LinkDelayEstimator.h
+
+#include "LinkDelayEstimator.h"
+
+LinkDelayEstimator::LinkDelayEstimator()
+{
+	reset();
+}
+
+void LinkDelayEstimator::reset()
+{
+	roundTrip_ = 0;
+	deviation_ = 0;
+	exchanges_ = 0;
+}
+
+// the deviation is updated against the old average, as RFC 6298 orders it
+void LinkDelayEstimator::addExchange(int64_t sent, int64_t received)
+{
+	int64_t sample = received - sent;
+	if (sample < 0)
+		return;
+	if (exchanges_ == 0)
+	{
+		roundTrip_ = sample;
+		deviation_ = sample / 2;
+	}
+	else
+	{
+		int64_t error = sample - roundTrip_;
+		deviation_ += ((error < 0 ? -error : error) - deviation_) / 4;
+		roundTrip_ += error / 8;
+	}
+	exchanges_++;
+}
+
+int64_t LinkDelayEstimator::getRoundTrip()
+{
+	return roundTrip_;
+}
+
+int64_t LinkDelayEstimator::getDeviation()
+{
+	return deviation_;
+}
+
+int64_t LinkDelayEstimator::getOneWay()
+{
+	return roundTrip_ / 2;
+}
+
+uint32_t LinkDelayEstimator::getExchanges()
+{
+	return exchanges_;
+}
+
+void LinkDelayEstimator::stampFrame(SensorFrame* frame, int64_t sent, int64_t received, int64_t nextSent)
+{
+	addExchange(sent, received);
+	int64_t oneWay = getOneWay();
+	frame->timestamp = received;
+	frame->sampledAt = received - oneWay;
+	frame->commandAt = nextSent + oneWay;
+}
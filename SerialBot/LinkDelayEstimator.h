@@ -0,0 +1,44 @@
+// LinkDelayEstimator.h
+// 10/18/2026
+
+// Estimates the delay of the serial link to Colin from command/response
+// timing, and stamps SensorFrames with when their readings were taken
+// and when the next command will take effect
+// Every exchange sends a command and waits for the sensor packet sent in
+// reply, so sent to received is one round trip. Round trips are smoothed
+// as TCP smooths them (RFC 6298): an average with gain 1/8 and a mean
+// deviation with gain 1/4
+// The link is taken to be symmetric, so a command takes effect half a
+// round trip after it's sent and a packet's readings are half a round
+// trip old when it arrives. At 9600 baud the sensor packet takes longer
+// on the wire than the command, so this puts the readings a little
+// earlier than they were taken and commands a little later than they act
+
+#ifndef LINKDELAYESTIMATOR_H
+#define LINKDELAYESTIMATOR_H
+
+#include <stdint.h>
+#include "SensorFrame.h"
+
+class LinkDelayEstimator
+{
+public:
+	LinkDelayEstimator();
+	void reset();
+	// one exchange: command sent and reply received, monotonic ns
+	void addExchange(int64_t sent, int64_t received);
+	int64_t getRoundTrip(); // smoothed, ns; 0 before any exchange
+	int64_t getDeviation(); // mean deviation of the round trip, ns
+	int64_t getOneWay(); // half the smoothed round trip, ns
+	uint32_t getExchanges();
+	// adds the exchange and fills frame's timestamp, sampledAt and
+	// commandAt; nextSent is when the next command goes out
+	void stampFrame(SensorFrame* frame, int64_t sent, int64_t received, int64_t nextSent);
+
+private:
+	int64_t roundTrip_;
+	int64_t deviation_;
+	uint32_t exchanges_;
+};
+
+#endif
@@ -0,0 +1,93 @@
+// PacketCodec.cpp
+// 10/18/2026
+
+// Colin's serial packets, see PacketCodec.h and SerialBot.h
+
+#include "PacketCodec.h"
+#include <string.h>
+
+static void put16(char* packet, int16_t value)
+{
+	packet[0] = (char)(value & 0xFF);
+	packet[1] = (char)((value >> 8) & 0xFF);
+}
+
+static int16_t get16(const char* packet)
+{
+	return (int16_t)((uint8_t)packet[0] | ((uint8_t)packet[1] << 8));
+}
+
+void encodeCommandPacket(char* packet, int16_t translational, double angular)
+{
+	put16(packet, translational);
+	put16(packet + 2, (int16_t)(int)(angular * 1000.0));
+}
+
+void decodeCommandPacket(const char* packet, int16_t* translational, double* angular)
+{
+	*translational = get16(packet);
+	*angular = get16(packet + 2) / 1000.0;
+}
+
+void encodeSensorPacket(char* packet, const SensorPacket& sensors)
+{
+	for (int i = 0; i < sensors.numSonar; i++)
+		put16(packet + 2 * i, sensors.distances[i]);
+	char* pose = packet + 2 * sensors.numSonar;
+	put16(pose, sensors.x);
+	put16(pose + 2, sensors.y);
+	put16(pose + 4, (int16_t)(int)(sensors.theta * 1000.0));
+}
+
+void decodeSensorPacket(const char* packet, int numSonar, SensorPacket* sensors)
+{
+	sensors->numSonar = numSonar;
+	for (int i = 0; i < numSonar; i++)
+		sensors->distances[i] = get16(packet + 2 * i);
+	const char* pose = packet + 2 * numSonar;
+	sensors->x = get16(pose);
+	sensors->y = get16(pose + 2);
+	sensors->theta = get16(pose + 4) / 1000.0;
+}
+
+PacketAssembler::PacketAssembler(int packetSize)
+{
+	packetSize_ = packetSize;
+	packet_ = new char[packetSize];
+	length_ = 0;
+}
+
+PacketAssembler::~PacketAssembler()
+{
+	delete [] packet_;
+}
+
+int PacketAssembler::append(const char* data, int length)
+{
+	int taken = packetSize_ - length_;
+	if (taken > length)
+		taken = length;
+	memcpy(packet_ + length_, data, taken);
+	length_ += taken;
+	return taken;
+}
+
+bool PacketAssembler::isComplete()
+{
+	return length_ == packetSize_;
+}
+
+const char* PacketAssembler::getPacket()
+{
+	return packet_;
+}
+
+int PacketAssembler::getLength()
+{
+	return length_;
+}
+
+void PacketAssembler::reset()
+{
+	length_ = 0;
+}
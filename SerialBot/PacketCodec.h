@@ -0,0 +1,65 @@
+// PacketCodec.h
+// 10/18/2026
+
+// Packing and unpacking of the packets exchanged with Colin's ATmega328,
+// shared by SerialBot and FleetManager; the formats are described in
+// SerialBot.h
+// 16 bit values are rebuilt from unsigned bytes, so a low byte of 0x80 or
+// more (a 200 cm reading, say) isn't sign extended over the high byte
+
+// PacketAssembler collects a packet from reads that may each return only
+// part of it, for links read without blocking
+
+#ifndef PACKETCODEC_H
+#define PACKETCODEC_H
+
+#include <stdint.h>
+#include "SensorFrame.h"
+
+const int commandPacketSize = 4;
+const int numPoseVariables = 3;
+
+constexpr int sensorPacketSize(int numSonar)
+{
+	return (numSonar + numPoseVariables) * 2;
+}
+
+const int maxSensorPacketSize = sensorPacketSize(maxSonar);
+
+struct SensorPacket
+{
+	int numSonar;
+	int16_t distances[maxSonar]; // cm
+	int16_t x, y; // cm
+	double theta; // rad
+};
+
+// angular is sent in thousandths of a rad/s, truncated
+void encodeCommandPacket(char* packet, int16_t translational, double angular);
+void decodeCommandPacket(const char* packet, int16_t* translational, double* angular);
+// numSonar must be at most maxSonar
+void encodeSensorPacket(char* packet, const SensorPacket& sensors);
+void decodeSensorPacket(const char* packet, int numSonar, SensorPacket* sensors);
+
+class PacketAssembler
+{
+public:
+	PacketAssembler(int packetSize);
+	~PacketAssembler();
+	// takes bytes until the packet is complete, returns how many it took
+	int append(const char* data, int length);
+	bool isComplete();
+	const char* getPacket();
+	int getLength(); // bytes collected so far
+	void reset(); // drops the packet, complete or not
+
+private:
+	char* packet_;
+	int packetSize_;
+	int length_;
+
+	PacketAssembler(const PacketAssembler&); // not copyable
+	PacketAssembler& operator=(const PacketAssembler&);
+};
+
+#endif
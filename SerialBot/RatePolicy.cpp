@@ -0,0 +1,91 @@
+// RatePolicy.cpp
+// 10/18/2026
+
+// Exchange rate policies for SerialBot, see RatePolicy.h
+
+#include "RatePolicy.h"
+#include "PacketCodec.h"
+#include <math.h>
+
+const int bitsPerByte = 10; // 8N1: start, 8 data, stop
+
+int minLinkPeriod(int baudRate, int numSonar, double share)
+{
+	double bits = (double)(commandPacketSize + sensorPacketSize(numSonar)) * bitsPerByte;
+	return (int)ceil(bits / baudRate / share * 1e6);
+}
+
+AdaptiveRateConfig defaultAdaptiveRateConfig()
+{
+	AdaptiveRateConfig config;
+	config.minPeriod = 62500; // 16 Hz
+	config.cruisePeriod = 250000; // 4 Hz, as SerialBot always ran
+	config.idlePeriod = 1000000;
+	config.fastSpeed = 150.0;
+	config.fastAngular = 1.5;
+	config.nearRange = 30;
+	config.farRange = 150;
+	config.idleFrames = 4;
+	config.maxLinkShare = 0.5;
+	config.hysteresis = 0.2;
+	return config;
+}
+
+AdaptiveRatePolicy::AdaptiveRatePolicy(const AdaptiveRateConfig& config, int baudRate, int numSonar)
+{
+	config_ = config;
+	int linkPeriod = minLinkPeriod(baudRate, numSonar, config.maxLinkShare);
+	minPeriod_ = (config.minPeriod > linkPeriod) ? config.minPeriod : linkPeriod;
+	if (config_.cruisePeriod < minPeriod_)
+		config_.cruisePeriod = minPeriod_;
+	period_ = config_.cruisePeriod;
+	stoppedFrames_ = 0;
+	reason_ = "cruise";
+}
+
+// urgency is interpolated in rate rather than period, so halfway between
+// 4 Hz and 16 Hz is 10 Hz
+int AdaptiveRatePolicy::getPeriod(const SensorFrame& frame)
+{
+	bool stopped = frame.translational == 0 && frame.angular == 0.0;
+	stoppedFrames_ = stopped ? stoppedFrames_ + 1 : 0;
+	int period;
+	const char* reason;
+	if (stoppedFrames_ >= config_.idleFrames)
+	{
+		period = config_.idlePeriod;
+		reason = "idle";
+	}
+	else
+	{
+		double speed = fmax(fabs((double)frame.translational) / config_.fastSpeed,
+		                    fabs(frame.angular) / config_.fastAngular);
+		int nearest = config_.farRange;
+		for (int i = 0; i < frame.numSonar; i++)
+			if (frame.distances[i] > 0 && frame.distances[i] < nearest)
+				nearest = frame.distances[i];
+		double proximity = (double)(config_.farRange - nearest)
+		                   / (config_.farRange - config_.nearRange);
+		double urgency = fmin(1.0, fmax(speed, proximity));
+		reason = (urgency <= 0.0) ? "cruise" : (speed >= proximity) ? "speed" : "proximity";
+		double slowRate = 1.0 / config_.cruisePeriod, fastRate = 1.0 / minPeriod_;
+		period = (int)lround(1.0 / (slowRate + urgency * (fastRate - slowRate)));
+	}
+	if (fabs((double)(period - period_)) > config_.hysteresis * period_
+	    || (period == config_.idlePeriod) != (period_ == config_.idlePeriod))
+	{
+		period_ = period;
+		reason_ = reason;
+	}
+	return period_;
+}
+
+const char* AdaptiveRatePolicy::getReason()
+{
+	return reason_;
+}
+
+int AdaptiveRatePolicy::getMinPeriod()
+{
+	return minPeriod_;
+}
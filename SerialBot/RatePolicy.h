@@ -0,0 +1,75 @@
+// RatePolicy.h
+// 10/18/2026
+
+// Chooses how often SerialBot exchanges a command and a sensor packet
+// with Colin. After every packet the comm thread asks its policy for the
+// time until the next exchange, given the frame just parsed; a SerialBot
+// without a policy keeps its configured readPeriod
+// getReason names what decided the last period, for SerialBot's log of
+// rate changes
+
+// AdaptiveRatePolicy exchanges quickly when fresh data matters and slowly
+// when it doesn't:
+//    moving: the rate rises from cruisePeriod's toward minPeriod's with
+//            the larger of the commanded translational and angular speed
+//            (as fractions of fastSpeed and fastAngular) and how close the
+//            nearest reading is (from farRange down to nearRange)
+//    stopped: after idleFrames frames with both speeds commanded to 0, the
+//            period drops to idlePeriod; SerialBot wakes early for a
+//            command that starts Colin moving, so idling doesn't delay it
+// minPeriod is raised to what the link can carry, so the exchanges never
+// take more than maxLinkShare of the serial line's time (minLinkPeriod)
+// A new period is only taken if it differs from the current one by more
+// than the hysteresis fraction, so noisy readings don't make it hunt
+
+#ifndef RATEPOLICY_H
+#define RATEPOLICY_H
+
+#include "SensorFrame.h"
+
+class RatePolicy
+{
+public:
+	virtual ~RatePolicy() {}
+	// microseconds until the next exchange
+	virtual int getPeriod(const SensorFrame& frame) = 0;
+	virtual const char* getReason() = 0;
+};
+
+// shortest period, in microseconds, at which a command and a sensor
+// packet each exchange use at most share of a link at baudRate (8N1)
+int minLinkPeriod(int baudRate, int numSonar, double share);
+
+struct AdaptiveRateConfig
+{
+	int minPeriod; // us
+	int cruisePeriod; // us
+	int idlePeriod; // us
+	double fastSpeed; // cm/s
+	double fastAngular; // rad/s
+	int nearRange; // cm
+	int farRange; // cm
+	int idleFrames;
+	double maxLinkShare; // fraction of the link's time exchanges may use
+	double hysteresis; // fraction of the current period
+};
+
+AdaptiveRateConfig defaultAdaptiveRateConfig();
+
+class AdaptiveRatePolicy : public RatePolicy
+{
+public:
+	AdaptiveRatePolicy(const AdaptiveRateConfig& config, int baudRate, int numSonar);
+	int getPeriod(const SensorFrame& frame);
+	const char* getReason();
+	int getMinPeriod(); // after the link limit
+
+private:
+	AdaptiveRateConfig config_;
+	int minPeriod_;
+	int period_;
+	int stoppedFrames_;
+	const char* reason_;
+};
+
+#endif
@@ -0,0 +1,37 @@
+// Robot.h
+// 10/18/2026
+
+// Interface to Colin shared by SerialBot, which talks to the real robot,
+// and SimBot, which simulates it, so control programs can run against
+// either one
+// See SerialBot.h for what each call does
+
+#ifndef ROBOT_H
+#define ROBOT_H
+
+#include <stdint.h>
+#include "SensorFrame.h"
+#include "../Pipeline/SpscQueue.h"
+#include "../RealTime/RealTime.h"
+#include "../Telemetry/TelemetryWriter.h"
+
+class Robot
+{
+public:
+	virtual ~Robot() {}
+	virtual void setSpeed(int translational, double angular) = 0;
+	virtual int getNumSonar() = 0;
+	virtual void getDistances(int* distances) = 0;
+	virtual void getPose(int* x, int* y, double* theta) = 0;
+	virtual void setFrameQueue(SpscQueue<SensorFrame>* frameQueue) = 0;
+	virtual void setTelemetry(TelemetryWriter* telemetry) = 0;
+	virtual uint32_t getFramesReceived() = 0;
+	virtual uint32_t getFramesDropped() = 0;
+	virtual int64_t getRoundTrip() = 0;
+	virtual int64_t getSnapshotAge() = 0;
+	virtual bool isStale() = 0;
+	virtual void setRealTime(const RealTimeConfig& config) = 0;
+	virtual void commThreadFunction() = 0;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// SensorFrame.h
+// 10/18/2026
+
+// Snapshot of one sensor packet received from Colin along with the
+// command that was in effect when it was requested
+// SerialBot pushes one SensorFrame per parsed packet to its frame queue
+// so downstream threads never touch SerialBot's members directly
+// sampledAt and commandAt come from the link delay estimate (see
+// LinkDelayEstimator.h), so control can act on where Colin will be when
+// its command lands rather than where it was when the sonars fired
+
+#ifndef SENSORFRAME_H
+#define SENSORFRAME_H
+
+#include <stdint.h>
+
+const int maxSonar = 16; // largest sonar array a frame can hold
+const double sonarBeamWidth = 0.26; // rad, full cone of Colin's sonars, about 15 degrees
+
+struct SensorFrame
+{
+	uint32_t sequence; // increments with every parsed sensor packet
+	int64_t timestamp; // monotonic time the packet was received in ns
+	int64_t sampledAt; // estimated time the readings and pose were taken
+	int64_t commandAt; // estimated time the next command sent takes effect
+	int numSonar; // number of valid entries in distances
+	int16_t distances[maxSonar]; // sonar readings in cm
+	int16_t x, y; // odometry position in cm
+	double theta; // odometry heading in radians
+	int16_t translational; // commanded translational speed in cm/s
+	double angular; // commanded angular velocity in rad/s
+};
+
+#endif
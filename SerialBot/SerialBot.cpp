@@ -32,11 +32,26 @@
 //   sonar 0 (LSB)  |  sonar 0 (MSB)  |  sonar 1 (LSB) | ... |   x position (LSB)    |    x position (MSB)    |    y position (LSB)    |    y position (MSB)    |  heading * 1000 (LSB)  |  heading * 1000 (MSB)  
 
 // commThreadFunction should be run in a separate thread
-// It will send a command and receive an update 4 times per second
+// It will send a command and receive an update every readPeriod, 4 times
+// per second by default
+// Accessors lock the bot's state, so they can be called from any thread
+// If a frame queue is set, every parsed sensor packet is also pushed to it
+// as a SensorFrame; frames are dropped and counted if the queue is full
+// setRealTime opts the comm thread into real-time scheduling, see RealTime.h
+// Frames are stamped with the link delay estimate, see LinkDelayEstimator.h
+// An optional RatePolicy sets the time between exchanges, see RatePolicy.h
+// Sensor packets are received without blocking, with a deadline and
+// bounded retries, see SerialBot.h
 
 #include "SerialBot.h"
+#include <poll.h>
+#include <errno.h>
 
-SerialBot::SerialBot()
+SerialBot::SerialBot() : SerialBot(defaultSerialBotConfig())
+{
+}
+
+SerialBot::SerialBot(const SerialBotConfig& config)
 {
 	// initialize member variables
 	x_ = 0;
@@ -45,70 +60,200 @@ SerialBot::SerialBot()
 	translational_ = 0;
 	angular_ = 0.0;
 	serialFd_ = -1;
-	readPeriod_ = 250000;
-	numSonar_ = 8;
-	sensorPacketSize_ = (numSonar_ + numPoseVariables) * 2;
+	readPeriod_ = config.readPeriod;
+	receiveTimeout_ = config.receiveTimeout;
+	maxRetries_ = config.maxRetries;
+	numSonar_ = (config.numSonar < maxSonar) ? config.numSonar : maxSonar;
+	sensorPacketSize_ = sensorPacketSize(numSonar_);
+	resetPin_ = config.resetPin;
+	exchangeTime_ = minLinkPeriod(config.baudRate, numSonar_, 1.0);
+	assembler_ = new PacketAssembler(sensorPacketSize_);
 	distances_ = new int16_t[numSonar_];
+	for (int i = 0; i < numSonar_; i++)
+		distances_[i] = 0;
+	pthread_mutex_init(&lock_, NULL);
+	frameQueue_ = NULL;
+	telemetry_ = NULL;
+	sequence_ = 0;
+	framesDropped_ = 0;
+	timeouts_ = 0;
+	retries_ = 0;
+	lastFrame_ = 0;
+	staleAt_ = 0;
+	realTime_ = defaultRealTimeConfig();
+	ratePolicy_ = NULL;
+	period_ = readPeriod_;
+	pthread_condattr_t wakeAttributes;
+	pthread_condattr_init(&wakeAttributes);
+	pthread_condattr_setclock(&wakeAttributes, CLOCK_MONOTONIC);
+	pthread_cond_init(&wake_, &wakeAttributes);
+	pthread_condattr_destroy(&wakeAttributes);
+	startRequested_ = false;
 	
 	resetController();
-	openSerial();
+	openSerial(config);
 }
 
 SerialBot::~SerialBot()
 {
 	delete[] distances_;
+	delete assembler_;
+	pthread_cond_destroy(&wake_);
+	pthread_mutex_destroy(&lock_);
+}
+
+int SerialBot::getNumSonar()
+{
+	return numSonar_;
 }
 
 void SerialBot::getDistances(int *distances)
 {
+	pthread_mutex_lock(&lock_);
 	for (int i = 0; i < numSonar_; i++)
 		distances[i] = distances_[i];
+	pthread_mutex_unlock(&lock_);
 }
 
 void SerialBot::getPose(int *x, int *y, double *theta)
 {
+	pthread_mutex_lock(&lock_);
 	*x = x_;
 	*y = y_;
 	*theta = theta_;
+	pthread_mutex_unlock(&lock_);
 }
 
 void SerialBot::setSpeed(int translational, double angular)
 {
+	pthread_mutex_lock(&lock_);
+	if (ratePolicy_ != NULL && translational_ == 0 && angular_ == 0.0
+	    && (translational != 0 || angular != 0.0))
+	{
+		startRequested_ = true;
+		pthread_cond_signal(&wake_);
+	}
 	translational_ = translational;
 	angular_ = angular;
+	pthread_mutex_unlock(&lock_);
+}
+
+// frameQueue must outlive the comm thread or be reset to NULL first
+void SerialBot::setFrameQueue(SpscQueue<SensorFrame>* frameQueue)
+{
+	pthread_mutex_lock(&lock_);
+	frameQueue_ = frameQueue;
+	pthread_mutex_unlock(&lock_);
+}
+
+// telemetry is written only by the comm thread, so it must be set before
+// the thread starts and outlive it
+void SerialBot::setTelemetry(TelemetryWriter* telemetry)
+{
+	telemetry_ = telemetry;
+}
+
+uint32_t SerialBot::getFramesReceived()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t received = sequence_;
+	pthread_mutex_unlock(&lock_);
+	return received;
+}
+
+uint32_t SerialBot::getFramesDropped()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t dropped = framesDropped_;
+	pthread_mutex_unlock(&lock_);
+	return dropped;
+}
+
+int64_t SerialBot::getRoundTrip()
+{
+	pthread_mutex_lock(&lock_);
+	int64_t roundTrip = linkDelay_.getRoundTrip();
+	pthread_mutex_unlock(&lock_);
+	return roundTrip;
+}
+
+int64_t SerialBot::getSnapshotAge()
+{
+	pthread_mutex_lock(&lock_);
+	int64_t age = (sequence_ > 0) ? monotonicNanos() - lastFrame_ : -1;
+	pthread_mutex_unlock(&lock_);
+	return age;
+}
+
+bool SerialBot::isStale()
+{
+	pthread_mutex_lock(&lock_);
+	bool stale = sequence_ > 0 && monotonicNanos() > staleAt_;
+	pthread_mutex_unlock(&lock_);
+	return stale;
+}
+
+uint32_t SerialBot::getTimeouts()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t timeouts = timeouts_;
+	pthread_mutex_unlock(&lock_);
+	return timeouts;
+}
+
+uint32_t SerialBot::getRetries()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t retries = retries_;
+	pthread_mutex_unlock(&lock_);
+	return retries;
+}
+
+void SerialBot::setRealTime(const RealTimeConfig& config)
+{
+	realTime_ = config;
+}
+
+// the policy is called only by the comm thread, so it must be set before
+// the thread starts and outlive it
+void SerialBot::setRatePolicy(RatePolicy* policy)
+{
+	pthread_mutex_lock(&lock_);
+	ratePolicy_ = policy;
+	pthread_mutex_unlock(&lock_);
+}
+
+int SerialBot::getPeriod()
+{
+	pthread_mutex_lock(&lock_);
+	int period = period_;
+	pthread_mutex_unlock(&lock_);
+	return period;
 }
 
 // opens serial connection with robot controller
-void SerialBot::openSerial()
+void SerialBot::openSerial(const SerialBotConfig& config)
 {
-	serialFd_ = open("/dev/serial0", O_RDWR); // left out O_NOCTTY and O_NDELAY
-																						// to allow blocking read
+	// non-blocking; receive waits for the sensor packet in poll
+	serialFd_ = openSerialPort(config.device, config.baudRate, 0);
 	if (serialFd_ == -1)
 	{
-		cerr << "Error - unable to open uart" << endl;
+		cerr << "Error - unable to open uart " << config.device << endl;
 		exit(-1);
 	}	
-	
-	struct termios options;
-	tcgetattr(serialFd_, &options);
-	options.c_cflag = B9600 | CS8 | CLOCAL | CREAD;
-	options.c_iflag = IGNPAR;
-	options.c_oflag = 0;
-	options.c_lflag = 0;
-	options.c_cc[VMIN] = sensorPacketSize_; // read blocks until all bytes are received
-	options.c_cc[VTIME] = 0;
-	tcsetattr(serialFd_, TCSANOW, &options);
 	usleep(250000);
 	tcflush(serialFd_, TCIOFLUSH);
 }
 
 void SerialBot::resetController()
 {
+	if (resetPin_ < 0)
+		return;
 	wiringPiSetupGpio();
-	pinMode(4, OUTPUT);
-	digitalWrite(4, LOW);
+	pinMode(resetPin_, OUTPUT);
+	digitalWrite(resetPin_, LOW);
 	delay(50);
-	digitalWrite(4, HIGH);
+	digitalWrite(resetPin_, HIGH);
 	delay(10000);
 }
 
@@ -124,63 +269,172 @@ int SerialBot::transmit(char* commandPacket)
 }
 
 // receives sensor update packet from the robot controller
-int SerialBot::receive(char* sensorPacket)
+// reads whatever has arrived into the assembler and waits in poll for
+// more until the packet is complete or deadline (monotonic ns) passes;
+// bytes past the end of the packet are left unread
+// returns the number of bytes received, sensorPacketSize_ if the whole
+// packet was, or -1 if the port failed
+int SerialBot::receive(char* sensorPacket, int64_t deadline)
 {
-	memset(sensorPacket, '\0', sensorPacketSize_);
-	int rxBytes;
-	if (serialFd_ != -1)
+	if (serialFd_ == -1)
+		return -1;
+	while (!assembler_->isComplete())
 	{
-		rxBytes = read(serialFd_, sensorPacket, sensorPacketSize_);
+		char data[maxSensorPacketSize];
+		int bytes = read(serialFd_, data, sensorPacketSize_ - assembler_->getLength());
+		if (bytes > 0)
+		{
+			assembler_->append(data, bytes);
+			continue;
+		}
+		if (bytes < 0 && errno != EAGAIN && errno != EINTR)
+			return -1;
+		int64_t remaining = deadline - monotonicNanos();
+		if (remaining <= 0)
+			break;
+		struct pollfd readable;
+		readable.fd = serialFd_;
+		readable.events = POLLIN;
+		struct timespec timeout;
+		timeout.tv_sec = remaining / 1000000000LL;
+		timeout.tv_nsec = remaining % 1000000000LL;
+		int ready = ppoll(&readable, 1, &timeout, NULL);
+		if (ready < 0 && errno != EINTR)
+			return -1;
+		if (ready > 0 && !(readable.revents & POLLIN))
+			return -1; // hung up or in error
 	}
-	return rxBytes;
+	memcpy(sensorPacket, assembler_->getPacket(), assembler_->getLength());
+	return assembler_->getLength();
 }
 
 // builds a command packet from the commanded speeds
-void SerialBot::makeCommandPacket(char* commandPacket)
+void SerialBot::makeCommandPacket(char* commandPacket, bool publish)
 {
-	int16_t intAngular = (int)(angular_ * 1000.0);
-	commandPacket[0] = (char)(translational_ & 0xFF);
-	commandPacket[1] = (char)((translational_ >> 8) & 0xFF);
-	commandPacket[2] = (char)(intAngular & 0xFF);
-	commandPacket[3] = (char)((intAngular >> 8) & 0xFF);
+	pthread_mutex_lock(&lock_);
+	int16_t translational = translational_;
+	double angular = angular_;
+	pthread_mutex_unlock(&lock_);
+	encodeCommandPacket(commandPacket, translational, angular);
+	if (publish && telemetry_ != NULL)
+		telemetry_->publishCommand(translational, (int16_t)(int)(angular * 1000.0) / 1000.0);
 }
 
 // parses a packet of sensor updates from the robot's controller
 // updates distance array and pose
-int SerialBot::parseSensorPacket(char* sensorPacket)
+// and passes a SensorFrame to the frame queue and telemetry if set
+// sent is when the command this packet answers went out; the next one
+// goes out a period later, the period the rate policy picks from this
+// frame if there is one
+int SerialBot::parseSensorPacket(char* sensorPacket, int64_t sent)
 {
-	int16_t firstByte;
-	int16_t secondByte;
-	int16_t inValues[numSonar_ + numPoseVariables];
-	for (int i = 0; i < numSonar_ + numPoseVariables; i++)
-	{
-		firstByte = sensorPacket[2 * i];
-		secondByte = sensorPacket[(2 * i) + 1];
-		inValues[i] = (secondByte << 8) | firstByte;
-	}
+	int64_t timestamp = monotonicNanos();
+	SensorPacket sensors;
+	decodeSensorPacket(sensorPacket, numSonar_, &sensors);
 
+	pthread_mutex_lock(&lock_);
 	for (int i = 0; i < numSonar_; i++)
 	{
-		distances_[i] = inValues[i];
+		distances_[i] = sensors.distances[i];
 	}
 	
-	x_ = inValues[8];
-	y_ = inValues[9];
-	theta_ = ((double)inValues[10]) / 1000.0;
+	x_ = sensors.x;
+	y_ = sensors.y;
+	theta_ = sensors.theta;
+	sequence_++;
+
+	SensorFrame frame;
+	frame.sequence = sequence_;
+	frame.numSonar = numSonar_;
+	for (int i = 0; i < numSonar_; i++)
+		frame.distances[i] = distances_[i];
+	frame.x = x_;
+	frame.y = y_;
+	frame.theta = theta_;
+	frame.translational = translational_;
+	frame.angular = angular_;
+	int lastPeriod = period_;
+	if (ratePolicy_ != NULL)
+		period_ = ratePolicy_->getPeriod(frame);
+	int period = period_;
+	int64_t nextSent = sent + (int64_t)period * 1000;
+	linkDelay_.stampFrame(&frame, sent, timestamp, nextSent);
+	lastFrame_ = timestamp;
+	staleAt_ = nextSent + (int64_t)period * 1000; // the next exchange, retries and all, has failed
+	if (frameQueue_ != NULL && !frameQueue_->tryPush(frame))
+		framesDropped_++;
+	pthread_mutex_unlock(&lock_);
+	if (period != lastPeriod)
+		cout << "update period " << lastPeriod / 1000 << " ms -> " << period / 1000
+		     << " ms (" << ratePolicy_->getReason() << ")" << endl;
+	if (telemetry_ != NULL)
+		telemetry_->publishFrame(frame);
+	return 1;
+}
+
+// sleeps on wake_ until deadline (monotonic ns) or until setSpeed asks
+// a stopped Colin to move
+bool SerialBot::waitForExchange(int64_t deadline)
+{
+	struct timespec until;
+	until.tv_sec = deadline / 1000000000LL;
+	until.tv_nsec = deadline % 1000000000LL;
+	pthread_mutex_lock(&lock_);
+	while (!startRequested_ && monotonicNanos() < deadline)
+		pthread_cond_timedwait(&wake_, &lock_, &until);
+	bool woken = startRequested_;
+	startRequested_ = false;
+	pthread_mutex_unlock(&lock_);
+	return woken;
 }
 
 // handles communication with the robot
 // needs to be run in a separate thread
+// cycles start a period after the previous one started rather than
+// sleeping for the period after each exchange, so transfer time doesn't
+// stretch the period; as with PeriodicTimer, a cycle that overran by more
+// than a period skips the deadlines it missed
+// each attempt waits receiveTimeout for the sensor packet, or until the
+// next cycle is due if that's sooner; a retry sends the latest command,
+// and is only made if the packets have time to cross the link before the
+// next cycle. Input is flushed before every command, so bytes of a
+// packet that came too late can't be taken for the start of the next one
 void SerialBot::commThreadFunction()
 {
+	if (realTime_.enabled)
+		enterRealTime("comm", realTime_);
+	int64_t deadline = monotonicNanos();
 	while (true) 
 	{
+		int64_t cycleEnd = deadline + (int64_t)getPeriod() * 1000;
 		char commandPacket[commandPacketSize];
-		makeCommandPacket(commandPacket);
-		if (transmit(commandPacket) < 1)
-			cerr << "command packet transmission failed" << endl;
-		char sensorPacket[sensorPacketSize_];
-		int receiveResult = receive(sensorPacket);
+		char sensorPacket[maxSensorPacketSize];
+		int64_t sent;
+		int receiveResult;
+		for (int attempt = 0; ; attempt++)
+		{
+			// a retry resends the command, it isn't a new one for telemetry
+			makeCommandPacket(commandPacket, attempt == 0);
+			tcflush(serialFd_, TCIFLUSH);
+			assembler_->reset();
+			sent = monotonicNanos();
+			if (transmit(commandPacket) < 1)
+				cerr << "command packet transmission failed" << endl;
+			int64_t timeout = sent + (int64_t)receiveTimeout_ * 1000;
+			receiveResult = receive(sensorPacket, (timeout < cycleEnd) ? timeout : cycleEnd);
+			if (receiveResult == sensorPacketSize_ || attempt >= maxRetries_
+			    || cycleEnd - monotonicNanos() < (int64_t)exchangeTime_ * 1000)
+				break;
+			pthread_mutex_lock(&lock_);
+			retries_++;
+			pthread_mutex_unlock(&lock_);
+		}
+		if (receiveResult < sensorPacketSize_)
+		{
+			pthread_mutex_lock(&lock_);
+			timeouts_++;
+			pthread_mutex_unlock(&lock_);
+		}
 		if (receiveResult < 1)
 		{
 			cerr << "sensor packet not received" << endl;
@@ -199,8 +453,14 @@ void SerialBot::commThreadFunction()
 			}
 			cout << endl;
 			*/
-			parseSensorPacket(sensorPacket);
+			parseSensorPacket(sensorPacket, sent);
 		}
-		usleep(readPeriod_);
+		int64_t period = (int64_t)getPeriod() * 1000;
+		deadline += period;
+		int64_t lateness = monotonicNanos() - deadline;
+		if (lateness > period)
+			deadline += (lateness / period) * period;
+		if (waitForExchange(deadline))
+			deadline = monotonicNanos();
 	}
 }
@@ -32,7 +32,39 @@
 //   sonar 0 (LSB)  |  sonar 0 (MSB)  |  sonar 1 (LSB) | ... |   x position (LSB)    |    x position (MSB)    |    y position (LSB)    |    y position (MSB)    |  heading * 1000 (LSB)  |  heading * 1000 (MSB)  
 
 // commThreadFunction should be run in a separate thread
-// It will send a command and receive an update 4 times per second
+// It will send a command and receive an update every readPeriod, 4 times
+// per second by default
+// Accessors lock the bot's state, so they can be called from any thread
+// If a frame queue is set, every parsed sensor packet is also pushed to it
+// as a SensorFrame; frames are dropped and counted if the queue is full
+// If a telemetry writer is set, every frame and each cycle's command (once,
+// however many times it's resent) are also published to shared memory for
+// other processes, see Telemetry/TelemetryRing.h
+// setRealTime opts the comm thread into real-time scheduling, see RealTime.h
+// The device, baud rate, sonar count and update period come from a
+// SerialBotConfig; the default constructor talks to Colin on /dev/serial0
+// Packets are built and parsed with PacketCodec.h
+// Each exchange's command/response timing feeds a LinkDelayEstimator,
+// which stamps frames with when their readings were taken and when the
+// next command will take effect
+// setRatePolicy lets a RatePolicy (RatePolicy.h) choose the time to the
+// next exchange after every packet in place of the fixed readPeriod, and
+// logs each change of period to cout; with a policy set, a command that
+// starts a stopped Colin moving is sent at once rather than at the next
+// exchange
+// The port is read without blocking: receive polls until the exchange's
+// deadline and assembles the sensor packet from however many reads it
+// arrives in (PacketAssembler). If no whole packet has arrived
+// receiveTimeout after the command went out, the command is sent again, up
+// to maxRetries times while the next exchange isn't yet due, so a dropped
+// byte costs an exchange rather than stalling the comm thread
+// getSnapshotAge gives how old the readings getDistances and getPose
+// return are, and isStale is true once the exchange that should have
+// replaced them has run out of time, retries included, so control threads
+// can stop within a period of a lost packet rather than act on frozen
+// readings
+// SerialBot implements Robot, so programs can run against the simulator
+// (Sim/SimBot.h) instead
 
 #ifndef SerialBot_h
 #define SerialBot_h
@@ -47,20 +79,41 @@
 #include <string.h>
 #include <pthread.h>
 #include <wiringPi.h>
+#include "Robot.h"
+#include "SensorFrame.h"
+#include "../Pipeline/SpscQueue.h"
+#include "../Pipeline/PipelineStage.h" // monotonicNanos
+#include "../RealTime/RealTime.h"
+#include "../Telemetry/TelemetryWriter.h"
+#include "PacketCodec.h"
+#include "SerialPort.h"
+#include "LinkDelayEstimator.h"
+#include "RatePolicy.h"
 
 using namespace std;
 
-const int commandPacketSize = 4;
-const int numPoseVariables = 3;
-
-class SerialBot
+class SerialBot : public Robot
 {
 public:
 	SerialBot();
+	SerialBot(const SerialBotConfig& config);
 	~SerialBot();
 	void setSpeed(int translational, double angular); 
+	int getNumSonar(); // number of entries getDistances fills
 	void getDistances(int* distances); // copies values in distances_ to distances
 	void getPose(int* x, int* y, double* theta); // copies values in x_, y_, and theta_ to x, y, and theta
+	void setFrameQueue(SpscQueue<SensorFrame>* frameQueue); // queue to receive parsed sensor frames
+	void setTelemetry(TelemetryWriter* telemetry); // must be called before commThreadFunction
+	uint32_t getFramesReceived(); // number of sensor packets parsed so far
+	uint32_t getFramesDropped(); // number of frames dropped because the queue was full
+	int64_t getRoundTrip(); // smoothed command to sensor packet time in ns
+	int64_t getSnapshotAge(); // ns since the latest sensor packet arrived, -1 before any
+	bool isStale(); // the next sensor packet is overdue
+	uint32_t getTimeouts(); // exchanges that got no sensor packet
+	uint32_t getRetries(); // commands sent again after a receive timeout
+	void setRealTime(const RealTimeConfig& config); // must be called before commThreadFunction
+	void setRatePolicy(RatePolicy* policy); // must be called before commThreadFunction
+	int getPeriod(); // microseconds between the latest exchanges
 	void commThreadFunction();
 private:
 	int x_, y_; // robot's x and y coordinates
@@ -70,19 +123,44 @@ private:
 	int16_t* distances_; // array of distance readings from sonar sensors
 	int serialFd_; // file descriptor for serial connection
 	int readPeriod_; // delay between updates in microseconds
+	int receiveTimeout_; // microseconds before a command is sent again
+	int maxRetries_;
+	int exchangeTime_; // microseconds the packets take on the wire
 	int sensorPacketSize_; // default size for sensor update packet
 	int numSonar_; // number of sonar sensors
-	int commandPacketSize_;
+	int resetPin_;
+	PacketAssembler* assembler_; // sensor packet being received
+	pthread_mutex_t lock_; // guards pose, speeds and distances
+	SpscQueue<SensorFrame>* frameQueue_; // optional consumer of sensor frames
+	TelemetryWriter* telemetry_; // optional shared memory publisher, used only by the comm thread
+	uint32_t sequence_; // number of sensor packets parsed
+	uint32_t framesDropped_; // frames not pushed because frameQueue_ was full
+	uint32_t timeouts_;
+	uint32_t retries_;
+	int64_t lastFrame_; // monotonic ns the latest sensor packet arrived
+	int64_t staleAt_; // when the next one is overdue
+	RealTimeConfig realTime_; // scheduling settings for the comm thread
+	LinkDelayEstimator linkDelay_; // updated by the comm thread under lock_
+	RatePolicy* ratePolicy_; // optional, used only by the comm thread
+	int period_; // microseconds to the next exchange, guarded by lock_
+	pthread_cond_t wake_; // signalled when a command starts Colin moving
+	bool startRequested_;
 	
-	void openSerial(); // opens serial connection with robot controller
+	void openSerial(const SerialBotConfig& config); // opens serial connection with robot controller
 	void resetController(); // resets the robot controller using gpio
 	int transmit(char* commandPacket); // transmits command packet to robot 
 	                                   //controller
-	int receive(char* sensorPacket); // receives sensor update packet
+	int receive(char* sensorPacket, int64_t deadline); // receives sensor update packet
 												// from robot controller
-	void makeCommandPacket(char* commandPacket); // builds a command packet from the commanded speeds
-	int parseSensorPacket(char* sensorPacket); // parses a packet of sensor
+	// builds a command packet from the commanded speeds, publishing the
+	// command to telemetry if asked
+	void makeCommandPacket(char* commandPacket, bool publish);
+	bool waitForExchange(int64_t deadline); // sleeps to deadline, true if woken early
+	int parseSensorPacket(char* sensorPacket, int64_t sent); // parses a packet of sensor
 																// updates from the robot																											 
+
+	SerialBot(const SerialBot&); // not copyable
+	SerialBot& operator=(const SerialBot&);
 };
 
 
@@ -0,0 +1,61 @@
+// SerialPort.cpp
+// 10/18/2026
+
+// Raw serial port setup, see SerialPort.h
+
+#include "SerialPort.h"
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+SerialBotConfig defaultSerialBotConfig()
+{
+	SerialBotConfig config;
+	config.device = "/dev/serial0";
+	config.baudRate = 9600;
+	config.numSonar = 8;
+	config.readPeriod = 250000;
+	config.receiveTimeout = 100000;
+	config.maxRetries = 1;
+	config.resetPin = 4;
+	return config;
+}
+
+static bool baudRateToSpeed(int baudRate, speed_t* speed)
+{
+	switch (baudRate)
+	{
+	case 9600: *speed = B9600; return true;
+	case 19200: *speed = B19200; return true;
+	case 38400: *speed = B38400; return true;
+	case 57600: *speed = B57600; return true;
+	case 115200: *speed = B115200; return true;
+	case 230400: *speed = B230400; return true;
+	default: return false;
+	}
+}
+
+int openSerialPort(const char* device, int baudRate, int minBytes)
+{
+	speed_t speed;
+	if (!baudRateToSpeed(baudRate, &speed))
+		return -1;
+	int flags = O_RDWR | O_NOCTTY | O_CLOEXEC;
+	if (minBytes == 0)
+		flags |= O_NONBLOCK;
+	int fd = open(device, flags);
+	if (fd == -1)
+		return -1;
+	struct termios options;
+	tcgetattr(fd, &options);
+	options.c_cflag = speed | CS8 | CLOCAL | CREAD;
+	options.c_iflag = IGNPAR;
+	options.c_oflag = 0;
+	options.c_lflag = 0;
+	cfsetispeed(&options, speed);
+	cfsetospeed(&options, speed);
+	options.c_cc[VMIN] = minBytes; // read blocks until all bytes are received
+	options.c_cc[VTIME] = 0;
+	tcsetattr(fd, TCSANOW, &options);
+	return fd;
+}
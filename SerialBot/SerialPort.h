@@ -0,0 +1,32 @@
+// SerialPort.h
+// 10/18/2026
+
+// Settings for one serial link to a Colin, used by SerialBot and
+// FleetManager, and opening the device in raw 8N1 mode as SerialBot
+// always has, at the link's baud rate
+// With minBytes > 0 a read blocks until that many bytes have arrived;
+// with minBytes 0 the descriptor is non-blocking, for event loops
+// receiveTimeout and maxRetries are SerialBot's; FleetManager gives up on
+// a packet when the robot's next command is due
+
+#ifndef SERIALPORT_H
+#define SERIALPORT_H
+
+struct SerialBotConfig
+{
+	const char* device; // serial device or pty
+	int baudRate;
+	int numSonar; // at most maxSonar
+	int readPeriod; // microseconds between updates
+	int receiveTimeout; // microseconds to wait for a sensor packet before resending the command
+	int maxRetries; // resends per exchange
+	int resetPin; // BCM gpio wired to the ATmega's reset, -1 for none
+};
+
+SerialBotConfig defaultSerialBotConfig(); // Colin on the Pi's uart
+
+// returns the file descriptor, or -1 if the device can't be opened or
+// the baud rate isn't a standard one
+int openSerialPort(const char* device, int baudRate, int minBytes);
+
+#endif
@@ -0,0 +1,505 @@
+// SimBot.cpp
+// 10/18/2026
+
+// Kinematic simulator of Colin, see SimBot.h
+
+#include "SimBot.h"
+#include "../Pipeline/PipelineStage.h" // monotonicNanos
+
+SimSonarModel defaultSimSonarModel()
+{
+	SimSonarModel model;
+	model.beamWidth = sonarBeamWidth;
+	model.raysPerBeam = 5;
+	model.minRange = 3.0;
+	model.maxRange = 300.0;
+	model.noiseSigma = 1.0;
+	model.noisePerCm = 0.01;
+	model.maxIncidence = 1.0;
+	model.dropoutRate = 0.02;
+	return model;
+}
+
+SimMotionModel defaultSimMotionModel()
+{
+	SimMotionModel model;
+	model.maxAccel = 100.0;
+	model.maxAngAccel = 4.0;
+	model.odometryScale = 1.02;
+	model.translationNoise = 0.1;
+	model.rotationNoise = 0.05;
+	return model;
+}
+
+SimLinkModel defaultSimLinkModel()
+{
+	SimLinkModel model;
+	model.latchCommands = false;
+	model.commandDelay = 0.0;
+	model.replyDelay = 0.0;
+	return model;
+}
+
+SimBot::SimBot(World* world, const double* sensorAngles, int numSonar,
+               const Pose2D& start, uint64_t seed)
+{
+	world_ = world;
+	numSonar_ = (numSonar < maxSonar) ? numSonar : maxSonar;
+	sensorAngles_ = new double[numSonar_];
+	for (int i = 0; i < numSonar_; i++)
+		sensorAngles_[i] = sensorAngles[i];
+	sonar_ = defaultSimSonarModel();
+	motion_ = defaultSimMotionModel();
+	link_ = defaultSimLinkModel();
+	dt_ = 0.01;
+	sensorPeriod_ = 0.25;
+	timeScale_ = 1.0;
+	radius_ = 12.0;
+	random_ = (seed == 0) ? 1 : seed;
+
+	truePose_ = start;
+	odometry_ = start;
+	trans_ = 0.0;
+	angular_ = 0.0;
+	commandTrans_ = 0.0;
+	commandAngular_ = 0.0;
+	requestedTrans_ = 0.0;
+	requestedAngular_ = 0.0;
+	sentTrans_ = 0.0;
+	sentAngular_ = 0.0;
+	simTime_ = 0.0;
+	nextFrameTime_ = sensorPeriod_;
+	exchangeTime_ = 0.0;
+	sampleTime_ = -1.0;
+	replyTime_ = -1.0;
+	collisions_ = 0;
+	colliding_ = false;
+	wallClock_ = false;
+
+	distances_ = new int16_t[numSonar_];
+	replyDistances_ = new int16_t[numSonar_];
+	for (int i = 0; i < numSonar_; i++)
+	{
+		distances_[i] = 0;
+		replyDistances_[i] = 0;
+	}
+	replyOdometry_ = start;
+	replyTrans_ = 0.0;
+	replyAngular_ = 0.0;
+	sequence_ = 0;
+	framesDropped_ = 0;
+	lastFrame_ = 0;
+	staleAt_ = 0;
+	frameQueue_ = NULL;
+	telemetry_ = NULL;
+	realTime_ = defaultRealTimeConfig();
+	running_ = true;
+	pthread_mutex_init(&lock_, NULL);
+}
+
+SimBot::~SimBot()
+{
+	pthread_mutex_destroy(&lock_);
+	delete [] sensorAngles_;
+	delete [] distances_;
+	delete [] replyDistances_;
+}
+
+// the command is rounded the way SerialBot packs it
+void SimBot::setSpeed(int translational, double angular)
+{
+	pthread_mutex_lock(&lock_);
+	requestedTrans_ = (int16_t)translational;
+	requestedAngular_ = (int16_t)(angular * 1000.0) / 1000.0;
+	if (!link_.latchCommands)
+	{
+		commandTrans_ = requestedTrans_;
+		commandAngular_ = requestedAngular_;
+	}
+	pthread_mutex_unlock(&lock_);
+}
+
+int SimBot::getNumSonar()
+{
+	return numSonar_;
+}
+
+void SimBot::getDistances(int* distances)
+{
+	pthread_mutex_lock(&lock_);
+	for (int i = 0; i < numSonar_; i++)
+		distances[i] = distances_[i];
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::getPose(int* x, int* y, double* theta)
+{
+	pthread_mutex_lock(&lock_);
+	*x = (int16_t)lround(odometry_.x);
+	*y = (int16_t)lround(odometry_.y);
+	*theta = (int16_t)lround(odometry_.theta * 1000.0) / 1000.0;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setFrameQueue(SpscQueue<SensorFrame>* frameQueue)
+{
+	pthread_mutex_lock(&lock_);
+	frameQueue_ = frameQueue;
+	pthread_mutex_unlock(&lock_);
+}
+
+// published from whichever thread steps the simulation, so it must be
+// set before stepping starts
+void SimBot::setTelemetry(TelemetryWriter* telemetry)
+{
+	pthread_mutex_lock(&lock_);
+	telemetry_ = telemetry;
+	pthread_mutex_unlock(&lock_);
+}
+
+uint32_t SimBot::getFramesReceived()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t frames = sequence_;
+	pthread_mutex_unlock(&lock_);
+	return frames;
+}
+
+uint32_t SimBot::getFramesDropped()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t dropped = framesDropped_;
+	pthread_mutex_unlock(&lock_);
+	return dropped;
+}
+
+int64_t SimBot::getRoundTrip()
+{
+	pthread_mutex_lock(&lock_);
+	int64_t roundTrip = linkDelay_.getRoundTrip();
+	pthread_mutex_unlock(&lock_);
+	return roundTrip;
+}
+
+int64_t SimBot::getSnapshotAge()
+{
+	pthread_mutex_lock(&lock_);
+	int64_t age = (sequence_ > 0) ? frameClock() - lastFrame_ : -1;
+	pthread_mutex_unlock(&lock_);
+	return age;
+}
+
+// the simulated link never loses a frame, but the comm thread can fall
+// behind or be stopped
+bool SimBot::isStale()
+{
+	pthread_mutex_lock(&lock_);
+	bool stale = sequence_ > 0 && frameClock() > staleAt_;
+	pthread_mutex_unlock(&lock_);
+	return stale;
+}
+
+void SimBot::setRealTime(const RealTimeConfig& config)
+{
+	realTime_ = config;
+}
+
+// advances one sensor period per cycle, paced by timeScale_
+void SimBot::commThreadFunction()
+{
+	if (realTime_.enabled)
+		enterRealTime("sim", realTime_);
+	pthread_mutex_lock(&lock_);
+	wallClock_ = true;
+	int64_t period = (int64_t)(sensorPeriod_ / timeScale_ * 1e9);
+	pthread_mutex_unlock(&lock_);
+	PeriodicTimer timer(period);
+	while (running_)
+	{
+		pthread_mutex_lock(&lock_);
+		while (!stepLocked())
+			;
+		pthread_mutex_unlock(&lock_);
+		timer.wait();
+	}
+}
+
+void SimBot::setSonarModel(const SimSonarModel& model)
+{
+	pthread_mutex_lock(&lock_);
+	sonar_ = model;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setMotionModel(const SimMotionModel& model)
+{
+	pthread_mutex_lock(&lock_);
+	motion_ = model;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setLinkModel(const SimLinkModel& model)
+{
+	pthread_mutex_lock(&lock_);
+	link_ = model;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setTimeStep(double dt)
+{
+	pthread_mutex_lock(&lock_);
+	dt_ = dt;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setSensorPeriod(double period)
+{
+	pthread_mutex_lock(&lock_);
+	nextFrameTime_ += period - sensorPeriod_;
+	sensorPeriod_ = period;
+	pthread_mutex_unlock(&lock_);
+}
+
+void SimBot::setTimeScale(double scale)
+{
+	timeScale_ = scale;
+}
+
+void SimBot::setRobotRadius(double radius)
+{
+	pthread_mutex_lock(&lock_);
+	radius_ = radius;
+	pthread_mutex_unlock(&lock_);
+}
+
+bool SimBot::step()
+{
+	pthread_mutex_lock(&lock_);
+	bool frame = stepLocked();
+	pthread_mutex_unlock(&lock_);
+	return frame;
+}
+
+void SimBot::stop()
+{
+	running_ = false;
+}
+
+Pose2D SimBot::getTruePose()
+{
+	pthread_mutex_lock(&lock_);
+	Pose2D pose = truePose_;
+	pthread_mutex_unlock(&lock_);
+	return pose;
+}
+
+Pose2D SimBot::getOdometryPose()
+{
+	pthread_mutex_lock(&lock_);
+	Pose2D pose = odometry_;
+	pthread_mutex_unlock(&lock_);
+	return pose;
+}
+
+double SimBot::getSimTime()
+{
+	pthread_mutex_lock(&lock_);
+	double time = simTime_;
+	pthread_mutex_unlock(&lock_);
+	return time;
+}
+
+uint32_t SimBot::getCollisions()
+{
+	pthread_mutex_lock(&lock_);
+	uint32_t collisions = collisions_;
+	pthread_mutex_unlock(&lock_);
+	return collisions;
+}
+
+bool SimBot::isColliding()
+{
+	pthread_mutex_lock(&lock_);
+	bool colliding = colliding_;
+	pthread_mutex_unlock(&lock_);
+	return colliding;
+}
+
+// caller holds lock_
+// an exchange goes through its three events in order; with an ideal link
+// they all fall in the same step
+bool SimBot::stepLocked()
+{
+	move();
+	simTime_ += dt_;
+	// small tolerance so accumulated rounding doesn't push an event a step late
+	if (simTime_ + 1e-9 >= nextFrameTime_)
+	{
+		// the command goes out
+		exchangeTime_ = simTime_;
+		nextFrameTime_ += sensorPeriod_;
+		sentTrans_ = requestedTrans_;
+		sentAngular_ = requestedAngular_;
+		sampleTime_ = simTime_ + link_.commandDelay;
+	}
+	if (sampleTime_ >= 0.0 && simTime_ + 1e-9 >= sampleTime_)
+	{
+		// it reaches Colin, which replies with fresh readings
+		if (link_.latchCommands)
+		{
+			commandTrans_ = sentTrans_;
+			commandAngular_ = sentAngular_;
+		}
+		readSonar(replyDistances_);
+		replyOdometry_ = odometry_;
+		replyTrans_ = commandTrans_;
+		replyAngular_ = commandAngular_;
+		sampleTime_ = -1.0;
+		replyTime_ = simTime_ + link_.replyDelay;
+	}
+	if (replyTime_ < 0.0 || simTime_ + 1e-9 < replyTime_)
+		return false;
+	replyTime_ = -1.0;
+	for (int i = 0; i < numSonar_; i++)
+		distances_[i] = replyDistances_[i];
+	publishFrame();
+	return true;
+}
+
+// speeds slew toward the command, then the robot moves along an arc
+void SimBot::move()
+{
+	double maxDeltaTrans = motion_.maxAccel * dt_;
+	double maxDeltaAng = motion_.maxAngAccel * dt_;
+	trans_ += fmax(-maxDeltaTrans, fmin(maxDeltaTrans, commandTrans_ - trans_));
+	angular_ += fmax(-maxDeltaAng, fmin(maxDeltaAng, commandAngular_ - angular_));
+
+	double dTheta = angular_ * dt_;
+	Pose2D delta;
+	if (fabs(dTheta) < 1e-9)
+		delta = makePose(trans_ * dt_, 0.0, 0.0);
+	else
+	{
+		double radius = trans_ / angular_;
+		delta = makePose(radius * sin(dTheta), radius * (1.0 - cos(dTheta)), dTheta);
+	}
+	Pose2D next = composePose(truePose_, delta);
+	if (world_->collides(next.x, next.y, radius_))
+	{
+		// the footprint is round, so turning in place is always possible
+		if (!colliding_)
+			collisions_++;
+		colliding_ = true;
+		trans_ = 0.0;
+		delta = makePose(0.0, 0.0, dTheta);
+		next = composePose(truePose_, delta);
+	}
+	else
+		colliding_ = false;
+	truePose_ = next;
+
+	// errors grow with the square root of distance travelled and angle
+	// turned, so they don't depend on the time step
+	double distance = hypot(delta.x, delta.y);
+	double scale = motion_.odometryScale;
+	if (distance > 0.0)
+		scale += motion_.translationNoise * sqrt(distance) * gaussianRandom() / distance;
+	double odometryTheta = delta.theta
+	                       + motion_.rotationNoise * sqrt(fabs(delta.theta)) * gaussianRandom();
+	odometry_ = composePose(odometry_, makePose(delta.x * scale, delta.y * scale, odometryTheta));
+}
+
+void SimBot::readSonar(int16_t* distances)
+{
+	for (int i = 0; i < numSonar_; i++)
+	{
+		double center = truePose_.theta + sensorAngles_[i];
+		double nearest = -1.0;
+		for (int r = 0; r < sonar_.raysPerBeam; r++)
+		{
+			double offset = 0.0;
+			if (sonar_.raysPerBeam > 1)
+				offset = sonar_.beamWidth * ((double)r / (sonar_.raysPerBeam - 1) - 0.5);
+			double incidence;
+			double range = world_->castRay(truePose_.x, truePose_.y, center + offset,
+			                               sonar_.maxRange, &incidence);
+			if (range >= 0.0 && incidence <= sonar_.maxIncidence
+			    && (nearest < 0.0 || range < nearest))
+				nearest = range;
+		}
+		// the dropout draw is made for every reading so one sensor's
+		// result doesn't shift the others' random numbers
+		bool dropped = uniformRandom() < sonar_.dropoutRate;
+		double noise = gaussianRandom();
+		if (nearest < 0.0 || dropped)
+		{
+			distances[i] = 0;
+			continue;
+		}
+		double reading = nearest + noise * (sonar_.noiseSigma + sonar_.noisePerCm * nearest);
+		reading = fmax(sonar_.minRange, reading);
+		distances[i] = (reading > sonar_.maxRange) ? 0 : (int16_t)lround(reading);
+	}
+}
+
+// builds a frame as SerialBot would from a sensor packet
+// the exchange's times are converted to the frame's clock, simulated time
+// or monotonic time scaled by timeScale_; an unlatched command takes
+// effect as soon as it's set, so for the link estimate the next one is
+// sent on arrival
+// telemetry gets the command and then the frame, the order SerialBot's
+// exchange produces them
+void SimBot::publishFrame()
+{
+	sequence_++;
+	int64_t received = frameClock();
+	double scale = wallClock_ ? 1e9 / timeScale_ : 1e9;
+	lastFrame_ = received;
+	double nextReply = nextFrameTime_ + link_.commandDelay + link_.replyDelay;
+	staleAt_ = received + (int64_t)llround((nextReply + sensorPeriod_ / 2 - simTime_) * scale);
+	int64_t sent = received - (int64_t)llround((simTime_ - exchangeTime_) * scale);
+	int64_t nextSent = received;
+	if (link_.latchCommands)
+		nextSent += (int64_t)llround((nextFrameTime_ - simTime_) * scale);
+	SensorFrame frame;
+	linkDelay_.stampFrame(&frame, sent, received, nextSent);
+	if (frameQueue_ == NULL && telemetry_ == NULL)
+		return;
+	frame.sequence = sequence_;
+	frame.numSonar = numSonar_;
+	for (int i = 0; i < numSonar_; i++)
+		frame.distances[i] = distances_[i];
+	frame.x = (int16_t)lround(replyOdometry_.x);
+	frame.y = (int16_t)lround(replyOdometry_.y);
+	frame.theta = (int16_t)lround(replyOdometry_.theta * 1000.0) / 1000.0;
+	frame.translational = (int16_t)replyTrans_;
+	frame.angular = replyAngular_;
+	if (frameQueue_ != NULL && !frameQueue_->tryPush(frame))
+		framesDropped_++;
+	if (telemetry_ != NULL)
+	{
+		telemetry_->publishCommand(frame.translational, frame.angular);
+		telemetry_->publishFrame(frame);
+	}
+}
+
+int64_t SimBot::frameClock()
+{
+	return wallClock_ ? monotonicNanos() : (int64_t)llround(simTime_ * 1e9);
+}
+
+// xorshift64*, as in ParticleFilter.cpp
+double SimBot::uniformRandom()
+{
+	random_ ^= random_ >> 12;
+	random_ ^= random_ << 25;
+	random_ ^= random_ >> 27;
+	return (double)((random_ * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double SimBot::gaussianRandom()
+{
+	double u1 = uniformRandom() + 1e-12;
+	double u2 = uniformRandom();
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
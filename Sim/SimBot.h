@@ -0,0 +1,179 @@
+// SimBot.h
+// 10/18/2026
+
+// Kinematic simulator of Colin, for running control programs without
+// the robot
+// Implements the same Robot interface as SerialBot: commands go in
+// through setSpeed, sonar readings and odometry come out through
+// getDistances, getPose and the frame queue
+
+// Motion: a differential drive whose speeds follow the commanded ones
+// under acceleration limits, integrated on exact arcs at a fixed time
+// step. Hitting a wall stops the robot where it was and is counted
+// Odometry: the reported pose accumulates a scale error and random noise
+// on every step, so it drifts from the true pose as Colin's does
+// Sonar: each sensor casts a fan of rays across its beam and reports the
+// nearest echo. Rays striking a wall too far from its normal reflect away
+// and return nothing, readings get range dependent Gaussian noise, and a
+// fraction drop out entirely. Like Colin's sonars, 0 means no echo
+// Readings are measured from the robot's centre, as the control programs
+// treat them
+// Link: by default commands take effect as soon as they're set and frames
+// arrive the instant their readings are taken. setLinkModel can instead
+// hold commands until the next exchange, as SerialBot's are, and delay
+// both directions of the exchange; frames are stamped from the exchange
+// timing with a LinkDelayEstimator just as SerialBot's are
+
+// The simulator is deterministic: the same world, seed and sequence of
+// commands always produce the same readings
+// Two ways to run it:
+//    call step() directly to advance the simulation as fast as it will go;
+//    frames are stamped with simulated time
+//    run commThreadFunction in a thread in place of SerialBot's; it advances
+//    one sensor period per cycle, sleeping period / timeScale in between,
+//    and stamps frames with monotonicNanos() as SerialBot does. stop()
+//    makes it return
+
+#ifndef SIMBOT_H
+#define SIMBOT_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include "World.h"
+#include "../SerialBot/Robot.h"
+#include "../SerialBot/LinkDelayEstimator.h"
+#include "../Geometry/Pose2D.h"
+
+struct SimSonarModel
+{
+	double beamWidth; // full width of the cone in radians
+	int raysPerBeam;
+	double minRange; // cm, nearer echoes read as minRange
+	double maxRange; // cm, farther echoes read as 0
+	double noiseSigma; // cm
+	double noisePerCm; // additional sigma per cm of range
+	double maxIncidence; // radians from the wall's normal beyond which a ray returns nothing
+	double dropoutRate; // fraction of readings that return nothing
+};
+
+SimSonarModel defaultSimSonarModel();
+
+struct SimMotionModel
+{
+	double maxAccel; // cm/s^2
+	double maxAngAccel; // rad/s^2
+	double odometryScale; // reported distance / true distance
+	double translationNoise; // sigma of odometry distance error per cm travelled
+	double rotationNoise; // sigma of odometry heading error per radian turned
+};
+
+SimMotionModel defaultSimMotionModel();
+
+// an exchange starts every sensor period; its command takes effect and the
+// sonars are read commandDelay later, and the frame arrives replyDelay
+// after that; the two together must be shorter than the sensor period
+struct SimLinkModel
+{
+	bool latchCommands; // setSpeed waits for the next exchange
+	double commandDelay; // s
+	double replyDelay; // s
+};
+
+SimLinkModel defaultSimLinkModel(); // ideal link
+
+class SimBot : public Robot
+{
+public:
+	SimBot(World* world, const double* sensorAngles, int numSonar,
+	       const Pose2D& start, uint64_t seed);
+	~SimBot();
+
+	// Robot
+	void setSpeed(int translational, double angular);
+	int getNumSonar();
+	void getDistances(int* distances);
+	void getPose(int* x, int* y, double* theta); // odometry, rounded as Colin reports it
+	void setFrameQueue(SpscQueue<SensorFrame>* frameQueue);
+	void setTelemetry(TelemetryWriter* telemetry);
+	uint32_t getFramesReceived();
+	uint32_t getFramesDropped();
+	int64_t getRoundTrip();
+	int64_t getSnapshotAge(); // in the frames' clock
+	bool isStale();
+	void setRealTime(const RealTimeConfig& config);
+	void commThreadFunction();
+
+	void setSonarModel(const SimSonarModel& model);
+	void setMotionModel(const SimMotionModel& model);
+	void setLinkModel(const SimLinkModel& model);
+	void setTimeStep(double dt); // seconds, default 0.01
+	void setSensorPeriod(double period); // seconds between frames, default 0.25 like SerialBot
+	void setTimeScale(double scale); // commThreadFunction's speed relative to real time, default 1
+	void setRobotRadius(double radius); // cm, default 12
+
+	bool step(); // advances one time step, returns true if a frame was produced
+	void stop(); // makes commThreadFunction return
+
+	Pose2D getTruePose();
+	Pose2D getOdometryPose();
+	double getSimTime(); // seconds
+	uint32_t getCollisions(); // number of times the robot has run into a wall
+	bool isColliding(); // pressed against a wall now
+
+private:
+	World* world_;
+	double* sensorAngles_;
+	int numSonar_;
+	SimSonarModel sonar_;
+	SimMotionModel motion_;
+	SimLinkModel link_;
+	double dt_;
+	double sensorPeriod_;
+	double timeScale_;
+	double radius_;
+	uint64_t random_; // xorshift state
+
+	Pose2D truePose_;
+	Pose2D odometry_;
+	double trans_, angular_; // actual speeds
+	double commandTrans_, commandAngular_; // in effect
+	double requestedTrans_, requestedAngular_; // set but not yet sent, when latched
+	double sentTrans_, sentAngular_; // on their way to Colin
+	double simTime_;
+	double nextFrameTime_; // next exchange
+	double exchangeTime_; // when the current exchange started
+	double sampleTime_; // when its readings are taken, < 0 once they have been
+	double replyTime_; // when its frame arrives, < 0 once it has
+	uint32_t collisions_;
+	bool colliding_;
+	bool wallClock_; // stamp frames with monotonicNanos rather than simulated time
+
+	int16_t* distances_; // from the last frame
+	int16_t* replyDistances_; // read but not yet arrived
+	Pose2D replyOdometry_;
+	double replyTrans_, replyAngular_;
+	LinkDelayEstimator linkDelay_;
+	int64_t lastFrame_; // frame clock ns the last frame arrived
+	int64_t staleAt_; // half a sensor period after the next one is due
+	uint32_t sequence_;
+	uint32_t framesDropped_;
+	SpscQueue<SensorFrame>* frameQueue_;
+	TelemetryWriter* telemetry_;
+	RealTimeConfig realTime_;
+	std::atomic<bool> running_;
+	pthread_mutex_t lock_; // guards everything above when commThreadFunction runs
+
+	bool stepLocked();
+	void move();
+	void readSonar(int16_t* distances);
+	void publishFrame();
+	int64_t frameClock(); // now, in the clock frames are stamped with
+	double uniformRandom();
+	double gaussianRandom();
+
+	SimBot(const SimBot&); // not copyable
+	SimBot& operator=(const SimBot&);
+};
+
+#endif
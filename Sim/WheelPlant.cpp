@@ -0,0 +1,221 @@
+// WheelPlant.cpp
+// 10/18/2026
+
+// Simulated wheel speed loop for PID_tune, see WheelPlant.h
+
+#include "WheelPlant.h"
+#include <math.h>
+
+const int motorSubsteps = 10; // motor integration steps per control loop
+const double settleBand = 0.05; // fraction of the step counted as settled
+const double steadyFraction = 0.2; // tail of the trial steadyError is measured over
+
+WheelPlantConfig defaultWheelPlantConfig()
+{
+	WheelPlantConfig config;
+	config.gain = 1.0;
+	config.timeConstant = 0.12;
+	config.deadband = 20.0;
+	config.maxPwm = 255.0;
+	config.loopPeriod = 0.02;
+	config.encoderResolution = 0.05;
+	config.wheelBase = 20.0;
+	config.speedNoise = 0.5;
+	return config;
+}
+
+WheelPlant::WheelPlant(const WheelPlantConfig& config, uint64_t seed)
+{
+	config_ = config;
+	random_ = (seed == 0) ? 1 : seed;
+}
+
+const WheelPlantConfig& WheelPlant::getConfig()
+{
+	return config_;
+}
+
+bool WheelPlant::runTrial(const PidTrial& trial, TrialMetrics* metrics)
+{
+	double halfBase = 0.5 * config_.wheelBase;
+	double targets[2] = {trial.speed - trial.angular * halfBase,
+	                     trial.speed + trial.angular * halfBase};
+	int loops = (int)(trial.time / 1000.0 / config_.loopPeriod);
+	int steadyStart = loops - (int)(loops * steadyFraction);
+	double duration = loops * config_.loopPeriod;
+	double sums[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+	int wheelsMeasured = 0;
+	for (int w = 0; w < 2 && loops > 0; w++)
+	{
+		double target = targets[w];
+		double step = fabs(target);
+		if (step < 1e-6)
+			continue;
+		double sign = (target > 0.0) ? 1.0 : -1.0;
+		Wheel wheel;
+		resetWheel(&wheel);
+		double measured = 0.0;
+		double t10 = -1.0, t90 = -1.0, peak = 0.0, lastOutside = 0.0;
+		double steadySum = 0.0, iae = 0.0;
+		for (int i = 0; i < loops; i++)
+		{
+			double pwm = pidOutput(&wheel, trial, target, measured);
+			measured = stepWheel(&wheel, pwm);
+			double t = (i + 1) * config_.loopPeriod;
+			double progress = sign * wheel.speed;
+			double error = fabs(target - wheel.speed);
+			if (t10 < 0.0 && progress >= 0.1 * step)
+				t10 = t;
+			if (t90 < 0.0 && progress >= 0.9 * step)
+				t90 = t;
+			if (progress > peak)
+				peak = progress;
+			if (error > settleBand * step)
+				lastOutside = t;
+			if (i >= steadyStart)
+				steadySum += error;
+			iae += error * config_.loopPeriod;
+		}
+		sums[0] += (t10 >= 0.0 && t90 >= 0.0) ? t90 - t10 : duration;
+		sums[1] += fmax(0.0, (peak - step) / step);
+		sums[2] += lastOutside;
+		sums[3] += (loops > steadyStart) ? steadySum / (loops - steadyStart) : 0.0;
+		sums[4] += iae / step;
+		wheelsMeasured++;
+	}
+	if (wheelsMeasured == 0)
+		return false;
+	metrics->riseTime = sums[0] / wheelsMeasured;
+	metrics->overshoot = sums[1] / wheelsMeasured;
+	metrics->settlingTime = sums[2] / wheelsMeasured;
+	metrics->steadyError = sums[3] / wheelsMeasured;
+	metrics->iae = sums[4] / wheelsMeasured;
+	return true;
+}
+
+// the relay starts switching between 0 and 2 * amplitude, and its bias is
+// adjusted every cycle until the high and low half cycles are equally
+// long, so it ends up at the pwm that holds setSpeed
+// hysteresis of one encoder count per loop keeps quantization from
+// chattering the relay
+bool WheelPlant::relayTest(double setSpeed, double amplitude, double duration,
+                           double* ultimateGain, double* ultimatePeriod)
+{
+	Wheel wheel;
+	resetWheel(&wheel);
+	double hysteresis = config_.encoderResolution / config_.loopPeriod;
+	double bias = amplitude;
+	bool high = true;
+	double measured = 0.0;
+	double lastRise = -1.0, lastSwitch = 0.0, highTime = 0.0;
+	double cycleMin = 1e9, cycleMax = -1e9;
+	double periodSum = 0.0, amplitudeSum = 0.0;
+	int cycles = 0;
+	int loops = (int)(duration / config_.loopPeriod);
+	for (int i = 0; i < loops; i++)
+	{
+		double t = i * config_.loopPeriod;
+		double error = setSpeed - measured;
+		if (high && error < -hysteresis)
+		{
+			high = false;
+			highTime = t - lastSwitch;
+			lastSwitch = t;
+		}
+		else if (!high && error > hysteresis)
+		{
+			high = true;
+			double lowTime = t - lastSwitch;
+			lastSwitch = t;
+			if (lastRise >= 0.0)
+			{
+				bias += amplitude * (lowTime - highTime) / (lowTime + highTime);
+				// the first few cycles are spent finding the bias
+				if (t > 0.5 * duration)
+				{
+					periodSum += t - lastRise;
+					amplitudeSum += 0.5 * (cycleMax - cycleMin);
+					cycles++;
+				}
+			}
+			lastRise = t;
+			cycleMin = 1e9;
+			cycleMax = -1e9;
+		}
+		double pwm = bias + (high ? amplitude : -amplitude);
+		pwm = fmax(-config_.maxPwm, fmin(config_.maxPwm, pwm));
+		measured = stepWheel(&wheel, pwm);
+		cycleMin = fmin(cycleMin, wheel.speed);
+		cycleMax = fmax(cycleMax, wheel.speed);
+	}
+	if (cycles < 3)
+		return false;
+	double oscillation = amplitudeSum / cycles;
+	if (oscillation <= hysteresis)
+		return false;
+	*ultimateGain = 4.0 * amplitude / (M_PI * sqrt(oscillation * oscillation - hysteresis * hysteresis));
+	*ultimatePeriod = periodSum / cycles;
+	return true;
+}
+
+void WheelPlant::resetWheel(Wheel* wheel)
+{
+	wheel->speed = 0.0;
+	wheel->travel = 0.0;
+	wheel->ticks = 0;
+	wheel->integral = 0.0;
+	wheel->lastError = 0.0;
+}
+
+double WheelPlant::stepWheel(Wheel* wheel, double pwm)
+{
+	double dt = config_.loopPeriod / motorSubsteps;
+	double decay = exp(-dt / config_.timeConstant);
+	double drive = 0.0;
+	if (fabs(pwm) > config_.deadband)
+		drive = config_.gain * (pwm - ((pwm > 0.0) ? config_.deadband : -config_.deadband));
+	for (int i = 0; i < motorSubsteps; i++)
+	{
+		// exact first order response over the substep
+		wheel->speed = drive + (wheel->speed - drive) * decay;
+		wheel->speed += config_.speedNoise * sqrt(dt) * gaussianRandom();
+		wheel->travel += wheel->speed * dt;
+	}
+	long ticks = (long)floor(wheel->travel / config_.encoderResolution);
+	double measured = (ticks - wheel->ticks) * config_.encoderResolution / config_.loopPeriod;
+	wheel->ticks = ticks;
+	return measured;
+}
+
+double WheelPlant::pidOutput(Wheel* wheel, const PidTrial& trial, double target, double measured)
+{
+	double error = target - measured;
+	double integral = wheel->integral + error;
+	double derivative = error - wheel->lastError;
+	wheel->lastError = error;
+	double output = trial.kP * error + trial.kI * integral + trial.kD * derivative;
+	if (output > config_.maxPwm || output < -config_.maxPwm)
+	{
+		output = (output > 0.0) ? config_.maxPwm : -config_.maxPwm;
+		// only keep the new error if it pulls the output out of saturation
+		if ((output > 0.0) != (error > 0.0))
+			wheel->integral = integral;
+	}
+	else
+		wheel->integral = integral;
+	return output;
+}
+
+// Box-Muller on two xorshift64* draws
+double WheelPlant::gaussianRandom()
+{
+	double u[2];
+	for (int i = 0; i < 2; i++)
+	{
+		random_ ^= random_ >> 12;
+		random_ ^= random_ << 25;
+		random_ ^= random_ >> 27;
+		u[i] = (double)((random_ * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+	}
+	return sqrt(-2.0 * log(u[0] + 1e-12)) * cos(2.0 * M_PI * u[1]);
+}
@@ -0,0 +1,97 @@
+// WheelPlant.h
+// 10/18/2026
+
+// Simulated plant for PID_tune: Colin's two drive wheels under the wheel
+// speed PID loop that PID_tune.ino runs on the ATmega328
+// A trial is what one PID_tune command packet asks for: drive at a
+// translational speed and angular velocity for a time with the given
+// gains. Each wheel starts from rest and tracks its share of the command
+// (translational -/+ angular * wheelBase / 2)
+
+// Motor: first order, speed approaches gain * pwm with timeConstant, with
+// a deadband of static friction below which the wheel doesn't turn
+// Sensing: speed is measured from whole encoder ticks counted each loop,
+// so it's quantized to encoderResolution / loopPeriod
+// Controller: runs every loopPeriod, in the form Arduino sketches use,
+// with the integral a running sum of errors and the derivative the change
+// in error since the last loop (neither scaled by the period); output is
+// clamped to +/-maxPwm and the integral stops growing while it saturates
+// PID_tune.ino isn't part of this tree, so the form and the constants are
+// estimates; kP is in pwm per cm/s
+
+// relayTest runs a relay feedback experiment (Astrom and Hagglund) on one
+// wheel: the pwm switches between bias +/- amplitude as the speed crosses
+// the set point, and the resulting limit cycle gives the ultimate gain
+// and period for Ziegler-Nichols tuning
+
+#ifndef WHEELPLANT_H
+#define WHEELPLANT_H
+
+#include <stdint.h>
+
+struct PidTrial
+{
+	int16_t speed; // cm/s
+	double angular; // rad/s
+	int16_t time; // ms
+	double kP, kI, kD;
+};
+
+// response of one trial, averaged over both wheels
+struct TrialMetrics
+{
+	double riseTime; // s from 10% to 90% of the step, the trial time if never reached
+	double overshoot; // peak past the target as a fraction of the step
+	double settlingTime; // s until the speed stays within 5% of the step
+	double steadyError; // mean absolute error over the last 20% of the trial, cm/s
+	double iae; // integral of absolute error / step size, s
+};
+
+struct WheelPlantConfig
+{
+	double gain; // steady speed per unit pwm, cm/s
+	double timeConstant; // s
+	double deadband; // pwm below which the wheel doesn't turn
+	double maxPwm;
+	double loopPeriod; // s
+	double encoderResolution; // cm per tick
+	double wheelBase; // cm between the wheels
+	double speedNoise; // sigma of random disturbance on wheel speed, cm/s
+};
+
+WheelPlantConfig defaultWheelPlantConfig();
+
+class WheelPlant
+{
+public:
+	WheelPlant(const WheelPlantConfig& config, uint64_t seed);
+	const WheelPlantConfig& getConfig();
+	// runs a trial from rest, returns false if neither wheel has a step to
+	// follow or the trial is shorter than one loop
+	bool runTrial(const PidTrial& trial, TrialMetrics* metrics);
+	// relay experiment on one wheel around setSpeed (cm/s) for duration
+	// seconds; returns false if no steady oscillation was seen
+	bool relayTest(double setSpeed, double amplitude, double duration,
+	               double* ultimateGain, double* ultimatePeriod);
+
+private:
+	WheelPlantConfig config_;
+	uint64_t random_;
+
+	struct Wheel
+	{
+		double speed; // true speed, cm/s
+		double travel; // cm, for the encoder
+		long ticks; // encoder count
+		double integral;
+		double lastError;
+	};
+
+	void resetWheel(Wheel* wheel);
+	// advances a wheel one loop at the given pwm, returns the measured speed
+	double stepWheel(Wheel* wheel, double pwm);
+	double pidOutput(Wheel* wheel, const PidTrial& trial, double target, double measured);
+	double gaussianRandom();
+};
+
+#endif
@@ -0,0 +1,189 @@
+// World.cpp
+// 10/18/2026
+
+// Wall segments for the simulator, see World.h
+
+#include "World.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int maxLineLength = 4096;
+const int maxPolygonVertices = 256;
+
+World::World(int maxSegments)
+{
+	maxSegments_ = maxSegments;
+	segments_ = new Segment[maxSegments];
+	numSegments_ = 0;
+	start_ = makePose(0.0, 0.0, 0.0);
+}
+
+World::~World()
+{
+	delete [] segments_;
+}
+
+void World::clear()
+{
+	numSegments_ = 0;
+	start_ = makePose(0.0, 0.0, 0.0);
+}
+
+bool World::addWall(double x0, double y0, double x1, double y1)
+{
+	if (numSegments_ >= maxSegments_)
+		return false;
+	Segment& segment = segments_[numSegments_++];
+	segment.x0 = x0;
+	segment.y0 = y0;
+	segment.x1 = x1;
+	segment.y1 = y1;
+	return true;
+}
+
+bool World::addPolygon(const double* xs, const double* ys, int numVertices)
+{
+	if (numVertices < 2 || numSegments_ + numVertices > maxSegments_)
+		return false;
+	for (int i = 0; i < numVertices; i++)
+	{
+		int next = (i + 1) % numVertices;
+		addWall(xs[i], ys[i], xs[next], ys[next]);
+	}
+	return true;
+}
+
+// reads the text format described in World.h
+// on failure the walls read before the bad line are kept
+bool World::load(const char* fileName)
+{
+	FILE* file = fopen(fileName, "r");
+	if (file == NULL)
+		return false;
+	char line[maxLineLength];
+	double values[2 * maxPolygonVertices];
+	bool ok = true;
+	while (ok && fgets(line, maxLineLength, file) != NULL)
+	{
+		char* keyword = strtok(line, " \t\r\n");
+		if (keyword == NULL || keyword[0] == '#')
+			continue;
+		int numValues = 0;
+		char* token;
+		while ((token = strtok(NULL, " \t\r\n")) != NULL && numValues < 2 * maxPolygonVertices)
+		{
+			char* end;
+			values[numValues++] = strtod(token, &end);
+			if (*end != '\0')
+				ok = false;
+		}
+		if (!ok)
+			break;
+		if (strcmp(keyword, "wall") == 0 && numValues == 4)
+			ok = addWall(values[0], values[1], values[2], values[3]);
+		else if (strcmp(keyword, "polygon") == 0 && numValues >= 6 && numValues % 2 == 0)
+		{
+			double xs[maxPolygonVertices], ys[maxPolygonVertices];
+			for (int i = 0; i < numValues / 2; i++)
+			{
+				xs[i] = values[2 * i];
+				ys[i] = values[2 * i + 1];
+			}
+			ok = addPolygon(xs, ys, numValues / 2);
+		}
+		else if (strcmp(keyword, "start") == 0 && numValues == 3)
+			start_ = makePose(values[0], values[1], values[2]);
+		else
+			ok = false;
+	}
+	fclose(file);
+	return ok;
+}
+
+int World::getNumSegments()
+{
+	return numSegments_;
+}
+
+const Segment& World::getSegment(int index)
+{
+	return segments_[index];
+}
+
+void World::setStart(const Pose2D& start)
+{
+	start_ = start;
+}
+
+Pose2D World::getStart()
+{
+	return start_;
+}
+
+// intersects the ray with every segment and keeps the nearest hit
+// ray: (x, y) + t * (dx, dy); segment: a + u * (b - a) with u in [0, 1]
+double World::castRay(double x, double y, double angle, double maxRange, double* incidence)
+{
+	double dx = cos(angle);
+	double dy = sin(angle);
+	double nearest = maxRange;
+	int hit = -1;
+	for (int i = 0; i < numSegments_; i++)
+	{
+		const Segment& s = segments_[i];
+		double ex = s.x1 - s.x0;
+		double ey = s.y1 - s.y0;
+		double denominator = dx * ey - dy * ex;
+		if (fabs(denominator) < 1e-12)
+			continue; // parallel
+		double ax = s.x0 - x;
+		double ay = s.y0 - y;
+		double t = (ax * ey - ay * ex) / denominator;
+		double u = (ax * dy - ay * dx) / denominator;
+		if (t >= 0.0 && t < nearest && u >= 0.0 && u <= 1.0)
+		{
+			nearest = t;
+			hit = i;
+		}
+	}
+	if (hit < 0)
+		return -1.0;
+	if (incidence != NULL)
+	{
+		const Segment& s = segments_[hit];
+		double ex = s.x1 - s.x0;
+		double ey = s.y1 - s.y0;
+		// cosine of the angle between the ray and the wall's normal
+		double cosine = fabs(dx * ey - dy * ex) / hypot(ex, ey);
+		*incidence = acos(fmin(1.0, cosine));
+	}
+	return nearest;
+}
+
+bool World::collides(double x, double y, double radius)
+{
+	double distance = distanceToWall(x, y);
+	return distance >= 0.0 && distance < radius;
+}
+
+double World::distanceToWall(double x, double y)
+{
+	double nearestSquared = -1.0;
+	for (int i = 0; i < numSegments_; i++)
+	{
+		const Segment& s = segments_[i];
+		double ex = s.x1 - s.x0;
+		double ey = s.y1 - s.y0;
+		double lengthSquared = ex * ex + ey * ey;
+		double u = 0.0;
+		if (lengthSquared > 0.0)
+			u = fmax(0.0, fmin(1.0, ((x - s.x0) * ex + (y - s.y0) * ey) / lengthSquared));
+		double px = s.x0 + u * ex - x;
+		double py = s.y0 + u * ey - y;
+		double distanceSquared = px * px + py * py;
+		if (nearestSquared < 0.0 || distanceSquared < nearestSquared)
+			nearestSquared = distanceSquared;
+	}
+	return (nearestSquared < 0.0) ? -1.0 : sqrt(nearestSquared);
+}
@@ -0,0 +1,62 @@
+// World.h
+// 10/18/2026
+
+// 2D world for the simulator, made of wall segments
+// Walls are added as single segments or as closed polygons (rooms,
+// boxes, pillars), and can be loaded from a text file with one entry per
+// line, coordinates in cm:
+//    wall x0 y0 x1 y1
+//    polygon x0 y0 x1 y1 x2 y2 ...
+//    start x y theta
+// blank lines and lines starting with # are ignored
+
+// Rays and the robot's footprint are tested against every segment; a
+// handful of rooms is a few dozen segments, which is cheap enough that
+// no spatial index is needed
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "../Geometry/Pose2D.h"
+
+struct Segment
+{
+	double x0, y0;
+	double x1, y1;
+};
+
+class World
+{
+public:
+	World(int maxSegments);
+	~World();
+	void clear();
+	bool addWall(double x0, double y0, double x1, double y1);
+	// adds the closed polygon through numVertices vertices
+	bool addPolygon(const double* xs, const double* ys, int numVertices);
+	bool load(const char* fileName); // returns false if the file can't be read or is malformed
+	int getNumSegments();
+	const Segment& getSegment(int index);
+	void setStart(const Pose2D& start);
+	Pose2D getStart(); // from the file's start line, the origin if it has none
+
+	// distance from (x, y) along angle to the nearest wall, or -1.0 if no
+	// wall is within maxRange; if a wall is hit and incidence isn't NULL
+	// it gets the angle between the ray and the wall's normal, in [0, pi/2]
+	double castRay(double x, double y, double angle, double maxRange, double* incidence);
+	// true if a circle of radius at (x, y) overlaps any wall
+	bool collides(double x, double y, double radius);
+	// distance from (x, y) to the nearest point on any wall, -1.0 if there are none
+	double distanceToWall(double x, double y);
+
+private:
+	Segment* segments_;
+	int numSegments_;
+	int maxSegments_;
+	Pose2D start_;
+
+	World(const World&); // not copyable
+	World& operator=(const World&);
+};
+
+#endif
@@ -0,0 +1,120 @@
+// SonarFilter.cpp
+// 10/18/2026
+
+// Filters raw sonar readings before they're turned into points
+// See SonarFilter.h for a description of the filtering steps
+
+#include "SonarFilter.h"
+
+// swaps lanes of a and b so a holds the smaller value in every lane
+static inline void compareExchange(float* a, float* b)
+{
+	for (int c = 0; c < sonarChannels; c++)
+	{
+		float low = (a[c] < b[c]) ? a[c] : b[c];
+		float high = (a[c] < b[c]) ? b[c] : a[c];
+		a[c] = low;
+		b[c] = high;
+	}
+}
+
+SonarFilter::SonarFilter(float maxRange)
+{
+	maxRange_ = maxRange;
+	processNoise_ = 25.0f;
+	measurementNoise_ = 16.0f;
+	innovationGate_ = 50.0f;
+	reset();
+}
+
+void SonarFilter::reset()
+{
+	head_ = 0;
+	initialized_ = false;
+}
+
+void SonarFilter::setNoise(float processNoise, float measurementNoise)
+{
+	processNoise_ = processNoise;
+	measurementNoise_ = measurementNoise;
+}
+
+void SonarFilter::setInnovationGate(float gate)
+{
+	innovationGate_ = gate;
+}
+
+void SonarFilter::update(const int16_t* distances, FilteredScan* out)
+{
+	float raw[sonarChannels];
+	float valid[sonarChannels];
+	for (int c = 0; c < sonarChannels; c++)
+	{
+		raw[c] = (float)distances[c];
+		valid[c] = (raw[c] > 0.0f && raw[c] <= maxRange_) ? 1.0f : 0.0f;
+	}
+
+	if (!initialized_)
+	{
+		for (int c = 0; c < sonarChannels; c++)
+		{
+			estimate_[c] = (valid[c] > 0.0f) ? raw[c] : maxRange_;
+			variance_[c] = measurementNoise_;
+		}
+		for (int i = 0; i < filterWindow; i++)
+		{
+			for (int c = 0; c < sonarChannels; c++)
+			{
+				history_[i][c] = estimate_[c];
+				valid_[i][c] = valid[c];
+			}
+		}
+		initialized_ = true;
+	}
+
+	// rejected readings hold the channel's last estimate so they don't
+	// drag the median toward 0 or maxRange
+	for (int c = 0; c < sonarChannels; c++)
+	{
+		history_[head_][c] = (valid[c] > 0.0f) ? raw[c] : estimate_[c];
+		valid_[head_][c] = valid[c];
+	}
+	head_ = (head_ + 1 == filterWindow) ? 0 : head_ + 1;
+
+	// median by odd-even transposition sort across the window
+	float sorted[filterWindow][sonarChannels];
+	float validCount[sonarChannels];
+	for (int c = 0; c < sonarChannels; c++)
+		validCount[c] = 0.0f;
+	for (int i = 0; i < filterWindow; i++)
+	{
+		for (int c = 0; c < sonarChannels; c++)
+		{
+			sorted[i][c] = history_[i][c];
+			validCount[c] += valid_[i][c];
+		}
+	}
+	for (int pass = 0; pass < filterWindow; pass++)
+	{
+		for (int i = pass & 1; i + 1 < filterWindow; i += 2)
+			compareExchange(sorted[i], sorted[i + 1]);
+	}
+	const float* median = sorted[filterWindow / 2];
+
+	const float invWindow = 1.0f / (float)filterWindow;
+	const float invGate = 1.0f / innovationGate_;
+	for (int c = 0; c < sonarChannels; c++)
+	{
+		float predictedVariance = variance_[c] + processNoise_;
+		float innovation = median[c] - estimate_[c];
+		float gain = predictedVariance / (predictedVariance + measurementNoise_);
+		estimate_[c] += gain * innovation;
+		variance_[c] = (1.0f - gain) * predictedVariance;
+
+		float magnitude = (innovation < 0.0f) ? -innovation : innovation;
+		float agreement = 1.0f - magnitude * invGate;
+		agreement = (agreement < 0.0f) ? 0.0f : agreement;
+		out->range[c] = estimate_[c];
+		out->confidence[c] = validCount[c] * invWindow * agreement;
+	}
+}
@@ -0,0 +1,58 @@
+// SonarFilter.h
+// 10/18/2026
+
+// Filters raw sonar readings before they're turned into points
+// All channels are processed together; state is stored structure-of-arrays
+// (one array per quantity, indexed by channel) so each step is a short
+// branch-free loop across channels the compiler can vectorize
+
+// Each scan goes through three steps:
+//    rejection: readings of 0 (no echo) or beyond maxRange are replaced by
+//               the channel's last estimate and count against its confidence
+//    median:    sliding median over the last filterWindow readings removes
+//               single spurious echoes
+//    kalman:    scalar Kalman filter per channel smooths the median
+// Each filtered range carries a confidence from 0 to 1 combining the
+// fraction of valid readings in the window with how well the newest
+// reading agreed with the prediction; LineFitter::setConfidence uses it
+// to scale point weights
+
+// History is fixed size and nothing is allocated after construction
+
+#ifndef SONARFILTER_H
+#define SONARFILTER_H
+
+#include <stdint.h>
+
+const int sonarChannels = 8; // number of channels filtered per scan
+const int filterWindow = 5; // readings in the sliding median, must be odd
+
+struct FilteredScan
+{
+	float range[sonarChannels]; // filtered range in cm
+	float confidence[sonarChannels]; // 0 (no information) to 1
+};
+
+class SonarFilter
+{
+public:
+	SonarFilter(float maxRange);
+	void reset(); // clears history, the next scan reinitializes every channel
+	void setNoise(float processNoise, float measurementNoise); // variances in cm^2
+	void setInnovationGate(float gate); // innovation in cm at which confidence reaches 0
+	void update(const int16_t* distances, FilteredScan* out); // filters one scan
+
+private:
+	float maxRange_;
+	float processNoise_; // kalman process noise variance
+	float measurementNoise_; // kalman measurement noise variance
+	float innovationGate_;
+	int head_; // index of the oldest reading in history_
+	bool initialized_;
+	float history_[filterWindow][sonarChannels];
+	float valid_[filterWindow][sonarChannels]; // 1 if the reading was valid
+	float estimate_[sonarChannels]; // kalman state
+	float variance_[sonarChannels]; // kalman covariance
+};
+
+#endif
@@ -0,0 +1,158 @@
+// TelemetryReader.cpp
+// 10/18/2026
+
+// Reading side of the shared memory telemetry ring, see TelemetryRing.h
+
+#include "TelemetryReader.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+TelemetryReader::TelemetryReader()
+{
+	header_ = NULL;
+	slots_ = NULL;
+	size_ = 0;
+	capacity_ = 0;
+	index_ = 0;
+	missed_ = 0;
+}
+
+TelemetryReader::~TelemetryReader()
+{
+	close();
+}
+
+bool TelemetryReader::open(const char* name)
+{
+	close();
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TelemetryHeader))
+	{
+		::close(fd);
+		return false;
+	}
+	void* memory = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED)
+		return false;
+	TelemetryHeader* header = (TelemetryHeader*)memory;
+	bool valid = header->magic == telemetryMagic;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	valid = valid && header->version == telemetryVersion
+	        && header->recordSize == sizeof(TelemetryRecord)
+	        && telemetrySize(header->capacity) <= (size_t)info.st_size;
+	if (!valid)
+	{
+		munmap(memory, info.st_size);
+		return false;
+	}
+	header_ = header;
+	slots_ = telemetrySlots(header);
+	size_ = info.st_size;
+	capacity_ = header->capacity;
+	uint64_t written = header_->writeIndex.load(std::memory_order_acquire);
+	index_ = (written > capacity_) ? written - capacity_ : 0;
+	missed_ = 0;
+	return true;
+}
+
+void TelemetryReader::close()
+{
+	if (header_ == NULL)
+		return;
+	munmap(header_, size_);
+	header_ = NULL;
+	slots_ = NULL;
+}
+
+bool TelemetryReader::isOpen()
+{
+	return header_ != NULL;
+}
+
+int TelemetryReader::next(TelemetryRecord* record)
+{
+	while (true)
+	{
+		uint64_t written = header_->writeIndex.load(std::memory_order_acquire);
+		if (index_ >= written)
+			return 0;
+		if (written - index_ > capacity_)
+		{
+			missed_ += written - capacity_ - index_;
+			index_ = written - capacity_;
+		}
+		if (read(index_, record))
+		{
+			index_++;
+			return 1;
+		}
+		// overwritten while we looked, the writer is at least a ring
+		// ahead now; the next pass skips forward
+		missed_++;
+		index_++;
+	}
+}
+
+bool TelemetryReader::latest(TelemetryRecord* record)
+{
+	while (true)
+	{
+		uint64_t written = header_->writeIndex.load(std::memory_order_acquire);
+		if (written == 0)
+			return false;
+		if (read(written - 1, record))
+			return true;
+	}
+}
+
+// walks back from the newest record; gives up if the writer laps the walk
+bool TelemetryReader::latestFrame(SensorFrame* frame)
+{
+	uint64_t written = header_->writeIndex.load(std::memory_order_acquire);
+	uint64_t oldest = (written > capacity_) ? written - capacity_ : 0;
+	TelemetryRecord record;
+	for (uint64_t index = written; index > oldest; index--)
+	{
+		if (!read(index - 1, &record))
+			return false;
+		if (record.type == telemetryFrame)
+		{
+			*frame = record.frame;
+			return true;
+		}
+	}
+	return false;
+}
+
+void TelemetryReader::skipToLatest()
+{
+	index_ = header_->writeIndex.load(std::memory_order_acquire);
+}
+
+uint64_t TelemetryReader::getPublished()
+{
+	return header_->writeIndex.load(std::memory_order_acquire);
+}
+
+uint64_t TelemetryReader::getMissed()
+{
+	return missed_;
+}
+
+bool TelemetryReader::read(uint64_t index, TelemetryRecord* record)
+{
+	const TelemetrySlot& slot = slots_[index & (capacity_ - 1)];
+	uint64_t expected = 2 * index + 2;
+	if (slot.sequence.load(std::memory_order_acquire) != expected)
+		return false;
+	memcpy(record, &slot.record, sizeof(*record));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
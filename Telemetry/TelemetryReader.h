@@ -0,0 +1,56 @@
+// TelemetryReader.h
+// 10/18/2026
+
+// Reading side of the shared memory telemetry ring, see TelemetryRing.h
+// Maps the ring read only, so a reader can't disturb the writer or other
+// readers. Each reader keeps its own position:
+//    next: returns records in order, for loggers; a reader more than a
+//          ring behind skips ahead, and getMissed counts what it skipped
+//    latest, latestFrame: return the newest record, for displays
+// Records are copied out, since the writer may reuse a slot at any time
+// Readers poll; nothing wakes them when a record arrives
+
+// Typical use:
+//    TelemetryReader reader;
+//    if (reader.open(defaultTelemetryName))
+//        while (running)
+//            if (reader.next(&record) == 0) usleep(1000);
+
+#ifndef TELEMETRYREADER_H
+#define TELEMETRYREADER_H
+
+#include "TelemetryRing.h"
+
+class TelemetryReader
+{
+public:
+	TelemetryReader();
+	~TelemetryReader();
+	// returns false if there's no ring by that name, or it was built
+	// with a different record layout; starts at the oldest record held
+	bool open(const char* name);
+	void close();
+	bool isOpen();
+	// 1 if a record was copied to record, 0 if there's nothing new
+	int next(TelemetryRecord* record);
+	bool latest(TelemetryRecord* record); // false if nothing has been published
+	bool latestFrame(SensorFrame* frame); // newest frame held in the ring
+	void skipToLatest(); // next will return only records published from now on
+	uint64_t getPublished(); // records the writer has published
+	uint64_t getMissed(); // records next skipped because the writer lapped this reader
+
+private:
+	TelemetryHeader* header_;
+	TelemetrySlot* slots_;
+	size_t size_;
+	uint64_t capacity_;
+	uint64_t index_; // next record next will return
+	uint64_t missed_;
+
+	bool read(uint64_t index, TelemetryRecord* record); // false if the slot no longer holds index
+
+	TelemetryReader(const TelemetryReader&); // not copyable
+	TelemetryReader& operator=(const TelemetryReader&);
+};
+
+#endif
@@ -0,0 +1,90 @@
+// TelemetryRing.h
+// 10/18/2026
+
+// Layout of the shared memory telemetry ring SerialBot publishes to
+// One writer (the comm thread) appends records to a fixed ring of slots
+// in a POSIX shared memory object; any number of reader processes map it
+// read only and follow along, see TelemetryWriter.h and TelemetryReader.h
+
+// Each slot is guarded by its own sequence number (a seqlock):
+//    the writer stores 2 * index + 1 before writing record index into the
+//    slot and 2 * index + 2 after, then advances writeIndex
+//    a reader copies the record out and checks the sequence was
+//    2 * index + 2 both before and after the copy; anything else means the
+//    writer lapped it and the copy is discarded
+// Readers never write to the shared memory, so however many there are
+// and however slowly they read, the writer's cost is the same: two
+// stores, a copy into the slot and an index update, with no locks or
+// system calls. A reader that falls more than a ring behind skips ahead
+// and counts the records it missed
+
+// Records hold structs by value, so the writer and readers must be built
+// from the same headers; the header's recordSize and version are checked
+// when a reader attaches
+// shm_open needs -lrt on older glibc
+
+#ifndef TELEMETRYRING_H
+#define TELEMETRYRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "../SerialBot/SensorFrame.h"
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the ring needs address free 64 bit atomics");
+
+const char defaultTelemetryName[] = "/colin_telemetry";
+const uint32_t telemetryMagic = 0x434f4c54; // "COLT"
+const uint32_t telemetryVersion = 2;
+const int defaultTelemetryCapacity = 1024; // records, rounded up to a power of two
+
+enum TelemetryType
+{
+	telemetryFrame = 1, // a SensorFrame as parsed from a sensor packet
+	telemetryCommand = 2 // a command sent to Colin
+};
+
+struct TelemetryCommand
+{
+	int16_t translational; // cm/s
+	double angular; // rad/s
+};
+
+struct TelemetryRecord
+{
+	uint32_t type; // TelemetryType
+	int64_t timestamp; // monotonic time the record was published in ns
+	union
+	{
+		SensorFrame frame;
+		TelemetryCommand command;
+	};
+};
+
+struct alignas(64) TelemetrySlot
+{
+	std::atomic<uint64_t> sequence; // 2 * index + 2 once record index is complete
+	TelemetryRecord record;
+};
+
+struct alignas(64) TelemetryHeader
+{
+	uint32_t magic; // written last when the ring is created
+	uint32_t version;
+	uint32_t recordSize; // sizeof(TelemetryRecord)
+	uint32_t capacity; // slots, a power of two
+	alignas(64) std::atomic<uint64_t> writeIndex; // records published so far
+};
+
+// bytes of shared memory for a ring of capacity slots
+inline size_t telemetrySize(uint32_t capacity)
+{
+	return sizeof(TelemetryHeader) + (size_t)capacity * sizeof(TelemetrySlot);
+}
+
+inline TelemetrySlot* telemetrySlots(TelemetryHeader* header)
+{
+	return (TelemetrySlot*)(header + 1);
+}
+
+#endif
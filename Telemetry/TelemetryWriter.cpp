@@ -0,0 +1,121 @@
+// TelemetryWriter.cpp
+// 10/18/2026
+
+// Writing side of the shared memory telemetry ring, see TelemetryRing.h
+
+#include "TelemetryWriter.h"
+#include "../Pipeline/PipelineStage.h" // monotonicNanos
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+TelemetryWriter::TelemetryWriter()
+{
+	name_[0] = '\0';
+	header_ = NULL;
+	slots_ = NULL;
+	size_ = 0;
+	mask_ = 0;
+	index_ = 0;
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+	close();
+}
+
+bool TelemetryWriter::open(const char* name, int capacity)
+{
+	close();
+	uint32_t slots = 2;
+	while ((int)slots < capacity)
+		slots <<= 1;
+	// a fresh object, so readers still attached to an old one can't
+	// mistake it for this ring
+	shm_unlink(name);
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd == -1)
+		return false;
+	size_t size = telemetrySize(slots);
+	if (ftruncate(fd, size) != 0)
+	{
+		::close(fd);
+		shm_unlink(name);
+		return false;
+	}
+	void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED)
+	{
+		shm_unlink(name);
+		return false;
+	}
+	// ftruncate zero fills, so every slot's sequence starts at 0 (empty)
+	header_ = (TelemetryHeader*)memory;
+	slots_ = telemetrySlots(header_);
+	size_ = size;
+	mask_ = slots - 1;
+	index_ = 0;
+	strncpy(name_, name, sizeof(name_) - 1);
+	name_[sizeof(name_) - 1] = '\0';
+	header_->version = telemetryVersion;
+	header_->recordSize = sizeof(TelemetryRecord);
+	header_->capacity = slots;
+	header_->writeIndex.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	header_->magic = telemetryMagic;
+	return true;
+}
+
+void TelemetryWriter::close()
+{
+	if (header_ == NULL)
+		return;
+	munmap(header_, size_);
+	shm_unlink(name_);
+	header_ = NULL;
+	slots_ = NULL;
+}
+
+bool TelemetryWriter::isOpen()
+{
+	return header_ != NULL;
+}
+
+void TelemetryWriter::publishFrame(const SensorFrame& frame)
+{
+	TelemetryRecord record;
+	record.type = telemetryFrame;
+	record.frame = frame;
+	publish(record);
+}
+
+void TelemetryWriter::publishCommand(int16_t translational, double angular)
+{
+	TelemetryRecord record;
+	record.type = telemetryCommand;
+	record.command.translational = translational;
+	record.command.angular = angular;
+	publish(record);
+}
+
+uint64_t TelemetryWriter::getPublished()
+{
+	return index_;
+}
+
+void TelemetryWriter::publish(const TelemetryRecord& record)
+{
+	if (header_ == NULL)
+		return;
+	TelemetrySlot& slot = slots_[index_ & mask_];
+	slot.sequence.store(2 * index_ + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&slot.record, &record, sizeof(record));
+	slot.record.timestamp = monotonicNanos();
+	slot.sequence.store(2 * index_ + 2, std::memory_order_release);
+	index_++;
+	header_->writeIndex.store(index_, std::memory_order_release);
+}
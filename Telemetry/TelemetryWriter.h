@@ -0,0 +1,40 @@
+// TelemetryWriter.h
+// 10/18/2026
+
+// Writing side of the shared memory telemetry ring, see TelemetryRing.h
+// open creates the shared memory object, replacing any left by an
+// earlier writer, and the destructor removes it
+// Only one thread may publish; SerialBot publishes from its comm thread
+
+#ifndef TELEMETRYWRITER_H
+#define TELEMETRYWRITER_H
+
+#include "TelemetryRing.h"
+
+class TelemetryWriter
+{
+public:
+	TelemetryWriter();
+	~TelemetryWriter();
+	bool open(const char* name, int capacity); // returns false if the ring can't be created
+	void close();
+	bool isOpen();
+	void publishFrame(const SensorFrame& frame);
+	void publishCommand(int16_t translational, double angular);
+	uint64_t getPublished();
+
+private:
+	char name_[64];
+	TelemetryHeader* header_;
+	TelemetrySlot* slots_;
+	size_t size_;
+	uint64_t mask_;
+	uint64_t index_; // next record to write
+
+	void publish(const TelemetryRecord& record);
+
+	TelemetryWriter(const TelemetryWriter&); // not copyable
+	TelemetryWriter& operator=(const TelemetryWriter&);
+};
+
+#endif
@@ -0,0 +1,112 @@
+// TelemetryLog.h
+// 10/18/2026
+
+// Layout of the columnar telemetry log files, for keeping weeks of
+// Colin's sensor frames and commands on disk and querying them offline
+// see TelemetryLogWriter.h and TelemetryLogReader.h
+
+// A log holds two tables, frames and commands. Rows are written in
+// blocks of up to blockRows rows; within a block each column is stored
+// contiguously, so a query reads only the columns it asks for and the
+// pages of the file it never touches are never read from disk
+// Values are stored at the width Colin sends them: times in ns as 64 bit
+// ints, the sequence number as 32 bits, and everything else as the 16 bit
+// values of the packets, with theta and angular in thousandths
+// Every block has an index entry with its row count, its time range and
+// the offset, minimum and maximum of each column, so a query for a time
+// range binary searches the index and skips whole blocks; the index is
+// written after the last block, followed by a fixed size trailer that
+// points back to it
+//    header | block | block | ... | index (LogBlock each) | trailer
+// Files are in the host's byte order; a reader rejects any other version
+
+#ifndef TELEMETRYLOG_H
+#define TELEMETRYLOG_H
+
+#include <stdint.h>
+#include "../SerialBot/SensorFrame.h"
+
+const uint32_t telemetryLogMagic = 0x434f4c4c; // "COLL"
+const uint32_t telemetryLogVersion = 1;
+const int defaultLogBlockRows = 4096;
+
+enum LogTable
+{
+	logFrames = 0,
+	logCommands = 1,
+	numLogTables = 2
+};
+
+// frame table columns; there's one distance column per sonar
+enum FrameColumn
+{
+	frameTimestamp = 0, // int64, ns the packet was received
+	frameSampledAt, // int64
+	frameCommandAt, // int64
+	frameSequence, // int32
+	frameX, // int16, cm
+	frameY,
+	frameTheta, // int16, mrad
+	frameTranslational, // int16, cm/s
+	frameAngular, // int16, mrad/s
+	frameDistance0 // int16, cm, sonar 0; sonar i is frameDistance0 + i
+};
+
+enum CommandColumn
+{
+	commandTimestamp = 0, // int64, ns the command was sent
+	commandTranslational, // int16, cm/s
+	commandAngular, // int16, mrad/s
+	numCommandColumns
+};
+
+const int maxLogColumns = frameDistance0 + maxSonar;
+
+// bytes per value of a column
+inline int logColumnWidth(int table, int column)
+{
+	if (column == 0 || (table == logFrames && column <= frameCommandAt))
+		return 8;
+	if (table == logFrames && column == frameSequence)
+		return 4;
+	return 2;
+}
+
+inline int logColumns(int table, int numSonar)
+{
+	return (table == logFrames) ? frameDistance0 + numSonar : numCommandColumns;
+}
+
+struct LogFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t numSonar;
+	int32_t blockRows;
+	double sensorAngles[maxSonar]; // rad, as the control programs give them
+};
+
+struct LogColumn
+{
+	uint64_t offset; // of the column's first value, from the start of the file
+	int64_t min;
+	int64_t max;
+};
+
+struct LogBlock
+{
+	int32_t table; // LogTable
+	int32_t rows;
+	int64_t firstTime; // smallest and largest timestamp in the block
+	int64_t lastTime;
+	LogColumn columns[maxLogColumns]; // only logColumns(table) are used
+};
+
+struct LogTrailer
+{
+	uint64_t indexOffset;
+	uint32_t numBlocks;
+	uint32_t magic;
+};
+
+#endif
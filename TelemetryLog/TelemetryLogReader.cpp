@@ -0,0 +1,220 @@
+// TelemetryLogReader.cpp
+// 10/18/2026
+
+// Reading side of the columnar telemetry log, see TelemetryLog.h
+
+#include "TelemetryLogReader.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+TelemetryLogReader::TelemetryLogReader()
+{
+	memory_ = NULL;
+	size_ = 0;
+	header_ = NULL;
+	index_ = NULL;
+	for (int t = 0; t < numLogTables; t++)
+	{
+		blocks_[t] = NULL;
+		numBlocks_[t] = 0;
+		rows_[t] = 0;
+	}
+}
+
+TelemetryLogReader::~TelemetryLogReader()
+{
+	close();
+}
+
+bool TelemetryLogReader::open(const char* path)
+{
+	close();
+	int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(LogFileHeader) + sizeof(LogTrailer))
+	{
+		::close(fd);
+		return false;
+	}
+	void* memory = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED)
+		return false;
+	memory_ = (char*)memory;
+	size_ = info.st_size;
+	header_ = (const LogFileHeader*)memory_;
+	LogTrailer trailer;
+	memcpy(&trailer, memory_ + size_ - sizeof(trailer), sizeof(trailer));
+	if (!validate(trailer))
+	{
+		close();
+		return false;
+	}
+	index_ = (const LogBlock*)(memory_ + trailer.indexOffset);
+	for (int t = 0; t < numLogTables; t++)
+		blocks_[t] = new int[trailer.numBlocks];
+	for (uint32_t b = 0; b < trailer.numBlocks; b++)
+	{
+		int table = index_[b].table;
+		blocks_[table][numBlocks_[table]++] = b;
+		rows_[table] += index_[b].rows;
+	}
+	return true;
+}
+
+void TelemetryLogReader::close()
+{
+	if (memory_ == NULL)
+		return;
+	munmap(memory_, size_);
+	memory_ = NULL;
+	header_ = NULL;
+	index_ = NULL;
+	for (int t = 0; t < numLogTables; t++)
+	{
+		delete [] blocks_[t];
+		blocks_[t] = NULL;
+		numBlocks_[t] = 0;
+		rows_[t] = 0;
+	}
+}
+
+bool TelemetryLogReader::isOpen()
+{
+	return memory_ != NULL;
+}
+
+int TelemetryLogReader::getNumSonar()
+{
+	return header_->numSonar;
+}
+
+double TelemetryLogReader::getSensorAngle(int sonar)
+{
+	return header_->sensorAngles[sonar];
+}
+
+int TelemetryLogReader::getNumBlocks(int table)
+{
+	return numBlocks_[table];
+}
+
+const LogBlock& TelemetryLogReader::getBlock(int table, int block)
+{
+	return index_[blocks_[table][block]];
+}
+
+uint64_t TelemetryLogReader::getRows(int table)
+{
+	return rows_[table];
+}
+
+int64_t TelemetryLogReader::getStartTime()
+{
+	int64_t start = 0;
+	bool found = false;
+	for (int t = 0; t < numLogTables; t++)
+		if (numBlocks_[t] > 0 && (!found || getBlock(t, 0).firstTime < start))
+		{
+			start = getBlock(t, 0).firstTime;
+			found = true;
+		}
+	return start;
+}
+
+int64_t TelemetryLogReader::getEndTime()
+{
+	int64_t end = 0;
+	bool found = false;
+	for (int t = 0; t < numLogTables; t++)
+		if (numBlocks_[t] > 0 && (!found || getBlock(t, numBlocks_[t] - 1).lastTime > end))
+		{
+			end = getBlock(t, numBlocks_[t] - 1).lastTime;
+			found = true;
+		}
+	return end;
+}
+
+// blocks of a table are written in time order, so both ends are found
+// by binary search
+bool TelemetryLogReader::findBlocks(int table, int64_t from, int64_t to, int* first, int* last)
+{
+	int low = 0, high = numBlocks_[table];
+	while (low < high)
+	{
+		int middle = (low + high) / 2;
+		if (getBlock(table, middle).lastTime < from)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	*first = low;
+	high = numBlocks_[table];
+	while (low < high)
+	{
+		int middle = (low + high) / 2;
+		if (getBlock(table, middle).firstTime <= to)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	*last = low - 1;
+	return *first <= *last;
+}
+
+const int64_t* TelemetryLogReader::getColumn64(const LogBlock& block, int column)
+{
+	return (const int64_t*)getColumn(block, column, 8);
+}
+
+const int32_t* TelemetryLogReader::getColumn32(const LogBlock& block, int column)
+{
+	return (const int32_t*)getColumn(block, column, 4);
+}
+
+const int16_t* TelemetryLogReader::getColumn16(const LogBlock& block, int column)
+{
+	return (const int16_t*)getColumn(block, column, 2);
+}
+
+const void* TelemetryLogReader::getColumn(const LogBlock& block, int column, int width)
+{
+	if (column < 0 || column >= logColumns(block.table, header_->numSonar)
+	    || logColumnWidth(block.table, column) != width)
+		return NULL;
+	return memory_ + block.columns[column].offset;
+}
+
+// every offset is checked against the file once here, so the accessors
+// can trust the index
+bool TelemetryLogReader::validate(const LogTrailer& trailer)
+{
+	if (header_->magic != telemetryLogMagic || header_->version != telemetryLogVersion
+	    || trailer.magic != telemetryLogMagic || header_->numSonar < 0
+	    || header_->numSonar > maxSonar)
+		return false;
+	size_t indexEnd = size_ - sizeof(LogTrailer);
+	if (trailer.indexOffset % 8 != 0 || trailer.indexOffset > indexEnd
+	    || indexEnd - trailer.indexOffset != (size_t)trailer.numBlocks * sizeof(LogBlock))
+		return false;
+	const LogBlock* index = (const LogBlock*)(memory_ + trailer.indexOffset);
+	for (uint32_t b = 0; b < trailer.numBlocks; b++)
+	{
+		const LogBlock& block = index[b];
+		if (block.table < 0 || block.table >= numLogTables || block.rows <= 0)
+			return false;
+		for (int c = 0; c < logColumns(block.table, header_->numSonar); c++)
+		{
+			int width = logColumnWidth(block.table, c);
+			if (block.columns[c].offset % width != 0
+			    || block.columns[c].offset + (uint64_t)block.rows * width > trailer.indexOffset)
+				return false;
+		}
+	}
+	return true;
+}
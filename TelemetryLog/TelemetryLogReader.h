@@ -0,0 +1,70 @@
+// TelemetryLogReader.h
+// 10/18/2026
+
+// Reads columnar telemetry logs, see TelemetryLog.h
+// The whole file is mapped read only and columns are handed out as
+// pointers into the mapping, so nothing is copied and only the pages of
+// the columns a query touches are read from disk. A reader never changes
+// after open, so any number of threads can scan one at once
+
+// Queries over a time range find the blocks that can hold it with
+// findBlocks, then read each block's columns:
+//    int first, last;
+//    if (log.findBlocks(logFrames, from, to, &first, &last))
+//        for (int b = first; b <= last; b++)
+//        {
+//            const LogBlock& block = log.getBlock(logFrames, b);
+//            const int64_t* times = log.getColumn64(block, frameTimestamp);
+//            ...
+//        }
+// Edge blocks can hold rows outside the range, so rows still have to be
+// checked against it
+
+#ifndef TELEMETRYLOGREADER_H
+#define TELEMETRYLOGREADER_H
+
+#include <stddef.h>
+#include "TelemetryLog.h"
+
+class TelemetryLogReader
+{
+public:
+	TelemetryLogReader();
+	~TelemetryLogReader();
+	// false if the file can't be mapped or isn't a complete log of this version
+	bool open(const char* path);
+	void close();
+	bool isOpen();
+	int getNumSonar();
+	double getSensorAngle(int sonar);
+	int getNumBlocks(int table);
+	const LogBlock& getBlock(int table, int block); // in time order
+	uint64_t getRows(int table);
+	// ns, over both tables; 0 for an empty log
+	int64_t getStartTime();
+	int64_t getEndTime();
+	// the range of blocks of table whose times overlap [from, to];
+	// false if there are none
+	bool findBlocks(int table, int64_t from, int64_t to, int* first, int* last);
+	// NULL if the column isn't stored at that width
+	const int64_t* getColumn64(const LogBlock& block, int column);
+	const int32_t* getColumn32(const LogBlock& block, int column);
+	const int16_t* getColumn16(const LogBlock& block, int column);
+
+private:
+	char* memory_;
+	size_t size_;
+	const LogFileHeader* header_;
+	const LogBlock* index_;
+	int* blocks_[numLogTables]; // index_ entries of each table
+	int numBlocks_[numLogTables];
+	uint64_t rows_[numLogTables];
+
+	const void* getColumn(const LogBlock& block, int column, int width);
+	bool validate(const LogTrailer& trailer);
+
+	TelemetryLogReader(const TelemetryLogReader&); // not copyable
+	TelemetryLogReader& operator=(const TelemetryLogReader&);
+};
+
+#endif
@@ -0,0 +1,202 @@
+// TelemetryLogWriter.cpp
+// 10/18/2026
+
+// Writing side of the columnar telemetry log, see TelemetryLog.h
+
+#include "TelemetryLogWriter.h"
+#include <string.h>
+#include <math.h>
+
+TelemetryLogWriter::TelemetryLogWriter(int blockRows)
+{
+	file_ = NULL;
+	offset_ = 0;
+	blockRows_ = (blockRows > 0) ? blockRows : defaultLogBlockRows;
+	numSonar_ = 0;
+	for (int t = 0; t < numLogTables; t++)
+	{
+		values_[t] = new int64_t[(size_t)blockRows_ * maxLogColumns];
+		rows_[t] = 0;
+		totalRows_[t] = 0;
+	}
+	indexCapacity_ = 64;
+	index_ = new LogBlock[indexCapacity_];
+	numBlocks_ = 0;
+	buffer_ = new char[(size_t)blockRows_ * 8];
+	failed_ = false;
+}
+
+TelemetryLogWriter::~TelemetryLogWriter()
+{
+	close();
+	for (int t = 0; t < numLogTables; t++)
+		delete [] values_[t];
+	delete [] index_;
+	delete [] buffer_;
+}
+
+bool TelemetryLogWriter::open(const char* path, int numSonar, const double* sensorAngles)
+{
+	close();
+	file_ = fopen(path, "wb");
+	if (file_ == NULL)
+		return false;
+	numSonar_ = (numSonar < maxSonar) ? numSonar : maxSonar;
+	offset_ = 0;
+	numBlocks_ = 0;
+	failed_ = false;
+	for (int t = 0; t < numLogTables; t++)
+	{
+		rows_[t] = 0;
+		totalRows_[t] = 0;
+	}
+	LogFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = telemetryLogMagic;
+	header.version = telemetryLogVersion;
+	header.numSonar = numSonar_;
+	header.blockRows = blockRows_;
+	for (int i = 0; i < numSonar_ && sensorAngles != NULL; i++)
+		header.sensorAngles[i] = sensorAngles[i];
+	write(&header, sizeof(header));
+	pad();
+	return !failed_;
+}
+
+bool TelemetryLogWriter::close()
+{
+	if (file_ == NULL)
+		return true;
+	for (int t = 0; t < numLogTables; t++)
+		if (rows_[t] > 0)
+			writeBlock(t);
+	pad();
+	LogTrailer trailer;
+	trailer.indexOffset = offset_;
+	trailer.numBlocks = numBlocks_;
+	trailer.magic = telemetryLogMagic;
+	write(index_, sizeof(LogBlock) * numBlocks_);
+	write(&trailer, sizeof(trailer));
+	if (fclose(file_) != 0)
+		failed_ = true;
+	file_ = NULL;
+	return !failed_;
+}
+
+bool TelemetryLogWriter::isOpen()
+{
+	return file_ != NULL;
+}
+
+void TelemetryLogWriter::addFrame(const SensorFrame& frame)
+{
+	if (file_ == NULL)
+		return;
+	int64_t* values = values_[logFrames] + rows_[logFrames];
+	values[frameTimestamp * blockRows_] = frame.timestamp;
+	values[frameSampledAt * blockRows_] = frame.sampledAt;
+	values[frameCommandAt * blockRows_] = frame.commandAt;
+	values[frameSequence * blockRows_] = (int32_t)frame.sequence;
+	values[frameX * blockRows_] = frame.x;
+	values[frameY * blockRows_] = frame.y;
+	values[frameTheta * blockRows_] = (int16_t)lround(frame.theta * 1000.0);
+	values[frameTranslational * blockRows_] = frame.translational;
+	values[frameAngular * blockRows_] = (int16_t)lround(frame.angular * 1000.0);
+	for (int i = 0; i < numSonar_; i++)
+		values[(frameDistance0 + i) * blockRows_] = (i < frame.numSonar) ? frame.distances[i] : 0;
+	if (++rows_[logFrames] == blockRows_)
+		writeBlock(logFrames);
+}
+
+void TelemetryLogWriter::addCommand(int64_t timestamp, int16_t translational, double angular)
+{
+	if (file_ == NULL)
+		return;
+	int64_t* values = values_[logCommands] + rows_[logCommands];
+	values[commandTimestamp * blockRows_] = timestamp;
+	values[commandTranslational * blockRows_] = translational;
+	values[commandAngular * blockRows_] = (int16_t)lround(angular * 1000.0);
+	if (++rows_[logCommands] == blockRows_)
+		writeBlock(logCommands);
+}
+
+void TelemetryLogWriter::addRecord(const TelemetryRecord& record)
+{
+	if (record.type == telemetryFrame)
+		addFrame(record.frame);
+	else if (record.type == telemetryCommand)
+		addCommand(record.timestamp, record.command.translational, record.command.angular);
+}
+
+uint64_t TelemetryLogWriter::getRows(int table)
+{
+	return totalRows_[table] + rows_[table];
+}
+
+uint32_t TelemetryLogWriter::getNumBlocks()
+{
+	return numBlocks_;
+}
+
+// each column starts on an 8 byte boundary so the reader can hand out
+// aligned pointers into the mapping
+void TelemetryLogWriter::writeBlock(int table)
+{
+	if (numBlocks_ == indexCapacity_)
+	{
+		LogBlock* index = new LogBlock[indexCapacity_ * 2];
+		memcpy(index, index_, sizeof(LogBlock) * numBlocks_);
+		delete [] index_;
+		index_ = index;
+		indexCapacity_ *= 2;
+	}
+	LogBlock& block = index_[numBlocks_++];
+	memset(&block, 0, sizeof(block));
+	block.table = table;
+	block.rows = rows_[table];
+	int columns = logColumns(table, numSonar_);
+	for (int c = 0; c < columns; c++)
+	{
+		const int64_t* values = values_[table] + (size_t)c * blockRows_;
+		int width = logColumnWidth(table, c);
+		int64_t min = values[0], max = values[0];
+		for (int r = 0; r < block.rows; r++)
+		{
+			int64_t value = values[r];
+			if (value < min)
+				min = value;
+			if (value > max)
+				max = value;
+			if (width == 8)
+				((int64_t*)buffer_)[r] = value;
+			else if (width == 4)
+				((int32_t*)buffer_)[r] = (int32_t)value;
+			else
+				((int16_t*)buffer_)[r] = (int16_t)value;
+		}
+		pad();
+		block.columns[c].offset = offset_;
+		block.columns[c].min = min;
+		block.columns[c].max = max;
+		write(buffer_, (size_t)block.rows * width);
+	}
+	block.firstTime = block.columns[0].min;
+	block.lastTime = block.columns[0].max;
+	totalRows_[table] += rows_[table];
+	rows_[table] = 0;
+}
+
+void TelemetryLogWriter::write(const void* data, size_t length)
+{
+	if (length == 0)
+		return;
+	if (fwrite(data, 1, length, file_) != length)
+		failed_ = true;
+	offset_ += length;
+}
+
+void TelemetryLogWriter::pad()
+{
+	static const char zeros[8] = {0};
+	write(zeros, (8 - offset_ % 8) % 8);
+}
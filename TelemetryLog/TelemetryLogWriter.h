@@ -0,0 +1,61 @@
+// TelemetryLogWriter.h
+// 10/18/2026
+
+// Writes columnar telemetry logs, see TelemetryLog.h
+// Rows are buffered until a table has a full block, which is then
+// written column by column; close writes whatever is left over, the
+// index and the trailer, so a log is only readable once it's closed
+// Frames and commands can come straight from the telemetry ring with
+// addRecord, which is how telemetryLog record keeps a log of a run
+
+// Typical use:
+//    TelemetryLogWriter log;
+//    if (log.open("run.log", numSonar, sensorAngles))
+//        while (reader.next(&record) == 1) log.addRecord(record);
+//    log.close();
+
+#ifndef TELEMETRYLOGWRITER_H
+#define TELEMETRYLOGWRITER_H
+
+#include <stdio.h>
+#include "TelemetryLog.h"
+#include "../Telemetry/TelemetryRing.h"
+
+class TelemetryLogWriter
+{
+public:
+	TelemetryLogWriter(int blockRows = defaultLogBlockRows);
+	~TelemetryLogWriter(); // closes the log
+	// sensorAngles may be NULL if they aren't known
+	bool open(const char* path, int numSonar, const double* sensorAngles);
+	bool close(); // false if any write failed
+	bool isOpen();
+	void addFrame(const SensorFrame& frame);
+	void addCommand(int64_t timestamp, int16_t translational, double angular);
+	void addRecord(const TelemetryRecord& record);
+	uint64_t getRows(int table);
+	uint32_t getNumBlocks(); // written so far
+
+private:
+	FILE* file_;
+	uint64_t offset_; // bytes written
+	int blockRows_;
+	int numSonar_;
+	int64_t* values_[numLogTables]; // column major, blockRows_ per column
+	int rows_[numLogTables]; // buffered
+	uint64_t totalRows_[numLogTables];
+	LogBlock* index_;
+	uint32_t numBlocks_;
+	uint32_t indexCapacity_;
+	char* buffer_; // one column narrowed to its stored width
+	bool failed_;
+
+	void writeBlock(int table);
+	void write(const void* data, size_t length);
+	void pad(); // to the next 8 byte boundary
+
+	TelemetryLogWriter(const TelemetryLogWriter&); // not copyable
+	TelemetryLogWriter& operator=(const TelemetryLogWriter&);
+};
+
+#endif
@@ -0,0 +1,127 @@
+// ThreadPool.cpp
+// 10/18/2026
+
+// Fixed set of worker threads for splitting a loop across cores
+// See ThreadPool.h for usage
+
+#include "ThreadPool.h"
+#include <unistd.h>
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	if (numThreads <= 0)
+		numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (numThreads <= 0)
+		numThreads = 1;
+	numThreads_ = numThreads;
+	pthread_mutex_init(&mutex_, NULL);
+	pthread_cond_init(&workReady_, NULL);
+	pthread_cond_init(&workDone_, NULL);
+	stopping_ = false;
+	generation_ = 0;
+	activeWorkers_ = 0;
+	function_ = NULL;
+	arg_ = NULL;
+	begin_ = end_ = grain_ = numChunks_ = 0;
+	nextChunk_.store(0);
+	workers_ = new pthread_t[numThreads_ - 1];
+	for (int i = 0; i < numThreads_ - 1; i++)
+		pthread_create(&workers_[i], NULL, workerFunction, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	pthread_mutex_lock(&mutex_);
+	stopping_ = true;
+	pthread_cond_broadcast(&workReady_);
+	pthread_mutex_unlock(&mutex_);
+	for (int i = 0; i < numThreads_ - 1; i++)
+		pthread_join(workers_[i], NULL);
+	delete[] workers_;
+	pthread_cond_destroy(&workReady_);
+	pthread_cond_destroy(&workDone_);
+	pthread_mutex_destroy(&mutex_);
+}
+
+int ThreadPool::getNumThreads()
+{
+	return numThreads_;
+}
+
+void ThreadPool::parallelFor(int begin, int end, RangeFunction function, void* arg, int grain)
+{
+	if (end <= begin)
+		return;
+	int count = end - begin;
+	if (grain <= 0)
+		grain = (count + numThreads_ * 4 - 1) / (numThreads_ * 4);
+	if (grain < 1)
+		grain = 1;
+	if (numThreads_ == 1 || count <= grain)
+	{
+		for (int chunk = begin; chunk < end; chunk += grain)
+			function(chunk, (chunk + grain < end) ? chunk + grain : end, arg);
+		return;
+	}
+
+	pthread_mutex_lock(&mutex_);
+	function_ = function;
+	arg_ = arg;
+	begin_ = begin;
+	end_ = end;
+	grain_ = grain;
+	numChunks_ = (count + grain - 1) / grain;
+	nextChunk_.store(0);
+	activeWorkers_ = numThreads_ - 1;
+	generation_++;
+	pthread_cond_broadcast(&workReady_);
+	pthread_mutex_unlock(&mutex_);
+
+	runChunks();
+
+	pthread_mutex_lock(&mutex_);
+	while (activeWorkers_ > 0)
+		pthread_cond_wait(&workDone_, &mutex_);
+	pthread_mutex_unlock(&mutex_);
+}
+
+void ThreadPool::runChunks()
+{
+	while (true)
+	{
+		int chunk = nextChunk_.fetch_add(1);
+		if (chunk >= numChunks_)
+			break;
+		int chunkBegin = begin_ + chunk * grain_;
+		int chunkEnd = (chunkBegin + grain_ < end_) ? chunkBegin + grain_ : end_;
+		function_(chunkBegin, chunkEnd, arg_);
+	}
+}
+
+void* ThreadPool::workerFunction(void* pool)
+{
+	((ThreadPool*)pool)->workerLoop();
+	return NULL;
+}
+
+void ThreadPool::workerLoop()
+{
+	unsigned seen = 0;
+	pthread_mutex_lock(&mutex_);
+	while (true)
+	{
+		while (!stopping_ && generation_ == seen)
+			pthread_cond_wait(&workReady_, &mutex_);
+		if (stopping_)
+			break;
+		seen = generation_;
+		pthread_mutex_unlock(&mutex_);
+
+		runChunks();
+
+		pthread_mutex_lock(&mutex_);
+		if (--activeWorkers_ == 0)
+			pthread_cond_signal(&workDone_);
+	}
+	pthread_mutex_unlock(&mutex_);
+}
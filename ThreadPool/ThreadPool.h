@@ -0,0 +1,61 @@
+// ThreadPool.h
+// 10/18/2026
+
+// Fixed set of worker threads for splitting a loop across cores
+// parallelFor cuts [begin, end) into chunks of roughly equal size and
+// hands them out through an atomic counter, so faster threads pick up
+// more chunks; the calling thread works on chunks too and returns once
+// every chunk has finished
+
+// Chunk boundaries depend only on the range and the grain size, not on
+// which thread runs a chunk, so work that seeds per chunk state (random
+// number generators, for instance) from the chunk's begin index gives
+// the same result on every run. That needs an explicit grain: the default
+// one depends on the thread count, so its chunks differ from one machine
+// to another
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+#include <atomic>
+
+// called once per chunk with the chunk's range
+typedef void (*RangeFunction)(int begin, int end, void* arg);
+
+class ThreadPool
+{
+public:
+	ThreadPool(int numThreads); // total threads including the caller, 0 uses every cpu
+	~ThreadPool();
+	int getNumThreads();
+	// runs function over [begin, end) in chunks of at least grain items
+	// grain <= 0 picks four chunks per thread, which varies with the thread count
+	void parallelFor(int begin, int end, RangeFunction function, void* arg, int grain = 0);
+
+private:
+	int numThreads_;
+	pthread_t* workers_;
+	pthread_mutex_t mutex_;
+	pthread_cond_t workReady_;
+	pthread_cond_t workDone_;
+	bool stopping_;
+	unsigned generation_; // incremented for every parallelFor call
+	int activeWorkers_; // workers still inside the current job
+
+	// current job
+	RangeFunction function_;
+	void* arg_;
+	int begin_, end_, grain_;
+	std::atomic<int> nextChunk_;
+	int numChunks_;
+
+	static void* workerFunction(void* pool);
+	void workerLoop();
+	void runChunks();
+
+	ThreadPool(const ThreadPool&); // not copyable
+	ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif
@@ -0,0 +1,68 @@
+// FixedWallFollowLaw.cpp
+// 10/18/2026
+
+// Integer wall following law, see FixedWallFollowLaw.h
+
+#include "FixedWallFollowLaw.h"
+#include "../FixedPoint/FixedMath.h"
+#include <math.h>
+
+FixedWallFollowGains toFixedGains(const WallFollowGains& gains)
+{
+	FixedWallFollowGains fixedGains;
+	fixedGains.setPoint = (int32_t)lround(gains.setPoint * q4One);
+	fixedGains.kE = (int32_t)lround(gains.kE * q16One);
+	fixedGains.kS = (int32_t)lround(gains.kS * q16One);
+	return fixedGains;
+}
+
+// sqrt(1 + slope^2) in Q16, from its square in Q32
+static int64_t secantOfSlope(int32_t slope)
+{
+	uint64_t squared = ((uint64_t)1 << 32) + (uint64_t)((int64_t)slope * slope);
+	return isqrt64(squared);
+}
+
+static int32_t distanceError(int64_t secant, int32_t intercept, int32_t setPoint)
+{
+	int64_t magnitude = (intercept < 0) ? -(int64_t)intercept : intercept;
+	int64_t distance = divideRounded(magnitude * q16One, secant);
+	int32_t error = (int32_t)(distance - setPoint);
+	return (intercept < 0) ? -error : error;
+}
+
+static int32_t setPointVelocity(int64_t secant, int32_t slope, int trans)
+{
+	return (int32_t)divideRounded((int64_t)trans * q4One * slope, secant);
+}
+
+int32_t getFixedDistanceToSetPoint(int32_t slope, int32_t intercept, int32_t setPoint)
+{
+	return distanceError(secantOfSlope(slope), intercept, setPoint);
+}
+
+int32_t getFixedVelocityOfSetPoint(int32_t slope, int trans)
+{
+	return setPointVelocity(secantOfSlope(slope), slope, trans);
+}
+
+// Q16 gains times Q4 terms are Q20 rad/s
+// the square root is shared by both terms
+int32_t getFixedWallFollowAngular(const FixedWallFollowGains& gains, int32_t slope,
+                                  int32_t intercept, int trans)
+{
+	int64_t secant = secantOfSlope(slope);
+	int64_t error = distanceError(secant, intercept, gains.setPoint);
+	int64_t dError = setPointVelocity(secant, slope, trans);
+	int64_t angular = (int64_t)gains.kE * error + (int64_t)gains.kS * dError;
+	return (int32_t)divideRounded(angular * 1000, (int64_t)1 << 20);
+}
+
+void limitFixedAngular(int* trans, int32_t* angular, int32_t maxAng)
+{
+	int32_t magnitude = (*angular < 0) ? -*angular : *angular;
+	if (magnitude <= maxAng)
+		return;
+	*trans = (int)((int64_t)*trans * maxAng / magnitude);
+	*angular = (*angular > 0) ? maxAng : -maxAng;
+}
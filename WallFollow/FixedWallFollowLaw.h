@@ -0,0 +1,39 @@
+// FixedWallFollowLaw.h
+// 10/18/2026
+
+// Integer version of the wall following law in WallFollowLaw.h, for lines
+// from FixedLineFitter; formats are as in FixedPoint/FixedMath.h
+// The distance to the line is |intercept| / sqrt(1 + slope^2) and the
+// set point's sideways velocity trans * slope / sqrt(1 + slope^2), the
+// same quantities WallFollowLaw gets with atan, sin and pow, here with one
+// integer square root between them
+// The angular velocity comes out in milliradians/s, the unit of the
+// command packet
+
+#ifndef FIXEDWALLFOLLOWLAW_H
+#define FIXEDWALLFOLLOWLAW_H
+
+#include <stdint.h>
+#include "WallFollowLaw.h"
+
+struct FixedWallFollowGains
+{
+	int32_t setPoint; // Q4 cm
+	int32_t kE; // Q16 rad/s per cm
+	int32_t kS; // Q16 rad/s per cm/s
+};
+
+// rounds double gains to fixed point, when setting the law up
+FixedWallFollowGains toFixedGains(const WallFollowGains& gains);
+
+// Q4 cm, sign as getDistanceToSetPoint
+int32_t getFixedDistanceToSetPoint(int32_t slope, int32_t intercept, int32_t setPoint);
+// Q4 cm/s, sign as getVelocityOfSetPoint
+int32_t getFixedVelocityOfSetPoint(int32_t slope, int trans);
+// milliradians/s
+int32_t getFixedWallFollowAngular(const FixedWallFollowGains& gains, int32_t slope,
+                                  int32_t intercept, int trans);
+// as limitAngular, with angular and maxAng in milliradians/s
+void limitFixedAngular(int* trans, int32_t* angular, int32_t maxAng);
+
+#endif
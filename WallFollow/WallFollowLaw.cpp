@@ -0,0 +1,61 @@
+// WallFollowLaw.cpp
+// 10/18/2026
+
+// Wall following control law, see WallFollowLaw.h
+
+#include "WallFollowLaw.h"
+#include <cmath>
+
+WallFollowGains defaultWallFollowGains()
+{
+	WallFollowGains gains;
+	gains.setPoint = 30.0;
+	gains.kE = 0.0;
+	gains.kS = 0.1;
+	return gains;
+}
+
+double getDistanceToSetPoint(double slope, double intercept, double setPoint)
+{
+	if (slope == 0.0) // if the line is perfectly horizontal
+		return std::abs(intercept) - setPoint;
+	double xIntercept = (-1.0 * intercept) / ((1.0 / slope) + slope);
+	double yIntercept = (slope * xIntercept) + intercept;
+	double distance = sqrt(pow(xIntercept, 2.0) + pow(yIntercept, 2.0));
+	double error = distance - setPoint;
+	if (intercept < 0)
+		error *= -1;
+	return error;
+}
+
+double getVelocityOfSetPoint(double slope, int trans)
+{
+	if (slope == 0.0)
+		return 0.0;
+	// calculate speedToSetPoint
+	double angleOfLine = atan(slope);
+	double speedToSetPoint = (double)trans * sin(angleOfLine);
+	// alternate method, doesn't use trig functions, but gives the speed
+	// without its sign:
+	//double speedToSetPoint = sqrt((pow((double)trans, 2) * pow(slope, 2))/(1 + pow(slope, 2)));
+	return speedToSetPoint;
+}
+
+double getWallFollowAngular(const WallFollowGains& gains, double slope,
+                            double intercept, int trans)
+{
+	double error = getDistanceToSetPoint(slope, intercept, gains.setPoint);
+	double dError = getVelocityOfSetPoint(slope, trans);
+	double eTerm = gains.kE * error;
+	double sTerm = gains.kS * dError;
+	return eTerm + sTerm;
+}
+
+void limitAngular(int* trans, double* angular, double maxAng)
+{
+	if (std::abs(*angular) <= maxAng)
+		return;
+	double radius = (double)*trans / std::abs(*angular);
+	*trans = radius * maxAng;
+	*angular = (*angular > 0.0) ? maxAng : maxAng * -1.0;
+}
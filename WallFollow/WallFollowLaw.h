@@ -0,0 +1,47 @@
+// WallFollowLaw.h
+// 10/18/2026
+
+// Wall following control law, moved out of wall_follow_single_line so the
+// gain sweep (gainSweep) can run the same law against the simulator
+// Walls are lines y = slope * x + intercept in Colin's local frame:
+//    x axis: forward-aft with forward positive
+//    y axis: left-right with left positive
+// The commanded angular velocity is
+//    kE * (distance to the wall - setPoint) + kS * (sideways velocity of the wall)
+// each term turning Colin toward the set point line
+
+#ifndef WALLFOLLOWLAW_H
+#define WALLFOLLOWLAW_H
+
+struct WallFollowGains
+{
+	double setPoint; // following distance in cm
+	double kE; // gain for error in following distance
+	double kS; // gain for slope of wall relative to Colin's path
+};
+
+WallFollowGains defaultWallFollowGains();
+
+// returns the error between the distance from the robot's location (the
+// origin) to the given line and the set point
+// positive error indicates the set point is between the robot and the wall
+// negative error indicates the robot is between the set point and the wall
+// the error's sign is flipped for walls on the right, so a positive
+// error always calls for a left turn
+double getDistanceToSetPoint(double slope, double intercept, double setPoint);
+
+// returns velocity of the set point in the robot's local coordinate system
+// when driving at trans
+// velocity is positive if the set point is moving to the left
+// velocity is negative if set point is moving to the right
+double getVelocityOfSetPoint(double slope, int trans);
+
+// angular velocity the law commands for the given line and speed
+double getWallFollowAngular(const WallFollowGains& gains, double slope,
+                            double intercept, int trans);
+
+// limits the angular velocity to maxAng but preserves the commanded
+// radius of travel by slowing down
+void limitAngular(int* trans, double* angular, double maxAng);
+
+#endif
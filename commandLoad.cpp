@@ -0,0 +1,362 @@
+// commandLoad.cpp
+// 10/18/2026
+
+// Load generator for CommandServer
+// Opens many client connections and has each send setSpeed requests
+// (every tenth one a snapshot request) at a fixed rate, one outstanding
+// request at a time, and reports the round trip time from writing a
+// request to reading its reply, which bounds the latency the server adds
+// to a command on its way to Robot::setSpeed. Half of the clients also
+// subscribe to frames and count them
+// At the end one more connection pipelines a burst of setSpeed requests
+// in a single write and reads the acks as they come, checking the server
+// holds back rather than disconnecting a client that sends faster than
+// its replies drain
+// Without -u the server runs in this process in front of a simulated
+// Colin (SimBot in an empty world, 20x real time so frames come often);
+// with -u it connects to a server that's already running, such as
+// serialBotTest -u or wall_follow_single_line -u
+//    commandLoad [-u socketPath] [clients] [seconds] [rate]
+//    clients: connections, default 16
+//    seconds: length of the run, default 5
+//    rate: requests per second per client, 0 for as fast as replies come, default 200
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <vector>
+#include "CommandServer/CommandServer.h"
+#include "Sim/SimBot.h"
+#include "Pipeline/PipelineStage.h" // monotonicNanos
+
+const char benchSocket[] = "/tmp/colin_command_bench";
+const char benchTelemetry[] = "/colin_command_bench";
+const int numSonar = 8;
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const int snapshotEvery = 10;
+const int burstRequests = 3000;
+
+struct LoadClient
+{
+	int fd;
+	bool subscriber;
+	bool waiting; // a request is outstanding
+	uint8_t waitingFor; // its type
+	int64_t sentAt;
+	int64_t nextSend;
+	int sent;
+	uint64_t frames;
+	int inLength;
+	uint8_t in[4096];
+};
+
+SimBot* sim = NULL;
+
+void* simFunction(void* args)
+{
+	sim->commThreadFunction();
+	return NULL;
+}
+
+int connectTo(const char* path)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1)
+		return -1;
+	if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+bool sendAll(int fd, const uint8_t* buffer, int length)
+{
+	while (length > 0)
+	{
+		ssize_t bytes = write(fd, buffer, length);
+		if (bytes < 0 && errno == EINTR)
+			continue;
+		if (bytes <= 0)
+			return false;
+		buffer += bytes;
+		length -= bytes;
+	}
+	return true;
+}
+
+void sendRequest(LoadClient* client, int64_t now)
+{
+	uint8_t message[maxCommandMessageSize];
+	int length;
+	if (client->sent % snapshotEvery == snapshotEvery - 1)
+		length = encodeSnapshotRequest(message);
+	else
+		length = encodeSetSpeed(message, client->sent % 100, 0.001 * (client->sent % 1000));
+	client->waiting = true;
+	client->waitingFor = message[0];
+	client->sentAt = now;
+	client->sent++;
+	if (!sendAll(client->fd, message, length))
+	{
+		fprintf(stderr, "send failed: %s\n", strerror(errno));
+		exit(1);
+	}
+}
+
+// writes count setSpeed requests as one buffer on a new connection,
+// reading acks while the server takes it; returns the acks read, or -1 if
+// the connection failed or the server closed it
+int pipelineBurst(const char* path, int count, double* seconds)
+{
+	int fd = connectTo(path);
+	if (fd == -1)
+		return -1;
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	uint8_t message[maxCommandMessageSize];
+	int messageLength = encodeSetSpeed(message, 10, 0.0);
+	int total = count * messageLength;
+	uint8_t* requests = new uint8_t[total];
+	for (int i = 0; i < count; i++)
+		memcpy(requests + i * messageLength, message, messageLength);
+	uint8_t in[4096];
+	int inLength = 0;
+	int written = 0, acks = 0;
+	int64_t start = monotonicNanos();
+	while (acks < count)
+	{
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN | ((written < total) ? POLLOUT : 0);
+		if (poll(&pfd, 1, 1000) <= 0)
+			break;
+		if (pfd.revents & POLLOUT)
+		{
+			ssize_t bytes = write(fd, requests + written, total - written);
+			if (bytes > 0)
+				written += bytes;
+		}
+		if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR)))
+			continue;
+		ssize_t bytes = read(fd, in + inLength, sizeof(in) - inLength);
+		if (bytes <= 0)
+		{
+			acks = -1;
+			break;
+		}
+		inLength += bytes;
+		int used = 0;
+		int length;
+		while ((length = commandMessageLength(in + used, inLength - used)) > 0
+		       && length <= inLength - used)
+		{
+			if (in[used] == replyAck)
+				acks++;
+			used += length;
+		}
+		inLength -= used;
+		memmove(in, in + used, inLength);
+	}
+	*seconds = (monotonicNanos() - start) / 1e9;
+	delete [] requests;
+	close(fd);
+	return acks;
+}
+
+void printPercentiles(const char* name, std::vector<int64_t>* times)
+{
+	if (times->empty())
+		return;
+	std::sort(times->begin(), times->end());
+	size_t n = times->size();
+	printf("%-9s %8zu  p50 %6.1f us  p90 %6.1f us  p99 %6.1f us  p99.9 %7.1f us  max %7.1f us\n",
+	       name, n, (*times)[n / 2] / 1e3, (*times)[n * 9 / 10] / 1e3, (*times)[n * 99 / 100] / 1e3,
+	       (*times)[n * 999 / 1000] / 1e3, times->back() / 1e3);
+}
+
+int main(int argc, char** argv)
+{
+	int arg = 1;
+	const char* path = NULL;
+	if (arg + 1 < argc && strcmp(argv[arg], "-u") == 0)
+	{
+		path = argv[arg + 1];
+		arg += 2;
+	}
+	int numClients = (arg < argc) ? atoi(argv[arg++]) : 16;
+	double seconds = (arg < argc) ? atof(argv[arg++]) : 5.0;
+	double rate = (arg < argc) ? atof(argv[arg++]) : 200.0;
+
+	World world(1);
+	TelemetryWriter telemetry;
+	CommandServer* server = NULL;
+	pthread_t simThread;
+	if (path == NULL)
+	{
+		path = benchSocket;
+		sim = new SimBot(&world, sensorAngles, numSonar, makePose(0.0, 0.0, 0.0), 1);
+		sim->setTimeScale(20.0);
+		if (telemetry.open(benchTelemetry, defaultTelemetryCapacity))
+			sim->setTelemetry(&telemetry);
+		pthread_create(&simThread, NULL, simFunction, NULL);
+		server = new CommandServer(sim, numClients + 1);
+		if (!server->setTelemetry(benchTelemetry))
+			fprintf(stderr, "no telemetry, subscribers will get no frames\n");
+		if (!server->open(path) || !server->start())
+			return 1;
+	}
+
+	int epollFd = epoll_create1(0);
+	std::vector<LoadClient> clients(numClients);
+	int64_t start = monotonicNanos();
+	for (int i = 0; i < numClients; i++)
+	{
+		LoadClient& client = clients[i];
+		client.fd = connectTo(path);
+		if (client.fd == -1)
+		{
+			fprintf(stderr, "unable to connect to %s: %s\n", path, strerror(errno));
+			return 1;
+		}
+		client.subscriber = (i % 2 == 1);
+		client.waiting = false;
+		client.sent = 0;
+		client.frames = 0;
+		client.inLength = 0;
+		// spread the clients' sends over the first period
+		client.nextSend = start + ((rate > 0.0) ? (int64_t)(1e9 / rate * i / numClients) : 0);
+		if (client.subscriber)
+		{
+			uint8_t message[2];
+			encodeSubscribe(message, true);
+			sendAll(client.fd, message, 2);
+			client.waiting = true;
+			client.waitingFor = requestSubscribe;
+			client.sentAt = start;
+		}
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+	}
+
+	std::vector<int64_t> commandTimes, snapshotTimes;
+	int64_t period = (rate > 0.0) ? (int64_t)(1e9 / rate) : 0;
+	int64_t end = start + (int64_t)(seconds * 1e9);
+	uint64_t unavailable = 0;
+	struct epoll_event events[64];
+	while (true)
+	{
+		int64_t now = monotonicNanos();
+		if (now >= end)
+			break;
+		int64_t nextSend = end;
+		for (int i = 0; i < numClients; i++)
+		{
+			LoadClient& client = clients[i];
+			if (client.waiting)
+				continue;
+			if (client.nextSend <= now)
+			{
+				sendRequest(&client, now);
+				client.nextSend += period;
+				if (client.nextSend < now)
+					client.nextSend = now; // fell behind, don't burst to catch up
+			}
+			else if (client.nextSend < nextSend)
+				nextSend = client.nextSend;
+		}
+		int timeout = (int)((nextSend - now + 999999) / 1000000);
+		int numEvents = epoll_wait(epollFd, events, 64, timeout);
+		now = monotonicNanos();
+		for (int e = 0; e < numEvents; e++)
+		{
+			LoadClient& client = clients[events[e].data.u32];
+			ssize_t bytes = read(client.fd, client.in + client.inLength, sizeof(client.in) - client.inLength);
+			if (bytes <= 0)
+			{
+				fprintf(stderr, "server closed the connection\n");
+				return 1;
+			}
+			client.inLength += bytes;
+			int used = 0;
+			int length;
+			while ((length = commandMessageLength(client.in + used, client.inLength - used)) > 0
+			       && length <= client.inLength - used)
+			{
+				const uint8_t* message = client.in + used;
+				if (message[0] == replyFrame)
+					client.frames++;
+				else if (client.waiting)
+				{
+					int64_t time = now - client.sentAt;
+					if (message[0] == replySnapshot)
+						snapshotTimes.push_back(time);
+					else if (message[1] == requestSetSpeed)
+						commandTimes.push_back(time);
+					else if (message[1] == requestSubscribe && message[2] != statusOk)
+						unavailable++;
+					client.waiting = false;
+				}
+				used += length;
+			}
+			if (length < 0)
+			{
+				fprintf(stderr, "unknown message type %d\n", client.in[used]);
+				return 1;
+			}
+			client.inLength -= used;
+			memmove(client.in, client.in + used, client.inLength);
+		}
+	}
+	double elapsed = (monotonicNanos() - start) / 1e9;
+
+	uint64_t frames = 0;
+	for (int i = 0; i < numClients; i++)
+	{
+		frames += clients[i].frames;
+		close(clients[i].fd);
+	}
+	printf("%d clients for %.1f s, %.0f requests/s in total\n", numClients, elapsed,
+	       (commandTimes.size() + snapshotTimes.size()) / elapsed);
+	printf("round trip from request to reply:\n");
+	printPercentiles("setSpeed", &commandTimes);
+	printPercentiles("snapshot", &snapshotTimes);
+	printf("%llu frames received by %d subscribers%s\n", (unsigned long long)frames,
+	       numClients / 2, unavailable ? " (server has no telemetry)" : "");
+	double burstSeconds;
+	int acks = pipelineBurst(path, burstRequests, &burstSeconds);
+	if (acks < 0)
+		printf("pipelined burst: server closed the connection\n");
+	else
+		printf("pipelined burst: %d of %d setSpeed requests acked in %.1f ms\n", acks,
+		       burstRequests, burstSeconds * 1e3);
+	if (server != NULL)
+	{
+		CommandServerStats stats;
+		server->getStats(&stats);
+		printf("server: %llu commands, %llu snapshots, %llu frames sent, %llu dropped, %llu disconnects\n",
+		       (unsigned long long)stats.commands, (unsigned long long)stats.snapshots,
+		       (unsigned long long)stats.framesSent, (unsigned long long)stats.framesDropped,
+		       (unsigned long long)stats.disconnects);
+		server->stop();
+		delete server;
+		sim->stop();
+		pthread_join(simThread, NULL);
+	}
+	return 0;
+}
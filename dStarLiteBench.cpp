@@ -0,0 +1,159 @@
+// dStarLiteBench.cpp
+// 10/18/2026
+
+// Benchmarks incremental replanning with D* Lite
+// For each grid size, scatters random walls, plans from one corner to
+// the other, then repeatedly moves the start a few cells along the path
+// and marks a batch of cells on the path ahead occupied, as new sonar
+// readings would. Each repair is timed against planning from scratch on
+// the same grid, and the two path costs are checked to agree
+//    dStarLiteBench [trials] [sizes...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "Planner/DStarLite.h"
+
+using namespace std;
+
+const int inflation = 1;
+const int changeSizes[] = {1, 10, 100};
+const int numChangeSizes = 3;
+const int maxPath = 1 << 16;
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// random horizontal and vertical wall segments, keeping the corners clear
+void addWalls(DStarLite* planner, int size)
+{
+	int numWalls = size / 6;
+	for (int i = 0; i < numWalls; i++)
+	{
+		int x = rand() % size;
+		int y = rand() % size;
+		int length = size / 8 + rand() % (size / 4);
+		bool horizontal = rand() % 2;
+		for (int j = 0; j < length; j++)
+		{
+			int cx = horizontal ? x + j : x;
+			int cy = horizontal ? y : y + j;
+			if (cx >= size || cy >= size)
+				break;
+			if ((cx < 4 && cy < 4) || (cx >= size - 4 && cy >= size - 4))
+				continue;
+			planner->setOccupied(cx, cy, true);
+		}
+	}
+}
+
+// copies the occupied cells of one planner into a fresh one
+void copyOccupancy(DStarLite* from, DStarLite* to)
+{
+	for (int y = 0; y < from->getHeight(); y++)
+		for (int x = 0; x < from->getWidth(); x++)
+			if (from->isOccupied(x, y))
+				to->setOccupied(x, y, true);
+}
+
+void runSize(int size, int trials, int* xs, int* ys)
+{
+	struct timespec start, end;
+	for (int c = 0; c < numChangeSizes; c++)
+	{
+		int changeSize = changeSizes[c];
+		double initialSeconds = 0.0, repairSeconds = 0.0, scratchSeconds = 0.0;
+		long repairExpansions = 0, scratchExpansions = 0;
+		int repairs = 0, mismatches = 0;
+		for (int trial = 0; trial < trials; trial++)
+		{
+			srand(trial * 7919 + size);
+			DStarLite planner(size, size, inflation);
+			addWalls(&planner, size);
+			planner.setStart(1, 1);
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			planner.setGoal(size - 2, size - 2);
+			bool found = planner.computePath();
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			initialSeconds += elapsedSeconds(start, end);
+			if (!found)
+				continue;
+
+			// a few repairs per trial as the robot moves along the path
+			for (int step = 0; step < 5; step++)
+			{
+				int length = planner.getPath(xs, ys, maxPath);
+				if (length < 20)
+					break;
+				int advance = length / 10;
+				// the repair includes marking cells, which updates their
+				// neighbours' lookahead values
+				clock_gettime(CLOCK_MONOTONIC, &start);
+				planner.setStart(xs[advance], ys[advance]);
+				// block cells on the path ahead of the new start
+				int changed = 0;
+				for (int i = advance + 5; i < length - 3 && changed < changeSize; i += 2, changed++)
+				{
+					int x = xs[i] + rand() % 3 - 1;
+					int y = ys[i] + rand() % 3 - 1;
+					if (x >= 0 && x < size && y >= 0 && y < size)
+						planner.setOccupied(x, y, true);
+				}
+				bool repaired = planner.computePath();
+				clock_gettime(CLOCK_MONOTONIC, &end);
+				repairSeconds += elapsedSeconds(start, end);
+				repairExpansions += planner.getExpansions();
+				repairs++;
+
+				DStarLite scratch(size, size, inflation);
+				copyOccupancy(&planner, &scratch);
+				scratch.setStart(xs[advance], ys[advance]);
+				clock_gettime(CLOCK_MONOTONIC, &start);
+				scratch.setGoal(size - 2, size - 2);
+				bool scratchFound = scratch.computePath();
+				clock_gettime(CLOCK_MONOTONIC, &end);
+				scratchSeconds += elapsedSeconds(start, end);
+				scratchExpansions += scratch.getExpansions();
+				if (repaired != scratchFound
+				    || (repaired && fabsf(planner.getPathCost() - scratch.getPathCost()) > 1e-2f))
+					mismatches++;
+				if (!repaired)
+					break;
+			}
+		}
+		if (repairs == 0)
+		{
+			printf("%4dx%-4d %3d changes: no path found in any trial\n", size, size, changeSize);
+			continue;
+		}
+		printf("%4dx%-4d %3d changes: initial %8.3f ms, repair %8.3f ms (%7ld expansions), "
+		       "scratch %8.3f ms (%7ld expansions), %d mismatches\n",
+		       size, size, changeSize, initialSeconds / trials * 1e3,
+		       repairSeconds / repairs * 1e3, repairExpansions / repairs,
+		       scratchSeconds / repairs * 1e3, scratchExpansions / repairs, mismatches);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int trials = (argc > 1) ? atoi(argv[1]) : 5;
+	int* xs = new int[maxPath];
+	int* ys = new int[maxPath];
+	if (argc > 2)
+	{
+		for (int i = 2; i < argc; i++)
+			runSize(atoi(argv[i]), trials, xs, ys);
+	}
+	else
+	{
+		runSize(100, trials, xs, ys);
+		runSize(200, trials, xs, ys);
+		runSize(400, trials, xs, ys);
+	}
+	delete [] xs;
+	delete [] ys;
+	return 0;
+}
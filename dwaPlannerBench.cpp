@@ -0,0 +1,92 @@
+// dwaPlannerBench.cpp
+// 10/18/2026
+
+// program to benchmark and test the DWA planner
+// times full plans against a given number of obstacle points, then drives
+// a virtual Colin straight at a wall asking for full speed, with the
+// planner between the request and the motors, and reports how close it
+// got
+//    dwaPlannerBench [obstacles] [plans]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Planner/DwaPlanner.h"
+#include "Geometry/Pose2D.h"
+
+using namespace std;
+
+const double wallX = 300.0; // wall across the robot's path, cm ahead
+const double planPeriod = 0.25; // s between plans, SerialBot's fixed rate
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+void benchmark(int numObstacles, int numPlans)
+{
+	DwaConfig config = defaultDwaConfig();
+	config.maxObstacles = numObstacles;
+	DwaPlanner planner(config);
+	Point* points = new Point[numObstacles];
+	srand(1);
+	for (int i = 0; i < numObstacles; i++)
+		points[i].setCartesian(40.0 + rand() % 260, -150.0 + rand() % 300);
+	planner.setObstacles(points, numObstacles);
+
+	struct timespec start, end;
+	double sum = 0.0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < numPlans; i++)
+		sum += planner.plan(100.0, 0.0, 150.0, 0.2 * (i % 5), planPeriod).angular;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = elapsedSeconds(start, end);
+	printf("%d candidates x %d steps x %d obstacles: %.3f ms/plan (checksum %.1f)\n",
+	       planner.getNumCandidates(), config.numSteps, numObstacles,
+	       seconds / numPlans * 1e3, sum);
+	delete [] points;
+}
+
+// drives at the wall until the planner stops the robot
+void driveAtWall()
+{
+	DwaConfig config = defaultDwaConfig();
+	DwaPlanner planner(config);
+	Point points[64];
+	Pose2D pose = makePose(0.0, 0.0, 0.0);
+	double trans = 0.0, angular = 0.0;
+	double closest = wallX;
+	int steps = 0;
+	for (; steps < 200; steps++)
+	{
+		// sonar sees the wall within 300 cm, in the local frame
+		int numPoints = 0;
+		for (int i = 0; i < 64; i++)
+		{
+			double localX, localY;
+			worldToLocal(pose, wallX, -128.0 + 4.0 * i, &localX, &localY);
+			if (hypot(localX, localY) < 300.0)
+				points[numPoints++].setCartesian(localX, localY);
+		}
+		planner.setObstacles(points, numPoints);
+		DwaCommand command = planner.plan(trans, angular, config.maxTrans, 0.0, planPeriod);
+		trans = command.translational;
+		angular = command.angular;
+		pose = composePose(pose, makePose(trans * planPeriod, 0.0, angular * planPeriod));
+		closest = fmin(closest, wallX - pose.x - config.robotRadius);
+		if (fabs(trans) < 1.0 && steps > 10)
+			break;
+	}
+	printf("driving at a wall %.0f cm ahead: stopped %.1f cm short after %d plans\n",
+	       wallX, closest, steps);
+}
+
+int main(int argc, char** argv)
+{
+	int numObstacles = (argc > 1) ? atoi(argv[1]) : 256;
+	int numPlans = (argc > 2) ? atoi(argv[2]) : 1000;
+	benchmark(numObstacles, numPlans);
+	driveAtWall();
+	return 0;
+}
@@ -0,0 +1,233 @@
+// fixedPointBench.cpp
+// 10/18/2026
+
+// Compares the fixed point perception and control path (FixedLineFitter,
+// FixedWallFollowLaw) with the floating point one (Point, LineFitter,
+// WallFollowLaw) on the same sonar readings
+// Readings are generated with integer math only: a straight wall beside
+// Colin at a random distance and angle, each of the eight sonars reading
+// the range along its heading to whole centimetres plus a little integer
+// noise, or nothing past 300 cm or near parallel to the wall
+// Reports the difference between the two paths' lines and commands, each
+// path's slope error against the true wall, and their throughput, then
+// hashes every fixed point output: the hash only depends on integer
+// arithmetic, so it must match expectedChecksum on every platform
+//    fixedPointBench [scenarios]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "FixedPoint/FixedMath.h"
+#include "LineFitter/LineFitter.h"
+#include "LineFitter/FixedLineFitter.h"
+#include "WallFollow/WallFollowLaw.h"
+#include "WallFollow/FixedWallFollowLaw.h"
+
+const int numSonar = 8;
+// Colin's sensor headings in milliradians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const int16_t sensorHeadings[] = {0, 5498, 4712, 3927, 3142, 2356, 1571, 785};
+const int maxRange = 300;
+const int trans = 100; // cm/s
+const int32_t maxAng = 2000; // milliradians/s
+const int repeats = 20; // passes over the scenarios when timing
+const uint64_t expectedChecksum = 0xa76ba317d4a25409ULL;
+
+struct Scenario
+{
+	int numPoints;
+	int16_t ranges[numSonar];
+	int16_t headings[numSonar];
+	double trueSlope;
+};
+
+struct Output
+{
+	double slope, intercept; // cm
+	int angular; // milliradians/s, as sent
+	int trans;
+};
+
+uint64_t randomState = 88172645463325252ULL;
+
+uint32_t nextRandom()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return (uint32_t)(randomState >> 32);
+}
+
+int randomBetween(int low, int high)
+{
+	return low + (int)(nextRandom() % (uint32_t)(high - low + 1));
+}
+
+// a wall whose normal points at normal (milliradians) from Colin, distance cm away
+void makeScenario(Scenario* scenario)
+{
+	int side = (nextRandom() & 1) ? 1571 : -1571;
+	int32_t normal = side + randomBetween(-600, 600);
+	int distance = randomBetween(15, 150);
+	scenario->numPoints = 0;
+	for (int i = 0; i < numSonar; i++)
+	{
+		int32_t cosine = cosMilli(sensorHeadings[i] - normal);
+		if (cosine < 6000)
+			continue; // pointing away from or along the wall
+		// sum of four uniforms, roughly gaussian with sigma 1.2 cm
+		int noise = 0;
+		for (int n = 0; n < 4; n++)
+			noise += randomBetween(-2, 2);
+		int range = (int)divideRounded((int64_t)distance * q15One, cosine) + noise;
+		if (range > maxRange || range < 3)
+			continue;
+		scenario->ranges[scenario->numPoints] = range;
+		scenario->headings[scenario->numPoints] = sensorHeadings[i];
+		scenario->numPoints++;
+	}
+	double angle = normal / 1000.0;
+	scenario->trueSlope = -cos(angle) / sin(angle);
+}
+
+void runFloat(const Scenario& scenario, LineFitter* fitter, const WallFollowGains& gains, Output* output)
+{
+	Point points[numSonar];
+	for (int i = 0; i < scenario.numPoints; i++)
+		points[i].setCoordinates(scenario.ranges[i], scenario.headings[i] / 1000.0);
+	fitter->setPoints(points, scenario.numPoints);
+	fitter->updateLine();
+	output->slope = fitter->getM();
+	output->intercept = fitter->getB();
+	int command = trans;
+	double angular = getWallFollowAngular(gains, output->slope, output->intercept, command);
+	limitAngular(&command, &angular, maxAng / 1000.0);
+	output->angular = (int)(angular * 1000.0); // as SerialBot packs it
+	output->trans = command;
+}
+
+void runFixed(const Scenario& scenario, FixedLineFitter* fitter, const FixedWallFollowGains& gains,
+              int32_t* slope, int32_t* intercept, int32_t* angular, int* command)
+{
+	FixedPoint points[numSonar];
+	for (int i = 0; i < scenario.numPoints; i++)
+		points[i] = makeFixedPoint(scenario.ranges[i], scenario.headings[i]);
+	fitter->setPoints(points, scenario.numPoints);
+	fitter->updateLine();
+	*slope = fitter->getSlope();
+	*intercept = fitter->getIntercept();
+	*command = trans;
+	*angular = getFixedWallFollowAngular(gains, *slope, *intercept, *command);
+	limitFixedAngular(command, angular, maxAng);
+}
+
+// FNV-1a over the bytes of value, least significant first
+void hash(uint64_t* checksum, int64_t value)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		*checksum ^= (uint8_t)((uint64_t)value >> (8 * i));
+		*checksum *= 1099511628211ULL;
+	}
+}
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+	int numScenarios = (argc > 1) ? atoi(argv[1]) : 100000;
+	Scenario* scenarios = new Scenario[numScenarios];
+	for (int i = 0; i < numScenarios; i++)
+		makeScenario(&scenarios[i]);
+
+	WallFollowGains gains = defaultWallFollowGains();
+	gains.kE = 0.02;
+	FixedWallFollowGains fixedGains = toFixedGains(gains);
+	Point empty[numSonar];
+	LineFitter floatFitter(empty, numSonar);
+	FixedLineFitter fixedFitter(numSonar);
+
+	// accuracy, on scenarios with enough points to fit
+	uint64_t checksum = 14695981039346656037ULL;
+	int compared = 0, commandsDiffer = 0;
+	double slopeDiff = 0.0, maxSlopeDiff = 0.0, interceptDiff = 0.0, maxInterceptDiff = 0.0;
+	double angularDiff = 0.0, maxAngularDiff = 0.0;
+	double floatTruth = 0.0, fixedTruth = 0.0;
+	for (int i = 0; i < numScenarios; i++)
+	{
+		const Scenario& scenario = scenarios[i];
+		Output output;
+		runFloat(scenario, &floatFitter, gains, &output);
+		int32_t slope, intercept, angular;
+		int command;
+		runFixed(scenario, &fixedFitter, fixedGains, &slope, &intercept, &angular, &command);
+		hash(&checksum, slope);
+		hash(&checksum, intercept);
+		hash(&checksum, angular);
+		hash(&checksum, command);
+		if (scenario.numPoints < 3 || fabs(scenario.trueSlope) > 3.0)
+			continue;
+		double fixedSlope = (double)slope / q16One;
+		double difference = fabs(fixedSlope - output.slope);
+		slopeDiff += difference;
+		maxSlopeDiff = fmax(maxSlopeDiff, difference);
+		difference = fabs((double)intercept / q4One - output.intercept);
+		interceptDiff += difference;
+		maxInterceptDiff = fmax(maxInterceptDiff, difference);
+		difference = fabs((double)(angular - output.angular));
+		angularDiff += difference;
+		maxAngularDiff = fmax(maxAngularDiff, difference);
+		if (angular != output.angular || command != output.trans)
+			commandsDiffer++;
+		floatTruth += fabs(atan(output.slope) - atan(scenario.trueSlope));
+		fixedTruth += fabs(atan(fixedSlope) - atan(scenario.trueSlope));
+		compared++;
+	}
+	printf("%d scenarios, %d compared (3 or more points, |slope| <= 3)\n", numScenarios, compared);
+	printf("fixed - float: slope mean %.5f max %.5f  intercept mean %.3f cm max %.3f cm\n",
+	       slopeDiff / compared, maxSlopeDiff, interceptDiff / compared, maxInterceptDiff);
+	printf("               angular mean %.2f mrad/s max %.0f mrad/s, %.1f%% of commands differ\n",
+	       angularDiff / compared, maxAngularDiff, 100.0 * commandsDiffer / compared);
+	printf("wall angle error: float %.4f rad  fixed %.4f rad\n",
+	       floatTruth / compared, fixedTruth / compared);
+
+	// throughput; the sums stop the optimizer dropping the work
+	struct timespec start, end;
+	double floatSum = 0.0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int r = 0; r < repeats; r++)
+		for (int i = 0; i < numScenarios; i++)
+		{
+			Output output;
+			runFloat(scenarios[i], &floatFitter, gains, &output);
+			floatSum += output.angular;
+		}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double floatSeconds = elapsedSeconds(start, end);
+	int64_t fixedSum = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int r = 0; r < repeats; r++)
+		for (int i = 0; i < numScenarios; i++)
+		{
+			int32_t slope, intercept, angular;
+			int command;
+			runFixed(scenarios[i], &fixedFitter, fixedGains, &slope, &intercept, &angular, &command);
+			fixedSum += angular;
+		}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double fixedSeconds = elapsedSeconds(start, end);
+	double runs = (double)repeats * numScenarios;
+	printf("float: %8.0f scans/s  %6.0f ns/scan  (sum %.0f)\n", runs / floatSeconds,
+	       floatSeconds * 1e9 / runs, floatSum);
+	printf("fixed: %8.0f scans/s  %6.0f ns/scan  (sum %lld)\n", runs / fixedSeconds,
+	       fixedSeconds * 1e9 / runs, (long long)fixedSum);
+
+	bool match = (numScenarios != 100000) || checksum == expectedChecksum;
+	printf("fixed point checksum %016llx%s\n", (unsigned long long)checksum,
+	       (numScenarios != 100000) ? "" : (match ? " (matches)" : " (DIFFERS from expected)"));
+	delete [] scenarios;
+	return match ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// fleet.cpp
+// 10/18/2026
+
+// Drives several Colins at once from one process with FleetManager
+// Each device is a serial port or pty with a Colin (or a stand-in) on it;
+// options before a device apply to it and every device after it
+//    fleet [-b baudRate] [-n numSonar] [-p periodMs] device [[options] device ...]
+// Prompts for "robot translational angular" and prints every robot's
+// state after each command; an empty robot number just prints the states
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Fleet/FleetManager.h"
+#include "Pipeline/PipelineStage.h" // monotonicNanos
+
+const int maxRobots = 64;
+
+void printStates(FleetManager* fleet)
+{
+	int64_t now = monotonicNanos();
+	for (int i = 0; i < fleet->getNumRobots(); i++)
+	{
+		FleetRobotState state;
+		fleet->getState(i, &state);
+		printf("robot %2d  %6u frames %4u timeouts  pose %5d %5d %6.3f  age %6.0f ms  sonar",
+		       i, state.framesReceived, state.timeouts, state.x, state.y, state.theta,
+		       state.lastFrame ? (now - state.lastFrame) / 1e6 : -1.0);
+		for (int s = 0; s < state.numSonar; s++)
+			printf(" %d", state.distances[s]);
+		printf("%s\n", state.connected ? "" : "  disconnected");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FleetManager fleet(maxRobots, 1);
+	SerialBotConfig config = defaultSerialBotConfig();
+	config.resetPin = -1;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (arg + 1 < argc && strcmp(argv[arg], "-b") == 0)
+			config.baudRate = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+			config.numSonar = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-p") == 0)
+			config.readPeriod = atoi(argv[++arg]) * 1000;
+		else
+		{
+			config.device = argv[arg];
+			if (fleet.addRobot(config) < 0)
+			{
+				fprintf(stderr, "unable to add robot on %s\n", argv[arg]);
+				return 1;
+			}
+		}
+	}
+	if (fleet.getNumRobots() == 0)
+	{
+		fprintf(stderr, "usage: fleet [-b baudRate] [-n numSonar] [-p periodMs] device [[options] device ...]\n");
+		return 1;
+	}
+	fleet.start();
+	char line[256];
+	while (true)
+	{
+		printf("robot translational angular: ");
+		fflush(stdout);
+		if (fgets(line, sizeof(line), stdin) == NULL)
+			break;
+		int robot, translational;
+		double angular;
+		if (sscanf(line, "%d %d %lf", &robot, &translational, &angular) == 3)
+		{
+			if (robot >= 0 && robot < fleet.getNumRobots())
+				fleet.setSpeed(robot, translational, angular);
+			else
+				printf("no robot %d\n", robot);
+		}
+		printStates(&fleet);
+	}
+	for (int i = 0; i < fleet.getNumRobots(); i++)
+		fleet.setSpeed(i, 0, 0.0);
+	usleep(2 * config.readPeriod); // let the stop commands go out
+	fleet.stop();
+	return 0;
+}
@@ -0,0 +1,338 @@
+// fleetBench.cpp
+// 10/18/2026
+
+// Benchmarks FleetManager with simulated robots on ptys
+// A child process plays the ATmega328 for every robot: it answers each
+// command packet with a sensor packet straight away, echoing the command
+// back as the pose and distances so the parent can check every value
+// made the round trip. Robots have different sonar counts (4 to 8) and
+// are commanded both forward and backward, with speeds whose low byte is
+// 0x80 or more
+// For each fleet size it reports exchanges per second against the target,
+// timeouts, the time from command to completed sensor packet, and the
+// CPU the fleet's loops used (getrusage on this process; the simulated
+// robots run in the child)
+// Two faulty fleets follow:
+//    late:    every third answer goes out a byte at a time at 9600 baud,
+//             starting half its wire time before the next command is due,
+//             so it's still arriving when that command goes out; the
+//             answers after it queue behind. Each answer carries its own
+//             count in every value, and the robots' state is polled every
+//             ms for a frame pieced from two answers
+//    unplug:  robot 0's pty is closed halfway through; it must be marked
+//             disconnected without the loop spinning on it, while the
+//             rest carry on
+//    fleetBench [robots] [rate] [seconds] [loops]
+//    robots: fleet size, default a sweep of 1, 8, 16, 32 and 64, and 8
+//            for the faulty fleets
+//    rate: exchanges per second per robot, default 20 (Colin runs at 4)
+//    seconds: length of each run, default 3
+//    loops: event loop threads, default 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <vector>
+#include "Fleet/FleetManager.h"
+#include "Pipeline/PipelineStage.h" // monotonicNanos
+
+enum FaultMode
+{
+	faultNone,
+	faultLate,
+	faultUnplug
+};
+
+const char* faultNames[] = {"", "late", "unplug"};
+const int maxPending = 64;
+const int lateBaud = 9600;
+
+// an answer, or part of one, waiting to be written
+struct PendingWrite
+{
+	int64_t at;
+	int length;
+	char data[2 * (maxSonar + numPoseVariables)];
+};
+
+struct FakeRobot
+{
+	int master;
+	int numSonar;
+	PacketAssembler* assembler;
+	int answered;
+	PendingWrite pending[maxPending]; // written in order, none before its time
+	int numPending;
+};
+
+int robotSonar(int robot)
+{
+	return 4 + robot % 5;
+}
+
+int robotSpeed(int robot)
+{
+	int speed = 130 + robot; // low byte 0x82 and up
+	return (robot % 2 == 0) ? speed : -speed;
+}
+
+void queueWrite(FakeRobot& robot, int64_t at, const char* data, int length)
+{
+	if (robot.numPending == maxPending)
+		return; // the fleet has fallen far behind, lose the answer
+	if (robot.numPending > 0 && at < robot.pending[robot.numPending - 1].at)
+		at = robot.pending[robot.numPending - 1].at;
+	PendingWrite& write = robot.pending[robot.numPending++];
+	write.at = at;
+	write.length = length;
+	memcpy(write.data, data, length);
+}
+
+// runs in the child: answers every command on every pty until killed
+// Answers echo the command, or with faultLate carry the answer's count
+void serveRobots(std::vector<FakeRobot>& robots, FaultMode fault, int64_t period,
+                 int64_t unplugAt)
+{
+	int epollFd = epoll_create1(0);
+	for (size_t i = 0; i < robots.size(); i++)
+	{
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, robots[i].master, &event);
+	}
+	struct epoll_event events[64];
+	while (true)
+	{
+		int64_t now = monotonicNanos();
+		int64_t next = (unplugAt > 0) ? unplugAt : -1;
+		for (size_t i = 0; i < robots.size(); i++)
+		{
+			FakeRobot& robot = robots[i];
+			int done = 0;
+			while (done < robot.numPending && robot.pending[done].at <= now)
+			{
+				if (write(robot.master, robot.pending[done].data, robot.pending[done].length) < 0)
+					_exit(1);
+				done++;
+			}
+			robot.numPending -= done;
+			memmove(robot.pending, robot.pending + done, robot.numPending * sizeof(PendingWrite));
+			if (robot.numPending > 0 && (next < 0 || robot.pending[0].at < next))
+				next = robot.pending[0].at;
+		}
+		if (unplugAt > 0 && now >= unplugAt)
+		{
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, robots[0].master, NULL);
+			close(robots[0].master);
+			robots[0].numPending = 0;
+			unplugAt = 0;
+			continue;
+		}
+		int timeout = (next < 0) ? -1 : (int)((next - now + 999999) / 1000000);
+		int numEvents = epoll_wait(epollFd, events, 64, timeout);
+		now = monotonicNanos();
+		for (int e = 0; e < numEvents; e++)
+		{
+			FakeRobot& robot = robots[events[e].data.u32];
+			char buffer[256];
+			ssize_t bytes = read(robot.master, buffer, sizeof(buffer));
+			if (bytes <= 0)
+				continue;
+			int used = 0;
+			while (used < bytes)
+			{
+				used += robot.assembler->append(buffer + used, bytes - used);
+				if (!robot.assembler->isComplete())
+					break;
+				int16_t translational;
+				double angular;
+				decodeCommandPacket(robot.assembler->getPacket(), &translational, &angular);
+				robot.assembler->reset();
+				robot.answered++;
+				int16_t value = (fault == faultLate) ? robot.answered : translational;
+				SensorPacket sensors;
+				sensors.numSonar = robot.numSonar;
+				for (int i = 0; i < robot.numSonar; i++)
+					sensors.distances[i] = value + i;
+				sensors.x = value;
+				sensors.y = -value;
+				sensors.theta = angular;
+				char packet[2 * (maxSonar + numPoseVariables)];
+				encodeSensorPacket(packet, sensors);
+				int size = sensorPacketSize(robot.numSonar);
+				if (fault == faultLate && robot.answered % 3 == 0)
+				{
+					int64_t byteTime = 10 * 1000000000LL / lateBaud;
+					int64_t begin = now + period - size * byteTime / 2;
+					for (int b = 0; b < size; b++)
+						queueWrite(robot, begin + b * byteTime, packet + b, 1);
+				}
+				else
+					queueWrite(robot, now, packet, size);
+			}
+		}
+	}
+}
+
+// a frame pieced from two answers has values that don't agree
+bool consistent(const FleetRobotState& state)
+{
+	bool agree = state.y == -state.x;
+	for (int s = 0; s < state.numSonar; s++)
+		agree = agree && state.distances[s] == state.x + s;
+	return agree;
+}
+
+double cpuSeconds()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+	       + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+bool runFleet(int numRobots, double rate, double seconds, int numLoops, FaultMode fault)
+{
+	std::vector<FakeRobot> robots(numRobots);
+	std::vector<char*> devices(numRobots);
+	for (int i = 0; i < numRobots; i++)
+	{
+		int master = posix_openpt(O_RDWR | O_NOCTTY);
+		if (master == -1 || grantpt(master) != 0 || unlockpt(master) != 0)
+		{
+			perror("posix_openpt");
+			return false;
+		}
+		fcntl(master, F_SETFL, O_NONBLOCK);
+		robots[i].master = master;
+		robots[i].numSonar = robotSonar(i);
+		robots[i].assembler = new PacketAssembler(commandPacketSize);
+		robots[i].answered = 0;
+		robots[i].numPending = 0;
+		devices[i] = strdup(ptsname(master));
+	}
+
+	FleetManager fleet(numRobots, numLoops);
+	for (int i = 0; i < numRobots; i++)
+	{
+		SerialBotConfig config = defaultSerialBotConfig();
+		config.device = devices[i];
+		config.baudRate = (fault == faultLate) ? lateBaud : 115200;
+		config.numSonar = robots[i].numSonar;
+		config.readPeriod = (int)(1e6 / rate);
+		config.resetPin = -1;
+		if (fleet.addRobot(config) != i)
+		{
+			fprintf(stderr, "unable to add robot on %s\n", devices[i]);
+			return false;
+		}
+		fleet.setSpeed(i, robotSpeed(i), 0.001 * i);
+	}
+
+	int64_t period = (int64_t)(1e9 / rate);
+	int64_t start = monotonicNanos();
+	int64_t unplugAt = (fault == faultUnplug) ? start + (int64_t)(seconds * 0.5e9) : 0;
+	pid_t child = fork();
+	if (child == 0)
+	{
+		serveRobots(robots, fault, period, unplugAt);
+		_exit(0);
+	}
+	if (fault == faultUnplug)
+	{
+		// only the child's copy keeps the pty open now
+		close(robots[0].master);
+		robots[0].master = -1;
+	}
+	double cpuStart = cpuSeconds();
+	fleet.start();
+	// poll every robot's state for frames pieced from two answers
+	std::vector<uint32_t> lastFrames(numRobots, 0);
+	int garbled = 0;
+	while (monotonicNanos() - start < (int64_t)(seconds * 1e9))
+	{
+		for (int i = 0; i < numRobots; i++)
+		{
+			FleetRobotState state;
+			fleet.getState(i, &state);
+			if (state.framesReceived == lastFrames[i])
+				continue;
+			lastFrames[i] = state.framesReceived;
+			if (!consistent(state))
+				garbled++;
+		}
+		usleep(1000);
+	}
+	fleet.stop();
+	double elapsed = (monotonicNanos() - start) / 1e9;
+	double cpu = cpuSeconds() - cpuStart;
+	kill(child, SIGKILL);
+	waitpid(child, NULL, 0);
+
+	uint64_t frames = 0, timeouts = 0;
+	int64_t totalLatency = 0, maxLatency = 0;
+	int wrong = 0, disconnected = 0;
+	for (int i = 0; i < numRobots; i++)
+	{
+		FleetRobotState state;
+		fleet.getState(i, &state);
+		frames += state.framesReceived;
+		timeouts += state.timeouts;
+		totalLatency += state.totalLatency;
+		if (state.maxLatency > maxLatency)
+			maxLatency = state.maxLatency;
+		bool right = state.framesReceived > 0 && state.numSonar == robotSonar(i)
+		             && fabs(state.theta - 0.001 * i) < 0.0015 && consistent(state);
+		if (fault != faultLate)
+			right = right && state.x == robotSpeed(i);
+		// only the unplugged robot may, and must, be disconnected
+		right = right && state.connected == !(fault == faultUnplug && i == 0);
+		if (!state.connected)
+			disconnected++;
+		if (!right)
+			wrong++;
+		if (robots[i].master != -1)
+			close(robots[i].master);
+		delete robots[i].assembler;
+		free(devices[i]);
+	}
+	printf("%-6s %5d robots  %9.0f exchanges/s of %9.0f  %6llu timeouts  %4d garbled"
+	       "  %2d disconnected  latency mean %7.1f us max %8.1f us  cpu %5.1f%%  %5.1f us/exchange  %s\n",
+	       faultNames[fault], numRobots, frames / elapsed, numRobots * rate,
+	       (unsigned long long)timeouts, garbled, disconnected,
+	       (frames > 0) ? totalLatency / 1e3 / frames : 0.0, maxLatency / 1e3,
+	       100.0 * cpu / elapsed, (frames > 0) ? cpu * 1e6 / frames : 0.0,
+	       (wrong == 0 && garbled == 0) ? "ok" : "WRONG VALUES");
+	return wrong == 0 && garbled == 0;
+}
+
+int main(int argc, char** argv)
+{
+	double rate = (argc > 2) ? atof(argv[2]) : 20.0;
+	double seconds = (argc > 3) ? atof(argv[3]) : 3.0;
+	int numLoops = (argc > 4) ? atoi(argv[4]) : 1;
+	bool ok = true;
+	int faultyRobots = 8;
+	if (argc > 1)
+	{
+		faultyRobots = atoi(argv[1]);
+		ok = runFleet(faultyRobots, rate, seconds, numLoops, faultNone);
+	}
+	else
+	{
+		const int sizes[] = {1, 8, 16, 32, 64};
+		for (int i = 0; i < 5; i++)
+			ok = runFleet(sizes[i], rate, seconds, numLoops, faultNone) && ok;
+	}
+	ok = runFleet(faultyRobots, rate, seconds, numLoops, faultLate) && ok;
+	ok = runFleet(faultyRobots, rate, seconds, numLoops, faultUnplug) && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,453 @@
+// gainSweep.cpp
+// 10/18/2026
+
+// Searches the wall following control law's gains (set point, kE, kS)
+// against the simulator
+// Every gain set on a grid is run through each of a handful of built-in
+// scenarios (straight walls on either side, an angled approach, inside
+// and outside corners). Each run is the wall follower's processing chain
+// (SonarFilter, ScanMatcher, PointAccumulator, LineFitter, WallEkf and
+// the control law) run synchronously against a SimBot, so simulated time
+// only advances between frames and a run takes a fraction of a second
+// Runs are independent and spread across cores with a ThreadPool, one
+// run per chunk; the shared counter hands the next run to whichever
+// thread finishes first, so uneven run times balance out
+
+// Each gain set is scored over all its runs by:
+//    tracking: rms of (true distance to the nearest wall - set point),
+//              each error capped at lostDistance
+//    oscillation: mean change in commanded angular velocity per frame
+//    collisions: total across scenarios
+// and the gain sets no other set beats on all three (the Pareto front)
+// are written to a CSV file
+
+// By default the simulated link is ideal: each command takes effect the
+// moment it's computed from a frame. -l models Colin's serial link
+// instead, where a command waits for the next exchange and the control
+// law acts on readings up to a period old, and -c compensates for that
+// as the wall follower does, predicting the filtered wall forward to when
+// the command takes effect; comparing -l with -l -c shows what the
+// compensation buys, and -v shows how it holds up at higher speeds
+
+// usage: gainSweep [-t seconds] [-p] [-l] [-c] [-v speed] [-n threads] [-o frontFile] [-a allFile]
+//    -t: simulated seconds per run (default 20)
+//    -p: pass commands through the DWA planner as the wall follower does;
+//        off by default so collisions reflect the gains alone
+//    -l: model the serial link's delays
+//    -c: compensate for them
+//    -v: cruise speed in cm/s (default 100)
+//    -n: threads, default every cpu
+//    -o: Pareto front CSV (default pareto.csv)
+//    -a: also write every gain set's scores to this CSV
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+#include "Sim/SimBot.h"
+#include "SonarFilter/SonarFilter.h"
+#include "ScanMatching/ScanMatcher.h"
+#include "PointCloud/PointAccumulator.h"
+#include "LineFitter/LineFitter.h"
+#include "Estimation/WallEkf.h"
+#include "Planner/DwaPlanner.h"
+#include "WallFollow/WallFollowLaw.h"
+#include "ThreadPool/ThreadPool.h"
+
+using namespace std;
+
+// same as wall_follow_single_line
+const int numSonar = 8;
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const int maxTrans = 200;
+const double maxAng = 2.0;
+const int maxRange = 300;
+const int maxScanPoints = 256;
+const int64_t maxPointAge = 3000000000LL;
+const double maxPointTravel = 100.0;
+const int matchMapPoints = 400;
+const float matchDistance = 30.0f;
+const float minConfidence = 0.2f;
+
+const int defaultCruiseSpeed = 100; // cm/s
+// Colin's link at 9600 baud: the 4 byte command takes about 4 ms on the
+// wire and the 22 byte sensor packet about 23 ms, plus handling time
+const double linkCommandDelay = 0.005; // s
+const double linkReplyDelay = 0.025; // s
+const double lostDistance = 100.0; // cm, tracking errors are capped at this
+
+// gain grid
+const double setPoints[] = {20.0, 30.0, 40.0, 50.0};
+const int numSetPoints = 4;
+const int numKE = 16;
+const double maxKE = 0.06;
+const int numKS = 16;
+const double maxKS = 0.15;
+
+struct Scenario
+{
+	const char* name;
+	World* world;
+	Pose2D start;
+};
+
+// score of one gain set in one scenario
+struct RunScore
+{
+	double squaredError; // sum over frames
+	double angularChange; // sum over frames
+	int frames;
+	uint32_t collisions;
+};
+
+struct GainScore
+{
+	WallFollowGains gains;
+	double tracking;
+	double oscillation;
+	uint32_t collisions;
+	bool front; // on the Pareto front
+};
+
+struct Sweep
+{
+	Scenario* scenarios;
+	int numScenarios;
+	WallFollowGains* gains;
+	RunScore* runs; // gain set major
+	double seconds;
+	bool usePlanner;
+	bool modelLink;
+	bool compensate;
+	int cruiseSpeed;
+};
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// walls 20 m long, so Colin doesn't run off the end within a run
+int buildScenarios(Scenario* scenarios, World** worlds)
+{
+	// wall along the x axis, to Colin's right
+	worlds[0]->addWall(-200.0, 0.0, 2000.0, 0.0);
+	// the same wall continuing down (outside corner) or up (inside corner) at x = 600
+	worlds[1]->addWall(-200.0, 0.0, 600.0, 0.0);
+	worlds[1]->addWall(600.0, 0.0, 600.0, -2000.0);
+	worlds[2]->addWall(-200.0, 0.0, 600.0, 0.0);
+	worlds[2]->addWall(600.0, 0.0, 600.0, 2000.0);
+
+	int n = 0;
+	scenarios[n].name = "right wall";
+	scenarios[n].world = worlds[0];
+	scenarios[n++].start = makePose(0.0, 45.0, 0.0);
+	scenarios[n].name = "left wall";
+	scenarios[n].world = worlds[0];
+	scenarios[n++].start = makePose(0.0, -45.0, 0.0);
+	scenarios[n].name = "angled approach";
+	scenarios[n].world = worlds[0];
+	scenarios[n++].start = makePose(0.0, 90.0, -0.4);
+	scenarios[n].name = "outside corner";
+	scenarios[n].world = worlds[1];
+	scenarios[n++].start = makePose(0.0, 30.0, 0.0);
+	scenarios[n].name = "inside corner";
+	scenarios[n].world = worlds[2];
+	scenarios[n++].start = makePose(0.0, 30.0, 0.0);
+	return n;
+}
+
+// one run: the wall follower's processing chain, one frame at a time
+RunScore simulate(const Scenario& scenario, const WallFollowGains& gains,
+                  uint64_t seed, const Sweep& sweep)
+{
+	SimBot bot(scenario.world, sensorAngles, numSonar, scenario.start, seed);
+	if (sweep.modelLink)
+	{
+		SimLinkModel link;
+		link.latchCommands = true;
+		link.commandDelay = linkCommandDelay;
+		link.replyDelay = linkReplyDelay;
+		bot.setLinkModel(link);
+	}
+	int cruiseSpeed = sweep.cruiseSpeed;
+	SpscQueue<SensorFrame> frames(4);
+	bot.setFrameQueue(&frames);
+	SonarFilter filter(maxRange);
+	ScanMatcher matcher(matchMapPoints, matchDistance);
+	PointAccumulator accumulator(maxScanPoints, maxPointAge, maxPointTravel);
+	Point points[maxScanPoints];
+	float confidence[maxScanPoints];
+	LineFitter line(points, maxScanPoints);
+	WallEkf ekf;
+	DwaConfig dwaConfig = defaultDwaConfig();
+	dwaConfig.maxTrans = maxTrans;
+	dwaConfig.maxAng = maxAng;
+	dwaConfig.maxObstacles = maxScanPoints;
+	DwaPlanner* planner = sweep.usePlanner ? new DwaPlanner(dwaConfig) : NULL;
+
+	RunScore score;
+	memset(&score, 0, sizeof(score));
+	bool havePose = false;
+	Pose2D lastPose = scenario.start;
+	double trans = 0.0, angular = 0.0;
+	int64_t lastCommandAt = 0; // when the last command took effect, 0 before the first
+	while (bot.getSimTime() < sweep.seconds)
+	{
+		if (!bot.step())
+			continue;
+		SensorFrame frame;
+		if (!frames.tryPop(frame))
+			continue;
+
+		// preprocess
+		FilteredScan filtered;
+		filter.update(frame.distances, &filtered);
+		Point scanPoints[numSonar];
+		float scanConfidence[numSonar];
+		int numPoints = 0;
+		for (int i = 0; i < numSonar; i++)
+		{
+			if (filtered.range[i] >= maxRange || filtered.confidence[i] < minConfidence)
+				continue;
+			scanPoints[numPoints].setCoordinates(filtered.range[i], sensorAngles[i]);
+			scanConfidence[numPoints] = filtered.confidence[i];
+			numPoints++;
+		}
+		Pose2D odometry = makePose(frame.x, frame.y, frame.theta);
+		Pose2D pose = matcher.processScan(scanPoints, numPoints, odometry).pose;
+		accumulator.addScan(scanPoints, scanConfidence, numPoints, pose, frame.timestamp);
+		int numScanPoints = accumulator.getRobotFrame(pose, points, confidence, maxScanPoints);
+
+		// line
+		line.setPoints(points, numScanPoints);
+		line.setConfidence(confidence);
+		line.updateLine();
+
+		// control; no time passes while processing, so the command always
+		// makes the exchange the frame expects
+		if (havePose)
+			ekf.predictOdometry(relativePose(lastPose, pose));
+		lastPose = pose;
+		havePose = true;
+		ekf.updateLine(line.getM(), line.getB());
+		double slope, intercept;
+		if (sweep.compensate)
+		{
+			WallEkf estimate = ekf;
+			estimate.predictCommand(trans, angular, (frame.commandAt - frame.sampledAt) / 1e9);
+			estimate.getLine(&slope, &intercept);
+		}
+		else
+			ekf.getLine(&slope, &intercept);
+		double newAngular = getWallFollowAngular(gains, slope, intercept, cruiseSpeed);
+		int newTrans = cruiseSpeed;
+		limitAngular(&newTrans, &newAngular, maxAng);
+		if (planner != NULL)
+		{
+			// the first command's window is closed, there's no time to accelerate in
+			double period = (lastCommandAt != 0) ? (frame.commandAt - lastCommandAt) / 1e9 : 0.0;
+			planner->setObstacles(points, numScanPoints);
+			DwaCommand command = planner->plan(trans, angular, newTrans, newAngular, period);
+			newTrans = (int)lround(command.translational);
+			newAngular = command.angular;
+		}
+		score.angularChange += fabs(newAngular - angular);
+		trans = newTrans;
+		angular = newAngular;
+		lastCommandAt = frame.commandAt;
+		bot.setSpeed(newTrans, newAngular);
+
+		Pose2D truth = bot.getTruePose();
+		double error = fabs(scenario.world->distanceToWall(truth.x, truth.y) - gains.setPoint);
+		error = fmin(error, lostDistance);
+		score.squaredError += error * error;
+		score.frames++;
+	}
+	score.collisions = bot.getCollisions();
+	delete planner;
+	return score;
+}
+
+void runChunk(int begin, int end, void* arg)
+{
+	Sweep* sweep = (Sweep*)arg;
+	for (int i = begin; i < end; i++)
+	{
+		int gainIndex = i / sweep->numScenarios;
+		int scenario = i % sweep->numScenarios;
+		// seeded by scenario, so every gain set sees the same sensor noise
+		sweep->runs[i] = simulate(sweep->scenarios[scenario], sweep->gains[gainIndex],
+		                          1000 + scenario, *sweep);
+	}
+}
+
+// a dominates b if it's no worse on every score and better on one
+bool dominates(const GainScore& a, const GainScore& b)
+{
+	if (a.tracking > b.tracking || a.oscillation > b.oscillation || a.collisions > b.collisions)
+		return false;
+	return a.tracking < b.tracking || a.oscillation < b.oscillation || a.collisions < b.collisions;
+}
+
+bool byTracking(const GainScore& a, const GainScore& b)
+{
+	return a.tracking < b.tracking;
+}
+
+bool writeScores(const char* fileName, const GainScore* scores, int numScores, bool frontOnly)
+{
+	FILE* file = fopen(fileName, "w");
+	if (file == NULL)
+		return false;
+	fprintf(file, "setPoint,kE,kS,tracking,oscillation,collisions\n");
+	for (int i = 0; i < numScores; i++)
+	{
+		if (frontOnly && !scores[i].front)
+			continue;
+		fprintf(file, "%.1f,%.4f,%.4f,%.3f,%.4f,%u\n", scores[i].gains.setPoint,
+		        scores[i].gains.kE, scores[i].gains.kS, scores[i].tracking,
+		        scores[i].oscillation, scores[i].collisions);
+	}
+	fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	double seconds = 20.0;
+	bool usePlanner = false;
+	bool modelLink = false;
+	bool compensate = false;
+	int cruiseSpeed = defaultCruiseSpeed;
+	int threads = 0;
+	const char* frontFile = "pareto.csv";
+	const char* allFile = NULL;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (strcmp(argv[arg], "-p") == 0)
+			usePlanner = true;
+		else if (strcmp(argv[arg], "-l") == 0)
+			modelLink = true;
+		else if (strcmp(argv[arg], "-c") == 0)
+			compensate = true;
+		else if (arg + 1 < argc && strcmp(argv[arg], "-v") == 0)
+			cruiseSpeed = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0)
+			seconds = atof(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+			threads = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-o") == 0)
+			frontFile = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-a") == 0)
+			allFile = argv[++arg];
+		else
+		{
+			printf("usage: gainSweep [-t seconds] [-p] [-l] [-c] [-v speed] [-n threads] "
+			       "[-o frontFile] [-a allFile]\n");
+			return 1;
+		}
+	}
+
+	World* worlds[3];
+	for (int i = 0; i < 3; i++)
+		worlds[i] = new World(16);
+	Scenario scenarios[8];
+	int numScenarios = buildScenarios(scenarios, worlds);
+
+	int numGainSets = numSetPoints * numKE * numKS;
+	WallFollowGains* gains = new WallFollowGains[numGainSets];
+	int n = 0;
+	for (int s = 0; s < numSetPoints; s++)
+		for (int e = 0; e < numKE; e++)
+			for (int k = 0; k < numKS; k++, n++)
+			{
+				gains[n].setPoint = setPoints[s];
+				gains[n].kE = maxKE * e / (numKE - 1);
+				gains[n].kS = maxKS * k / (numKS - 1);
+			}
+
+	Sweep sweep;
+	sweep.scenarios = scenarios;
+	sweep.numScenarios = numScenarios;
+	sweep.gains = gains;
+	sweep.runs = new RunScore[numGainSets * numScenarios];
+	sweep.seconds = seconds;
+	sweep.usePlanner = usePlanner;
+	sweep.modelLink = modelLink;
+	sweep.compensate = compensate;
+	sweep.cruiseSpeed = cruiseSpeed;
+
+	ThreadPool pool(threads);
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pool.parallelFor(0, numGainSets * numScenarios, runChunk, &sweep, 1);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double elapsed = elapsedSeconds(start, end);
+	printf("%d gain sets x %d scenarios x %.0f s on %d threads in %.1f s (%.0f runs/s, %.0fx real time)\n",
+	       numGainSets, numScenarios, seconds, pool.getNumThreads(), elapsed,
+	       numGainSets * numScenarios / elapsed, numGainSets * numScenarios * seconds / elapsed);
+
+	GainScore* scores = new GainScore[numGainSets];
+	for (int i = 0; i < numGainSets; i++)
+	{
+		double squaredError = 0.0, angularChange = 0.0;
+		int frames = 0;
+		uint32_t collisions = 0;
+		for (int s = 0; s < numScenarios; s++)
+		{
+			const RunScore& run = sweep.runs[i * numScenarios + s];
+			squaredError += run.squaredError;
+			angularChange += run.angularChange;
+			frames += run.frames;
+			collisions += run.collisions;
+		}
+		scores[i].gains = gains[i];
+		scores[i].tracking = sqrt(squaredError / frames);
+		scores[i].oscillation = angularChange / frames;
+		scores[i].collisions = collisions;
+	}
+	int frontSize = 0;
+	for (int i = 0; i < numGainSets; i++)
+	{
+		scores[i].front = true;
+		for (int j = 0; j < numGainSets && scores[i].front; j++)
+			if (j != i && dominates(scores[j], scores[i]))
+				scores[i].front = false;
+		if (scores[i].front)
+			frontSize++;
+	}
+	sort(scores, scores + numGainSets, byTracking);
+
+	WallFollowGains current = defaultWallFollowGains();
+	printf("%d gain sets on the Pareto front, best tracking:\n", frontSize);
+	printf("  setPoint     kE      kS   tracking  oscillation  collisions\n");
+	for (int i = 0, shown = 0; i < numGainSets && shown < 10; i++)
+	{
+		if (!scores[i].front)
+			continue;
+		printf("  %8.0f %6.4f %7.4f %8.2f cm %8.4f rad/s %6u\n", scores[i].gains.setPoint,
+		       scores[i].gains.kE, scores[i].gains.kS, scores[i].tracking,
+		       scores[i].oscillation, scores[i].collisions);
+		shown++;
+	}
+	for (int i = 0; i < numGainSets; i++)
+		if (scores[i].gains.setPoint == current.setPoint && scores[i].gains.kE == current.kE
+		    && fabs(scores[i].gains.kS - current.kS) < 1e-9)
+			printf("current gains (%.0f, %.2f, %.2f): tracking %.2f cm, oscillation %.4f rad/s, "
+			       "%u collisions\n", current.setPoint, current.kE, current.kS,
+			       scores[i].tracking, scores[i].oscillation, scores[i].collisions);
+
+	if (!writeScores(frontFile, scores, numGainSets, true))
+		printf("unable to write %s\n", frontFile);
+	if (allFile != NULL && !writeScores(allFile, scores, numGainSets, false))
+		printf("unable to write %s\n", allFile);
+	delete [] scores;
+	delete [] sweep.runs;
+	delete [] gains;
+	for (int i = 0; i < 3; i++)
+		delete worlds[i];
+	return 0;
+}
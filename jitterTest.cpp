@@ -0,0 +1,133 @@
+// jitterTest.cpp
+// 10/18/2026
+
+// Measures the period jitter of a periodic thread with and without
+// real-time mode while other threads load the cpu
+// Sleeps to absolute monotonic deadlines a fixed period apart
+// (PeriodicTimer) and reports how late each wake-up was. That stands in
+// for the comm thread's wait between exchanges: SerialBot::waitForExchange
+// sleeps on a condition variable, on the monotonic clock, until a deadline
+// its rate policy spaces, so its lateness is the same scheduling latency,
+// though its period varies from one exchange to the next
+
+// usage: jitterTest [periodUs] [cycles] [loadThreads] [priority] [cpu]
+//    periodUs:    loop period in microseconds (default 1000)
+//    cycles:      number of periods measured per run (default 5000)
+//    loadThreads: number of busy-looping threads (default 4)
+//    priority:    SCHED_FIFO priority for the real-time run (default 80)
+//    cpu:         cpu the measured and load threads share (default 0)
+// Real-time mode needs root or CAP_SYS_NICE; without it the second run
+// logs the failure and repeats the normal run
+
+#include "RealTime/RealTime.h"
+#include "Pipeline/PipelineStage.h"
+#include <stdio.h>
+#include <cstdlib>
+#include <math.h>
+#include <pthread.h>
+#include <atomic>
+#include <algorithm>
+
+using namespace std;
+
+atomic<bool> loadRunning(false);
+
+struct JitterArgs
+{
+	int64_t periodNanos;
+	int cycles;
+	RealTimeConfig realTime;
+	int64_t* lateness; // one entry per cycle
+};
+
+// synthetic cpu load
+void* loadFunction(void* args)
+{
+	volatile double sink = 0.0;
+	while (loadRunning.load(memory_order_relaxed))
+	{
+		for (int i = 0; i < 10000; i++)
+			sink += sqrt((double)i);
+	}
+	return NULL;
+}
+
+void* measureFunction(void* args)
+{
+	JitterArgs* jitter = (JitterArgs*)args;
+	if (jitter->realTime.enabled)
+		enterRealTime("jitterTest", jitter->realTime);
+	else if (jitter->realTime.cpu >= 0)
+		pinThreadToCpu(pthread_self(), jitter->realTime.cpu);
+	PeriodicTimer timer(jitter->periodNanos);
+	for (int i = 0; i < jitter->cycles; i++)
+		jitter->lateness[i] = timer.wait();
+	return NULL;
+}
+
+void printResults(const char* label, int64_t* lateness, int cycles)
+{
+	sort(lateness, lateness + cycles);
+	double sum = 0.0;
+	double sumSquares = 0.0;
+	for (int i = 0; i < cycles; i++)
+	{
+		sum += lateness[i];
+		sumSquares += (double)lateness[i] * lateness[i];
+	}
+	double mean = sum / cycles;
+	double stdDev = sqrt(sumSquares / cycles - mean * mean);
+	printf("%-10s min %8.1f  mean %8.1f  stddev %8.1f  p99 %8.1f  max %8.1f us\n",
+	       label, lateness[0] / 1000.0, mean / 1000.0, stdDev / 1000.0,
+	       lateness[(cycles * 99) / 100] / 1000.0, lateness[cycles - 1] / 1000.0);
+}
+
+void runTest(const char* label, JitterArgs* jitter, int loadThreads)
+{
+	pthread_t* load = new pthread_t[loadThreads];
+	loadRunning.store(true);
+	for (int i = 0; i < loadThreads; i++)
+	{
+		pthread_create(&load[i], NULL, loadFunction, NULL);
+		pinThreadToCpu(load[i], jitter->realTime.cpu);
+	}
+	pthread_t measure;
+	pthread_create(&measure, NULL, measureFunction, jitter);
+	pthread_join(measure, NULL);
+	loadRunning.store(false);
+	for (int i = 0; i < loadThreads; i++)
+		pthread_join(load[i], NULL);
+	delete[] load;
+	printResults(label, jitter->lateness, jitter->cycles);
+}
+
+int main(int argc, char** argv)
+{
+	int periodUs = (argc > 1) ? atoi(argv[1]) : 1000;
+	int cycles = (argc > 2) ? atoi(argv[2]) : 5000;
+	int loadThreads = (argc > 3) ? atoi(argv[3]) : 4;
+	int priority = (argc > 4) ? atoi(argv[4]) : 80;
+	int cpu = (argc > 5) ? atoi(argv[5]) : 0;
+	if (periodUs <= 0 || cycles <= 0 || loadThreads < 0)
+	{
+		fprintf(stderr, "usage: jitterTest [periodUs] [cycles] [loadThreads] [priority] [cpu]\n");
+		return 1;
+	}
+
+	printf("period %d us, %d cycles, %d load threads on cpu %d\n",
+	       periodUs, cycles, loadThreads, cpu);
+	JitterArgs jitter;
+	jitter.periodNanos = (int64_t)periodUs * 1000;
+	jitter.cycles = cycles;
+	jitter.lateness = new int64_t[cycles];
+	jitter.realTime = defaultRealTimeConfig();
+	jitter.realTime.cpu = cpu;
+	runTest("normal", &jitter, loadThreads);
+
+	jitter.realTime.enabled = true;
+	jitter.realTime.priority = priority;
+	runTest("real-time", &jitter, loadThreads);
+
+	delete[] jitter.lateness;
+	return 0;
+}
@@ -0,0 +1,221 @@
+// linkFaultBench.cpp
+// 10/18/2026
+
+// Runs a SerialBot against a fake ATmega328 on a pty that misbehaves the
+// ways a real serial link does, to check that the comm thread keeps its
+// schedule and that stale readings are noticed
+// The fake answers every command with a sensor packet whose y is a
+// marker, so a packet assembled from the wrong bytes shows up as a frame
+// without it. Phases:
+//    clean:  answers at once
+//    split:  sends each packet in three pieces a few ms apart
+//    drop:   leaves the last byte off every third packet
+//    late:   answers every other command after 150 ms, past the timeout
+//    silent: stops answering, while commands keep arriving
+//    clean:  answers at once again
+// For each phase it reports frames, good and garbled, receive timeouts,
+// retries, the oldest the readings got and the commands that reached the
+// fake, and how long isStale reported the readings stale; for the silent
+// phase, how long until it noticed
+//    linkFaultBench [seconds]
+//    seconds: length of each phase, default 2
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "SerialBot/SerialBot.h"
+
+const int numSonar = 8;
+const int16_t marker = 1234;
+
+enum FaultMode
+{
+	faultNone,
+	faultSplit,
+	faultDrop,
+	faultLate,
+	faultSilent
+};
+
+struct Phase
+{
+	const char* name;
+	FaultMode mode;
+	int translational; // cm/s, commanded for the phase
+};
+
+const Phase phases[] = {
+	{"clean", faultNone, 20},
+	{"split", faultSplit, 30},
+	{"drop", faultDrop, 40},
+	{"late", faultLate, 50},
+	{"silent", faultSilent, 60},
+	{"clean again", faultNone, 70}
+};
+const int numPhases = sizeof(phases) / sizeof(phases[0]);
+
+// shared with the fake
+struct FakeState
+{
+	volatile int mode;
+	volatile int commands; // commands received
+	volatile int translational; // the latest one's speed
+};
+
+// runs in the child: answers commands on master until killed
+void serveBot(int master, FakeState* state)
+{
+	PacketAssembler assembler(commandPacketSize);
+	char data[64];
+	char packet[sensorPacketSize(maxSonar)];
+	int size = sensorPacketSize(numSonar);
+	int answered = 0;
+	while (true)
+	{
+		int length = read(master, data, sizeof(data));
+		if (length <= 0)
+			_exit(0);
+		for (int used = 0; used < length; )
+		{
+			used += assembler.append(data + used, length - used);
+			if (!assembler.isComplete())
+				continue;
+			int16_t translational;
+			double angular;
+			decodeCommandPacket(assembler.getPacket(), &translational, &angular);
+			assembler.reset();
+			state->commands++;
+			state->translational = translational;
+			int mode = state->mode;
+			if (mode == faultSilent)
+				continue;
+			answered++;
+			SensorPacket sensors;
+			memset(&sensors, 0, sizeof(sensors));
+			sensors.numSonar = numSonar;
+			for (int s = 0; s < numSonar; s++)
+				sensors.distances[s] = 100;
+			sensors.x = answered;
+			sensors.y = marker;
+			encodeSensorPacket(packet, sensors);
+			int bytes = size;
+			if (mode == faultDrop && answered % 3 == 0)
+				bytes--;
+			if (mode == faultLate && answered % 2 == 0)
+				usleep(150000);
+			if (mode == faultSplit)
+			{
+				int piece = size / 3;
+				for (int sent = 0; sent < size; sent += piece)
+				{
+					int count = (size - sent < piece) ? size - sent : piece;
+					if (write(master, packet + sent, count) < 0)
+						_exit(1);
+					usleep(5000);
+				}
+			}
+			else if (write(master, packet, bytes) < 0)
+				_exit(1);
+		}
+	}
+}
+
+void* commFunction(void* bot)
+{
+	((SerialBot*)bot)->commThreadFunction();
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+	FakeState* state = (FakeState*)mmap(NULL, sizeof(FakeState), PROT_READ | PROT_WRITE,
+	                                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	state->mode = faultNone;
+	state->commands = 0;
+	state->translational = 0;
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master == -1 || grantpt(master) != 0 || unlockpt(master) != 0)
+	{
+		perror("posix_openpt");
+		return 1;
+	}
+	SerialBotConfig config = defaultSerialBotConfig();
+	config.device = ptsname(master);
+	config.numSonar = numSonar;
+	config.resetPin = -1;
+	pid_t child = fork();
+	if (child == 0)
+	{
+		serveBot(master, state);
+		_exit(0);
+	}
+	SerialBot bot(config);
+	SpscQueue<SensorFrame> frames(64);
+	bot.setFrameQueue(&frames);
+	printf("period %d ms, receive timeout %d ms, %d retry\n", config.readPeriod / 1000,
+	       config.receiveTimeout / 1000, config.maxRetries);
+	pthread_t thread;
+	pthread_create(&thread, NULL, commFunction, &bot);
+	pthread_detach(thread);
+
+	printf("%-12s %6s %7s %8s %7s %9s %8s %9s\n", "", "frames", "garbled", "timeouts",
+	       "retries", "max age", "commands", "stale");
+	for (int p = 0; p < numPhases; p++)
+	{
+		state->mode = phases[p].mode;
+		bot.setSpeed(phases[p].translational, 0.0);
+		uint32_t timeouts = bot.getTimeouts();
+		uint32_t retries = bot.getRetries();
+		int commands = state->commands;
+		int good = 0, garbled = 0;
+		int64_t maxAge = 0;
+		double staleAfter = -1.0;
+		double staleAge = 0.0;
+		int64_t staleTime = 0;
+		int64_t start = monotonicNanos();
+		int64_t lastPoll = start;
+		while (monotonicNanos() - start < (int64_t)(seconds * 1e9))
+		{
+			SensorFrame frame;
+			while (frames.tryPop(frame))
+			{
+				if (frame.y == marker)
+					good++;
+				else
+					garbled++;
+			}
+			int64_t now = monotonicNanos();
+			int64_t age = bot.getSnapshotAge();
+			if (age > maxAge)
+				maxAge = age;
+			if (bot.isStale())
+			{
+				staleTime += now - lastPoll;
+				if (staleAfter < 0.0)
+				{
+					staleAfter = (now - start) / 1e6;
+					staleAge = age / 1e6;
+				}
+			}
+			lastPoll = now;
+			usleep(1000);
+		}
+		printf("%-12s %6d %7d %8u %7u %6.0f ms %8d %6.0f ms\n", phases[p].name, good, garbled,
+		       bot.getTimeouts() - timeouts, bot.getRetries() - retries, maxAge / 1e6,
+		       state->commands - commands, staleTime / 1e6);
+		if (phases[p].mode == faultSilent)
+			printf("%-12s stale after %.0f ms, readings %.0f ms old; fake last saw %d cm/s\n",
+			       "", staleAfter, staleAge, state->translational);
+	}
+	bot.setFrameQueue(NULL);
+	kill(child, SIGKILL);
+	waitpid(child, NULL, 0);
+	return 0;
+}
@@ -0,0 +1,208 @@
+// navigate.cpp
+// 10/18/2026
+
+// Drives Colin to a goal through a prebuilt occupancy grid map
+// The map is loaded, and every sensor frame is added to it as Colin
+// drives; cells near Colin whose occupancy changed are passed to a D*
+// Lite planner, which repairs its path rather than replanning, and a
+// waypoint tracker turns the path's corners into speed commands
+
+// Poses come straight from odometry, so the map should have been built
+// in the same frame, starting from where Colin starts now
+
+// Frames and commands are published to the shared memory telemetry ring
+
+// -s runs against the simulator (SimBot) in the given world file instead
+// of the robot, starting at the world's start pose, and -t runs the
+// simulator scale times faster than real time (default 1)
+// On leaving, Colin is stopped and the program waits for the stop to
+// have gone out in an exchange, so Colin isn't left driving on the last
+// command
+
+// usage: navigate [-s worldFile [-t scale]] mapFile goalX goalY
+//    goalX, goalY: goal in cm in the map's frame
+
+#include "SerialBot/SerialBot.h"
+#include "Sim/SimBot.h"
+#include "Mapping/OccupancyGrid.h"
+#include "Planner/DStarLite.h"
+#include "Planner/WaypointTracker.h"
+#include <pthread.h>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+Robot* colin; // SerialBot, or SimBot with -s
+SimBot* sim = NULL; // colin when simulating
+TelemetryWriter telemetry;
+
+const int numSonar = 8;
+// angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const int maxTrans = 100; // cm/s, slower than wall following
+const double maxAng = 2.0; // rad/s
+const double maxRange = 300.0; // cm, cells farther than this from Colin aren't resynced
+const double robotRadius = 12.0; // cm, obstacles are inflated by this
+const int mapMargin = 20; // cells around the map's bounds the planner covers
+const int maxWaypoints = 256;
+const int queueCapacity = 4;
+const int64_t stopTimeout = 2000000000LL; // ns to wait for the stop command to go out
+
+// map cell at the planner's (0, 0)
+int originCx, originCy;
+
+void* commFunction(void* args)
+{
+	colin->commThreadFunction();
+	return NULL;
+}
+
+// sets zero speed and waits until an exchange sent after it has completed,
+// two frames on, or until stopTimeout passes if the link is down
+void stopColin()
+{
+	colin->setSpeed(0, 0.0);
+	uint32_t frames = colin->getFramesReceived();
+	int64_t deadline = monotonicNanos() + stopTimeout;
+	while (colin->getFramesReceived() - frames < 2 && monotonicNanos() < deadline)
+		usleep(10000);
+}
+
+// copies occupancy from the map into the planner for cells within
+// radius cells of (cx, cy); setOccupied ignores cells that haven't changed
+void syncPlanner(OccupancyGrid* grid, DStarLite* planner, int cx, int cy, int radius)
+{
+	int minX = max(0, cx - radius - originCx);
+	int maxX = min(planner->getWidth() - 1, cx + radius - originCx);
+	int minY = max(0, cy - radius - originCy);
+	int maxY = min(planner->getHeight() - 1, cy + radius - originCy);
+	for (int y = minY; y <= maxY; y++)
+		for (int x = minX; x <= maxX; x++)
+			planner->setOccupied(x, y, grid->isOccupied(x + originCx, y + originCy));
+}
+
+int main(int argc, char** argv)
+{
+	int arg = 1;
+	World world(1024);
+	if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+	{
+		if (!world.load(argv[arg + 1]))
+		{
+			cerr << "unable to load world " << argv[arg + 1] << endl;
+			return 1;
+		}
+		sim = new SimBot(&world, sensorAngles, numSonar, world.getStart(), 1);
+		arg += 2;
+		if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0)
+		{
+			sim->setTimeScale(atof(argv[arg + 1]));
+			arg += 2;
+		}
+	}
+	if (arg + 3 > argc)
+	{
+		cerr << "usage: navigate [-s worldFile [-t scale]] mapFile goalX goalY" << endl;
+		return 1;
+	}
+	OccupancyGrid grid(5.0);
+	if (!grid.load(argv[arg]))
+	{
+		cerr << "unable to load map " << argv[arg] << endl;
+		return 1;
+	}
+	double goalX = atof(argv[arg + 1]);
+	double goalY = atof(argv[arg + 2]);
+	if (sim != NULL)
+		colin = sim;
+	else
+		colin = new SerialBot();
+	double resolution = grid.getResolution();
+
+	// the planner covers the map plus a margin, and the start and goal
+	int minCx = 0, minCy = 0, maxCx = 0, maxCy = 0, goalCx, goalCy;
+	grid.getBounds(&minCx, &minCy, &maxCx, &maxCy);
+	grid.worldToCell(goalX, goalY, &goalCx, &goalCy);
+	minCx = min(min(minCx, goalCx), 0) - mapMargin;
+	minCy = min(min(minCy, goalCy), 0) - mapMargin;
+	maxCx = max(max(maxCx, goalCx + 1), 1) + mapMargin;
+	maxCy = max(max(maxCy, goalCy + 1), 1) + mapMargin;
+	originCx = minCx;
+	originCy = minCy;
+	int inflation = (int)ceil(robotRadius / resolution);
+	DStarLite planner(maxCx - minCx, maxCy - minCy, inflation);
+	syncPlanner(&grid, &planner, (minCx + maxCx) / 2, (minCy + maxCy) / 2,
+	            max(maxCx - minCx, maxCy - minCy));
+	WaypointTracker tracker(maxWaypoints, maxTrans, maxAng);
+	int waypointXs[maxWaypoints], waypointYs[maxWaypoints];
+	double worldXs[maxWaypoints], worldYs[maxWaypoints];
+
+	SpscQueue<SensorFrame> frames(queueCapacity);
+	colin->setFrameQueue(&frames);
+	if (telemetry.open(defaultTelemetryName, defaultTelemetryCapacity))
+		colin->setTelemetry(&telemetry);
+	else
+		cerr << "unable to open telemetry " << defaultTelemetryName << endl;
+	pthread_t commThread;
+	pthread_create(&commThread, NULL, commFunction, NULL);
+
+	bool goalSet = false;
+	int rangeCells = (int)(maxRange / resolution);
+	while (true)
+	{
+		SensorFrame frame;
+		if (!frames.tryPop(frame))
+		{
+			usleep(10000);
+			continue;
+		}
+		grid.insertFrame(frame, sensorAngles);
+		Pose2D pose = makePose(frame.x, frame.y, frame.theta);
+		int cx, cy;
+		grid.worldToCell(pose.x, pose.y, &cx, &cy);
+		if (cx < minCx || cx >= maxCx || cy < minCy || cy >= maxCy)
+		{
+			cerr << "Colin has left the planned area" << endl;
+			break;
+		}
+		syncPlanner(&grid, &planner, cx, cy, rangeCells);
+		planner.setStart(cx - originCx, cy - originCy);
+		if (!goalSet)
+		{
+			planner.setGoal(goalCx - originCx, goalCy - originCy);
+			goalSet = true;
+		}
+		if (!planner.computePath())
+		{
+			cerr << "no path to the goal" << endl;
+			break;
+		}
+		int numWaypoints = planner.getWaypoints(waypointXs, waypointYs, maxWaypoints);
+		for (int i = 0; i < numWaypoints; i++)
+			grid.cellToWorld(waypointXs[i] + originCx, waypointYs[i] + originCy,
+			                 &worldXs[i], &worldYs[i]);
+		tracker.setWaypoints(worldXs, worldYs, numWaypoints);
+		TrackerCommand command = tracker.update(pose);
+		printf("pose (%.0f, %.0f) path %.0f cm, %d waypoints, %d expansions\n",
+		       pose.x, pose.y, planner.getPathCost() * resolution, numWaypoints,
+		       planner.getExpansions());
+		if (command.finished)
+		{
+			printf("goal reached\n");
+			break;
+		}
+		colin->setSpeed((int)command.translational, command.angular);
+	}
+	colin->setFrameQueue(NULL);
+	stopColin();
+	if (sim != NULL)
+	{
+		sim->stop();
+		pthread_join(commThread, NULL);
+	}
+	return 0;
+}
@@ -0,0 +1,93 @@
+// occupancyGridBench.cpp
+// 10/18/2026
+
+// Benchmarks occupancy grid updates
+// Drives a virtual Colin around a loop inside a rectangular room, builds
+// sonar readings from the room walls and inserts them into the grid,
+// then reports scans per second and cell updates per second
+// Optionally saves the resulting map, which is handy as a prebuilt map
+
+// usage: occupancyGridBench [scans] [resolution] [mapFile]
+//    scans:      number of sensor frames inserted (default 20000)
+//    resolution: cell size in cm (default 5)
+//    mapFile:    if given, the map is saved here
+
+#include <stdio.h>
+#include <cstdlib>
+#include <time.h>
+#include "Mapping/OccupancyGrid.h"
+
+using namespace std;
+
+const int numSonar = 8;
+// angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const double roomWidth = 600.0; // room spans 0 to roomWidth in x
+const double roomHeight = 400.0; // and 0 to roomHeight in y
+const double maxRange = 300.0;
+
+double secondsNow()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// distance from (x, y) along angle to the nearest room wall
+double rangeToWall(double x, double y, double angle)
+{
+	double c = cos(angle);
+	double s = sin(angle);
+	double best = 1e9;
+	if (c > 1e-9)
+		best = fmin(best, (roomWidth - x) / c);
+	if (c < -1e-9)
+		best = fmin(best, -x / c);
+	if (s > 1e-9)
+		best = fmin(best, (roomHeight - y) / s);
+	if (s < -1e-9)
+		best = fmin(best, -y / s);
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	int scans = (argc > 1) ? atoi(argv[1]) : 20000;
+	double resolution = (argc > 2) ? atof(argv[2]) : 5.0;
+	const char* mapFile = (argc > 3) ? argv[3] : NULL;
+
+	OccupancyGrid grid(resolution);
+	int16_t ranges[numSonar];
+	double start = secondsNow();
+	for (int i = 0; i < scans; i++)
+	{
+		// ellipse around the middle of the room, one lap every 400 scans
+		double t = 2.0 * M_PI * (i % 400) / 400.0;
+		Pose2D pose = makePose(roomWidth / 2 + 180.0 * cos(t),
+		                       roomHeight / 2 + 100.0 * sin(t),
+		                       normalizeAngle(t + M_PI / 2));
+		for (int s = 0; s < numSonar; s++)
+		{
+			double range = rangeToWall(pose.x, pose.y, pose.theta + sensorAngles[s]);
+			ranges[s] = (range > maxRange) ? 0 : (int16_t)range;
+		}
+		grid.insertScan(pose, ranges, sensorAngles, numSonar);
+	}
+	double elapsed = secondsNow() - start;
+
+	int minCx = 0, minCy = 0, maxCx = 0, maxCy = 0;
+	grid.getBounds(&minCx, &minCy, &maxCx, &maxCy);
+	printf("%d scans in %.3f s\n", scans, elapsed);
+	printf("%.0f scans/s, %.2f M cell updates/s\n", scans / elapsed,
+	       grid.getCellUpdates() / elapsed / 1e6);
+	printf("%d tiles, bounds (%d, %d) to (%d, %d) cells\n", grid.getNumTiles(),
+	       minCx, minCy, maxCx, maxCy);
+	if (mapFile != NULL)
+	{
+		if (grid.save(mapFile))
+			printf("map saved to %s\n", mapFile);
+		else
+			fprintf(stderr, "unable to save map to %s\n", mapFile);
+	}
+	return 0;
+}
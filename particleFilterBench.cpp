@@ -0,0 +1,135 @@
+// particleFilterBench.cpp
+// 10/18/2026
+
+// Benchmarks Monte Carlo localization
+// Builds (or loads) a map of a rectangular room, drives a virtual Colin
+// around it with drifting odometry, and runs the particle filter on each
+// frame; reports time per update, achievable update rate and the error
+// of the estimate against ground truth and against raw odometry
+
+// usage: particleFilterBench [particles] [threads] [steps] [mapFile]
+//    particles: number of particles (default 5000)
+//    threads:   threads in the pool, 0 for every cpu (default 4)
+//    steps:     number of frames processed (default 400)
+//    mapFile:   map saved by occupancyGridBench, built here if omitted
+// the room must match the one used to build mapFile
+
+#include <stdio.h>
+#include <cstdlib>
+#include <time.h>
+#include "Mapping/OccupancyGrid.h"
+#include "Localization/LikelihoodField.h"
+#include "Localization/ParticleFilter.h"
+#include "ThreadPool/ThreadPool.h"
+
+using namespace std;
+
+const int numSonar = 8;
+// angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const double roomWidth = 600.0;
+const double roomHeight = 400.0;
+const double maxRange = 300.0;
+
+double secondsNow()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// distance from (x, y) along angle to the nearest room wall
+double rangeToWall(double x, double y, double angle)
+{
+	double c = cos(angle);
+	double s = sin(angle);
+	double best = 1e9;
+	if (c > 1e-9)
+		best = fmin(best, (roomWidth - x) / c);
+	if (c < -1e-9)
+		best = fmin(best, -x / c);
+	if (s > 1e-9)
+		best = fmin(best, (roomHeight - y) / s);
+	if (s < -1e-9)
+		best = fmin(best, -y / s);
+	return best;
+}
+
+void makeRanges(const Pose2D& pose, int16_t* ranges)
+{
+	for (int s = 0; s < numSonar; s++)
+	{
+		double range = rangeToWall(pose.x, pose.y, pose.theta + sensorAngles[s]);
+		ranges[s] = (range > maxRange) ? 0 : (int16_t)range;
+	}
+}
+
+// pose on an ellipse around the middle of the room
+Pose2D truePose(int step)
+{
+	double t = 2.0 * M_PI * (step % 400) / 400.0;
+	return makePose(roomWidth / 2 + 180.0 * cos(t), roomHeight / 2 + 100.0 * sin(t),
+	                normalizeAngle(t + M_PI / 2));
+}
+
+int main(int argc, char** argv)
+{
+	int numParticles = (argc > 1) ? atoi(argv[1]) : 5000;
+	int numThreads = (argc > 2) ? atoi(argv[2]) : 4;
+	int steps = (argc > 3) ? atoi(argv[3]) : 400;
+	const char* mapFile = (argc > 4) ? argv[4] : NULL;
+
+	OccupancyGrid grid(5.0);
+	int16_t ranges[numSonar];
+	if (mapFile == NULL || !grid.load(mapFile))
+	{
+		for (int i = 0; i < 400; i++)
+		{
+			makeRanges(truePose(i), ranges);
+			grid.insertScan(truePose(i), ranges, sensorAngles, numSonar);
+		}
+	}
+	LikelihoodField field(&grid, 10.0, 0.05);
+	ThreadPool pool(numThreads);
+	ParticleFilter filter(&field, numParticles, &pool);
+	filter.initialize(truePose(0), 20.0, 0.1);
+
+	// odometry that over-reports distance by 3% and drifts in heading
+	Pose2D odometry = truePose(0);
+	double totalTime = 0.0, worstTime = 0.0;
+	double filterError = 0.0, odometryError = 0.0;
+	for (int step = 1; step <= steps; step++)
+	{
+		Pose2D delta = relativePose(truePose(step - 1), truePose(step));
+		delta.x *= 1.03;
+		delta.theta += 0.002;
+		odometry = composePose(odometry, delta);
+
+		SensorFrame frame;
+		frame.numSonar = numSonar;
+		makeRanges(truePose(step), ranges);
+		for (int s = 0; s < numSonar; s++)
+			frame.distances[s] = ranges[s];
+		frame.x = (int16_t)odometry.x;
+		frame.y = (int16_t)odometry.y;
+		frame.theta = odometry.theta;
+
+		double start = secondsNow();
+		filter.processFrame(frame, sensorAngles);
+		double elapsed = secondsNow() - start;
+		totalTime += elapsed;
+		worstTime = fmax(worstTime, elapsed);
+
+		Pose2D estimate = filter.getEstimate();
+		Pose2D truth = truePose(step);
+		filterError += hypot(estimate.x - truth.x, estimate.y - truth.y);
+		odometryError += hypot(odometry.x - truth.x, odometry.y - truth.y);
+	}
+
+	printf("%d particles, %d threads, %d steps\n", numParticles, pool.getNumThreads(), steps);
+	printf("mean update %.3f ms, worst %.3f ms, %.1f Hz achievable\n",
+	       totalTime / steps * 1000.0, worstTime * 1000.0, steps / totalTime);
+	printf("mean position error: filter %.1f cm, odometry %.1f cm\n",
+	       filterError / steps, odometryError / steps);
+	return 0;
+}
@@ -0,0 +1,267 @@
+// poseGraphBench.cpp
+// 10/18/2026
+
+// Benchmarks the incremental pose graph (PoseGraph) as it grows
+// A virtual Colin drives laps of a rectangular corridor loop, 12 m by
+// 8 m around the outside and 1.6 m wide, adding a pose every 10 cm from
+// odometry whose distance scale, heading and turns all drift. From each
+// pose it fits the two side walls (exact lines plus noise) and passes
+// them to addWall; at each corner a place recognizer closes the loop to
+// the same corner on the previous lap, and every eighth lap to the first
+// lap as well
+// update() is timed after every pose; for each block of poses it reports
+// the mean and worst update time, how many columns were eliminated (and
+// of those, how many only because their update matrix had been freed)
+// and back substituted, and at the end the error of the graph's poses
+// and of raw odometry against the true path
+// With batch set, optimize(1) (a full relinearize and refactor, as a
+// batch solver does each iteration) is also timed at the end of every
+// block; it leaves the graph freshly ordered, so it's off by default
+
+// usage: poseGraphBench [poses] [batch]
+//    poses: number of poses added (default 20000)
+//    batch: 1 to time optimize at the end of every block (default 0)
+
+#include <stdio.h>
+#include <cstdlib>
+#include <time.h>
+#include "PoseGraph/PoseGraph.h"
+
+using namespace std;
+
+const double stepLength = 10.0; // cm between poses
+const double outerLeft = 100.0, outerBottom = 100.0; // outer walls
+const double outerRight = 1300.0, outerTop = 900.0;
+const double corridorWidth = 160.0;
+const int blockPoses = 2000;
+
+// odometry drift
+const double distanceScale = 1.01;
+const double headingNoise = 0.003; // rad per step
+const double turnScale = 1.02;
+
+// wall fits and loop closures
+const double fitDistanceSigma = 2.0; // cm
+const double fitAngleSigma = 0.02; // rad
+const double closureTranslationSigma = 2.0;
+const double closureRotationSigma = 0.01;
+
+struct Line
+{
+	double rho, alpha; // x cos(alpha) + y sin(alpha) = rho
+};
+
+uint64_t randomState = 88172645463325252ULL;
+
+// xorshift64*, as in SimBot
+double uniformRandom()
+{
+	randomState ^= randomState >> 12;
+	randomState ^= randomState << 25;
+	randomState ^= randomState >> 27;
+	return (double)((randomState * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double gaussianRandom()
+{
+	double u = uniformRandom();
+	if (u < 1e-300)
+		u = 1e-300;
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * uniformRandom());
+}
+
+double secondsNow()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// the corridor's centre line, corner to corner counterclockwise from the
+// bottom left
+const double half = corridorWidth / 2;
+const double corners[4][2] = {
+	{outerLeft + half, outerBottom + half}, {outerRight - half, outerBottom + half},
+	{outerRight - half, outerTop - half}, {outerLeft + half, outerTop - half}
+};
+
+// side walls of each leg: outer then inner
+Line sideWalls[4][2];
+
+void makeWalls()
+{
+	double width = corridorWidth;
+	// bottom leg, heading +x: outer y = bottom, inner y = bottom + width
+	sideWalls[0][0].rho = -outerBottom; sideWalls[0][0].alpha = -M_PI / 2;
+	sideWalls[0][1].rho = outerBottom + width; sideWalls[0][1].alpha = M_PI / 2;
+	// right leg, heading +y
+	sideWalls[1][0].rho = outerRight; sideWalls[1][0].alpha = 0.0;
+	sideWalls[1][1].rho = outerRight - width; sideWalls[1][1].alpha = 0.0;
+	// top leg, heading -x
+	sideWalls[2][0].rho = outerTop; sideWalls[2][0].alpha = M_PI / 2;
+	sideWalls[2][1].rho = outerTop - width; sideWalls[2][1].alpha = M_PI / 2;
+	// left leg, heading -y
+	sideWalls[3][0].rho = -outerLeft; sideWalls[3][0].alpha = M_PI;
+	sideWalls[3][1].rho = outerLeft + width; sideWalls[3][1].alpha = 0.0;
+	for (int leg = 0; leg < 4; leg++)
+		for (int i = 0; i < 2; i++)
+			if (sideWalls[leg][i].rho < 0.0)
+			{
+				sideWalls[leg][i].rho = -sideWalls[leg][i].rho;
+				sideWalls[leg][i].alpha = normalizeAngle(sideWalls[leg][i].alpha + M_PI);
+			}
+}
+
+int main(int argc, char** argv)
+{
+	int numPoses = (argc > 1) ? atoi(argv[1]) : 20000;
+	bool batch = (argc > 2) && atoi(argv[2]) != 0;
+	makeWalls();
+	int legSteps[4];
+	for (int leg = 0; leg < 4; leg++)
+	{
+		int next = (leg + 1) % 4;
+		double length = fabs(corners[next][0] - corners[leg][0]) + fabs(corners[next][1] - corners[leg][1]);
+		legSteps[leg] = (int)(length / stepLength + 0.5);
+	}
+	int lapSteps = legSteps[0] + legSteps[1] + legSteps[2] + legSteps[3];
+
+	PoseGraph graph(numPoses, 6 * numPoses, defaultPoseGraphConfig());
+	Pose2D* truth = new Pose2D[numPoses];
+	Pose2D* odometry = new Pose2D[numPoses];
+	int cornerPose[4] = {-1, -1, -1, -1}; // last visit to each corner
+	int firstLapCorner[4] = {-1, -1, -1, -1};
+	int closures = 0;
+
+	printf("%d poses, %d per lap\n", numPoses, lapSteps);
+	printf("%8s %9s %9s %11s %9s %8s %6s %10s %10s", "poses", "mean ms", "max ms",
+	       "eliminated", "uncached", "solved", "front", "L blocks", "update MB");
+	if (batch)
+		printf(" %9s", "batch ms");
+	printf("\n");
+	double blockTime = 0.0, blockMax = 0.0;
+	long blockEliminated = 0, blockUncached = 0, blockSolved = 0;
+	int blockFront = 0;
+	double totalTime = 0.0;
+
+	Pose2D pose = makePose(corners[0][0], corners[0][1], 0.0);
+	Pose2D reported = pose;
+	int leg = 0, legStep = 0, lap = 0;
+	for (int i = 0; i < numPoses; i++)
+	{
+		if (i > 0)
+		{
+			// drive one step along the leg, or turn at its end
+			Pose2D delta = makePose(stepLength, 0.0, 0.0);
+			if (legStep == legSteps[leg])
+			{
+				delta = makePose(0.0, 0.0, M_PI / 2);
+				leg = (leg + 1) % 4;
+				legStep = 0;
+				if (leg == 0)
+					lap++;
+			}
+			else
+				legStep++;
+			pose = composePose(pose, delta);
+			Pose2D measured = makePose(delta.x * distanceScale, 0.0,
+			                           delta.theta * turnScale + headingNoise * gaussianRandom());
+			reported = composePose(reported, measured);
+		}
+		truth[i] = pose;
+		odometry[i] = reported;
+		int id = graph.addPose(reported);
+		for (int w = 0; w < 2 && legStep > 0; w++)
+		{
+			// the wall in the robot's frame as LineFitter would give it
+			const Line& wall = sideWalls[leg][w];
+			double phi = wall.alpha - pose.theta + fitAngleSigma * gaussianRandom();
+			double r = wall.rho - pose.x * cos(wall.alpha) - pose.y * sin(wall.alpha)
+			         + fitDistanceSigma * gaussianRandom();
+			if (fabs(sin(phi)) < 0.5)
+				continue;
+			graph.addWall(id, -cos(phi) / sin(phi), r / sin(phi));
+		}
+		if (legStep == 0)
+		{
+			// at a corner, before turning: recognized if visited before
+			int corner = leg;
+			int previous[2] = {cornerPose[corner], (lap % 8 == 0) ? firstLapCorner[corner] : -1};
+			for (int k = 0; k < 2; k++)
+			{
+				int j = previous[k];
+				if (j < 0 || (k == 1 && j == previous[0]))
+					continue;
+				Pose2D relative = relativePose(truth[j], truth[id]);
+				relative.x += closureTranslationSigma * gaussianRandom();
+				relative.y += closureTranslationSigma * gaussianRandom();
+				relative.theta = normalizeAngle(relative.theta + closureRotationSigma * gaussianRandom());
+				if (graph.addConstraint(j, id, relative, closureTranslationSigma, closureRotationSigma))
+					closures++;
+			}
+			if (cornerPose[corner] == -1 || truth[cornerPose[corner]].theta != pose.theta)
+			{
+				if (firstLapCorner[corner] == -1)
+					firstLapCorner[corner] = id;
+				cornerPose[corner] = id;
+			}
+		}
+
+		double start = secondsNow();
+		graph.update();
+		double elapsed = secondsNow() - start;
+		PoseGraphStats stats;
+		graph.getStats(&stats);
+		totalTime += elapsed;
+		blockTime += elapsed;
+		if (elapsed > blockMax)
+			blockMax = elapsed;
+		blockEliminated += stats.eliminated;
+		blockUncached += stats.uncached;
+		blockSolved += stats.solved;
+		if (stats.maxFront > blockFront)
+			blockFront = stats.maxFront;
+		if ((i + 1) % blockPoses == 0 || i + 1 == numPoses)
+		{
+			int count = (i % blockPoses) + 1;
+			printf("%8d %9.3f %9.3f %11.1f %9.1f %8.1f %6d %10lld %10.1f", i + 1, blockTime / count * 1e3,
+			       blockMax * 1e3, (double)blockEliminated / count, (double)blockUncached / count,
+			       (double)blockSolved / count, blockFront, (long long)stats.factorBlocks,
+			       stats.updateDoubles * 8.0 / 1e6);
+			if (batch)
+			{
+				double batchStart = secondsNow();
+				graph.optimize(1);
+				printf(" %9.1f", (secondsNow() - batchStart) * 1e3);
+			}
+			printf("\n");
+			blockTime = blockMax = 0.0;
+			blockEliminated = blockUncached = blockSolved = 0;
+			blockFront = 0;
+		}
+	}
+
+	// error against the true path
+	double graphSquared = 0.0, odometrySquared = 0.0;
+	for (int i = 0; i < numPoses; i++)
+	{
+		Pose2D estimate = graph.getPose(i);
+		graphSquared += pow(estimate.x - truth[i].x, 2) + pow(estimate.y - truth[i].y, 2);
+		odometrySquared += pow(odometry[i].x - truth[i].x, 2) + pow(odometry[i].y - truth[i].y, 2);
+	}
+	PoseGraphStats stats;
+	graph.getStats(&stats);
+	Pose2D last = graph.getPose(numPoses - 1);
+	printf("%d laps, %d constraints (%d loop closures), %d walls\n", lap, stats.constraints,
+	       closures, stats.walls);
+	printf("total update time %.2f s, %.3f ms per pose\n", totalTime, totalTime / numPoses * 1e3);
+	printf("rms position error: graph %.1f cm, odometry %.1f cm\n",
+	       sqrt(graphSquared / numPoses), sqrt(odometrySquared / numPoses));
+	printf("final pose error: graph %.1f cm, odometry %.1f cm\n",
+	       hypot(last.x - truth[numPoses - 1].x, last.y - truth[numPoses - 1].y),
+	       hypot(odometry[numPoses - 1].x - truth[numPoses - 1].x,
+	             odometry[numPoses - 1].y - truth[numPoses - 1].y));
+	delete[] truth;
+	delete[] odometry;
+	return 0;
+}
@@ -0,0 +1,199 @@
+// rateBench.cpp
+// 10/18/2026
+
+// Compares SerialBot's fixed update rate with AdaptiveRatePolicy over a
+// scripted drive: parked, cruising in the open, driving fast, creeping
+// along a wall, and parked again
+// Two SerialBots, one of each, run side by side on ptys. A child process
+// plays the ATmega328 for both: it answers every command packet with a
+// sensor packet straight away, every sonar reading the distance to the
+// nearest wall that the script has set for the current phase, and the x
+// position echoing the commanded speed so the script can tell when a
+// command has arrived
+// For each phase it reports each bot's exchanges per second and the share
+// of a 9600 baud link they would take up, and at the end how long each bot
+// took to send the command that started Colin moving after parking
+//    rateBench [seconds]
+//    seconds: length of each phase, default 3
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "SerialBot/SerialBot.h"
+
+const int numSonar = 8;
+const int colinBaud = 9600;
+const int numBots = 2;
+
+struct Phase
+{
+	const char* name;
+	int translational; // cm/s
+	double angular; // rad/s
+	int nearest; // cm, the reading every sonar returns
+};
+
+const Phase phases[] = {
+	{"parked", 0, 0.0, 200},
+	{"cruise in the open", 60, 0.0, 200},
+	{"fast in the open", 180, 0.0, 200},
+	{"creeping by a wall", 40, 0.3, 25},
+	{"parked again", 0, 0.0, 25}
+};
+const int numPhases = sizeof(phases) / sizeof(phases[0]);
+
+// runs in the child: answers every command on both ptys until killed
+void serveBots(int* masters, volatile int* nearest)
+{
+	PacketAssembler* assemblers[numBots];
+	struct pollfd fds[numBots];
+	for (int i = 0; i < numBots; i++)
+	{
+		assemblers[i] = new PacketAssembler(commandPacketSize);
+		fds[i].fd = masters[i];
+		fds[i].events = POLLIN;
+	}
+	char data[64];
+	char packet[sensorPacketSize(maxSonar)];
+	while (poll(fds, numBots, -1) > 0)
+		for (int i = 0; i < numBots; i++)
+		{
+			if (!(fds[i].revents & POLLIN))
+				continue;
+			int length = read(masters[i], data, sizeof(data));
+			for (int used = 0; used < length; )
+			{
+				used += assemblers[i]->append(data + used, length - used);
+				if (!assemblers[i]->isComplete())
+					continue;
+				int16_t translational;
+				double angular;
+				decodeCommandPacket(assemblers[i]->getPacket(), &translational, &angular);
+				assemblers[i]->reset();
+				SensorPacket sensors;
+				memset(&sensors, 0, sizeof(sensors));
+				sensors.numSonar = numSonar;
+				sensors.x = translational;
+				for (int s = 0; s < numSonar; s++)
+					sensors.distances[s] = *nearest;
+				encodeSensorPacket(packet, sensors);
+				if (write(masters[i], packet, sensorPacketSize(numSonar)) < 0)
+					_exit(1);
+			}
+		}
+}
+
+void* commFunction(void* bot)
+{
+	((SerialBot*)bot)->commThreadFunction();
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	double seconds = (argc > 1) ? atof(argv[1]) : 3.0;
+	volatile int* nearest = (volatile int*)mmap(NULL, sizeof(int), PROT_READ | PROT_WRITE,
+	                                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	*nearest = phases[0].nearest;
+	int masters[numBots];
+	char* devices[numBots];
+	for (int i = 0; i < numBots; i++)
+	{
+		masters[i] = posix_openpt(O_RDWR | O_NOCTTY);
+		if (masters[i] == -1 || grantpt(masters[i]) != 0 || unlockpt(masters[i]) != 0)
+		{
+			perror("posix_openpt");
+			return 1;
+		}
+		devices[i] = strdup(ptsname(masters[i]));
+	}
+	pid_t child = fork();
+	if (child == 0)
+	{
+		serveBots(masters, nearest);
+		_exit(0);
+	}
+
+	SerialBot* bots[numBots];
+	const char* names[numBots] = {"fixed", "adaptive"};
+	AdaptiveRatePolicy policy(defaultAdaptiveRateConfig(), colinBaud, numSonar);
+	for (int i = 0; i < numBots; i++)
+	{
+		SerialBotConfig config = defaultSerialBotConfig();
+		config.device = devices[i];
+		config.numSonar = numSonar;
+		config.resetPin = -1;
+		bots[i] = new SerialBot(config);
+	}
+	bots[1]->setRatePolicy(&policy);
+	printf("adaptive: %d ms at fastest (link limit %d ms), %d ms cruising, %d ms idle\n",
+	       policy.getMinPeriod() / 1000, minLinkPeriod(colinBaud, numSonar, 1.0) / 1000,
+	       defaultAdaptiveRateConfig().cruisePeriod / 1000, defaultAdaptiveRateConfig().idlePeriod / 1000);
+	pthread_t threads[numBots];
+	for (int i = 0; i < numBots; i++)
+	{
+		pthread_create(&threads[i], NULL, commFunction, bots[i]);
+		pthread_detach(threads[i]);
+	}
+
+	// half a fixed period out of step with the bots, so a command waits
+	// for the fixed bot's next exchange as long as it does on average
+	usleep(defaultSerialBotConfig().readPeriod / 2);
+	double linkSeconds = (double)(commandPacketSize + sensorPacketSize(numSonar)) * 10 / colinBaud;
+	double startDelay[numBots];
+	uint32_t totals[numBots] = {0, 0};
+	printf("%-20s %18s %18s\n", "", "fixed", "adaptive");
+	for (int p = 0; p < numPhases; p++)
+	{
+		*nearest = phases[p].nearest;
+		uint32_t before[numBots];
+		for (int i = 0; i < numBots; i++)
+			before[i] = bots[i]->getFramesReceived();
+		int64_t start = monotonicNanos();
+		for (int i = 0; i < numBots; i++)
+			bots[i]->setSpeed(phases[p].translational, phases[p].angular);
+		if (p > 0 && phases[p - 1].translational == 0 && phases[p].translational != 0)
+		{
+			for (int i = 0; i < numBots; i++)
+				startDelay[i] = -1.0;
+			for (int started = 0; started < numBots; )
+			{
+				usleep(500);
+				for (int i = 0; i < numBots; i++)
+				{
+					int x, y;
+					double theta;
+					bots[i]->getPose(&x, &y, &theta);
+					if (startDelay[i] < 0.0 && x == phases[p].translational)
+					{
+						startDelay[i] = (monotonicNanos() - start) / 1e6;
+						started++;
+					}
+				}
+			}
+		}
+		usleep((useconds_t)((seconds - (monotonicNanos() - start) / 1e9) * 1e6));
+		double elapsed = (monotonicNanos() - start) / 1e9;
+		printf("%-20s", phases[p].name);
+		for (int i = 0; i < numBots; i++)
+		{
+			uint32_t frames = bots[i]->getFramesReceived() - before[i];
+			totals[i] += frames;
+			printf("  %5.1f/s %5.1f%% link", frames / elapsed, 100.0 * frames * linkSeconds / elapsed);
+		}
+		printf("\n");
+	}
+	printf("%-20s %13u exchanges %8u exchanges\n", "total", totals[0], totals[1]);
+	for (int i = 0; i < numBots; i++)
+		printf("%s: started moving %.1f ms after the command\n", names[i], startDelay[i]);
+	kill(child, SIGKILL);
+	waitpid(child, NULL, 0);
+	return 0;
+}
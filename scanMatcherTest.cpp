@@ -0,0 +1,95 @@
+// scanMatcherTest.cpp
+// 10/18/2026
+
+// program to test the scan matching class
+// drives a virtual Colin around a loop in a rectangular room twice, once
+// with exact odometry and once with odometry that over-reports distance
+// by 3% and drifts in heading, and compares the scan matched pose and the
+// raw odometry against ground truth
+
+#include <stdio.h>
+#include <time.h>
+#include "ScanMatching/ScanMatcher.h"
+
+using namespace std;
+
+const int numSonar = 8;
+// angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const double roomWidth = 600.0;
+const double roomHeight = 400.0;
+const double maxRange = 300.0;
+const int numSteps = 800;
+
+// distance from (x, y) along angle to the nearest room wall
+double rangeToWall(double x, double y, double angle)
+{
+	double c = cos(angle);
+	double s = sin(angle);
+	double best = 1e9;
+	if (c > 1e-9)
+		best = fmin(best, (roomWidth - x) / c);
+	if (c < -1e-9)
+		best = fmin(best, -x / c);
+	if (s > 1e-9)
+		best = fmin(best, (roomHeight - y) / s);
+	if (s < -1e-9)
+		best = fmin(best, -y / s);
+	return best;
+}
+
+// pose on an ellipse around the middle of the room
+Pose2D truePose(int step)
+{
+	double t = 2.0 * M_PI * (step % 400) / 400.0;
+	return makePose(roomWidth / 2 + 180.0 * cos(t), roomHeight / 2 + 100.0 * sin(t),
+	                normalizeAngle(t + M_PI / 2));
+}
+
+void runTest(const char* label, double distanceScale, double headingDrift)
+{
+	ScanMatcher matcher(400, 30.0f);
+	Pose2D odometry = truePose(0);
+	double matchError = 0.0, odometryError = 0.0, seconds = 0.0;
+	int matched = 0;
+	for (int step = 0; step < numSteps; step++)
+	{
+		if (step > 0)
+		{
+			Pose2D delta = relativePose(truePose(step - 1), truePose(step));
+			delta.x *= distanceScale;
+			delta.theta += headingDrift;
+			odometry = composePose(odometry, delta);
+		}
+		Pose2D truth = truePose(step);
+		Point points[numSonar];
+		int numPoints = 0;
+		for (int s = 0; s < numSonar; s++)
+		{
+			double range = rangeToWall(truth.x, truth.y, truth.theta + sensorAngles[s]);
+			if (range < maxRange)
+				points[numPoints++].setCoordinates((int)range, sensorAngles[s]);
+		}
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		ScanMatchResult result = matcher.processScan(points, numPoints, odometry);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+		matchError += hypot(result.pose.x - truth.x, result.pose.y - truth.y);
+		odometryError += hypot(odometry.x - truth.x, odometry.y - truth.y);
+		if (result.matched)
+			matched++;
+	}
+	printf("%-10s mean error: matched %6.1f cm, odometry %6.1f cm, %d/%d scans matched, %.1f us/scan\n",
+	       label, matchError / numSteps, odometryError / numSteps, matched, numSteps,
+	       seconds / numSteps * 1e6);
+}
+
+int main()
+{
+	runTest("exact", 1.0, 0.0);
+	runTest("drifting", 1.03, 0.002);
+	return 0;
+}
@@ -3,14 +3,19 @@
 // 11/30/2016
 
 // testing for the SerialBot class
+// -u also serves commands on a Unix domain socket (CommandServer), so
+// other programs can drive Colin while this one prompts for speeds:
+//    serialBotTest [-u socketPath]
 
-#include "SerialBot.h"
+#include "SerialBot/SerialBot.h"
+#include "CommandServer/CommandServer.h"
 #include <pthread.h>
 
 using namespace std;
 
 SerialBot colin;
 pthread_t commThread;
+TelemetryWriter telemetry; // frames for the server's subscribers
 
 void* threadFunction(void* args)
 {
@@ -51,11 +56,24 @@ void getPose()
 	cout << "      x = " << x << endl;
 	cout << "      y = " << y << endl;
 	cout << "  theta = " << theta << endl;
+	cout << "Readings are " << colin.getSnapshotAge() / 1000000 << " ms old, "
+	     << colin.getTimeouts() << " exchanges timed out" << endl;
 	cout << endl;
 }
 
-int main()
+int main(int argc, char** argv)
 {
+	CommandServer server(&colin, 16);
+	if (argc > 2 && strcmp(argv[1], "-u") == 0)
+	{
+		if (telemetry.open(defaultTelemetryName, defaultTelemetryCapacity))
+		{
+			colin.setTelemetry(&telemetry);
+			server.setTelemetry(defaultTelemetryName);
+		}
+		if (!server.open(argv[2]) || !server.start())
+			cerr << "unable to serve commands on " << argv[2] << endl;
+	}
 	pthread_create(&commThread, NULL, threadFunction, NULL);
 	while (true)
 	{
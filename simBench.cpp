@@ -0,0 +1,123 @@
+// simBench.cpp
+// 10/18/2026
+
+// Benchmarks the simulator (SimBot) and checks it is deterministic
+// Drives a simulated Colin around a world with a simple reactive
+// controller (drive forward, turn away from the nearest reading ahead)
+// for a stretch of simulated time, stepping as fast as possible, and
+// reports how much faster than real time it ran, the collisions, and how
+// far odometry drifted from the true pose. The run is then repeated with
+// the same seed and its frames must match the first run exactly
+//    simBench [worldFile] [seconds]
+// without a world file, a 6 m x 4 m room with a box in it is used
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "Sim/SimBot.h"
+
+const int numSonar = 8;
+// angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
+const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const int cruiseSpeed = 100; // cm/s
+const double avoidDistance = 60.0; // cm, turn away from readings nearer than this
+const uint64_t seed = 12345;
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+void buildRoom(World* world)
+{
+	const double roomXs[] = {0.0, 600.0, 600.0, 0.0};
+	const double roomYs[] = {0.0, 0.0, 400.0, 400.0};
+	const double boxXs[] = {250.0, 350.0, 350.0, 250.0};
+	const double boxYs[] = {150.0, 150.0, 250.0, 250.0};
+	world->addPolygon(roomXs, roomYs, 4);
+	world->addPolygon(boxXs, boxYs, 4);
+	world->setStart(makePose(100.0, 100.0, 0.0));
+}
+
+// the three forward sonars steer, each frame
+void control(SimBot* bot, const SensorFrame& frame)
+{
+	int front = frame.distances[0];
+	int right = frame.distances[1];
+	int left = frame.distances[7];
+	double angular = 0.0;
+	int trans = cruiseSpeed;
+	if (front > 0 && front < avoidDistance)
+	{
+		trans = cruiseSpeed / 4;
+		angular = (right > 0 && (left == 0 || right < left)) ? 1.5 : -1.5;
+	}
+	else if (right > 0 && right < avoidDistance)
+		angular = 0.8;
+	else if (left > 0 && left < avoidDistance)
+		angular = -0.8;
+	bot->setSpeed(trans, angular);
+}
+
+// runs the simulation and returns a checksum of every frame
+uint64_t run(World* world, double seconds, bool report)
+{
+	SimBot bot(world, sensorAngles, numSonar, world->getStart(), seed);
+	SpscQueue<SensorFrame> frames(4);
+	bot.setFrameQueue(&frames);
+	long steps = 0;
+	uint64_t checksum = 1469598103934665603ULL;
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while (bot.getSimTime() < seconds)
+	{
+		steps++;
+		if (!bot.step())
+			continue;
+		SensorFrame frame;
+		while (frames.tryPop(frame))
+		{
+			for (int i = 0; i < frame.numSonar; i++)
+				checksum = (checksum ^ (uint16_t)frame.distances[i]) * 1099511628211ULL;
+			checksum = (checksum ^ (uint16_t)frame.x) * 1099511628211ULL;
+			checksum = (checksum ^ (uint16_t)frame.y) * 1099511628211ULL;
+			control(&bot, frame);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (report)
+	{
+		double wall = elapsedSeconds(start, end);
+		Pose2D truth = bot.getTruePose();
+		Pose2D odometry = bot.getOdometryPose();
+		printf("%.0f s simulated in %.3f s: %.0f steps/s, %.0fx real time\n",
+		       seconds, wall, steps / wall, seconds / wall);
+		printf("%u frames, %u collisions\n", bot.getFramesReceived(), bot.getCollisions());
+		printf("true pose (%.0f, %.0f, %.2f), odometry (%.0f, %.0f, %.2f), drift %.0f cm\n",
+		       truth.x, truth.y, truth.theta, odometry.x, odometry.y, odometry.theta,
+		       hypot(truth.x - odometry.x, truth.y - odometry.y));
+	}
+	return checksum;
+}
+
+int main(int argc, char** argv)
+{
+	World world(1024);
+	if (argc > 1)
+	{
+		if (!world.load(argv[1]))
+		{
+			printf("unable to load world %s\n", argv[1]);
+			return 1;
+		}
+	}
+	else
+		buildRoom(&world);
+	double seconds = (argc > 2) ? atof(argv[2]) : 3600.0;
+	printf("%d wall segments\n", world.getNumSegments());
+	uint64_t first = run(&world, seconds, true);
+	uint64_t second = run(&world, seconds, false);
+	printf("repeat run %s\n", (first == second) ? "identical" : "DIFFERS");
+	return (first == second) ? 0 : 1;
+}
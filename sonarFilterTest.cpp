@@ -0,0 +1,56 @@
+// sonarFilterTest.cpp
+// 10/18/2026
+
+// program to test the sonar filtering class
+// feeds a scripted sequence of scans with spurious echoes and dropouts
+// through the filter, prints the results, then times the filter
+
+#include <stdio.h>
+#include <time.h>
+#include "SonarFilter/SonarFilter.h"
+
+using namespace std;
+
+const int numScans = 12;
+const int timingScans = 1000000;
+
+double secondsNow()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main()
+{
+	SonarFilter filter(300.0f);
+	FilteredScan filtered;
+	int16_t scan[sonarChannels];
+
+	printf("scan | raw ch0 ch2 ch6 | filtered ch0 ch2 ch6 | confidence ch0 ch2 ch6\n");
+	for (int i = 0; i < numScans; i++)
+	{
+		for (int c = 0; c < sonarChannels; c++)
+			scan[c] = 100 + 10 * c;
+		scan[0] -= 2 * i; // approaching obstacle
+		if (i == 4)
+			scan[2] = 15; // spurious echo
+		if (i >= 6 && i <= 8)
+			scan[6] = 0; // dropouts
+		filter.update(scan, &filtered);
+		printf("%4d | %4d %4d %4d | %6.1f %6.1f %6.1f | %4.2f %4.2f %4.2f\n", i,
+		       scan[0], scan[2], scan[6],
+		       filtered.range[0], filtered.range[2], filtered.range[6],
+		       filtered.confidence[0], filtered.confidence[2], filtered.confidence[6]);
+	}
+
+	double start = secondsNow();
+	for (int i = 0; i < timingScans; i++)
+	{
+		scan[i & 7] = (int16_t)(50 + (i & 127));
+		filter.update(scan, &filtered);
+	}
+	double elapsed = secondsNow() - start;
+	printf("\n%.1f ns per scan (%d scans)\n", elapsed / timingScans * 1e9, timingScans);
+	return 0;
+}
@@ -0,0 +1,195 @@
+// telemetryBench.cpp
+// 10/18/2026
+
+// Benchmarks the shared memory telemetry ring (Telemetry/TelemetryRing.h)
+// First measures what publishing costs the comm thread with nobody
+// reading, then forks reader processes that follow the ring while the
+// writer publishes at a fixed rate, and reports each reader's throughput,
+// the records it missed because the writer lapped it, and the latency from
+// publish to read (both sides stamp CLOCK_MONOTONIC)
+// The writer's cost should be the same with any number of readers
+//    telemetryBench [readers] [records] [rate]
+//    readers: reader processes, default 4
+//    records: records published while they read, default 100000
+//    rate: records per second, 0 publishes as fast as possible, default 20000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <vector>
+#include "Telemetry/TelemetryWriter.h"
+#include "Telemetry/TelemetryReader.h"
+#include "Pipeline/PipelineStage.h" // monotonicNanos
+#include "RealTime/RealTime.h"
+
+const char benchName[] = "/colin_telemetry_bench";
+const int capacity = 4096;
+const int costRecords = 1000000;
+const int batch = 100; // records published per timer tick when paced
+
+struct ReaderResult
+{
+	uint64_t received;
+	uint64_t missed;
+	double seconds;
+	int64_t p50, p99, max; // latency in ns
+};
+
+SensorFrame makeFrame(uint32_t sequence)
+{
+	SensorFrame frame;
+	frame.sequence = sequence;
+	frame.timestamp = 0;
+	frame.sampledAt = 0;
+	frame.commandAt = 0;
+	frame.numSonar = 8;
+	for (int i = 0; i < maxSonar; i++)
+		frame.distances[i] = (int16_t)(sequence + i);
+	frame.x = (int16_t)sequence;
+	frame.y = 0;
+	frame.theta = 0.0;
+	frame.translational = 100;
+	frame.angular = 0.0;
+	return frame;
+}
+
+// follows the ring until the writer has published total records and
+// everything reachable has been read
+ReaderResult runReader(uint64_t total, int readyFd)
+{
+	ReaderResult result = {0, 0, 0.0, 0, 0, 0};
+	TelemetryReader reader;
+	if (!reader.open(benchName))
+	{
+		fprintf(stderr, "reader: unable to open %s\n", benchName);
+		return result;
+	}
+	reader.skipToLatest();
+	std::vector<int64_t> latencies;
+	latencies.reserve(total);
+	char ready = 1;
+	if (write(readyFd, &ready, 1) != 1)
+		return result;
+	int64_t start = 0;
+	TelemetryRecord record;
+	uint32_t lastSequence = 0;
+	bool ordered = true;
+	while (true)
+	{
+		if (reader.next(&record) == 0)
+		{
+			if (reader.getPublished() >= total)
+				break;
+			sched_yield();
+			continue;
+		}
+		int64_t now = monotonicNanos();
+		if (start == 0)
+			start = now;
+		latencies.push_back(now - record.timestamp);
+		if (record.frame.sequence <= lastSequence && lastSequence != 0)
+			ordered = false;
+		if (record.frame.distances[7] != (int16_t)(record.frame.sequence + 7))
+			ordered = false; // a torn copy got through
+		lastSequence = record.frame.sequence;
+	}
+	if (!ordered)
+		fprintf(stderr, "reader: records out of order or torn\n");
+	result.received = latencies.size();
+	result.missed = reader.getMissed();
+	result.seconds = (monotonicNanos() - start) / 1e9;
+	if (!latencies.empty())
+	{
+		std::sort(latencies.begin(), latencies.end());
+		result.p50 = latencies[latencies.size() / 2];
+		result.p99 = latencies[latencies.size() * 99 / 100];
+		result.max = latencies.back();
+	}
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	int numReaders = (argc > 1) ? atoi(argv[1]) : 4;
+	uint64_t records = (argc > 2) ? atoll(argv[2]) : 100000;
+	double rate = (argc > 3) ? atof(argv[3]) : 20000.0;
+
+	TelemetryWriter writer;
+	if (!writer.open(benchName, capacity))
+	{
+		fprintf(stderr, "unable to create %s\n", benchName);
+		return 1;
+	}
+	SensorFrame frame = makeFrame(1);
+	int64_t start = monotonicNanos();
+	for (int i = 0; i < costRecords; i++)
+	{
+		frame.sequence = i + 1;
+		writer.publishFrame(frame);
+	}
+	double publishNanos = (double)(monotonicNanos() - start) / costRecords;
+	printf("publish with no readers: %.1f ns/record, %zu byte records\n",
+	       publishNanos, sizeof(TelemetryRecord));
+
+	// a fresh ring, so readers count from zero
+	writer.open(benchName, capacity);
+	int readyPipe[2], resultPipe[2];
+	if (pipe(readyPipe) != 0 || pipe(resultPipe) != 0)
+		return 1;
+	std::vector<pid_t> children;
+	for (int r = 0; r < numReaders; r++)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			ReaderResult result = runReader(records, readyPipe[1]);
+			if (write(resultPipe[1], &result, sizeof(result)) != sizeof(result))
+				_exit(1);
+			_exit(0);
+		}
+		children.push_back(pid);
+	}
+	for (int r = 0; r < numReaders; r++)
+	{
+		char ready;
+		if (read(readyPipe[0], &ready, 1) != 1)
+			return 1;
+	}
+
+	PeriodicTimer timer((rate > 0.0) ? (int64_t)(batch * 1e9 / rate) : 1);
+	timer.start();
+	start = monotonicNanos();
+	int64_t publishTotal = 0;
+	for (uint64_t i = 0; i < records; i++)
+	{
+		frame = makeFrame((uint32_t)(i + 1));
+		int64_t before = monotonicNanos();
+		writer.publishFrame(frame);
+		publishTotal += monotonicNanos() - before;
+		if (rate > 0.0 && (i + 1) % batch == 0)
+			timer.wait();
+	}
+	double seconds = (monotonicNanos() - start) / 1e9;
+	printf("published %llu records in %.3f s with %d readers: %.1f ns/record\n",
+	       (unsigned long long)records, seconds, numReaders, (double)publishTotal / records);
+
+	for (int r = 0; r < numReaders; r++)
+	{
+		ReaderResult result;
+		if (read(resultPipe[0], &result, sizeof(result)) != sizeof(result))
+		{
+			fprintf(stderr, "reader %d failed\n", r);
+			continue;
+		}
+		printf("reader %d: %llu read, %llu missed, %.0f records/s, latency p50 %.1f us p99 %.1f us max %.1f us\n",
+		       r, (unsigned long long)result.received, (unsigned long long)result.missed,
+		       (result.seconds > 0.0) ? result.received / result.seconds : 0.0,
+		       result.p50 / 1e3, result.p99 / 1e3, result.max / 1e3);
+	}
+	for (size_t i = 0; i < children.size(); i++)
+		waitpid(children[i], NULL, 0);
+	return 0;
+}
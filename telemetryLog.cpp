@@ -0,0 +1,601 @@
+// telemetryLog.cpp
+// 10/18/2026
+
+// Keeps Colin's telemetry in columnar log files (TelemetryLog/TelemetryLog.h)
+// and answers questions about them offline
+//    record:   follows the shared memory telemetry ring and logs every
+//              frame and command until interrupted
+//    convert:  turns a raw dump of the sensor packets SerialBot reads (the
+//              bytes from the serial port, packets back to back) into a
+//              log; a dump has no times, so frames are stamped a period
+//              apart, and has no commands
+//    info:     tables, blocks, rows and time span
+//    dropout:  fraction of each sonar's readings that returned no echo
+//    residual: distribution of the rms distance of each scan's readings
+//              from the single line fitted to them, the fit the wall
+//              follower makes before accumulating points
+//    latency:  distribution of the time from each command being sent to
+//              the sensor packet answering it, and the link delay
+//              estimate the frames were stamped with
+// Queries find the blocks overlapping the time range from the log's index,
+// read only the columns they need, and spread blocks across threads with
+// a ThreadPool; each chunk of blocks is reduced locally and merged at the
+// end. Blocks wholly inside the range skip the timestamp column, and
+// dropout skips any sonar column whose block minimum shows it has no
+// zeros
+
+// usage:
+//    telemetryLog record [-r ring] [-b blockRows] logFile
+//    telemetryLog convert [-s numSonar] [-p periodMs] [-b blockRows] dumpFile logFile
+//    telemetryLog info logFile
+//    telemetryLog dropout|residual|latency [-f seconds] [-t seconds] [-n threads] logFile
+//    -r: telemetry ring name, /colin_telemetry by default
+//    -b: rows per block, default 4096
+//    -s: sonars per sensor packet, default 8
+//    -p: ms between packets in the dump, default 250
+//    -f, -t: only rows from / to this many seconds after the log starts
+//    -n: threads, default every cpu
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <math.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "TelemetryLog/TelemetryLogWriter.h"
+#include "TelemetryLog/TelemetryLogReader.h"
+#include "Telemetry/TelemetryReader.h"
+#include "SerialBot/PacketCodec.h"
+#include "LineFitter/LineFitter.h"
+#include "LineFitter/Point.h"
+#include "ThreadPool/ThreadPool.h"
+
+// same as wall_follow_single_line
+const int colinSonar = 8;
+const double colinSensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
+const int maxRange = 300;
+
+const int pollPeriod = 5000; // us between ring polls when nothing is new
+const int dumpChunk = 65536; // bytes read from a dump at a time
+const int minFitPoints = 3; // scans with fewer readings aren't fitted
+const double residualBin = 0.5; // cm
+const int residualBins = 400;
+const double latencyBin = 0.1; // ms
+const int latencyBins = 10000;
+
+volatile sig_atomic_t running = 1;
+
+void stopRecording(int signal)
+{
+	running = 0;
+}
+
+double elapsedSeconds(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int record(const char* ring, int blockRows, const char* logFile)
+{
+	TelemetryReader reader;
+	if (!reader.open(ring))
+	{
+		fprintf(stderr, "unable to open telemetry %s\n", ring);
+		return 1;
+	}
+	TelemetryLogWriter log(blockRows);
+	if (!log.open(logFile, colinSonar, colinSensorAngles))
+	{
+		fprintf(stderr, "unable to create %s\n", logFile);
+		return 1;
+	}
+	signal(SIGINT, stopRecording);
+	signal(SIGTERM, stopRecording);
+	TelemetryRecord record;
+	while (running)
+	{
+		if (reader.next(&record) == 0)
+			usleep(pollPeriod);
+		else
+			log.addRecord(record);
+	}
+	uint64_t frames = log.getRows(logFrames), commands = log.getRows(logCommands);
+	if (!log.close())
+	{
+		fprintf(stderr, "error writing %s\n", logFile);
+		return 1;
+	}
+	printf("%llu frames, %llu commands, %llu records missed\n", (unsigned long long)frames,
+	       (unsigned long long)commands, (unsigned long long)reader.getMissed());
+	return 0;
+}
+
+int convert(const char* dumpFile, const char* logFile, int numSonar, double period, int blockRows)
+{
+	FILE* dump = fopen(dumpFile, "rb");
+	if (dump == NULL)
+	{
+		fprintf(stderr, "unable to open %s\n", dumpFile);
+		return 1;
+	}
+	TelemetryLogWriter log(blockRows);
+	if (!log.open(logFile, numSonar, (numSonar == colinSonar) ? colinSensorAngles : NULL))
+	{
+		fprintf(stderr, "unable to create %s\n", logFile);
+		fclose(dump);
+		return 1;
+	}
+	PacketAssembler assembler(sensorPacketSize(numSonar));
+	int64_t periodNanos = (int64_t)llround(period * 1e6);
+	char* data = new char[dumpChunk];
+	uint32_t frames = 0;
+	size_t length;
+	while ((length = fread(data, 1, dumpChunk, dump)) > 0)
+	{
+		for (size_t used = 0; used < length; )
+		{
+			used += assembler.append(data + used, length - used);
+			if (!assembler.isComplete())
+				continue;
+			SensorPacket sensors;
+			decodeSensorPacket(assembler.getPacket(), numSonar, &sensors);
+			assembler.reset();
+			SensorFrame frame;
+			memset(&frame, 0, sizeof(frame));
+			frame.sequence = ++frames;
+			frame.timestamp = frames * periodNanos;
+			frame.sampledAt = frame.timestamp;
+			frame.commandAt = frame.timestamp + periodNanos;
+			frame.numSonar = numSonar;
+			for (int i = 0; i < numSonar; i++)
+				frame.distances[i] = sensors.distances[i];
+			frame.x = sensors.x;
+			frame.y = sensors.y;
+			frame.theta = sensors.theta;
+			log.addFrame(frame);
+		}
+	}
+	delete [] data;
+	fclose(dump);
+	if (assembler.getLength() > 0)
+		printf("dropped %d trailing bytes of an incomplete packet\n", assembler.getLength());
+	if (!log.close())
+	{
+		fprintf(stderr, "error writing %s\n", logFile);
+		return 1;
+	}
+	printf("%u frames\n", frames);
+	return 0;
+}
+
+int info(TelemetryLogReader& log)
+{
+	const char* names[] = {"frames", "commands"};
+	int64_t start = log.getStartTime();
+	printf("%d sonars, %.1f s from %.3f s\n", log.getNumSonar(),
+	       (log.getEndTime() - start) / 1e9, start / 1e9);
+	for (int t = 0; t < numLogTables; t++)
+	{
+		printf("%-9s %10llu rows in %6d blocks", names[t],
+		       (unsigned long long)log.getRows(t), log.getNumBlocks(t));
+		if (log.getNumBlocks(t) > 0)
+			printf(", %.3f s to %.3f s", (log.getBlock(t, 0).firstTime - start) / 1e9,
+			       (log.getBlock(t, log.getNumBlocks(t) - 1).lastTime - start) / 1e9);
+		printf("\n");
+	}
+	return 0;
+}
+
+// what every query shares; each query's totals follow it in its own struct
+struct Query
+{
+	TelemetryLogReader* log;
+	int64_t from, to; // ns
+	int firstBlock;
+	pthread_mutex_t lock; // guards the totals
+	uint64_t rows; // rows in range
+	uint64_t bytes; // column bytes read
+};
+
+// rows of a frame block inside the range; times is only read for blocks
+// that straddle an end of it
+bool inRange(const Query& query, const LogBlock& block, const int64_t* times, int row)
+{
+	if (block.firstTime >= query.from && block.lastTime <= query.to)
+		return true;
+	return times[row] >= query.from && times[row] <= query.to;
+}
+
+const int64_t* rangeTimes(Query& query, const LogBlock& block, uint64_t* bytes)
+{
+	if (block.firstTime >= query.from && block.lastTime <= query.to)
+		return NULL;
+	*bytes += (uint64_t)block.rows * 8;
+	return query.log->getColumn64(block, frameTimestamp);
+}
+
+struct DropoutQuery
+{
+	Query query;
+	uint64_t readings[maxSonar];
+	uint64_t dropouts[maxSonar];
+};
+
+void dropoutChunk(int begin, int end, void* arg)
+{
+	DropoutQuery* dropout = (DropoutQuery*)arg;
+	Query& query = dropout->query;
+	int numSonar = query.log->getNumSonar();
+	uint64_t readings[maxSonar], dropouts[maxSonar], rows = 0, bytes = 0;
+	memset(readings, 0, sizeof(readings));
+	memset(dropouts, 0, sizeof(dropouts));
+	for (int b = begin; b < end; b++)
+	{
+		const LogBlock& block = query.log->getBlock(logFrames, query.firstBlock + b);
+		const int64_t* times = rangeTimes(query, block, &bytes);
+		uint64_t blockRows = 0;
+		for (int r = 0; r < block.rows; r++)
+			if (times == NULL || inRange(query, block, times, r))
+				blockRows++;
+		rows += blockRows;
+		for (int i = 0; i < numSonar; i++)
+		{
+			readings[i] += blockRows;
+			const LogColumn& column = block.columns[frameDistance0 + i];
+			if (column.min > 0)
+				continue;
+			if (column.max == 0 && times == NULL)
+			{
+				dropouts[i] += blockRows;
+				continue;
+			}
+			const int16_t* distances = query.log->getColumn16(block, frameDistance0 + i);
+			bytes += (uint64_t)block.rows * 2;
+			for (int r = 0; r < block.rows; r++)
+				if (distances[r] == 0 && (times == NULL || inRange(query, block, times, r)))
+					dropouts[i]++;
+		}
+	}
+	pthread_mutex_lock(&query.lock);
+	for (int i = 0; i < numSonar; i++)
+	{
+		dropout->readings[i] += readings[i];
+		dropout->dropouts[i] += dropouts[i];
+	}
+	query.rows += rows;
+	query.bytes += bytes;
+	pthread_mutex_unlock(&query.lock);
+}
+
+struct ResidualQuery
+{
+	Query query;
+	uint64_t histogram[residualBins + 1]; // the last bin holds everything beyond
+	uint64_t fits;
+	double sum;
+};
+
+// rms perpendicular distance of the readings from the line fitted to them
+void residualChunk(int begin, int end, void* arg)
+{
+	ResidualQuery* residual = (ResidualQuery*)arg;
+	Query& query = residual->query;
+	int numSonar = query.log->getNumSonar();
+	Point points[maxSonar];
+	LineFitter line(points, maxSonar);
+	uint64_t* histogram = new uint64_t[residualBins + 1];
+	memset(histogram, 0, sizeof(uint64_t) * (residualBins + 1));
+	uint64_t fits = 0, rows = 0, bytes = 0;
+	double sum = 0.0;
+	for (int b = begin; b < end; b++)
+	{
+		const LogBlock& block = query.log->getBlock(logFrames, query.firstBlock + b);
+		const int64_t* times = rangeTimes(query, block, &bytes);
+		const int16_t* distances[maxSonar];
+		for (int i = 0; i < numSonar; i++)
+			distances[i] = query.log->getColumn16(block, frameDistance0 + i);
+		bytes += (uint64_t)block.rows * 2 * numSonar;
+		for (int r = 0; r < block.rows; r++)
+		{
+			if (times != NULL && !inRange(query, block, times, r))
+				continue;
+			rows++;
+			int numPoints = 0;
+			for (int i = 0; i < numSonar; i++)
+			{
+				int16_t distance = distances[i][r];
+				if (distance > 0 && distance < maxRange)
+					points[numPoints++].setCoordinates(distance, query.log->getSensorAngle(i));
+			}
+			if (numPoints < minFitPoints)
+				continue;
+			line.setPoints(points, numPoints);
+			line.updateLine();
+			double m = line.getM(), intercept = line.getB();
+			double squared = 0.0;
+			for (int p = 0; p < numPoints; p++)
+			{
+				double error = m * points[p].getX() - points[p].getY() + intercept;
+				squared += error * error / (1.0 + m * m);
+			}
+			double rms = sqrt(squared / numPoints);
+			int bin = (int)(rms / residualBin);
+			histogram[(bin < residualBins) ? bin : residualBins]++;
+			sum += rms;
+			fits++;
+		}
+	}
+	pthread_mutex_lock(&query.lock);
+	for (int i = 0; i <= residualBins; i++)
+		residual->histogram[i] += histogram[i];
+	residual->fits += fits;
+	residual->sum += sum;
+	query.rows += rows;
+	query.bytes += bytes;
+	pthread_mutex_unlock(&query.lock);
+	delete [] histogram;
+}
+
+struct LatencyQuery
+{
+	Query query;
+	uint64_t histogram[latencyBins + 1];
+	uint64_t matched;
+	double sum;
+	double estimateSum; // frames' own round trip estimate
+};
+
+// last command sent at or before time, as a block and row; false if none
+bool findCommand(TelemetryLogReader* log, int64_t time, int* block, int* row)
+{
+	int first, last;
+	if (!log->findBlocks(logCommands, INT64_MIN, time, &first, &last))
+		return false;
+	const LogBlock& found = log->getBlock(logCommands, last);
+	const int64_t* times = log->getColumn64(found, commandTimestamp);
+	int low = 0, high = found.rows;
+	while (low < high)
+	{
+		int middle = (low + high) / 2;
+		if (times[middle] <= time)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if (low == 0)
+		return false;
+	*block = last;
+	*row = low - 1;
+	return true;
+}
+
+// frames are in time order, so after one search per block the matching
+// command is found by walking forward
+void latencyChunk(int begin, int end, void* arg)
+{
+	LatencyQuery* latency = (LatencyQuery*)arg;
+	Query& query = latency->query;
+	TelemetryLogReader* log = query.log;
+	uint64_t* histogram = new uint64_t[latencyBins + 1];
+	memset(histogram, 0, sizeof(uint64_t) * (latencyBins + 1));
+	uint64_t matched = 0, rows = 0, bytes = 0;
+	double sum = 0.0, estimateSum = 0.0;
+	for (int b = begin; b < end; b++)
+	{
+		const LogBlock& block = log->getBlock(logFrames, query.firstBlock + b);
+		const int64_t* times = log->getColumn64(block, frameTimestamp);
+		const int64_t* sampled = log->getColumn64(block, frameSampledAt);
+		bytes += (uint64_t)block.rows * 16;
+		int commandBlock, commandRow;
+		bool haveCommand = findCommand(log, block.firstTime, &commandBlock, &commandRow);
+		for (int r = 0; r < block.rows; r++)
+		{
+			if (times[r] < query.from || times[r] > query.to)
+				continue;
+			rows++;
+			estimateSum += 2.0 * (times[r] - sampled[r]) / 1e6;
+			if (!haveCommand)
+			{
+				haveCommand = findCommand(log, times[r], &commandBlock, &commandRow);
+				if (!haveCommand)
+					continue;
+			}
+			// step to the last command at or before this frame
+			while (true)
+			{
+				const LogBlock* commands = &log->getBlock(logCommands, commandBlock);
+				int nextBlock = commandBlock, nextRow = commandRow + 1;
+				if (nextRow == commands->rows)
+				{
+					if (++nextBlock == log->getNumBlocks(logCommands))
+						break;
+					nextRow = 0;
+					commands = &log->getBlock(logCommands, nextBlock);
+				}
+				if (log->getColumn64(*commands, commandTimestamp)[nextRow] > times[r])
+					break;
+				commandBlock = nextBlock;
+				commandRow = nextRow;
+			}
+			const LogBlock& commands = log->getBlock(logCommands, commandBlock);
+			double ms = (times[r] - log->getColumn64(commands, commandTimestamp)[commandRow]) / 1e6;
+			int bin = (int)(ms / latencyBin);
+			histogram[(bin < latencyBins) ? bin : latencyBins]++;
+			sum += ms;
+			matched++;
+		}
+	}
+	pthread_mutex_lock(&query.lock);
+	for (int i = 0; i <= latencyBins; i++)
+		latency->histogram[i] += histogram[i];
+	latency->matched += matched;
+	latency->sum += sum;
+	latency->estimateSum += estimateSum;
+	query.rows += rows;
+	query.bytes += bytes;
+	pthread_mutex_unlock(&query.lock);
+	delete [] histogram;
+}
+
+// upper edge of the bin the given fraction of samples falls in
+double percentile(const uint64_t* histogram, int bins, double binWidth, uint64_t total, double fraction)
+{
+	uint64_t target = (uint64_t)ceil(total * fraction), count = 0;
+	for (int i = 0; i <= bins; i++)
+	{
+		count += histogram[i];
+		if (count >= target && count > 0)
+			return (i + 1) * binWidth;
+	}
+	return bins * binWidth;
+}
+
+int main(int argc, char** argv)
+{
+	const char* ring = defaultTelemetryName;
+	int blockRows = defaultLogBlockRows;
+	int numSonar = colinSonar;
+	double period = 250.0;
+	double fromSeconds = -1.0, toSeconds = -1.0;
+	int threads = 0;
+	const char* files[2] = {NULL, NULL};
+	int numFiles = 0;
+	const char* command = (argc > 1) ? argv[1] : "";
+	bool valid = argc > 1;
+	for (int arg = 2; arg < argc && valid; arg++)
+	{
+		if (arg + 1 < argc && strcmp(argv[arg], "-r") == 0)
+			ring = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-b") == 0)
+			blockRows = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+			numSonar = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-p") == 0)
+			period = atof(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-f") == 0)
+			fromSeconds = atof(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0)
+			toSeconds = atof(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+			threads = atoi(argv[++arg]);
+		else if (argv[arg][0] != '-' && numFiles < 2)
+			files[numFiles++] = argv[arg];
+		else
+			valid = false;
+	}
+	bool query = strcmp(command, "dropout") == 0 || strcmp(command, "residual") == 0
+	             || strcmp(command, "latency") == 0;
+	bool convertCommand = strcmp(command, "convert") == 0;
+	if (!valid || numFiles != (convertCommand ? 2 : 1)
+	    || (!query && !convertCommand && strcmp(command, "record") != 0 && strcmp(command, "info") != 0)
+	    || numSonar < 1 || numSonar > maxSonar)
+	{
+		printf("usage: telemetryLog record [-r ring] [-b blockRows] logFile\n"
+		       "       telemetryLog convert [-s numSonar] [-p periodMs] [-b blockRows] dumpFile logFile\n"
+		       "       telemetryLog info logFile\n"
+		       "       telemetryLog dropout|residual|latency [-f seconds] [-t seconds] [-n threads] logFile\n");
+		return 1;
+	}
+	if (strcmp(command, "record") == 0)
+		return record(ring, blockRows, files[0]);
+	if (convertCommand)
+		return convert(files[0], files[1], numSonar, period, blockRows);
+
+	TelemetryLogReader log;
+	if (!log.open(files[0]))
+	{
+		fprintf(stderr, "unable to read %s\n", files[0]);
+		return 1;
+	}
+	if (strcmp(command, "info") == 0)
+		return info(log);
+
+	DropoutQuery dropout;
+	ResidualQuery residual;
+	LatencyQuery latency;
+	Query* shared;
+	RangeFunction function;
+	void* arg;
+	if (strcmp(command, "dropout") == 0)
+	{
+		memset(&dropout, 0, sizeof(dropout));
+		shared = &dropout.query;
+		function = dropoutChunk;
+		arg = &dropout;
+	}
+	else if (strcmp(command, "residual") == 0)
+	{
+		memset(&residual, 0, sizeof(residual));
+		shared = &residual.query;
+		function = residualChunk;
+		arg = &residual;
+	}
+	else
+	{
+		memset(&latency, 0, sizeof(latency));
+		shared = &latency.query;
+		function = latencyChunk;
+		arg = &latency;
+	}
+	int64_t start = log.getStartTime();
+	shared->log = &log;
+	shared->from = (fromSeconds >= 0.0) ? start + (int64_t)llround(fromSeconds * 1e9) : INT64_MIN;
+	shared->to = (toSeconds >= 0.0) ? start + (int64_t)llround(toSeconds * 1e9) : INT64_MAX;
+	pthread_mutex_init(&shared->lock, NULL);
+	int first, last;
+	if (!log.findBlocks(logFrames, shared->from, shared->to, &first, &last))
+	{
+		printf("no frames in range\n");
+		return 0;
+	}
+	shared->firstBlock = first;
+
+	ThreadPool pool(threads);
+	struct timespec startTime, endTime;
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	pool.parallelFor(0, last - first + 1, function, arg, 1);
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+	double elapsed = elapsedSeconds(startTime, endTime);
+	pthread_mutex_destroy(&shared->lock);
+
+	if (function == dropoutChunk)
+	{
+		printf("sonar  readings   no echo\n");
+		for (int i = 0; i < log.getNumSonar(); i++)
+			printf("%5d %9llu %8.2f%%\n", i, (unsigned long long)dropout.readings[i],
+			       dropout.readings[i] ? 100.0 * dropout.dropouts[i] / dropout.readings[i] : 0.0);
+	}
+	else if (function == residualChunk)
+	{
+		uint64_t fits = residual.fits;
+		printf("%llu scans fitted, %llu with fewer than %d readings\n", (unsigned long long)fits,
+		       (unsigned long long)(shared->rows - fits), minFitPoints);
+		if (fits > 0)
+			printf("rms residual: mean %.2f cm, p50 %.1f cm, p90 %.1f cm, p99 %.1f cm\n",
+			       residual.sum / fits,
+			       percentile(residual.histogram, residualBins, residualBin, fits, 0.5),
+			       percentile(residual.histogram, residualBins, residualBin, fits, 0.9),
+			       percentile(residual.histogram, residualBins, residualBin, fits, 0.99));
+	}
+	else
+	{
+		uint64_t matched = latency.matched;
+		printf("%llu frames, %llu matched to a command\n", (unsigned long long)shared->rows,
+		       (unsigned long long)matched);
+		if (matched > 0)
+			printf("command to frame: mean %.2f ms, p50 %.1f ms, p90 %.1f ms, p99 %.1f ms\n",
+			       latency.sum / matched,
+			       percentile(latency.histogram, latencyBins, latencyBin, matched, 0.5),
+			       percentile(latency.histogram, latencyBins, latencyBin, matched, 0.9),
+			       percentile(latency.histogram, latencyBins, latencyBin, matched, 0.99));
+		if (shared->rows > 0)
+			printf("frames' round trip estimate: mean %.2f ms\n", latency.estimateSum / shared->rows);
+	}
+	printf("%d of %d blocks, %llu rows, %.1f MB of columns read on %d threads in %.3f s\n",
+	       last - first + 1, log.getNumBlocks(logFrames), (unsigned long long)shared->rows,
+	       shared->bytes / 1e6, pool.getNumThreads(), elapsed);
+	return 0;
+}
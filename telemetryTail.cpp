@@ -0,0 +1,78 @@
+// telemetryTail.cpp
+// 10/18/2026
+
+// Prints the records SerialBot publishes to the shared memory telemetry
+// ring as they arrive, from another process and without disturbing the
+// programs driving Colin; see Telemetry/TelemetryRing.h
+//    telemetryTail [-l] [name]
+//    -l: print only the latest frame twice a second instead of every record
+//    name: shared memory object, /colin_telemetry by default
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "Telemetry/TelemetryReader.h"
+
+const int pollPeriod = 5000; // us between polls when nothing is new
+const int latestPeriod = 500000; // us between frames with -l
+
+void printFrame(const SensorFrame& frame)
+{
+	printf("frame %u %.3f s  pose %d %d %.3f  sonar", frame.sequence,
+	       frame.timestamp / 1e9, frame.x, frame.y, frame.theta);
+	for (int i = 0; i < frame.numSonar && i < maxSonar; i++)
+		printf(" %d", frame.distances[i]);
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	bool latestOnly = false;
+	const char* name = defaultTelemetryName;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (strcmp(argv[arg], "-l") == 0)
+			latestOnly = true;
+		else
+			name = argv[arg];
+	}
+	TelemetryReader reader;
+	if (!reader.open(name))
+	{
+		fprintf(stderr, "unable to open telemetry %s\n", name);
+		return 1;
+	}
+	if (latestOnly)
+	{
+		SensorFrame frame;
+		while (true)
+		{
+			if (reader.latestFrame(&frame))
+				printFrame(frame);
+			fflush(stdout);
+			usleep(latestPeriod);
+		}
+	}
+	uint64_t missed = 0;
+	TelemetryRecord record;
+	while (true)
+	{
+		if (reader.next(&record) == 0)
+		{
+			fflush(stdout);
+			usleep(pollPeriod);
+			continue;
+		}
+		if (reader.getMissed() != missed)
+		{
+			printf("missed %llu records\n", (unsigned long long)(reader.getMissed() - missed));
+			missed = reader.getMissed();
+		}
+		if (record.type == telemetryFrame)
+			printFrame(record.frame);
+		else if (record.type == telemetryCommand)
+			printf("command %.3f s  %d cm/s %.3f rad/s\n", record.timestamp / 1e9,
+			       record.command.translational, record.command.angular);
+	}
+	return 0;
+}
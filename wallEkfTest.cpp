@@ -0,0 +1,92 @@
+// wallEkfTest.cpp
+// 10/18/2026
+
+// program to test the wall EKF
+// drives a virtual Colin weaving alongside a straight wall, feeding the
+// filter odometry that over-reports distance by 3% with noisy heading and
+// line fits with noisy slope and intercept, then turns left to follow a
+// second wall on its right; compares the filtered and raw wall offset
+// and heading against ground truth
+
+#include <stdio.h>
+#include <time.h>
+#include <random>
+#include "Estimation/WallEkf.h"
+
+using namespace std;
+
+const int numSteps = 2000;
+const int cornerStep = 1000; // Colin turns 90 degrees left here
+const double dt = 0.25; // Colin's sensor period in seconds
+const double speed = 20.0; // cm/s
+const double slopeNoise = 0.08;
+const double interceptNoise = 4.0; // cm
+
+int main()
+{
+	mt19937 rng(1);
+	normal_distribution<double> noise(0.0, 1.0);
+	WallEkf ekf;
+	Pose2D truth = makePose(0.0, 0.0, 0.0);
+	// the wall is y = wallY until the corner, then x = wallX
+	double wallY = 60.0;
+	double wallX = 0.0;
+	double rawOffsetError = 0.0, ekfOffsetError = 0.0;
+	double rawHeadingError = 0.0, ekfHeadingError = 0.0;
+	int rejected = 0, counted = 0;
+	double seconds = 0.0;
+	for (int step = 0; step < numSteps; step++)
+	{
+		Pose2D previous = truth;
+		// weave either side of the wall's direction
+		double direction = (step < cornerStep) ? 0.0 : M_PI / 2;
+		double target = direction + 0.15 * sin(step * 0.03);
+		Pose2D delta = makePose(speed * dt, 0.0, normalizeAngle(target - truth.theta));
+		if (step == cornerStep)
+			wallX = truth.x + 60.0;
+		truth = composePose(truth, delta);
+
+		// offset and heading of the wall in the local frame
+		double offset, heading;
+		if (step < cornerStep)
+		{
+			offset = wallY - truth.y;
+			heading = normalizeAngle(-truth.theta);
+		}
+		else
+		{
+			offset = truth.x - wallX;
+			heading = normalizeAngle(M_PI / 2 - truth.theta);
+		}
+		double slope = tan(heading) + slopeNoise * noise(rng);
+		double intercept = offset / cos(heading) + interceptNoise * noise(rng);
+
+		Pose2D odometry = relativePose(previous, truth);
+		odometry.x *= 1.03;
+		odometry.theta += 0.003 * noise(rng);
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		ekf.predictOdometry(odometry);
+		if (!ekf.updateLine(slope, intercept))
+			rejected++;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+		// skip the first scans after each wall is picked up
+		if (step < 20 || (step >= cornerStep && step < cornerStep + 20))
+			continue;
+		double rawOffset = intercept * cos(atan(slope));
+		rawOffsetError += fabs(rawOffset - offset);
+		ekfOffsetError += fabs(ekf.getWallOffset() - offset);
+		rawHeadingError += fabs(atan(slope) - heading);
+		ekfHeadingError += fabs(ekf.getWallHeading() - heading);
+		counted++;
+	}
+	printf("mean offset error:  raw %5.2f cm,  filtered %5.2f cm\n",
+	       rawOffsetError / counted, ekfOffsetError / counted);
+	printf("mean heading error: raw %.4f rad, filtered %.4f rad\n",
+	       rawHeadingError / counted, ekfHeadingError / counted);
+	printf("%d/%d fits rejected, %.2f us/step\n", rejected, numSteps, seconds / numSteps * 1e6);
+	return 0;
+}
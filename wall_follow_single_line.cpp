@@ -4,145 +4,474 @@
 
 // Wall following program for Colin the robot
 // Models walls as a single line constructed using weighted linear regression
-// on obstacle locations in Colin's local coordinate system measured with 
+// on obstacle locations in Colin's local coordinate system measured with
 // sonar sensors
 
 // local coordinate system is defined as follows:
 //    x axis: forward-aft with forward positive
 //    y axis: left-right with left positive
 
+// Processing is split into a pipeline of four stages, each in its own thread:
+//    comm:       SerialBot::commThreadFunction, pushes SensorFrames
+//    preprocess: filters readings (SonarFilter), converts them to Cartesian
+//                points, corrects odometry by scan matching (ScanMatcher) and
+//                accumulates points over recent scans with the corrected pose
+//    line:       fits a line to the accumulated points
+//    control:    smooths the fitted line with an EKF (WallEkf) that also
+//                tracks the pose, predicts it forward to when the next
+//                command takes effect with the commanded speeds and
+//                computes speed commands from it,
+//                which a DWA planner (DwaPlanner) turns into the closest
+//                command that won't drive into the accumulated points
+// Stages are connected by bounded lock-free SPSC queues and pass messages
+// by value, so no state is shared between them
+// By default each stage is pinned to its own core (0 through 3); the cores
+// can be given on the command line, with -1 leaving a stage unpinned
+// -r enables real-time mode (SCHED_FIFO, locked memory) for the comm and
+// control threads, with the control thread one priority below comm
+// -s runs against the simulator (SimBot) in the given world file instead
+// of the robot, and -t runs the simulator scale times faster than real
+// time (default 1)
+// -g sets the control law's gains (setPoint kE kS), as picked with gainSweep
+// -u serves commands on a Unix domain socket (CommandServer) as well as
+// the terminal: set speed requests set the translational speed, while
+// the control law keeps steering; commandLoad -u measures its latency
+// Once the terminal's input ends it keeps serving until SIGINT or SIGTERM,
+// which also ends the terminal loop; either way Colin is stopped on exit
+// -a lets SerialBot adapt its update rate to Colin's speed and how close
+// the walls are (AdaptiveRatePolicy) instead of updating 4 times a second
+// Every frame and command is published to the shared memory telemetry
+// ring, so telemetryTail or other tools can watch from another process
+//    wall_follow_single_line [-s worldFile [-t scale]] [-g setPoint kE kS]
+//                            [-r priority] [-u socketPath] [-a]
+//                            [commCpu preprocessCpu lineCpu controlCpu]
+
 #include "SerialBot/SerialBot.h"
+#include "Sim/SimBot.h"
 #include "LineFitter/LineFitter.h"
 #include "LineFitter/Point.h"
+#include "SonarFilter/SonarFilter.h"
+#include "PointCloud/PointAccumulator.h"
+#include "ScanMatching/ScanMatcher.h"
+#include "Estimation/WallEkf.h"
+#include "Planner/DwaPlanner.h"
+#include "WallFollow/WallFollowLaw.h"
+#include "Geometry/Pose2D.h"
+#include "Pipeline/SpscQueue.h"
+#include "Pipeline/PipelineStage.h"
+#include "RealTime/RealTime.h"
+#include "CommandServer/CommandServer.h"
 #include <pthread.h>
+#include <unistd.h>
+#include <signal.h>
 #include <cmath>
+#include <atomic>
 
 using namespace std;
 
-SerialBot colin;
+Robot* colin; // SerialBot, or SimBot with -s
+SimBot* sim = NULL; // colin when simulating
+TelemetryWriter telemetry;
 
 const int numSonar = 8;
 const int maxTrans = 200; // max translational speed
 const double maxAng = 2.0; // max angular velocity
+const int maxRange = 300; // readings of 0 or beyond this are treated as no echo
 // angles of sensors in radians: 0, 7pi/4, 3pi/2, 5pi/4, pi, 3pi/4, pi/2, pi/4
 const double sensorAngles[] = {0.0, 5.497787, 4.712389, 3.926991, 3.141593, 2.356194, 1.570796, 0.785398};
-int distances[numSonar];
-Point points[numSonar];
-LineFitter line(points, numSonar);
-double setPoint = 30; // initial set point for following distance
-double kE = 0.0; // gain for error in following distance
-double kS = 0.1; // gain for slope of wall relative to Colin's path
+static_assert(numSonar == sonarChannels, "SonarFilter is sized for Colin's sonar array");
+const int maxScanPoints = 256; // most accumulated points passed to the line fitter
+const int64_t maxPointAge = 3000000000LL; // accumulated points expire after 3 s
+const double maxPointTravel = 100.0; // or after driving 100 cm
+const int matchMapPoints = 400; // points in the scan matcher's local map
+const float matchDistance = 30.0f; // farthest scan matching correspondence in cm
+const float minConfidence = 0.2f; // filtered readings below this aren't accumulated
+const int queueCapacity = 4; // kept short so stale data doesn't build up
+const int64_t stopTimeout = 2000000000LL; // ns to wait for the stop command to go out
+WallFollowGains gains = defaultWallFollowGains(); // set with -g
 
-int translational = 0;
-double angular = 0.0;
+atomic<int> translational(0); // set by the user in main or over the socket, read by control stage
+volatile sig_atomic_t running = 1; // cleared by SIGINT or SIGTERM
 
-void* commFunction(void* args)
+// output of the preprocessing stage
+struct Scan
+{
+	uint32_t sequence;
+	int64_t timestamp;
+	int64_t sampledAt; // from the SensorFrame
+	int64_t commandAt;
+	Pose2D pose; // scan matched pose
+	int numPoints;
+	Point points[maxScanPoints]; // in Colin's local frame at the time of the scan
+	float confidence[maxScanPoints]; // from SonarFilter, scales the fit weights
+};
+
+// output of the line extraction stage
+struct WallLine
+{
+	uint32_t sequence;
+	int64_t timestamp;
+	int64_t sampledAt;
+	int64_t commandAt;
+	Pose2D pose; // scan matched pose the line was seen from
+	double slope;
+	double intercept;
+	int numPoints;
+	Point points[maxScanPoints]; // the scan's points, obstacles for the planner
+};
+
+// sets colin's speed set points
+// limits the angular and translational velocities to the max angular velocity
+// but preserves the commanded radius of travel
+void setSpeed(int trans, double angular)
 {
-	colin.commThreadFunction();
+	limitAngular(&trans, &angular, maxAng);
+	colin->setSpeed(trans, angular);
 }
 
-void updatePoints()
+// filters readings, converts them to points and returns the points
+// accumulated over recent scans in Colin's local coordinate system
+class PreprocessStage : public PipelineStage
 {
-	for (int i = 0; i < numSonar; i++)
-		points[i].setCoordinates(distances[i], sensorAngles[i]);
+public:
+	PreprocessStage(int cpu, SpscQueue<SensorFrame>* in, SpscQueue<Scan>* out)
+		: PipelineStage("preprocess", cpu), in_(in), out_(out), filter_(maxRange),
+		  accumulator_(maxScanPoints, maxPointAge, maxPointTravel),
+		  matcher_(matchMapPoints, matchDistance) {}
+protected:
+	bool process()
+	{
+		SensorFrame frame;
+		if (!in_->tryPop(frame))
+			return false;
+		Scan scan;
+		scan.sequence = frame.sequence;
+		scan.timestamp = frame.timestamp;
+		scan.sampledAt = frame.sampledAt;
+		scan.commandAt = frame.commandAt;
+		FilteredScan filtered;
+		filter_.update(frame.distances, &filtered);
+
+		// only readings that hit something are worth keeping
+		Point points[numSonar];
+		float confidence[numSonar];
+		int numPoints = 0;
+		for (int i = 0; i < numSonar; i++)
+		{
+			if (filtered.range[i] >= maxRange || filtered.confidence[i] < minConfidence)
+				continue;
+			points[numPoints].setCoordinates(filtered.range[i], sensorAngles[i]);
+			confidence[numPoints] = filtered.confidence[i];
+			numPoints++;
+		}
+		Pose2D odometry = makePose(frame.x, frame.y, frame.theta);
+		Pose2D pose = matcher_.processScan(points, numPoints, odometry).pose;
+		accumulator_.addScan(points, confidence, numPoints, pose, frame.timestamp);
+		scan.pose = pose;
+		scan.numPoints = accumulator_.getRobotFrame(pose, scan.points,
+		                                            scan.confidence, maxScanPoints);
+		pushOutput(out_, scan);
+		return true;
+	}
+private:
+	SpscQueue<SensorFrame>* in_;
+	SpscQueue<Scan>* out_;
+	SonarFilter filter_;
+	PointAccumulator accumulator_;
+	ScanMatcher matcher_;
+};
+
+// fits a single line to each scan
+class LineStage : public PipelineStage
+{
+public:
+	LineStage(int cpu, SpscQueue<Scan>* in, SpscQueue<WallLine>* out)
+		: PipelineStage("line", cpu), in_(in), out_(out), line_(points_, maxScanPoints) {}
+protected:
+	bool process()
+	{
+		Scan scan;
+		if (!in_->tryPop(scan))
+			return false;
+		line_.setPoints(scan.points, scan.numPoints);
+		line_.setConfidence(scan.confidence);
+		line_.updateLine();
+		WallLine wall;
+		wall.sequence = scan.sequence;
+		wall.timestamp = scan.timestamp;
+		wall.sampledAt = scan.sampledAt;
+		wall.commandAt = scan.commandAt;
+		wall.pose = scan.pose;
+		wall.slope = line_.getM();
+		wall.intercept = line_.getB();
+		wall.numPoints = scan.numPoints;
+		for (int i = 0; i < scan.numPoints; i++)
+			wall.points[i] = scan.points[i];
+		pushOutput(out_, wall);
+		return true;
+	}
+private:
+	SpscQueue<Scan>* in_;
+	SpscQueue<WallLine>* out_;
+	Point points_[maxScanPoints];
+	LineFitter line_;
+};
+
+// filters each fitted line and applies the wall following control law
+// the filter steps from pose to pose with the scan matched odometry and is
+// corrected by the fit; a copy is then predicted forward with the last
+// command from when the readings were taken to when the command computed
+// from them takes effect, both estimated from the link delay (see
+// SerialBot/LinkDelayEstimator.h), so the control law acts on where the
+// wall will be rather than where it was seen a period or more ago
+// if the pipeline has run past the exchange the frame expected to carry
+// the command, it goes out on a later one; exchanges are spaced as far
+// apart as consecutive frames' commandAt
+// the planner then picks the reachable command nearest the control law's
+// that keeps clear of the scan's points, or stops Colin if none does
+// if the robot's readings go stale while it's moving (Robot::isStale), it's
+// stopped until frames arrive again rather than left driving on the last
+// command
+class ControlStage : public PipelineStage
+{
+public:
+	ControlStage(int cpu, SpscQueue<WallLine>* in, const DwaConfig& dwaConfig)
+		: PipelineStage("control", cpu), in_(in), planner_(dwaConfig),
+		  havePose_(false), trans_(0.0), angular_(0.0), lastCommandAt_(0), appliedAt_(0),
+		  stale_(false) {}
+protected:
+	bool process()
+	{
+		WallLine wall;
+		if (!in_->tryPop(wall))
+		{
+			if (!stale_ && (trans_ != 0.0 || angular_ != 0.0) && colin->isStale())
+			{
+				printf("sensor data %.0f ms old, stopping\n", colin->getSnapshotAge() / 1e6);
+				trans_ = 0.0;
+				angular_ = 0.0;
+				setSpeed(0, 0.0);
+				stale_ = true;
+			}
+			return false;
+		}
+		stale_ = false;
+		if (havePose_)
+			ekf_.predictOdometry(relativePose(lastPose_, wall.pose));
+		lastPose_ = wall.pose;
+		havePose_ = true;
+		ekf_.updateLine(wall.slope, wall.intercept);
+
+		int trans = translational.load();
+		int64_t commandAt = wall.commandAt;
+		int64_t period = commandAt - lastCommandAt_;
+		lastCommandAt_ = wall.commandAt;
+		int64_t now = monotonicNanos();
+		if (commandAt < now)
+			commandAt = (period > 0) ? commandAt + ((now - commandAt) / period + 1) * period : now;
+		WallEkf estimate = ekf_;
+		estimate.predictCommand(trans_, angular_, (commandAt - wall.sampledAt) / 1e9);
+		double slope, intercept;
+		estimate.getLine(&slope, &intercept);
+		double angular = 0.0;
+		if (trans != 0)
+		{
+			printf("y=%.2fx + %.2f (fit y=%.2fx + %.2f)\n", slope, intercept,
+			       wall.slope, wall.intercept);
+			angular = getWallFollowAngular(gains, slope, intercept, trans);
+		}
+		// the planner's window spans from when the last command took effect
+		// to when this one will, however the rate policy spaces them; the
+		// first has no time to accelerate in
+		double planPeriod = (appliedAt_ != 0) ? (commandAt - appliedAt_) / 1e9 : 0.0;
+		appliedAt_ = commandAt;
+		planner_.setObstacles(wall.points, wall.numPoints);
+		DwaCommand command = planner_.plan(trans_, angular_, trans, angular, planPeriod);
+		if (!command.valid && trans != 0)
+			printf("no safe command, stopping\n");
+		trans_ = command.translational;
+		angular_ = command.angular;
+		setSpeed((int)lround(trans_), angular_);
+		return true;
+	}
+private:
+	SpscQueue<WallLine>* in_;
+	WallEkf ekf_;
+	DwaPlanner planner_;
+	bool havePose_;
+	Pose2D lastPose_;
+	double trans_; // last commanded speeds
+	double angular_;
+	int64_t lastCommandAt_;
+	int64_t appliedAt_; // when the last planned command takes effect, 0 before the first
+	bool stale_; // stopped for stale readings
+};
+
+// set speed requests from CommandServer; only the translational speed is
+// taken, since the wall following law decides the angular velocity
+void serverSetSpeed(int trans, double /* angular */, void* /* arg */)
+{
+	if (abs(trans) > maxTrans)
+		trans = (trans > 0) ? maxTrans : -maxTrans;
+	translational.store(trans);
 }
 
-// accepts two doubles as parameters:
-//    the slope of the line representing the wall
-//    the y intercept of the line representing the wall
-// returns the error between the distance between the robot's location (the origin)
-// and the given line and the set point
-// positive error indicates the robot is between the set point and the wall
-// negative error indicates the set point is between the robot and the wall
-double getDistanceToSetPoint(double slope, double intercept)
+void stopRunning(int /* signal */)
 {
-	if (slope == 0.0) // if the line is perfectly horizontal
-		return abs(intercept) - setPoint;
-	double xIntercept = (-1.0 * intercept) / ((1.0 / slope) + slope);
-	double yIntercept = (slope * xIntercept) + intercept;
-	double distance = sqrt(pow(xIntercept, 2.0) + pow(yIntercept, 2.0));
-	double error = distance - setPoint;
-	if (intercept < 0)
-		error *= -1;
-	return error;
+	running = 0;
 }
 
-// accepts one double as a parameter:
-//    the slope of the line representing the wall
-// returns velocity of the set point in the robot's local coordinate system
-// velocity is positive if the set point is moving to the left
-// velocity is negative if set point is moving to the right
-double getVelocityOfSetPoint(double slope) 
+void* commFunction(void* args)
 {
-	if (slope == 0.0)
-		return 0.0;
-	// calculate speedToSetPoint
-	double angleOfLine = atan(slope);
-	double speedToSetPoint = (double)translational * sin(angleOfLine);
-	// alternate method, doesn't use trig functions:
-	//double speedToSetPoint = sqrt((pow((double)translational, 2) * pow(slope, 2))/(1 + pow(slope, 2)));
-	if (slope < 0.0)
-		speedToSetPoint *= -1.0;
-	return speedToSetPoint;
+	colin->commThreadFunction();
+	return NULL;
 }
 
-// sets colin's speed set points
-// limits the angular and translational velocities to the max angular velocity
-// but preserves the commanded radius of travel
-void setSpeed()
+// sets zero speed and waits until an exchange sent after it has completed,
+// two frames on, or until stopTimeout passes if the link is down
+void stopColin()
 {
-	if (abs(angular) > maxAng)
-	{
-		double radius = (double)translational / abs(angular);
-		int adjustedTrans = radius * maxAng;
-		double adjustedAng = (angular > 0.0)? maxAng : maxAng * -1.0;
-		colin.setSpeed(adjustedTrans, adjustedAng);
-	}
-	else
+	colin->setSpeed(0, 0.0);
+	uint32_t frames = colin->getFramesReceived();
+	int64_t deadline = monotonicNanos() + stopTimeout;
+	while (colin->getFramesReceived() - frames < 2 && monotonicNanos() < deadline)
+		usleep(10000);
+}
+
+void printStats(PipelineStage** stages, int numStages)
+{
+	printf("%-12s %8u frames  %6u dropped  %6.1f ms round trip  %6.1f ms old\n", "comm",
+	       colin->getFramesReceived(), colin->getFramesDropped(), colin->getRoundTrip() / 1e6,
+	       colin->getSnapshotAge() / 1e6);
+	for (int i = 0; i < numStages; i++)
+		stages[i]->printStats();
+	if (sim != NULL)
 	{
-		colin.setSpeed(translational, angular);	
+		Pose2D pose = sim->getTruePose();
+		printf("%-12s %8.1f s  true pose (%.0f, %.0f, %.2f)  %u collisions\n", "sim",
+		       sim->getSimTime(), pose.x, pose.y, pose.theta, sim->getCollisions());
 	}
 }
 
-void* wallFollowFunction(void* args)
+int main(int argc, char** argv)
 {
-	while(true)
+	int cpus[] = {0, 1, 2, 3};
+	RealTimeConfig realTime = defaultRealTimeConfig();
+	int arg = 1;
+	World world(1024);
+	if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
 	{
-		if (translational != 0)
+		if (!world.load(argv[arg + 1]))
 		{
-			colin.getDistances(distances);
-			updatePoints();
-			line.setPoints(points);
-			line.updateLine();
-			double slope = line.getM();
-			double intercept = line.getB();
-			printf("y=%.2fx + %.2f\n", slope, intercept);
-			double error = getDistanceToSetPoint(slope, intercept);
-			double dError = getVelocityOfSetPoint(slope);
-			double eTerm = kE * error;
-			double sTerm = kS * dError;
-			angular = eTerm + sTerm;
+			cerr << "unable to load world " << argv[arg + 1] << endl;
+			return 1;
 		}
-		else
+		sim = new SimBot(&world, sensorAngles, numSonar, world.getStart(), 1);
+		arg += 2;
+		if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0)
 		{
-			angular = 0.0;
+			sim->setTimeScale(atof(argv[arg + 1]));
+			arg += 2;
 		}
-		setSpeed();
-		usleep(500000); // repeat every 0.5 seconds
 	}
-}
+	if (arg + 3 < argc && strcmp(argv[arg], "-g") == 0)
+	{
+		gains.setPoint = atof(argv[arg + 1]);
+		gains.kE = atof(argv[arg + 2]);
+		gains.kS = atof(argv[arg + 3]);
+		arg += 4;
+	}
+	if (arg + 1 < argc && strcmp(argv[arg], "-r") == 0)
+	{
+		realTime.enabled = true;
+		realTime.priority = atoi(argv[arg + 1]);
+		arg += 2;
+	}
+	const char* socketPath = NULL;
+	if (arg + 1 < argc && strcmp(argv[arg], "-u") == 0)
+	{
+		socketPath = argv[arg + 1];
+		arg += 2;
+	}
+	bool adaptiveRate = false;
+	if (arg < argc && strcmp(argv[arg], "-a") == 0)
+	{
+		adaptiveRate = true;
+		arg++;
+	}
+	for (int i = 0; arg < argc && i < 4; i++, arg++)
+		cpus[i] = atoi(argv[arg]);
+	if (sim != NULL)
+		colin = sim;
+	else
+	{
+		SerialBotConfig config = defaultSerialBotConfig();
+		SerialBot* bot = new SerialBot(config);
+		if (adaptiveRate)
+			bot->setRatePolicy(new AdaptiveRatePolicy(defaultAdaptiveRateConfig(),
+			                                          config.baudRate, config.numSonar));
+		colin = bot;
+	}
 
-int main()
-{
+	SpscQueue<SensorFrame> frames(queueCapacity);
+	SpscQueue<Scan> scans(queueCapacity);
+	SpscQueue<WallLine> lines(queueCapacity);
+	PreprocessStage preprocess(cpus[1], &frames, &scans);
+	LineStage lineStage(cpus[2], &scans, &lines);
+	DwaConfig dwaConfig = defaultDwaConfig();
+	dwaConfig.maxTrans = maxTrans;
+	dwaConfig.maxAng = maxAng;
+	dwaConfig.maxObstacles = maxScanPoints;
+	ControlStage control(cpus[3], &lines, dwaConfig);
+	PipelineStage* stages[] = {&preprocess, &lineStage, &control};
+
+	if (realTime.enabled)
+	{
+		RealTimeConfig commRealTime = realTime;
+		commRealTime.cpu = cpus[0];
+		colin->setRealTime(commRealTime);
+		RealTimeConfig controlRealTime = realTime;
+		controlRealTime.priority = realTime.priority - 1;
+		control.setRealTime(controlRealTime);
+	}
+	colin->setFrameQueue(&frames);
+	if (telemetry.open(defaultTelemetryName, defaultTelemetryCapacity))
+		colin->setTelemetry(&telemetry);
+	else
+		cerr << "unable to open telemetry " << defaultTelemetryName << endl;
 	pthread_t commThread;
-	pthread_t lineFollowThread;
 	pthread_create(&commThread, NULL, commFunction, NULL);
-	pthread_create(&lineFollowThread, NULL, wallFollowFunction, NULL);
-	while (true)
+	if (cpus[0] >= 0 && !pinThreadToCpu(commThread, cpus[0]))
+		cerr << "comm: unable to pin stage to cpu " << cpus[0] << endl;
+	for (int i = 0; i < 3; i++)
+		stages[i]->start();
+	CommandServer* server = NULL;
+	if (socketPath != NULL)
+	{
+		server = new CommandServer(colin, 16);
+		server->setSpeedFunction(serverSetSpeed, NULL);
+		if (telemetry.isOpen())
+			server->setTelemetry(defaultTelemetryName);
+		if (!server->open(socketPath) || !server->start())
+		{
+			cerr << "unable to serve commands on " << socketPath << endl;
+			delete server;
+			server = NULL;
+		}
+	}
+
+	// without SA_RESTART, so a read from the terminal is interrupted too
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = stopRunning;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	while (running)
 	{
 		cout << "Enter translational speed: ";
 		int newTrans;
-		cin >> newTrans;
+		if (!(cin >> newTrans))
+			break;
 		cout << endl;
 		if (abs(newTrans) > maxTrans)
 		{
@@ -152,6 +481,26 @@ int main()
 		{
 			translational = newTrans;
 		}
+		printStats(stages, 3);
+	}
+	// without a terminal, keep following the wall for the socket's clients
+	// until a signal
+	while (server != NULL && running)
+	{
+		sleep(5);
+		printStats(stages, 3);
+	}
+	// stops the server and removes its socket
+	delete server;
+	// the control stage would overwrite the stop, so it goes first
+	colin->setFrameQueue(NULL);
+	for (int i = 0; i < 3; i++)
+		stages[i]->stop();
+	stopColin();
+	if (sim != NULL)
+	{
+		sim->stop();
+		pthread_join(commThread, NULL);
 	}
-	return 1;
+	return 0;
 }